@@ -0,0 +1,405 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/analysisoutput.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "smash/action.h"
+#include "smash/config.h"
+#include "smash/cxx14compat.h"
+#include "smash/particles.h"
+
+namespace smash {
+
+/*!\Userguide
+ * \page analysis_output_user_guide_ Analysis Output
+ * Instead of writing the particles or interactions to disk and histogramming
+ * them afterwards, the analysis output fills histograms of common observables
+ * during the run and only writes the results at the end of the run. If the
+ * run is aborted, the files keep their ".unfinished" name. Every ensemble is
+ * treated as an independent event. The only available format is
+ * \key ASCII. The observables are configured in the \key Analysis section:
+ *
+ * \key Observables (list of strings, optional, default = ["Spectra", "Flow",
+ * "Multiplicity", "Collision_Rate"]): \n
+ * \li \key "Spectra" - Rapidity spectra dN/dy and transverse momentum spectra
+ *     dN/dpT at midrapidity of the identified hadrons, written to
+ *     \c analysis_spectra.dat.
+ * \li \key "Flow" - Flow coefficients \f$v_n = \langle \cos(n\phi) \rangle\f$
+ *     of the identified hadrons at midrapidity as function of pT, with
+ *     respect to the reaction plane, which is the x-z plane. Written to
+ *     \c analysis_flow.dat.
+ * \li \key "Multiplicity" - Probability distribution of the number of charged
+ *     hadrons at midrapidity, written to \c analysis_multiplicity.dat.
+ * \li \key "Collision_Rate" - Number of interactions per event and time,
+ *     for all interactions and separately for elastic scatterings, inelastic
+ *     scatterings, string excitations and decays, written to
+ *     \c analysis_collision_rate.dat.
+ *
+ * \key Species (list of ints, optional, default = [211, -211, 111, 321, -321,
+ * 2212, -2212]): \n
+ * PDG codes of the identified hadrons.
+ *
+ * \key Rapidity_Cut (double, optional, default = 0.5): \n
+ * Particles with \f$|y|\f$ below this value are at midrapidity.
+ *
+ * \key Rapidity_Range (list of 2 doubles, optional, default = [-4.0, 4.0]),
+ * \key Rapidity_Bins (int, optional, default = 40): \n
+ * Binning of the rapidity spectra.
+ *
+ * \key Pt_Range (list of 2 doubles, optional, default = [0.0, 3.0]),
+ * \key Pt_Bins (int, optional, default = 30): \n
+ * Binning in transverse momentum in GeV.
+ *
+ * \key Max_Harmonic (int, optional, default = 4): \n
+ * Highest harmonic n of the flow coefficients.
+ *
+ * \key Time_Range (list of 2 doubles, optional, default = [0.0, 100.0]),
+ * \key Time_Bins (int, optional, default = 100): \n
+ * Binning of the collision rate in fm.
+ *
+ * All histograms are normalized per event and per bin width. The files start
+ * with comment lines beginning with '#' describing the columns.
+ *
+ * \n
+ * **Example: Configuring the Analysis Output**\n
+ *\verbatim
+ Output:
+     Analysis:
+         Format: ["ASCII"]
+         Observables: ["Spectra", "Flow"]
+         Species: [211, -211, 2212]
+         Pt_Range: [0.0, 2.0]
+         Pt_Bins: 20
+ \endverbatim
+ */
+
+namespace {
+/**
+ * \param[in] p Particle.
+ * \return Longitudinal rapidity of the particle.
+ */
+double rapidity(const ParticleData &p) {
+  const FourVector &mom = p.momentum();
+  return 0.5 * std::log((mom.x0() + mom.x3()) / (mom.x0() - mom.x3()));
+}
+
+/**
+ * \param[in] p Particle.
+ * \return Transverse momentum of the particle.
+ */
+double transverse_momentum(const ParticleData &p) {
+  const FourVector &mom = p.momentum();
+  return std::sqrt(mom.x1() * mom.x1() + mom.x2() * mom.x2());
+}
+
+/**
+ * Create one empty histogram per entry.
+ *
+ * \param[in] n Number of histograms.
+ * \param[in] range Range of the histograms.
+ * \param[in] n_bins Number of bins.
+ * \return The histograms.
+ */
+std::vector<UniformHistogram> make_histograms(
+    size_t n, const std::array<double, 2> &range, int n_bins) {
+  return std::vector<UniformHistogram>(
+      n, UniformHistogram(range[0], range[1], n_bins));
+}
+
+/**
+ * Read the identified species from the analysis parameters.
+ *
+ * \param[in] par Parameters of the analysis.
+ * \return PDG codes of the species.
+ * \throws invalid_argument if no species are given.
+ */
+std::vector<PdgCode> species_codes(const AnalysisParameters &par) {
+  if (par.species.empty()) {
+    throw std::invalid_argument("Analysis output needs at least one species.");
+  }
+  std::vector<PdgCode> codes;
+  for (const int pdg : par.species) {
+    codes.push_back(PdgCode::from_decimal(pdg));
+  }
+  return codes;
+}
+
+/**
+ * Write the header line shared by all analysis files.
+ *
+ * \param[in] file File to write to.
+ * \param[in] title Name of the observable.
+ * \param[in] n_events Number of events.
+ */
+void write_header(std::FILE *file, const char *title, int n_events) {
+  std::fprintf(file, "# %s %s, %i events\n", VERSION_MAJOR, title, n_events);
+}
+}  // unnamed namespace
+
+UniformHistogram::UniformHistogram(double min, double max, int n_bins)
+    : min_(min) {
+  if (!(max > min) || n_bins < 1) {
+    throw std::invalid_argument(
+        "Histogram needs a non-empty range and at least one bin.");
+  }
+  width_ = (max - min) / n_bins;
+  contents_.resize(n_bins, 0.);
+}
+
+IdentifiedSpectra::IdentifiedSpectra(const AnalysisParameters &par)
+    : species_(species_codes(par)),
+      rapidity_cut_(par.rapidity_cut),
+      dN_dy_(make_histograms(species_.size(), par.rapidity_range,
+                             par.rapidity_bins)),
+      dN_dpT_(make_histograms(species_.size(), par.pt_range, par.pt_bins)) {}
+
+void IdentifiedSpectra::at_eventend(const Particles &particles,
+                                    const EventInfo &) {
+  for (const ParticleData &p : particles) {
+    for (size_t i = 0; i < species_.size(); i++) {
+      if (p.pdgcode() == species_[i]) {
+        const double y = rapidity(p);
+        dN_dy_[i].fill(y);
+        if (std::abs(y) < rapidity_cut_) {
+          dN_dpT_[i].fill(transverse_momentum(p));
+        }
+        break;
+      }
+    }
+  }
+}
+
+void IdentifiedSpectra::write(std::FILE *file, int n_events) const {
+  write_header(file, "identified spectra", n_events);
+  const double norm = 1. / std::max(n_events, 1);
+  std::fprintf(file, "# dN/dy\n# y");
+  for (const PdgCode &pdg : species_) {
+    std::fprintf(file, " %s", pdg.string().c_str());
+  }
+  std::fprintf(file, "\n");
+  for (int bin = 0; bin < dN_dy_[0].n_bins(); bin++) {
+    std::fprintf(file, "%g", dN_dy_[0].bin_center(bin));
+    for (const UniformHistogram &h : dN_dy_) {
+      std::fprintf(file, " %g", h.content(bin) * norm / h.bin_width());
+    }
+    std::fprintf(file, "\n");
+  }
+  std::fprintf(file, "\n\n# dN/dpT [1/GeV] for |y| < %g\n# pT", rapidity_cut_);
+  for (const PdgCode &pdg : species_) {
+    std::fprintf(file, " %s", pdg.string().c_str());
+  }
+  std::fprintf(file, "\n");
+  for (int bin = 0; bin < dN_dpT_[0].n_bins(); bin++) {
+    std::fprintf(file, "%g", dN_dpT_[0].bin_center(bin));
+    for (const UniformHistogram &h : dN_dpT_) {
+      std::fprintf(file, " %g", h.content(bin) * norm / h.bin_width());
+    }
+    std::fprintf(file, "\n");
+  }
+}
+
+FlowCoefficients::FlowCoefficients(const AnalysisParameters &par)
+    : species_(species_codes(par)),
+      rapidity_cut_(par.rapidity_cut),
+      max_harmonic_(par.max_harmonic),
+      counts_(make_histograms(species_.size(), par.pt_range, par.pt_bins)),
+      cos_sum_(make_histograms(species_.size() * par.max_harmonic,
+                               par.pt_range, par.pt_bins)),
+      cos2_sum_(cos_sum_) {
+  if (max_harmonic_ < 1) {
+    throw std::invalid_argument("Max_Harmonic has to be at least 1.");
+  }
+}
+
+void FlowCoefficients::at_eventend(const Particles &particles,
+                                   const EventInfo &) {
+  for (const ParticleData &p : particles) {
+    for (size_t i = 0; i < species_.size(); i++) {
+      if (p.pdgcode() != species_[i]) {
+        continue;
+      }
+      if (std::abs(rapidity(p)) < rapidity_cut_) {
+        const double pT = transverse_momentum(p);
+        const double phi = std::atan2(p.momentum().x2(), p.momentum().x1());
+        counts_[i].fill(pT);
+        for (int n = 1; n <= max_harmonic_; n++) {
+          const double c = std::cos(n * phi);
+          cos_sum_[i * max_harmonic_ + n - 1].fill(pT, c);
+          cos2_sum_[i * max_harmonic_ + n - 1].fill(pT, c * c);
+        }
+      }
+      break;
+    }
+  }
+}
+
+void FlowCoefficients::write(std::FILE *file, int n_events) const {
+  write_header(file, "flow coefficients", n_events);
+  std::fprintf(file,
+               "# v_n(pT) for |y| < %g with statistical errors, one block per "
+               "species\n",
+               rapidity_cut_);
+  for (size_t i = 0; i < species_.size(); i++) {
+    std::fprintf(file, "# %s\n# pT N", species_[i].string().c_str());
+    for (int n = 1; n <= max_harmonic_; n++) {
+      std::fprintf(file, " v%i err_v%i", n, n);
+    }
+    std::fprintf(file, "\n");
+    for (int bin = 0; bin < counts_[i].n_bins(); bin++) {
+      const double N = counts_[i].content(bin);
+      std::fprintf(file, "%g %g", counts_[i].bin_center(bin), N);
+      for (int n = 1; n <= max_harmonic_; n++) {
+        double v = 0., error = 0.;
+        if (N > 0.) {
+          v = cos_sum_[i * max_harmonic_ + n - 1].content(bin) / N;
+          const double v2 =
+              cos2_sum_[i * max_harmonic_ + n - 1].content(bin) / N;
+          error = std::sqrt(std::max(0., v2 - v * v) / N);
+        }
+        std::fprintf(file, " %g %g", v, error);
+      }
+      std::fprintf(file, "\n");
+    }
+    std::fprintf(file, "\n\n");
+  }
+}
+
+MultiplicityDistribution::MultiplicityDistribution(
+    const AnalysisParameters &par)
+    : rapidity_cut_(par.rapidity_cut) {}
+
+void MultiplicityDistribution::at_eventend(const Particles &particles,
+                                           const EventInfo &) {
+  int n_charged = 0;
+  for (const ParticleData &p : particles) {
+    if (p.type().charge() != 0 && p.is_hadron() &&
+        std::abs(rapidity(p)) < rapidity_cut_) {
+      n_charged++;
+    }
+  }
+  events_[n_charged]++;
+}
+
+void MultiplicityDistribution::write(std::FILE *file, int n_events) const {
+  write_header(file, "multiplicity distribution", n_events);
+  std::fprintf(file, "# charged hadrons with |y| < %g\n# N_ch P(N_ch)\n",
+               rapidity_cut_);
+  for (const auto &entry : events_) {
+    std::fprintf(file, "%i %g\n", entry.first,
+                 static_cast<double>(entry.second) / std::max(n_events, 1));
+  }
+}
+
+CollisionRate::CollisionRate(const AnalysisParameters &par)
+    : rates_(make_histograms(5, par.time_range, par.time_bins)) {}
+
+void CollisionRate::at_interaction(const InteractionRecord &interaction) {
+  const ProcessType type = interaction.type;
+  if (type == ProcessType::Wall || type == ProcessType::HyperSurfaceCrossing ||
+      type == ProcessType::None) {
+    return;
+  }
+  int category;
+  if (type == ProcessType::Elastic) {
+    category = 1;
+  } else if (type == ProcessType::Decay) {
+    category = 4;
+  } else if (is_string_soft_process(type) ||
+             type == ProcessType::StringHard) {
+    category = 3;
+  } else {
+    category = 2;
+  }
+  const double t = interaction.time;
+  rates_[0].fill(t);
+  rates_[category].fill(t);
+}
+
+void CollisionRate::write(std::FILE *file, int n_events) const {
+  write_header(file, "collision rate", n_events);
+  std::fprintf(file,
+               "# dN/dt [c/fm] per event\n"
+               "# t all elastic inelastic string decay\n");
+  const double norm = 1. / (std::max(n_events, 1) * rates_[0].bin_width());
+  for (int bin = 0; bin < rates_[0].n_bins(); bin++) {
+    std::fprintf(file, "%g", rates_[0].bin_center(bin));
+    for (const UniformHistogram &h : rates_) {
+      std::fprintf(file, " %g", h.content(bin) * norm);
+    }
+    std::fprintf(file, "\n");
+  }
+}
+
+std::unique_ptr<AnalysisObservable> AnalysisOutput::create_observable(
+    const std::string &name, const AnalysisParameters &par) {
+  if (name == "Spectra") {
+    return make_unique<IdentifiedSpectra>(par);
+  } else if (name == "Flow") {
+    return make_unique<FlowCoefficients>(par);
+  } else if (name == "Multiplicity") {
+    return make_unique<MultiplicityDistribution>(par);
+  } else if (name == "Collision_Rate") {
+    return make_unique<CollisionRate>(par);
+  }
+  throw std::invalid_argument(
+      "Unknown analysis observable \"" + name +
+      "\", should be \"Spectra\", \"Flow\", \"Multiplicity\" or "
+      "\"Collision_Rate\".");
+}
+
+AnalysisOutput::AnalysisOutput(const bf::path &path, const std::string &name,
+                               const OutputParameters &out_par)
+    : OutputInterface(name) {
+  for (const std::string &observable : out_par.analysis.observables) {
+    auto obs = create_observable(observable, out_par.analysis);
+    auto file = make_unique<RenamingFilePtr>(
+        path / ("analysis_" + obs->name() + ".dat"), "w", out_par.async_write);
+    observables_.emplace_back(std::move(obs), std::move(file));
+  }
+}
+
+AnalysisOutput::~AnalysisOutput() {
+  if (!finished_) {
+    for (const auto &observable : observables_) {
+      observable.second->keep_unfinished();
+    }
+  }
+}
+
+void AnalysisOutput::at_runend() {
+  if (finished_) {
+    return;
+  }
+  for (const auto &observable : observables_) {
+    observable.first->write(observable.second->get(), n_events_);
+  }
+  finished_ = true;
+}
+
+void AnalysisOutput::at_eventend(const Particles &particles, const int,
+                                 const EventInfo &info) {
+  n_events_++;
+  for (const auto &observable : observables_) {
+    observable.first->at_eventend(particles, info);
+  }
+}
+
+void AnalysisOutput::at_interactions(ConstSpan<InteractionRecord> records) {
+  for (const InteractionRecord &record : records) {
+    for (const auto &observable : observables_) {
+      observable.first->at_interaction(record);
+    }
+  }
+}
+
+}  // namespace smash
@@ -13,7 +13,6 @@
 
 #include <boost/filesystem.hpp>
 
-#include "smash/action.h"
 #include "smash/clock.h"
 #include "smash/config.h"
 
@@ -45,10 +44,24 @@ static constexpr int HyperSurfaceCrossing = LogArea::HyperSurfaceCrossing::id;
  * \endcode
  * \li magic_number - 4 bytes that in ASCII read as "SMSH".
  * \li Format version is an integer number, currently it is 7.
- * \li Format variant is an integer number: 0 for default, 1 for extended.
+ * \li Format variant is an integer number: 0 for default, 1 for extended,
+ * 2 for selected fields.
  * \li len is the length of smash version string
  * \li smash_version is len chars that give information about the SMASH version.
  *
+ * For format variant 2, i.e. if the \c Columns option of the output content is
+ * given (see \ref output_content_specific_options_), the header continues with
+ * the written fields:
+ * \code
+ * uint32_t   n_fields * (uint32_t len*char char)
+ * n_fields,  name_len, name,   type
+ * \endcode
+ * \li name is the name of the field as in the OSCAR2013 header, e.g. \c px.
+ * \li type is 'd' for doubles and 'i' for int32_t.
+ *
+ * The particle lines then consist of these fields in this order instead of
+ * the ones below.
+ *
  * **Output block header**\n
  * At start of event, end of event or any other particle output:
  * \code
@@ -134,50 +147,87 @@ static constexpr int HyperSurfaceCrossing = LogArea::HyperSurfaceCrossing::id;
 BinaryOutputBase::BinaryOutputBase(const bf::path &path,
                                    const std::string &mode,
                                    const std::string &name,
-                                   bool extended_format)
-    : OutputInterface(name), file_{path, mode}, extended_(extended_format) {
-  std::fwrite("SMSH", 4, 1, file_.get());  // magic number
-  write(format_version_);                  // file format version number
-  std::uint16_t format_variant = static_cast<uint16_t>(extended_);
+                                   bool extended_format,
+                                   const AsyncWriteParameters &async_write,
+                                   const OutputSelection &selection)
+    : OutputInterface(name),
+      file_{path, mode, async_write},
+      selection_(selection),
+      extended_(extended_format) {
+  buffer_.reserve(2 * block_buffer_size_);
+  append("SMSH", 4);       // magic number
+  write(format_version_);  // file format version number
+  std::uint16_t format_variant =
+      selection_.fields.empty() ? static_cast<uint16_t>(extended_) : 2;
   write(format_variant);
   write(VERSION_MAJOR);  // SMASH version
+  if (!selection_.fields.empty()) {
+    write(selection_.fields.size());
+    for (ParticleField field : selection_.fields) {
+      write(std::string(field_name(field)));
+      write(field_is_integer(field) ? 'i' : 'd');
+    }
+  }
+  write_buffer();
 }
 
-// write functions:
-void BinaryOutputBase::write(const char c) {
-  std::fwrite(&c, sizeof(char), 1, file_.get());
+BinaryOutputBase::~BinaryOutputBase() { write_buffer(); }
+
+void BinaryOutputBase::write_buffer() {
+  if (!buffer_.empty()) {
+    std::fwrite(buffer_.data(), 1, buffer_.size(), file_.get());
+    buffer_.clear();
+  }
 }
 
+void BinaryOutputBase::flush() {
+  write_buffer();
+  file_.flush();
+}
+
+// write functions:
+void BinaryOutputBase::write(const char c) { append(&c, sizeof(char)); }
+
 void BinaryOutputBase::write(const std::string &s) {
   const auto size = boost::numeric_cast<uint32_t>(s.size());
-  std::fwrite(&size, sizeof(std::uint32_t), 1, file_.get());
-  std::fwrite(s.c_str(), s.size(), 1, file_.get());
+  append(&size, sizeof(std::uint32_t));
+  append(s.c_str(), s.size());
 }
 
-void BinaryOutputBase::write(const double x) {
-  std::fwrite(&x, sizeof(x), 1, file_.get());
-}
+void BinaryOutputBase::write(const double x) { append(&x, sizeof(x)); }
 
 void BinaryOutputBase::write(const FourVector &v) {
-  std::fwrite(v.begin(), sizeof(*v.begin()), 4, file_.get());
+  append(v.begin(), 4 * sizeof(*v.begin()));
 }
 
 void BinaryOutputBase::write(const Particles &particles) {
+  const bool select = selection_.selects_particles();
   for (const auto &p : particles) {
-    write_particledata(p);
+    if (!select || selection_.accepts(p)) {
+      write_particledata(p);
+    }
   }
 }
 
-void BinaryOutputBase::write(const ParticleList &particles) {
+void BinaryOutputBase::write(ParticleSpan particles) {
   for (const auto &p : particles) {
     write_particledata(p);
   }
 }
 
 void BinaryOutputBase::write_particledata(const ParticleData &p) {
+  if (!selection_.fields.empty()) {
+    for (ParticleField field : selection_.fields) {
+      if (field_is_integer(field)) {
+        write(integer_field_value(p, field));
+      } else {
+        write(field_value(p, field));
+      }
+    }
+    return;
+  }
   write(p.position());
-  double mass = p.effective_mass();
-  std::fwrite(&mass, sizeof(mass), 1, file_.get());
+  write(p.effective_mass());
   write(p.momentum());
   write(p.pdgcode().get_decimal());
   write(p.id());
@@ -200,16 +250,18 @@ BinaryOutputCollisions::BinaryOutputCollisions(const bf::path &path,
                                                const OutputParameters &out_par)
     : BinaryOutputBase(
           path / ((name == "Collisions" ? "collisions_binary" : name) + ".bin"),
-          "wb", name, out_par.get_coll_extended(name)),
+          "wb", name, out_par.get_coll_extended(name), out_par.async_write,
+          out_par.get_selection(name)),
       print_start_end_(out_par.coll_printstartend) {}
 
 void BinaryOutputCollisions::at_eventstart(const Particles &particles,
                                            const int, const EventInfo &) {
   const char pchar = 'p';
   if (print_start_end_) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
-    write(particles.size());
+    write(pchar);
+    write(selection_.count(particles));
     write(particles);
+    finish_block();
   }
 }
 
@@ -218,54 +270,59 @@ void BinaryOutputCollisions::at_eventend(const Particles &particles,
                                          const EventInfo &event) {
   const char pchar = 'p';
   if (print_start_end_) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
-    write(particles.size());
+    write(pchar);
+    write(selection_.count(particles));
     write(particles);
   }
 
   // Event end line
   const char fchar = 'f';
-  std::fwrite(&fchar, sizeof(char), 1, file_.get());
+  write(fchar);
   write(event_number);
   write(event.impact_parameter);
   const char empty = event.empty_event;
   write(empty);
 
   // Flush to disk
-  std::fflush(file_.get());
+  flush();
 }
 
-void BinaryOutputCollisions::at_interaction(const Action &action,
-                                            const double density) {
-  const char ichar = 'i';
-  std::fwrite(&ichar, sizeof(char), 1, file_.get());
-  write(action.incoming_particles().size());
-  write(action.outgoing_particles().size());
-  std::fwrite(&density, sizeof(double), 1, file_.get());
-  const double weight = action.get_total_weight();
-  std::fwrite(&weight, sizeof(double), 1, file_.get());
-  const double partial_weight = action.get_partial_weight();
-  std::fwrite(&partial_weight, sizeof(double), 1, file_.get());
-  const auto type = static_cast<uint32_t>(action.get_type());
-  std::fwrite(&type, sizeof(uint32_t), 1, file_.get());
-  write(action.incoming_particles());
-  write(action.outgoing_particles());
+void BinaryOutputCollisions::at_interactions(
+    ConstSpan<InteractionRecord> records) {
+  for (const InteractionRecord &record : records) {
+    if (!selection_.accepts(record)) {
+      continue;
+    }
+    const char ichar = 'i';
+    write(ichar);
+    write(record.incoming.size());
+    write(record.outgoing.size());
+    write(record.density);
+    write(record.total_weight);
+    write(record.partial_weight);
+    write(static_cast<uint32_t>(record.type));
+    write(record.incoming);
+    write(record.outgoing);
+    finish_block();
+  }
 }
 
 BinaryOutputParticles::BinaryOutputParticles(const bf::path &path,
                                              std::string name,
                                              const OutputParameters &out_par)
     : BinaryOutputBase(path / "particles_binary.bin", "wb", name,
-                       out_par.part_extended),
+                       out_par.part_extended, out_par.async_write,
+                       out_par.part_selection),
       only_final_(out_par.part_only_final) {}
 
 void BinaryOutputParticles::at_eventstart(const Particles &particles, const int,
                                           const EventInfo &) {
   const char pchar = 'p';
   if (only_final_ == OutputOnlyFinal::No) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
-    write(particles.size());
+    write(pchar);
+    write(selection_.count(particles));
     write(particles);
+    finish_block();
   }
 }
 
@@ -274,21 +331,21 @@ void BinaryOutputParticles::at_eventend(const Particles &particles,
                                         const EventInfo &event) {
   const char pchar = 'p';
   if (!(event.empty_event && only_final_ == OutputOnlyFinal::IfNotEmpty)) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
-    write(particles.size());
+    write(pchar);
+    write(selection_.count(particles));
     write(particles);
   }
 
   // Event end line
   const char fchar = 'f';
-  std::fwrite(&fchar, sizeof(char), 1, file_.get());
+  write(fchar);
   write(event_number);
   write(event.impact_parameter);
   const char empty = event.empty_event;
   write(empty);
 
   // Flush to disk
-  std::fflush(file_.get());
+  flush();
 }
 
 void BinaryOutputParticles::at_intermediate_time(const Particles &particles,
@@ -297,16 +354,17 @@ void BinaryOutputParticles::at_intermediate_time(const Particles &particles,
                                                  const EventInfo &) {
   const char pchar = 'p';
   if (only_final_ == OutputOnlyFinal::No) {
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
-    write(particles.size());
+    write(pchar);
+    write(selection_.count(particles));
     write(particles);
+    finish_block();
   }
 }
 
 BinaryOutputInitialConditions::BinaryOutputInitialConditions(
     const bf::path &path, std::string name, const OutputParameters &out_par)
-    : BinaryOutputBase(path / "SMASH_IC.bin", "wb", name, out_par.ic_extended) {
-}
+    : BinaryOutputBase(path / "SMASH_IC.bin", "wb", name, out_par.ic_extended,
+                       out_par.async_write) {}
 
 void BinaryOutputInitialConditions::at_eventstart(const Particles &, const int,
                                                   const EventInfo &) {}
@@ -316,14 +374,14 @@ void BinaryOutputInitialConditions::at_eventend(const Particles &particles,
                                                 const EventInfo &event) {
   // Event end line
   const char fchar = 'f';
-  std::fwrite(&fchar, sizeof(char), 1, file_.get());
+  write(fchar);
   write(event_number);
   write(event.impact_parameter);
   const char empty = event.empty_event;
   write(empty);
 
   // Flush to disk
-  std::fflush(file_.get());
+  flush();
 
   // If the runtime is too short some particles might not yet have
   // reached the hypersurface. Warning is printed.
@@ -335,13 +393,16 @@ void BinaryOutputInitialConditions::at_eventend(const Particles &particles,
   }
 }
 
-void BinaryOutputInitialConditions::at_interaction(const Action &action,
-                                                   const double) {
-  if (action.get_type() == ProcessType::HyperSurfaceCrossing) {
-    const char pchar = 'p';
-    std::fwrite(&pchar, sizeof(char), 1, file_.get());
-    write(action.incoming_particles().size());
-    write(action.incoming_particles());
+void BinaryOutputInitialConditions::at_interactions(
+    ConstSpan<InteractionRecord> records) {
+  for (const InteractionRecord &record : records) {
+    if (record.type == ProcessType::HyperSurfaceCrossing) {
+      const char pchar = 'p';
+      write(pchar);
+      write(record.incoming.size());
+      write(record.incoming);
+      finish_block();
+    }
   }
 }
 }  // namespace smash
@@ -18,11 +18,11 @@
 #include "smash/constants.h"
 #include "smash/cxx14compat.h"
 #include "smash/experimentparameters.h"
+#include "smash/interactionrecord.h"
 #include "smash/logging.h"
 #include "smash/quantumsampling.h"
 #include "smash/random.h"
 #include "smash/threevector.h"
-#include "smash/wallcrossingaction.h"
 
 namespace smash {
 static constexpr int LBox = LogArea::Box::id;
@@ -365,6 +365,7 @@ double BoxModus::initial_conditions(Particles *particles,
 int BoxModus::impose_boundary_conditions(Particles *particles,
                                          const OutputsList &output_list) {
   int wraps = 0;
+  InteractionBatch wall_crossings;
 
   for (ParticleData &data : *particles) {
     FourVector position = data.position();
@@ -374,12 +375,14 @@ int BoxModus::impose_boundary_conditions(Particles *particles,
       const ParticleData incoming_particle(data);
       data.set_4position(position);
       ++wraps;
-      ActionPtr action =
-          make_unique<WallcrossingAction>(incoming_particle, data);
-      for (const auto &output : output_list) {
-        if (!output->is_dilepton_output() && !output->is_photon_output()) {
-          output->at_interaction(*action, 0.);
-        }
+      wall_crossings.add_wall_crossing(incoming_particle, data);
+    }
+  }
+  if (!wall_crossings.empty()) {
+    const ConstSpan<InteractionRecord> records = wall_crossings.records();
+    for (const auto &output : output_list) {
+      if (!output->is_dilepton_output() && !output->is_photon_output()) {
+        output->at_interactions(records);
       }
     }
   }
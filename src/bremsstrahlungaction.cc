@@ -8,6 +8,10 @@
  */
 
 #include "smash/bremsstrahlungaction.h"
+
+#include <algorithm>
+#include <cmath>
+
 #include "smash/crosssectionsbrems.h"
 #include "smash/outputinterface.h"
 #include "smash/random.h"
@@ -187,7 +191,7 @@ CollisionBranchList BremsstrahlungAction::brems_cross_sections() {
   // Create interpolation objects, if not yet existent; only trigger for one
   // of them as either all or none is created
   if (pi0pi0_pipi_dsigma_dtheta_interpolation == nullptr) {
-    create_interpolations();
+    create_interpolations(0.);
   }
 
   // Find cross section corresponding to given sqrt(s)
@@ -316,7 +320,98 @@ std::pair<double, double> BremsstrahlungAction::brems_diff_cross_sections() {
   return diff_x_sections;
 }
 
-void BremsstrahlungAction::create_interpolations() {
+/**
+ * Smallest spacing of the tabulated center-of-mass energies [GeV]. All
+ * tabulated energies are multiples of it.
+ */
+static constexpr double brems_sqrts_spacing = 0.01;
+
+/**
+ * Largest factor, by which the uniform grids are refined with respect to the
+ * tabulated energies. The photon momenta and angles are refined by twice the
+ * factor.
+ */
+static constexpr size_t brems_max_refinement = 4;
+
+/**
+ * Largest deviation of a uniform grid from the spline it was sampled from in
+ * the middle of its cells, relative to the largest tabulated value at the
+ * same energy.
+ *
+ * \param[in] uniform Resampled interpolation.
+ * \param[in] spline Interpolation of the table.
+ * \param[in] x Tabulated photon momenta or angles.
+ * \param[in] n_x Number of photon momenta or angles of the uniform grid.
+ * \param[in] sqrts_min Smallest energy [GeV].
+ * \param[in] sqrts_max Largest energy [GeV].
+ * \param[in] n_sqrts Number of energies of the uniform grid.
+ * \param[in] logarithmic_x Whether the grid is uniform in the logarithm of x.
+ * \return Relative deviation.
+ */
+static double brems_grid_deviation(const InterpolateData2D &uniform,
+                                   const InterpolateData2D &spline,
+                                   const std::vector<double> &x, size_t n_x,
+                                   double sqrts_min, double sqrts_max,
+                                   size_t n_sqrts, bool logarithmic_x) {
+  const double u_min = logarithmic_x ? std::log(x.front()) : x.front();
+  const double u_max = logarithmic_x ? std::log(x.back()) : x.back();
+  const double du = (u_max - u_min) / (n_x - 1);
+  const double ds = (sqrts_max - sqrts_min) / (n_sqrts - 1);
+  double deviation = 0.;
+  for (size_t j = 0; j + 1 < n_sqrts; j++) {
+    const double s = sqrts_min + (j + 0.5) * ds;
+    double scale = 0.;
+    for (double xi : x) {
+      scale = std::max(scale, std::abs(spline(xi, s)));
+    }
+    if (scale == 0.) {
+      continue;
+    }
+    for (size_t i = 0; i + 1 < n_x; i++) {
+      const double u = u_min + (i + 0.5) * du;
+      const double xi = logarithmic_x ? std::exp(u) : u;
+      const double difference = std::abs(uniform(xi, s) - spline(xi, s));
+      deviation = std::max(deviation, difference / scale);
+    }
+  }
+  return deviation;
+}
+
+std::unique_ptr<InterpolateData2D> make_brems_interpolation(
+    const std::vector<double> &x, const std::vector<double> &sqrts,
+    const std::vector<double> &dsigma, bool logarithmic_x, double accuracy) {
+  auto spline = make_unique<InterpolateData2DSpline>(x, sqrts, dsigma);
+  if (!(accuracy > 0.)) {
+    return std::move(spline);
+  }
+  const InterpolateData2DSpline &f = *spline;
+  const size_t n_tabulated_sqrts = static_cast<size_t>(
+      std::round((sqrts.back() - sqrts.front()) / brems_sqrts_spacing) + 1);
+  std::unique_ptr<InterpolateData2DUniform> uniform;
+  double deviation = 0.;
+  for (size_t refinement = 1; refinement <= brems_max_refinement;
+       refinement *= 2) {
+    const size_t n_x = 2 * refinement * (x.size() - 1) + 1;
+    const size_t n_sqrts = refinement * (n_tabulated_sqrts - 1) + 1;
+    uniform = make_unique<InterpolateData2DUniform>(
+        [&f](double xi, double yi) { return f(xi, yi); }, x.front(), x.back(),
+        n_x, sqrts.front(), sqrts.back(), n_sqrts, logarithmic_x);
+    deviation = brems_grid_deviation(*uniform, f, x, n_x, sqrts.front(),
+                                     sqrts.back(), n_sqrts, logarithmic_x);
+    if (deviation <= accuracy) {
+      logg[LScatterAction].debug("Bremsstrahlung cross section grid with ",
+                                 n_x, " x ", n_sqrts, " values deviates by ",
+                                 deviation, " from the spline");
+      return std::move(uniform);
+    }
+  }
+  logg[LScatterAction].warn(
+      "Bremsstrahlung cross section grid deviates by ", deviation,
+      " from the spline, more than the requested accuracy ", accuracy);
+  return std::move(uniform);
+}
+
+void BremsstrahlungAction::create_interpolations(double accuracy) {
   // Read in tabularized values for sqrt(s), k and theta
   std::vector<double> sqrts = BREMS_SQRTS;
   std::vector<double> photon_momentum = BREMS_K;
@@ -363,34 +458,30 @@ void BremsstrahlungAction::create_interpolations() {
       make_unique<InterpolateDataLinear<double>>(sqrts, sigma_pi0pi0_pipi);
 
   // Create interpolation objects containing bicubic interpolations for
-  // differential dSigma/dk
-  pipi_pipi_opp_dsigma_dk_interpolation = make_unique<InterpolateData2DSpline>(
-      photon_momentum, sqrts, dsigma_dk_pipi_pipi_opp);
-  pipi_pipi_same_dsigma_dk_interpolation = make_unique<InterpolateData2DSpline>(
-      photon_momentum, sqrts, dsigma_dk_pipi_pipi_same);
-  pipi0_pipi0_dsigma_dk_interpolation = make_unique<InterpolateData2DSpline>(
-      photon_momentum, sqrts, dsigma_dk_pipi0_pipi0);
-  pipi_pi0pi0_dsigma_dk_interpolation = make_unique<InterpolateData2DSpline>(
-      photon_momentum, sqrts, dsigma_dk_pipi_pi0pi0);
-  pi0pi0_pipi_dsigma_dk_interpolation = make_unique<InterpolateData2DSpline>(
-      photon_momentum, sqrts, dsigma_dk_pi0pi0_pipi);
+  // differential dSigma/dk, or their resampling on grids uniform in the
+  // logarithm of k
+  pipi_pipi_opp_dsigma_dk_interpolation = make_brems_interpolation(
+      photon_momentum, sqrts, dsigma_dk_pipi_pipi_opp, true, accuracy);
+  pipi_pipi_same_dsigma_dk_interpolation = make_brems_interpolation(
+      photon_momentum, sqrts, dsigma_dk_pipi_pipi_same, true, accuracy);
+  pipi0_pipi0_dsigma_dk_interpolation = make_brems_interpolation(
+      photon_momentum, sqrts, dsigma_dk_pipi0_pipi0, true, accuracy);
+  pipi_pi0pi0_dsigma_dk_interpolation = make_brems_interpolation(
+      photon_momentum, sqrts, dsigma_dk_pipi_pi0pi0, true, accuracy);
+  pi0pi0_pipi_dsigma_dk_interpolation = make_brems_interpolation(
+      photon_momentum, sqrts, dsigma_dk_pi0pi0_pipi, true, accuracy);
 
   // Create interpolation objects containing bicubic interpolations for
-  // differential dSigma/dtheta
-  pipi_pipi_opp_dsigma_dtheta_interpolation =
-      make_unique<InterpolateData2DSpline>(photon_angle, sqrts,
-                                           dsigma_dtheta_pipi_pipi_opp);
-  pipi_pipi_same_dsigma_dtheta_interpolation =
-      make_unique<InterpolateData2DSpline>(photon_angle, sqrts,
-                                           dsigma_dtheta_pipi_pipi_same);
-  pipi0_pipi0_dsigma_dtheta_interpolation =
-      make_unique<InterpolateData2DSpline>(photon_angle, sqrts,
-                                           dsigma_dtheta_pipi0_pipi0);
-  pipi_pi0pi0_dsigma_dtheta_interpolation =
-      make_unique<InterpolateData2DSpline>(photon_angle, sqrts,
-                                           dsigma_dtheta_pipi_pi0pi0);
-  pi0pi0_pipi_dsigma_dtheta_interpolation =
-      make_unique<InterpolateData2DSpline>(photon_angle, sqrts,
-                                           dsigma_dtheta_pi0pi0_pipi);
+  // differential dSigma/dtheta, or their resampling on uniform grids
+  pipi_pipi_opp_dsigma_dtheta_interpolation = make_brems_interpolation(
+      photon_angle, sqrts, dsigma_dtheta_pipi_pipi_opp, false, accuracy);
+  pipi_pipi_same_dsigma_dtheta_interpolation = make_brems_interpolation(
+      photon_angle, sqrts, dsigma_dtheta_pipi_pipi_same, false, accuracy);
+  pipi0_pipi0_dsigma_dtheta_interpolation = make_brems_interpolation(
+      photon_angle, sqrts, dsigma_dtheta_pipi0_pipi0, false, accuracy);
+  pipi_pi0pi0_dsigma_dtheta_interpolation = make_brems_interpolation(
+      photon_angle, sqrts, dsigma_dtheta_pipi_pi0pi0, false, accuracy);
+  pi0pi0_pipi_dsigma_dtheta_interpolation = make_brems_interpolation(
+      photon_angle, sqrts, dsigma_dtheta_pi0pi0_pipi, false, accuracy);
 }
 }  // namespace smash
@@ -0,0 +1,390 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/columnaroutput.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <boost/numeric/conversion/cast.hpp>
+
+#include "smash/config.h"
+#include "smash/particles.h"
+
+namespace smash {
+
+/*!\Userguide
+ * \page format_columnar_ Columnar Format
+ * The columnar format is a binary format for the \b Particles content, meant
+ * for analyses which read large amounts of output. In contrast to the
+ * \ref format_binary_ "binary format", which stores one particle after the
+ * other, every particle list is stored as a chunk in which the values of
+ * each particle property (a column) are contiguous. An index at the end of
+ * the file gives the position of every chunk. Therefore single events or
+ * single columns (e.g. only the momenta for spectra) can be read without
+ * reading the whole file. The C++ class \c smash::ColumnarReader implements
+ * this.
+ *
+ * The output is written to the \c particles_columnar.bin file, at the same
+ * moments as the binary particles output (see the \key Only_Final and
+ * \key Extended options in
+ * \ref output_content_specific_options_ "content-specific output options").
+ * The types used are 1 byte chars, 4 bytes signed and unsigned integers,
+ * 8 bytes unsigned integers and 8 bytes doubles.
+ *
+ * **Header**
+ * \code
+ * 4*char        uint16_t        uint16_t        uint32_t  len*char
+ * magic_number, format_version, format_variant, len,      smash_version
+ * uint32_t   n_columns * (uint32_t len*char char)
+ * n_columns, name_len, name,   type
+ * \endcode
+ * \li magic_number - 4 bytes that in ASCII read as "SMSC".
+ * \li Format version is an integer number, currently it is 1.
+ * \li Format variant is an integer number: 0 for default, 1 for extended,
+ * 2 for columns selected with the \key Columns option.
+ * \li type is 'd' for columns of doubles and 'i' for columns of int32_t.
+ *
+ * The default columns are
+ * t x y z mass p0 px py pz pdg ID charge,
+ * the extended format adds
+ * ncoll form_time xsecfac proc_id_origin proc_type_origin time_last_coll
+ * pdg_mother1 pdg_mother2,
+ * see \ref format_binary_ for their meaning. Only the particles accepted by
+ * the \key Filter of the \b Particles content are written.
+ *
+ * **Chunk**
+ * \code
+ * char uint32_t
+ * 'c'  n_particles
+ * \endcode
+ * followed by the columns in the order of the header, each consisting of
+ * \c n_particles values.
+ *
+ * **Index**
+ * \code
+ * uint32_t
+ * n_chunks
+ * n_chunks * (uint64_t int32_t      uint32_t    double double           char)
+ *             offset   event_number n_particles time   impact_parameter empty
+ * uint64_t     4*char
+ * index_offset magic_number
+ * \endcode
+ * \li offset is the position of the chunk in the file.
+ * \li index_offset is the position of the index in the file. Together with
+ * the magic number it forms the last 12 bytes of the file.
+ * The index is only written when the run ends normally. Files of aborted runs
+ * have no index and keep their ".unfinished" name.
+ */
+
+namespace {
+/// Magic number of columnar output files
+constexpr char columnar_magic[4] = {'S', 'M', 'S', 'C'};
+
+/**
+ * Append the values of one particle property of all particles to a buffer.
+ *
+ * \tparam T Type of the values in the file.
+ * \tparam F Type of the function returning the property.
+ * \param[out] buffer Buffer the values are appended to.
+ * \param[in] particles Particles to be written.
+ * \param[in] value Function returning the property of a particle.
+ */
+template <typename T, typename F>
+void append_column(std::vector<char> *buffer,
+                   const std::vector<const ParticleData *> &particles,
+                   F &&value) {
+  const size_t old_size = buffer->size();
+  buffer->resize(old_size + particles.size() * sizeof(T));
+  char *out = buffer->data() + old_size;
+  for (const ParticleData *p : particles) {
+    const T x = value(*p);
+    std::memcpy(out, &x, sizeof(T));
+    out += sizeof(T);
+  }
+}
+
+/**
+ * \param[in] fields Particle fields.
+ * \return Names and types of the columns of the fields.
+ */
+std::vector<ColumnDescription> describe_columns(
+    const std::vector<ParticleField> &fields) {
+  std::vector<ColumnDescription> columns;
+  for (ParticleField field : fields) {
+    columns.emplace_back(field_name(field), field_is_integer(field)
+                                                ? ColumnType::Int32
+                                                : ColumnType::Double);
+  }
+  return columns;
+}
+
+/**
+ * \param[in] type Type of a column.
+ * \return Size of one value of the column in bytes.
+ */
+size_t value_size(ColumnType type) {
+  return type == ColumnType::Double ? sizeof(double) : sizeof(std::int32_t);
+}
+}  // unnamed namespace
+
+constexpr std::uint16_t ColumnarOutput::format_version;
+
+std::vector<ColumnDescription> ColumnarOutput::columns(bool extended) {
+  return describe_columns(default_fields(extended));
+}
+
+ColumnarOutput::ColumnarOutput(const bf::path &path, const std::string &name,
+                               const OutputParameters &out_par)
+    : OutputInterface(name),
+      file_{path / "particles_columnar.bin", "wb", out_par.async_write},
+      extended_(out_par.part_extended),
+      only_final_(out_par.part_only_final),
+      selection_(out_par.part_selection),
+      fields_(selection_.fields.empty() ? default_fields(extended_)
+                                        : selection_.fields) {
+  append(columnar_magic, 4);
+  append(&format_version, sizeof(format_version));
+  const std::uint16_t format_variant =
+      selection_.fields.empty() ? static_cast<uint16_t>(extended_) : 2;
+  append(&format_variant, sizeof(format_variant));
+  const std::string version = VERSION_MAJOR;
+  const auto version_size = boost::numeric_cast<uint32_t>(version.size());
+  append(&version_size, sizeof(version_size));
+  append(version.data(), version.size());
+  const auto columns_in_file = describe_columns(fields_);
+  const auto n_columns = boost::numeric_cast<uint32_t>(columns_in_file.size());
+  append(&n_columns, sizeof(n_columns));
+  for (const auto &column : columns_in_file) {
+    const auto name_size = boost::numeric_cast<uint32_t>(column.first.size());
+    append(&name_size, sizeof(name_size));
+    append(column.first.data(), column.first.size());
+    append(&column.second, sizeof(char));
+  }
+  write_buffer();
+}
+
+ColumnarOutput::~ColumnarOutput() {
+  if (!finished_) {
+    file_.keep_unfinished();
+  }
+}
+
+void ColumnarOutput::at_runend() {
+  if (finished_) {
+    return;
+  }
+  const std::uint64_t index_offset = position_;
+  const auto n_chunks = boost::numeric_cast<uint32_t>(index_.size());
+  append(&n_chunks, sizeof(n_chunks));
+  for (const ColumnarChunkInfo &info : index_) {
+    append(&info.offset, sizeof(info.offset));
+    append(&info.event_number, sizeof(info.event_number));
+    append(&info.n_particles, sizeof(info.n_particles));
+    append(&info.time, sizeof(info.time));
+    append(&info.impact_parameter, sizeof(info.impact_parameter));
+    const char empty = info.empty_event;
+    append(&empty, sizeof(empty));
+  }
+  append(&index_offset, sizeof(index_offset));
+  append(columnar_magic, 4);
+  write_buffer();
+  finished_ = true;
+}
+
+void ColumnarOutput::append(const void *data, size_t size) {
+  const char *bytes = static_cast<const char *>(data);
+  buffer_.insert(buffer_.end(), bytes, bytes + size);
+}
+
+void ColumnarOutput::write_buffer() {
+  std::fwrite(buffer_.data(), 1, buffer_.size(), file_.get());
+  position_ += buffer_.size();
+  buffer_.clear();
+}
+
+void ColumnarOutput::write_chunk(const Particles &particles,
+                                 const int event_number,
+                                 const EventInfo &event) {
+  selected_.clear();
+  for (const ParticleData &p : particles) {
+    if (selection_.accepts(p)) {
+      selected_.push_back(&p);
+    }
+  }
+  ColumnarChunkInfo info;
+  info.offset = position_;
+  info.event_number = event_number;
+  info.n_particles = boost::numeric_cast<uint32_t>(selected_.size());
+  info.time = event.current_time;
+  info.impact_parameter = event.impact_parameter;
+  info.empty_event = event.empty_event;
+  index_.push_back(info);
+
+  const char cchar = 'c';
+  append(&cchar, sizeof(cchar));
+  append(&info.n_particles, sizeof(info.n_particles));
+  for (ParticleField field : fields_) {
+    if (field_is_integer(field)) {
+      append_column<std::int32_t>(&buffer_, selected_,
+                                  [field](const ParticleData &p) {
+                                    return integer_field_value(p, field);
+                                  });
+    } else {
+      append_column<double>(&buffer_, selected_,
+                            [field](const ParticleData &p) {
+                              return field_value(p, field);
+                            });
+    }
+  }
+  write_buffer();
+}
+
+void ColumnarOutput::at_eventstart(const Particles &particles,
+                                   const int event_number,
+                                   const EventInfo &event) {
+  current_event_ = event_number;
+  if (only_final_ == OutputOnlyFinal::No) {
+    write_chunk(particles, event_number, event);
+  }
+}
+
+void ColumnarOutput::at_eventend(const Particles &particles,
+                                 const int event_number,
+                                 const EventInfo &event) {
+  if (!(event.empty_event && only_final_ == OutputOnlyFinal::IfNotEmpty)) {
+    write_chunk(particles, event_number, event);
+  }
+  file_.flush();
+}
+
+void ColumnarOutput::at_intermediate_time(const Particles &particles,
+                                          const std::unique_ptr<Clock> &,
+                                          const DensityParameters &,
+                                          const EventInfo &event) {
+  if (only_final_ == OutputOnlyFinal::No) {
+    write_chunk(particles, current_event_, event);
+  }
+}
+
+ColumnarReader::ColumnarReader(const bf::path &path)
+    : file_(fopen(path, "rb")) {
+  if (!file_) {
+    throw std::runtime_error("Could not open " + path.string());
+  }
+  char magic[4];
+  read(magic, 4);
+  if (std::memcmp(magic, columnar_magic, 4) != 0) {
+    throw std::runtime_error(path.string() + " is not a columnar output file");
+  }
+  std::uint16_t version, variant;
+  read(&version, sizeof(version));
+  read(&variant, sizeof(variant));
+  if (version != ColumnarOutput::format_version) {
+    throw std::runtime_error("Unsupported columnar format version " +
+                             std::to_string(version));
+  }
+  extended_ = (variant == 1);
+  std::uint32_t size;
+  read(&size, sizeof(size));
+  std::string smash_version(size, ' ');
+  read(&smash_version[0], size);
+  std::uint32_t n_columns;
+  read(&n_columns, sizeof(n_columns));
+  for (std::uint32_t i = 0; i < n_columns; i++) {
+    read(&size, sizeof(size));
+    std::string name(size, ' ');
+    read(&name[0], size);
+    char type;
+    read(&type, sizeof(type));
+    columns_.emplace_back(name, static_cast<ColumnType>(type));
+  }
+
+  // the index position is stored in the last 12 bytes
+  std::uint64_t index_offset;
+  if (std::fseek(file_.get(), -12, SEEK_END) != 0) {
+    throw std::runtime_error(path.string() + " has no index");
+  }
+  read(&index_offset, sizeof(index_offset));
+  read(magic, 4);
+  if (std::memcmp(magic, columnar_magic, 4) != 0 ||
+      std::fseek(file_.get(), index_offset, SEEK_SET) != 0) {
+    throw std::runtime_error(path.string() + " has no index");
+  }
+  std::uint32_t n_chunks;
+  read(&n_chunks, sizeof(n_chunks));
+  chunks_.resize(n_chunks);
+  for (ColumnarChunkInfo &info : chunks_) {
+    read(&info.offset, sizeof(info.offset));
+    read(&info.event_number, sizeof(info.event_number));
+    read(&info.n_particles, sizeof(info.n_particles));
+    read(&info.time, sizeof(info.time));
+    read(&info.impact_parameter, sizeof(info.impact_parameter));
+    char empty;
+    read(&empty, sizeof(empty));
+    info.empty_event = (empty != 0);
+  }
+}
+
+std::vector<size_t> ColumnarReader::chunks_of_event(int event_number) const {
+  std::vector<size_t> result;
+  for (size_t i = 0; i < chunks_.size(); i++) {
+    if (chunks_[i].event_number == event_number) {
+      result.push_back(i);
+    }
+  }
+  return result;
+}
+
+std::vector<double> ColumnarReader::read_doubles(size_t chunk,
+                                                 const std::string &column) {
+  seek_column(chunk, column, ColumnType::Double);
+  std::vector<double> values(chunks_[chunk].n_particles);
+  read(values.data(), values.size() * sizeof(double));
+  return values;
+}
+
+std::vector<std::int32_t> ColumnarReader::read_ints(size_t chunk,
+                                                    const std::string &column) {
+  seek_column(chunk, column, ColumnType::Int32);
+  std::vector<std::int32_t> values(chunks_[chunk].n_particles);
+  read(values.data(), values.size() * sizeof(std::int32_t));
+  return values;
+}
+
+void ColumnarReader::seek_column(size_t chunk, const std::string &column,
+                                 ColumnType type) {
+  if (chunk >= chunks_.size()) {
+    throw std::invalid_argument("Columnar output has no chunk " +
+                                std::to_string(chunk));
+  }
+  const ColumnarChunkInfo &info = chunks_[chunk];
+  // skip the chunk header and all previous columns
+  std::uint64_t offset = info.offset + sizeof(char) + sizeof(std::uint32_t);
+  for (const ColumnDescription &c : columns_) {
+    if (c.first == column) {
+      if (c.second != type) {
+        throw std::invalid_argument("Column " + column +
+                                    " has a different type");
+      }
+      std::fseek(file_.get(), offset, SEEK_SET);
+      return;
+    }
+    offset += value_size(c.second) * info.n_particles;
+  }
+  throw std::invalid_argument("Columnar output has no column " + column);
+}
+
+void ColumnarReader::read(void *data, size_t size) {
+  if (size > 0 && std::fread(data, 1, size, file_.get()) != size) {
+    throw std::runtime_error("Unexpected end of columnar output file");
+  }
+}
+
+}  // namespace smash
@@ -8,6 +8,9 @@
  */
 
 #include "smash/density.h"
+
+#include <algorithm>
+
 #include "smash/constants.h"
 #include "smash/logging.h"
 
@@ -179,6 +182,123 @@ current_eckart(const ThreeVector &r, const Particles &plist,
                              smearing);
 }
 
+DensityCellList::DensityCellList(const std::vector<Particles> &ensembles,
+                                 const DensityParameters &par,
+                                 DensityType dens_type) {
+  std::vector<const ParticleData *> selected;
+  for (const Particles &particles : ensembles) {
+    for (const ParticleData &p : particles) {
+      if (std::fabs(density_factor(p.type(), dens_type)) >= really_small) {
+        /* The isospin of a type is computed on first use, which is done
+         * here, such that the densities can be evaluated concurrently from
+         * the cell list. */
+        p.type().isospin();
+        selected.push_back(&p);
+      }
+    }
+  }
+  if (selected.empty()) {
+    cell_begin_.assign(2, 0);
+    return;
+  }
+
+  std::array<double, 3> max_position;
+  for (int i = 0; i < 3; i++) {
+    origin_[i] = selected.front()->position()[i + 1];
+    max_position[i] = origin_[i];
+  }
+  for (const ParticleData *p : selected) {
+    const FourVector &pos = p->position();
+    for (int i = 0; i < 3; i++) {
+      origin_[i] = std::min(origin_[i], pos[i + 1]);
+      max_position[i] = std::max(max_position[i], pos[i + 1]);
+    }
+  }
+
+  /* Cells must not be smaller than r_cut. Like for the collision Grid, the
+   * number of cells is limited such that there are not more cells than
+   * particles, which also bounds the memory for very dilute systems. */
+  const int max_cells =
+      std::max(1, static_cast<int>(std::cbrt(selected.size())));
+  for (int i = 0; i < 3; i++) {
+    const double length = max_position[i] - origin_[i];
+    n_cells_[i] = std::min(
+        max_cells, std::max(1, static_cast<int>(length / par.r_cut())));
+    cell_length_[i] = std::max(par.r_cut(), length / n_cells_[i]);
+  }
+
+  // counting sort of the particles by their cell index
+  const auto cell_index = [this](const ThreeVector &r) {
+    std::array<int, 3> idx;
+    for (int i = 0; i < 3; i++) {
+      idx[i] = std::min(
+          n_cells_[i] - 1,
+          static_cast<int>((r[i] - origin_[i]) / cell_length_[i]));
+    }
+    return idx[0] + n_cells_[0] * (idx[1] + n_cells_[1] * idx[2]);
+  };
+  std::vector<int> index_of_particle;
+  index_of_particle.reserve(selected.size());
+  cell_begin_.assign(n_cells_[0] * n_cells_[1] * n_cells_[2] + 1, 0);
+  for (const ParticleData *p : selected) {
+    const int index = cell_index(p->position().threevec());
+    index_of_particle.push_back(index);
+    cell_begin_[index + 1]++;
+  }
+  for (std::size_t c = 1; c < cell_begin_.size(); c++) {
+    cell_begin_[c] += cell_begin_[c - 1];
+  }
+  std::vector<std::size_t> fill(cell_begin_.begin(), cell_begin_.end() - 1);
+  std::vector<const ParticleData *> sorted(selected.size());
+  for (std::size_t k = 0; k < selected.size(); k++) {
+    sorted[fill[index_of_particle[k]]++] = selected[k];
+  }
+  particles_.reserve(sorted.size());
+  for (const ParticleData *p : sorted) {
+    particles_.push_back(*p);
+  }
+  logg[LDensity].debug("Density cell list with ", particles_.size(),
+                       " particles in ", n_cells_[0], "x", n_cells_[1], "x",
+                       n_cells_[2], " cells");
+}
+
+DensityCellList::NeighborRange DensityCellList::neighbors(
+    const ThreeVector &r) const {
+  NeighborRange range;
+  if (particles_.empty()) {
+    return range;
+  }
+  std::array<int, 3> lower, upper;
+  for (int i = 0; i < 3; i++) {
+    const double x = std::floor((r[i] - origin_[i]) / cell_length_[i]);
+    // no cell within r_cut
+    if (x < -1. || x > n_cells_[i]) {
+      return range;
+    }
+    lower[i] = std::max(0, static_cast<int>(x) - 1);
+    upper[i] = std::min(n_cells_[i] - 1, static_cast<int>(x) + 1);
+  }
+  const ParticleData *data = particles_.data();
+  for (int iz = lower[2]; iz <= upper[2]; iz++) {
+    for (int iy = lower[1]; iy <= upper[1]; iy++) {
+      const int row = n_cells_[0] * (iy + n_cells_[1] * iz);
+      range.add_span(data + cell_begin_[row + lower[0]],
+                     data + cell_begin_[row + upper[0] + 1]);
+    }
+  }
+  return range;
+}
+
+std::tuple<double, FourVector, ThreeVector, ThreeVector, FourVector, FourVector,
+           FourVector, FourVector>
+current_eckart(const ThreeVector &r,
+               const DensityCellList::NeighborRange &plist,
+               const DensityParameters &par, DensityType dens_type,
+               bool compute_gradient, bool smearing) {
+  return current_eckart_impl(r, plist, par, dens_type, compute_gradient,
+                             smearing);
+}
+
 void update_lattice(
     RectangularLattice<DensityOnLattice> *lat,
     RectangularLattice<FourVector> *old_jmu,
@@ -194,6 +314,8 @@ void update_lattice(
   const std::array<int, 3> lattice_n_cells = lat->n_cells();
   const int number_of_nodes =
       lattice_n_cells[0] * lattice_n_cells[1] * lattice_n_cells[2];
+  // read access, which does not mark the tiles of the lattice as occupied
+  const RectangularLattice<DensityOnLattice> &const_lat = *lat;
 
   /*
    * Take the provided DensityOnLattice lattice and use the information about
@@ -205,7 +327,7 @@ void update_lattice(
   // proceed only if finite difference gradients are calculated
   if (par.derivatives() == DerivativesMode::FiniteDifference) {
     for (int i = 0; i < number_of_nodes; i++) {
-      old_jmu->assign_value(i, ((*lat)[i]).jmu_net());
+      old_jmu->assign_value(i, const_lat[i].jmu_net());
     }
   }
 
@@ -215,25 +337,32 @@ void update_lattice(
   if (par.derivatives() == DerivativesMode::FiniteDifference) {
     // copy values of jmu FourVectors at t_0 + time_step onto new_jmu
     for (int i = 0; i < number_of_nodes; i++) {
-      new_jmu->assign_value(i, ((*lat)[i]).jmu_net());
+      new_jmu->assign_value(i, const_lat[i].jmu_net());
     }
 
     // compute time derivatives and gradients of all components of jmu
     new_jmu->compute_four_gradient_lattice(*old_jmu, time_step,
                                            *four_grad_lattice);
 
-    // substitute new derivatives
-    int node_number = 0;
-    for (auto &node : *lat) {
-      auto tmp = (*four_grad_lattice)[node_number];
-      node.overwrite_djmu_dxnu(tmp[0], tmp[1], tmp[2], tmp[3]);
-      node_number++;
+    /* substitute new derivatives. The finite differences reach into empty
+     * cells next to occupied ones, so only the nodes whose derivatives change
+     * are written, which marks their tiles and leaves the others empty. */
+    const RectangularLattice<std::array<FourVector, 4>> &four_grad =
+        *four_grad_lattice;
+    for (int i = 0; i < number_of_nodes; i++) {
+      const std::array<FourVector, 4> &tmp = four_grad[i];
+      if (tmp != const_lat[i].djmu_dxnu()) {
+        DensityOnLattice node = const_lat[i];
+        node.overwrite_djmu_dxnu(tmp[0], tmp[1], tmp[2], tmp[3]);
+        lat->assign_value(i, node);
+      }
     }
   }  // if (par.derivatives() == DerivativesMode::FiniteDifference)
 
-  // calculate gradients of rest frame density
+  /* calculate gradients of rest frame density, which vanish in empty cells
+   * and therefore only need to be computed in occupied tiles */
   if (par.rho_derivatives() == RestFrameDensityDerivativesMode::On) {
-    for (auto &node : *lat) {
+    lat->iterate_occupied([](DensityOnLattice &node, int) {
       // the rest frame density
       double rho = node.rho();
       const int sgn = rho > 0 ? 1 : -1;
@@ -269,7 +398,7 @@ void update_lattice(
       const FourVector drho_dxnu = {drho_dt, drho_dx, drho_dy, drho_dz};
 
       node.overwrite_drho_dxnu(drho_dxnu);
-    }
+    });
   }  // if (par.rho_derivatives() == RestFrameDensityDerivatives::On){
 }  // void update_lattice()
 
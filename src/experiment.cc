@@ -102,6 +102,13 @@ ExperimentPtr ExperimentBase::create(Configuration config,
  * ensemble* method (see below). Because of this, the parallel ensembles
  * technique is computationally faster than the full ensemble technique.
  *
+ * \key Threads (int, optional, default = 1): \n
+ * Number of threads sharing the parallel parts of SMASH, i.e. the
+ * tabulations at startup and the update of the momenta with potentials. The
+ * threads are started once. 0 means one thread per hardware thread. When
+ * several SMASH jobs run on the same node, their numbers of threads should
+ * add up to at most the number of cores.
+ *
  * \key Testparticles (int, optional, default = 1): \n
  * Number of test-particles per real particle in the simulation.
  *
@@ -237,6 +244,32 @@ ExperimentPtr ExperimentBase::create(Configuration config,
  * \li \key "pion" - Pion density
  * \li \key "none" - Do not calculate density, print 0.0
  *
+ * \key Asynchronous (section, optional): \n
+ * If present, the ASCII and binary output files are written by separate
+ * writer threads. The simulation hands the output over in large buffers and
+ * does not wait for the file system, except if too many buffers are pending.
+ * The OSCAR outputs only hand over copies of the particles and interactions,
+ * which are formatted by the writer threads; the other outputs are still
+ * formatted by the simulation. At the end of every event, the output is
+ * handed over to the writer threads. A file is only renamed from its
+ * ".unfinished" name once all of its data is written, also if the simulation
+ * is aborted by an exception. If writing fails, the file keeps its
+ * ".unfinished" name. The files are written uncompressed. ROOT, HepMC, VTK
+ * and the thermodynamic lattice output are always written by the simulation.
+ * \li \key Enable (bool, optional, default = true): \n
+ * Switch the asynchronous writing on or off.
+ * \li \key Buffer_Size (double, optional, default = 4.0): \n
+ * Size of one buffer in MiB.
+ * \li \key Max_Pending_Buffers (int, optional, default = 4): \n
+ * Number of filled buffers per file that may wait for being written, before
+ * the simulation waits for the writer thread.
+ *\verbatim
+ Output:
+     Asynchronous:
+         Buffer_Size: 4.0
+         Max_Pending_Buffers: 4
+ \endverbatim
+ *
  * \n
  * ### Format configuration independently of the specific output content
  * Further options are defined for every single output content
@@ -270,6 +303,11 @@ ExperimentPtr ExperimentBase::create(Configuration config,
  *                         is not empty (i.e. any collisions happened between
  *                         projectile and target). Useful to save disk space. \n
  *   \li \key No - Particle list at output interval including initial time \n
+ *
+ *   \key Single_Precision (bool, optional, default = false, only for
+ *                          VTK_Binary format): \n
+ *   Write positions, momenta and the other floating point values as 4 byte
+ *   floats instead of 8 byte doubles, see \ref format_vtk.
  * \n
  * - \b Collisions (VTK not available) \n
  *   \key Extended (bool, optional, default = false, incompatible with
@@ -294,6 +332,49 @@ ExperimentPtr ExperimentBase::create(Configuration config,
  *   \li \key true - Print extended information for each particle \n
  *   \li \key false - Regular output for each particle \n
  * \n
+ * \anchor output_filter_
+ * - \b Particles, \b Collisions, \b Dileptons and \b Photons
+ *   (Oscar1999, Oscar2013, binary and, for particles, columnar formats) \n
+ *   \key Filter (map, optional): \n
+ *   Only the particles and interactions fulfilling all given criteria are
+ *   written, which is decided before they are formatted. Particle lists only
+ *   contain the accepted particles. An interaction is written with all its
+ *   particles if its process type and time are accepted and at least one of
+ *   its particles fulfills the criteria on particles.
+ *   \li \key PDG (list of ints, optional, default = all): Accepted species
+ *       as decimal PDG codes
+ *   \li \key Rapidity_Range (list of 2 doubles, optional, default = all):
+ *       Accepted range of the momentum rapidity
+ *   \li \key Pt_Range (list of 2 doubles, optional, default = all):
+ *       Accepted range of the transverse momentum in GeV
+ *   \li \key Only_Participants (bool, optional, default = false): Only
+ *       accept particles which had at least one interaction
+ *   \li \key Time_Range (list of 2 doubles, optional, default = all):
+ *       Accepted range of the time coordinate of particles and of the
+ *       execution time of interactions in fm
+ *   \li \key Process_Types (list of ints, optional, default = all, not for
+ *       \b Particles): Accepted process types, see \ref process_type
+ *
+ *   \key Columns (list of strings, optional, default = all, incompatible with
+ *                 Oscar1999 format): \n
+ *   The particle fields written to each particle line, in the given order,
+ *   named as in the OSCAR2013 header, e.g. [pdg, p0, px, py, pz]. The
+ *   fields of the extended format can be used without \key Extended. The
+ *   header of the OSCAR2013 output lists the written fields, the binary
+ *   and columnar formats use format variant 2 and store them in the header.
+ *
+ *   For example, to only write the momenta of the pions with
+ *   \f$|y| < 1\f$ at the end of the event:
+ *\verbatim
+ Output:
+     Particles:
+         Format: ["Binary"]
+         Filter:
+             PDG: [211, -211, 111]
+             Rapidity_Range: [-1.0, 1.0]
+         Columns: ["pdg", "p0", "px", "py", "pz"]
+ \endverbatim
+ * \n
  * - \b Initial_Conditions (Oscar1999, Oscar2013, binary, ROOT and special ASCII
  * IC (\ref IC_output_user_guide_) formats)\n
  *   \key Proper_Time (double, optional, default = nuclei passing time, if
@@ -309,7 +390,11 @@ ExperimentPtr ExperimentBase::create(Configuration config,
  * - \b Rivet (Only YODA format)\n
  *   See \ref rivet_output_user_guide_ for more information
  * \n
- * - \b Coulomb (Only VTK format)\n
+ * - \b Analysis (Only ASCII format)\n
+ *   See \ref analysis_output_user_guide_ for the observables and their
+ *   options
+ * \n
+ * - \b Coulomb (Only VTK and VTK_Binary formats)\n
  *   No content-specific output options \n
  * \n
  * \anchor Thermodynamics
@@ -366,6 +451,11 @@ ExperimentPtr ExperimentBase::create(Configuration config,
  *   \li \key true - smearing applied
  *   \li \key false - smearing not applied
  *
+ *   \key Single_Precision (bool, optional, default = false): \n
+ *   Write the values of the \key Lattice_Binary and \key VTK_Binary outputs
+ *   as 4 byte floats instead of 8 byte doubles, which halves the size of the
+ *   files, see \ref thermodyn_lattice_output_ and \ref output_vtk_lattice_.
+ *
  *   \anchor onlypart
  *   \key Only_Participants (bool, optional, default = false): \n
  *   If set to true, only participants are included in the computation of the
@@ -726,7 +816,7 @@ std::string format_measurements(const std::vector<Particles> &ensembles,
 
 double calculate_mean_field_energy(
     const Potentials &potentials,
-    RectangularLattice<smash::DensityOnLattice> &jmuB_lat,
+    const RectangularLattice<smash::DensityOnLattice> &jmuB_lat,
     RectangularLattice<std::pair<ThreeVector, ThreeVector>> *em_lattice,
     const ExperimentParameters &parameters) {
   // basic parameters and variables
@@ -944,6 +1034,88 @@ double calculate_mean_field_energy(
   return E_mean_field;
 }
 
+bool fit_adaptive_lattice(const std::vector<Particles> &ensembles,
+                          const DensityParameters &par, bool include_charged,
+                          const std::array<double, 3> &cell_sizes,
+                          const std::array<int, 3> &max_n_cells,
+                          std::array<double, 3> &origin,
+                          std::array<int, 3> &n_cells) {
+  std::array<double, 3> r_min, r_max, r_sum{};
+  r_min.fill(std::numeric_limits<double>::max());
+  r_max.fill(std::numeric_limits<double>::lowest());
+  int n_contributing = 0;
+  for (const Particles &particles : ensembles) {
+    for (const ParticleData &p : particles) {
+      if (par.only_participants() &&
+          p.get_history().collisions_per_particle == 0) {
+        continue;
+      }
+      const bool contributes = p.pdgcode().baryon_number() != 0 ||
+                               (include_charged && p.type().charge() != 0);
+      if (!contributes) {
+        continue;
+      }
+      const ThreeVector r = p.position().threevec();
+      for (int i = 0; i < 3; i++) {
+        r_min[i] = std::min(r_min[i], r[i]);
+        r_max[i] = std::max(r_max[i], r[i]);
+        r_sum[i] += r[i];
+      }
+      n_contributing++;
+    }
+  }
+  if (n_contributing == 0) {
+    return false;
+  }
+
+  std::array<double, 3> new_origin;
+  std::array<int, 3> new_n;
+  bool refit = false;
+  for (int i = 0; i < 3; i++) {
+    /* Cells needed (relative to the current origin) to hold the smeared
+     * particles, plus one cell on each side for the finite differences. */
+    const double smearing_range =
+        std::max(par.r_cut(), par.triangular_range() * cell_sizes[i]);
+    const int lower =
+        std::floor((r_min[i] - smearing_range - origin[i]) / cell_sizes[i]) -
+        1;
+    const int upper =
+        std::ceil((r_max[i] + smearing_range - origin[i]) / cell_sizes[i]) +
+        1;
+    const int needed = upper - lower;
+    if (needed <= max_n_cells[i]) {
+      if (lower < 0 || upper > n_cells[i] || 2 * needed < n_cells[i]) {
+        refit = true;
+      }
+      /* Leave a margin of a quarter of the needed extent on each side, such
+       * that an expanding system does not need a refit every time step. */
+      const int margin = std::min(needed / 4, (max_n_cells[i] - needed) / 2);
+      new_n[i] = needed + 2 * margin;
+      new_origin[i] = origin[i] + (lower - margin) * cell_sizes[i];
+    } else {
+      /* The particles are spread too far, e.g. if fragments fly apart. Center
+       * the largest allowed lattice on their mean position; the particles
+       * outside get their potentials from their neighbors directly. */
+      const int center = std::floor(
+          (r_sum[i] / n_contributing - origin[i]) / cell_sizes[i]);
+      const int window_lower =
+          std::min(std::max(center - max_n_cells[i] / 2, lower),
+                   upper - max_n_cells[i]);
+      if (n_cells[i] != max_n_cells[i] ||
+          std::abs(window_lower) > max_n_cells[i] / 4) {
+        refit = true;
+      }
+      new_n[i] = max_n_cells[i];
+      new_origin[i] = origin[i] + window_lower * cell_sizes[i];
+    }
+  }
+  if (refit) {
+    origin = new_origin;
+    n_cells = new_n;
+  }
+  return refit;
+}
+
 EventInfo fill_event_info(const std::vector<Particles> &ensembles,
                           double E_mean_field, double modus_impact_parameter,
                           const ExperimentParameters &parameters,
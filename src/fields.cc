@@ -32,8 +32,10 @@ void update_fields_lattice(
    * information about the fields to populate the lattice of A^mu FourVectors at
    * t0, old_fields.
    */
+  // read access, which does not mark the tiles of the lattice as occupied
+  const RectangularLattice<FieldsOnLattice> &const_fields_lat = *fields_lat;
   for (int i = 0; i < number_of_nodes; i++) {
-    old_fields->assign_value(i, ((*fields_lat)[i]).A_mu());
+    old_fields->assign_value(i, const_fields_lat[i].A_mu());
   }
 
   /*
@@ -41,45 +43,22 @@ void update_fields_lattice(
    */
   fields_lat->reset();
 
-  // Get the potential parameters
-  const double rhoB_0 = potentials.saturation_density();
-
-  // update the fields lattice
-  for (int i = 0; i < number_of_nodes; i++) {
-    // read values off the jmu_B lattice (which holds values at t0 + Delta t)
-    double rhoB_at_i = ((*jmuB_lat)[i]).rho();
-    FourVector jmuB_at_i = ((*jmuB_lat)[i]).jmu_net();
-
-    double abs_rhoB_at_i = std::abs(rhoB_at_i);
-    // this is to prevent nan expressions
-    if (abs_rhoB_at_i < very_small_double) {
-      abs_rhoB_at_i = very_small_double;
-    }
-
-    // this needs to be used in order to prevent trying to calculate something
-    // an expression like (-rhoB)^{3.4}
-    const int sgn = rhoB_at_i > 0 ? 1 : -1;
-
+  /* update the fields lattice; the fields vanish where the baryon current
+   * does, so only the occupied tiles of the jmu_B lattice (which holds values
+   * at t0 + Delta t) are visited */
+  jmuB_lat->iterate_occupied([&](const DensityOnLattice &jmuB, int i) {
     // field contributions as obtained in the VDF model
-    double field_contribution = 0.0;
-    for (int j = 0; j < potentials.number_of_terms(); j++) {
-      field_contribution +=
-          sgn * potentials.coeffs()[j] *
-          std::pow(abs_rhoB_at_i / rhoB_0, potentials.powers()[j] - 2.0) /
-          rhoB_0;
-    }
-    FourVector field_at_i = field_contribution * jmuB_at_i;
-
-    // fill the A_mu lattice
-    ((*fields_lat)[i]).overwrite_A_mu(field_at_i);
-  }
+    FieldsOnLattice node = const_fields_lat[i];
+    node.overwrite_A_mu(potentials.vdf_pot(jmuB.rho(), jmuB.jmu_net()));
+    fields_lat->assign_value(i, node);
+  });
 
   /*
    * Use the updated fields lattice, fields_lat, to populate the lattice of A^mu
    * FourVectors at t0 + Delta t, new_fields.
    */
   for (int i = 0; i < number_of_nodes; i++) {
-    new_fields->assign_value(i, ((*fields_lat)[i]).A_mu());
+    new_fields->assign_value(i, const_fields_lat[i].A_mu());
   }
 
   /*
@@ -88,10 +67,17 @@ void update_fields_lattice(
   new_fields->compute_four_gradient_lattice(*old_fields, time_step,
                                             *fields_four_grad_lattice);
 
-  // substitute new derivatives
+  /* substitute new derivatives, only writing the nodes whose derivatives
+   * change, such that the empty tiles stay unoccupied */
+  const RectangularLattice<std::array<FourVector, 4>> &four_grad =
+      *fields_four_grad_lattice;
   for (int i = 0; i < number_of_nodes; i++) {
-    auto tmp = (*fields_four_grad_lattice)[i];
-    ((*fields_lat)[i]).overwrite_dAmu_dxnu(tmp[0], tmp[1], tmp[2], tmp[3]);
+    const std::array<FourVector, 4> &tmp = four_grad[i];
+    if (tmp != const_fields_lat[i].dAmu_dxnu()) {
+      FieldsOnLattice node = const_fields_lat[i];
+      node.overwrite_dAmu_dxnu(tmp[0], tmp[1], tmp[2], tmp[3]);
+      fields_lat->assign_value(i, node);
+    }
   }
 }  // void update_fields_lattice()
 
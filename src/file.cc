@@ -9,26 +9,251 @@
 
 #include "smash/file.h"
 
+#include <algorithm>
+#include <utility>
+
+#include "smash/logging.h"
+#include "smash/macros.h"
+
 namespace smash {
+static constexpr int LOutput = LogArea::Output::id;
 
 FilePtr fopen(const bf::path& filename, const std::string& mode) {
   FilePtr f{std::fopen(filename.c_str(), mode.c_str())};
   return f;
 }
 
+AsyncFileWriter::AsyncFileWriter(std::FILE* file,
+                                 const AsyncWriteParameters& par)
+    : file_(file),
+      buffer_size_(par.buffer_size),
+      max_pending_(par.max_pending_buffers) {
+  if (buffer_size_ == 0 || max_pending_ == 0) {
+    throw std::invalid_argument(
+        "Asynchronous output needs a positive buffer size and queue length.");
+  }
+  front_.reserve(buffer_size_);
+  thread_ = std::thread(&AsyncFileWriter::run, this);
+}
+
+AsyncFileWriter::~AsyncFileWriter() { finish(); }
+
+void AsyncFileWriter::append(const char* data, size_t size) {
+  while (size > 0) {
+    const size_t n = std::min(size, buffer_size_ - front_.size());
+    front_.insert(front_.end(), data, data + n);
+    data += n;
+    size -= n;
+    if (front_.size() >= buffer_size_) {
+      queue_front_buffer();
+    }
+  }
+}
+
+void AsyncFileWriter::post(std::function<void(std::FILE*)> task) {
+  if (!front_.empty()) {
+    queue_front_buffer();
+  }
+  PendingWrite write;
+  write.task = std::move(task);
+  queue(std::move(write));
+}
+
+void AsyncFileWriter::flush() {
+  if (!front_.empty()) {
+    queue_front_buffer();
+  }
+  check_error();
+}
+
+int AsyncFileWriter::finish() {
+  if (thread_.joinable()) {
+    if (!front_.empty()) {
+      queue_front_buffer();
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_ = true;
+    }
+    has_work_.notify_one();
+    thread_.join();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  return error_;
+}
+
+void AsyncFileWriter::queue_front_buffer() {
+  PendingWrite write;
+  write.buffer = std::move(front_);
+  queue(std::move(write));
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (spare_.empty()) {
+    front_ = std::vector<char>();
+    front_.reserve(buffer_size_);
+  } else {
+    front_ = std::move(spare_.back());
+    spare_.pop_back();
+  }
+}
+
+void AsyncFileWriter::queue(PendingWrite&& write) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  // backpressure: wait for the writer thread if the queue is full
+  has_space_.wait(lock, [this] { return pending_.size() < max_pending_; });
+  pending_.push_back(std::move(write));
+  lock.unlock();
+  has_work_.notify_one();
+}
+
+void AsyncFileWriter::check_error() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (error_ != 0) {
+    throw std::runtime_error(std::strerror(error_));
+  }
+}
+
+void AsyncFileWriter::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    has_work_.wait(lock, [this] { return done_ || !pending_.empty(); });
+    if (pending_.empty()) {
+      // done_ is set and everything is written
+      break;
+    }
+    PendingWrite write = std::move(pending_.front());
+    pending_.pop_front();
+    lock.unlock();
+    errno = 0;
+    bool ok = true;
+    if (write.task) {
+      try {
+        write.task(file_);
+      } catch (std::exception& e) {
+        logg[LOutput].error("Formatting the output failed: ", e.what());
+        ok = false;
+      }
+      ok = ok && !std::ferror(file_);
+    } else {
+      ok = std::fwrite(write.buffer.data(), 1, write.buffer.size(), file_) ==
+           write.buffer.size();
+    }
+    ok = ok && std::fflush(file_) == 0;
+    const int err = ok ? 0 : (errno != 0 ? errno : EIO);
+    lock.lock();
+    if (err != 0 && error_ == 0) {
+      error_ = err;
+    }
+    if (write.buffer.capacity() > 0) {
+      write.buffer.clear();
+      spare_.push_back(std::move(write.buffer));
+    }
+    has_space_.notify_one();
+  }
+}
+
+namespace {
+/**
+ * Write function of the stream returned by RenamingFilePtr::get() when
+ * writing asynchronously: the data is appended to the buffers of the
+ * AsyncFileWriter.
+ *
+ * \param[in] cookie The AsyncFileWriter.
+ * \param[in] data Data to be written.
+ * \param[in] size Number of bytes.
+ * \return Number of bytes written.
+ */
+#ifdef __APPLE__
+int write_to_async_writer(void* cookie, const char* data, int size) {
+#else
+ssize_t write_to_async_writer(void* cookie, const char* data, size_t size) {
+#endif
+  static_cast<AsyncFileWriter*>(cookie)->append(data, size);
+  return size;
+}
+
+/**
+ * Open a stream that writes to the given AsyncFileWriter.
+ *
+ * \param[in] writer Writer the data is handed to.
+ * \param[in] mode The mode in which the stream should be opened.
+ * \return The stream.
+ */
+FILE* open_async_stream(AsyncFileWriter* writer, const std::string& mode) {
+#ifdef __APPLE__
+  SMASH_UNUSED(mode);
+  return funopen(writer, nullptr, write_to_async_writer, nullptr, nullptr);
+#else
+  cookie_io_functions_t functions = {nullptr, write_to_async_writer, nullptr,
+                                     nullptr};
+  return fopencookie(writer, mode.c_str(), functions);
+#endif
+}
+}  // unnamed namespace
+
 RenamingFilePtr::RenamingFilePtr(const bf::path& filename,
-                                 const std::string& mode) {
+                                 const std::string& mode,
+                                 const AsyncWriteParameters& async) {
+  if (async.enabled &&
+      (async.buffer_size == 0 || async.max_pending_buffers == 0)) {
+    throw std::invalid_argument(
+        "Asynchronous output needs a positive buffer size and queue length.");
+  }
   filename_ = filename;
   filename_unfinished_ = filename;
   filename_unfinished_ += ".unfinished";
   file_ = std::fopen(filename_unfinished_.c_str(), mode.c_str());
+  if (async.enabled && file_ != nullptr) {
+    target_ = file_;
+    writer_ = make_unique<AsyncFileWriter>(target_, async);
+    file_ = open_async_stream(writer_.get(), mode);
+    if (file_ == nullptr) {
+      const int err = errno;
+      writer_.reset();
+      std::fclose(target_);
+      throw std::runtime_error(std::strerror(err));
+    }
+  }
 }
 
 FILE* RenamingFilePtr::get() { return file_; }
 
+void RenamingFilePtr::post(std::function<void(std::FILE*)> task) {
+  if (writer_) {
+    // hand over what was written through the stream before the task
+    std::fflush(file_);
+    writer_->post(std::move(task));
+  } else {
+    task(file_);
+  }
+}
+
+void RenamingFilePtr::flush() {
+  std::fflush(file_);
+  if (writer_) {
+    writer_->flush();
+  }
+}
+
 RenamingFilePtr::~RenamingFilePtr() {
-  std::fclose(file_);
-  bf::rename(filename_unfinished_, filename_);
+  int error = std::fclose(file_) == 0 ? 0 : errno;
+  if (writer_) {
+    // all data has been handed over by fclose, wait until it is written
+    const int write_error = writer_->finish();
+    if (std::fclose(target_) != 0 && error == 0) {
+      error = errno;
+    }
+    if (write_error != 0) {
+      error = write_error;
+    }
+  }
+  if (error != 0) {
+    logg[LOutput].error("Writing ", filename_unfinished_, " failed (",
+                        std::strerror(error), "), it is not renamed.");
+    return;
+  }
+  if (!keep_unfinished_) {
+    bf::rename(filename_unfinished_, filename_);
+  }
 }
 
 }  // namespace smash
@@ -252,29 +252,31 @@ void GrandCanThermalizer::sample_multinomial(HadronClass particle_class,
 void GrandCanThermalizer::sample_in_random_cell_BF_algo(ParticleList &plist,
                                                         const double time,
                                                         size_t type_index) {
-  N_in_cells_.clear();
-  N_total_in_cells_ = 0.0;
-  for (auto cell_index : cells_to_sample_) {
-    const ThermLatticeNode cell = (*lat_)[cell_index];
-    const double gamma = 1.0 / std::sqrt(1.0 - cell.v().sqr());
-    const double N_this_cell =
-        lat_cell_volume_ * gamma *
-        HadronGasEos::partial_density(*eos_typelist_[type_index], cell.T(),
-                                      cell.mub(), cell.mus(), cell.muq());
-    N_in_cells_.push_back(N_this_cell);
-    N_total_in_cells_ += N_this_cell;
+  if (mult_int_[type_index] == 0) {
+    return;
+  }
+  /* The distribution of a species over the cells is the same for all attempts
+   * of thermalize_BF_algo, so its alias table is built only when the species
+   * is sampled for the first time. */
+  std::unique_ptr<random::AliasSampler> &cell_sampler =
+      cell_samplers_[type_index];
+  if (!cell_sampler) {
+    N_in_cells_.clear();
+    for (auto cell_index : cells_to_sample_) {
+      const ThermLatticeNode cell = (*lat_)[cell_index];
+      const double gamma = 1.0 / std::sqrt(1.0 - cell.v().sqr());
+      const double N_this_cell =
+          lat_cell_volume_ * gamma *
+          HadronGasEos::partial_density(*eos_typelist_[type_index], cell.T(),
+                                        cell.mub(), cell.mus(), cell.muq());
+      N_in_cells_.push_back(N_this_cell);
+    }
+    cell_sampler = make_unique<random::AliasSampler>(N_in_cells_);
   }
 
   for (int i = 0; i < mult_int_[type_index]; i++) {
     // Choose random cell, probability = N_in_cell/N_total
-    double r = random::uniform(0.0, N_total_in_cells_);
-    double partial_sum = 0.0;
-    int index_only_thermalized = -1;
-    while (partial_sum < r) {
-      index_only_thermalized++;
-      partial_sum += N_in_cells_[index_only_thermalized];
-    }
-    const int cell_index = cells_to_sample_[index_only_thermalized];
+    const size_t cell_index = cells_to_sample_[cell_sampler->sample()];
     const ThermLatticeNode cell = (*lat_)[cell_index];
     const ThreeVector cell_center = lat_->cell_center(cell_index);
 
@@ -297,6 +299,8 @@ void GrandCanThermalizer::sample_in_random_cell_BF_algo(ParticleList &plist,
 
 void GrandCanThermalizer::thermalize_BF_algo(QuantumNumbers &conserved_initial,
                                              double time, int ntest) {
+  cell_samplers_.clear();
+  cell_samplers_.resize(N_sorts_);
   std::fill(mult_sort_.begin(), mult_sort_.end(), 0.0);
   for (auto cell_index : cells_to_sample_) {
     const ThermLatticeNode cell = (*lat_)[cell_index];
@@ -7,20 +7,32 @@
  *
  */
 
+#include <fcntl.h>
 #include <gsl/gsl_sf_bessel.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
-#include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
 
 #include <boost/filesystem.hpp>
 
 #include "smash/constants.h"
+#include "smash/cxx14compat.h"
+#include "smash/decaymodes.h"
 #include "smash/hadgas_eos.h"
 #include "smash/integrate.h"
 #include "smash/interpolation.h"
 #include "smash/logging.h"
 #include "smash/random.h"
+#include "smash/threadpool.h"
 
 namespace smash {
 static constexpr int LResonances = LogArea::Resonances::id;
@@ -31,132 +43,206 @@ EosTable::EosTable(double de, double dnb, double dq, size_t n_e, size_t n_nb,
   table_.resize(n_e_ * n_nb_ * n_q_);
 }
 
-void EosTable::compile_table(HadronGasEos &eos,
-                             const std::string &eos_savefile_name) {
-  bool table_read_success = false, table_consistency = true;
-  if (boost::filesystem::exists(eos_savefile_name)) {
-    std::cout << "Reading table from file " << eos_savefile_name << std::endl;
-    std::ifstream file;
-    file.open(eos_savefile_name, std::ios::in);
-    file >> de_ >> dnb_ >> dq_;
-    file >> n_e_ >> n_nb_ >> n_q_;
-    table_.resize(n_e_ * n_nb_ * n_q_);
-    for (size_t ie = 0; ie < n_e_; ie++) {
-      for (size_t inb = 0; inb < n_nb_; inb++) {
-        for (size_t iq = 0; iq < n_q_; iq++) {
-          double p, T, mub, mus, muq;
-          file >> p >> T >> mub >> mus >> muq;
-          table_[index(ie, inb, iq)] = {p, T, mub, mus, muq};
-        }
-      }
+namespace {
+/// Header of a binary EoS table file, which is followed by the elements
+struct EosTableHeader {
+  /// Identifies the file as EoS table
+  char magic[8];
+  /// Version of the file format
+  std::uint64_t version;
+  /// Hash of the grid and the hadrons, see EosTable::hash
+  sha256::Hash hash;
+  /// Number of steps in energy, net baryon and net charge density
+  std::uint64_t n[3];
+};
+static_assert(sizeof(EosTableHeader) % alignof(double) == 0,
+              "The table elements have to be aligned in the file.");
+static_assert(sizeof(EosTable::table_element) == 5 * sizeof(double),
+              "The table elements are stored without padding.");
+
+/// Magic string at the start of a binary EoS table file
+constexpr char eos_table_magic[8] = {'S', 'M', 'A', 'S', 'H', 'E', 'O', 'S'};
+/**
+ * Version of the binary EoS table format. It has to be increased, if the
+ * way the table is computed changes, e.g. the tolerance of the solver.
+ */
+constexpr std::uint64_t eos_table_version = 1;
+}  // namespace
+
+sha256::Hash EosTable::hash(bool account_for_width) const {
+  sha256::Context context;
+  auto add = [&context](double x) {
+    context.update(reinterpret_cast<const uint8_t *>(&x), sizeof(x));
+  };
+  for (double x : {de_, dnb_, dq_, static_cast<double>(n_e_),
+                   static_cast<double>(n_nb_), static_cast<double>(n_q_),
+                   account_for_width ? 1.0 : 0.0}) {
+    add(x);
+  }
+  // The quantum numbers and the degeneracy follow from the PDG code
+  for (const ParticleType &ptype : ParticleType::list_all()) {
+    if (!HadronGasEos::is_eos_particle(ptype)) {
+      continue;
     }
-    table_read_success = true;
-    std::cout << "Table consumed successfully." << std::endl;
-  }
-
-  if (table_read_success) {
-    // Check if the saved table is consistent with the current particle table
-    std::cout << "Checking consistency of the table... " << std::endl;
-    constexpr size_t number_of_steps = 50;
-    const size_t ie_step = 1 + n_e_ / number_of_steps;
-    const size_t inb_step = 1 + n_nb_ / number_of_steps;
-    const size_t iq_step = 1 + n_q_ / number_of_steps;
-    for (size_t ie = 0; ie < n_e_; ie += ie_step) {
-      for (size_t inb = 0; inb < n_nb_; inb += inb_step) {
-        for (size_t iq = 0; iq < n_q_; iq += iq_step) {
-          const table_element x = table_[index(ie, inb, iq)];
-          const bool w = eos.account_for_resonance_widths();
-          const double e_comp = eos.energy_density(x.T, x.mub, x.mus, x.muq);
-          const double nb_comp =
-              eos.net_baryon_density(x.T, x.mub, x.mus, x.muq, w);
-          const double ns_comp =
-              eos.net_strange_density(x.T, x.mub, x.mus, x.muq, w);
-          const double p_comp = eos.pressure(x.T, x.mub, x.mus, x.muq, w);
-          const double nq_comp =
-              eos.net_charge_density(x.T, x.mub, x.mus, x.muq, w);
-          // Precision is just 10^-3, this is precision of saved data in the
-          // file
-          const double eps = 1.e-3;
-          // Only check the physical region, hence T > 0 condition
-          if ((std::abs(de_ * ie - e_comp) > eps ||
-               std::abs(dnb_ * inb - nb_comp) > eps ||
-               std::abs(ns_comp) > eps || std::abs(x.p - p_comp) > eps ||
-               std::abs(dq_ * iq - nq_comp) > eps) &&
-              (x.T > 0.0)) {
-            std::cout << "discrepancy: " << de_ * ie << " = " << e_comp << ", "
-                      << dnb_ * inb << " = " << nb_comp << ", " << x.p << " = "
-                      << p_comp << ", 0 = " << ns_comp << ", " << dq_ * iq
-                      << " = " << nq_comp << std::endl;
-            table_consistency = false;
-            goto finish_consistency_check;
-          }
+    context.update(ptype.pdgcode().string());
+    add(ptype.mass());
+    add(ptype.width_at_pole());
+    if (account_for_width) {
+      // The spectral function depends on the decay modes
+      for (const auto &mode : ptype.decay_modes().decay_mode_list()) {
+        add(mode->weight());
+        for (const ParticleTypePtr daughter : mode->particle_types()) {
+          context.update(daughter->pdgcode().string());
         }
       }
     }
   }
-finish_consistency_check:
-
-  if (!table_read_success || !table_consistency) {
-    std::cout << "Compiling an EoS table..." << std::endl;
-    const double ns = 0.0;
-    for (size_t ie = 0; ie < n_e_; ie++) {
-      std::cout << ie << "/" << n_e_ << "\r" << std::flush;
-      const double e = de_ * ie;
-      for (size_t inb = 0; inb < n_nb_; inb++) {
-        const double nb = dnb_ * inb;
-        for (size_t iq = 0; iq < n_q_; iq++) {
-          const double q = dq_ * iq;
-          // It is physically impossible to have energy density > nucleon
-          // mass*nb, therefore eqns have no solutions.
-          if (nb >= e || q >= e) {
-            table_[index(ie, inb, iq)] = {0.0, 0.0, 0.0, 0.0, 0.0};
-            continue;
-          }
-          // Take extrapolated (T, mub, mus, muq) as initial approximation
-          std::array<double, 4> init_approx;
-          if (inb >= 2) {
-            const table_element y = table_[index(ie, inb - 2, iq)];
-            const table_element x = table_[index(ie, inb - 1, iq)];
-            init_approx = {2.0 * x.T - y.T, 2.0 * x.mub - y.mub,
-                           2.0 * x.mus - y.mus, 2.0 * x.muq - y.muq};
-          } else if (iq >= 2) {
-            const table_element y = table_[index(ie, inb, iq - 2)];
-            const table_element x = table_[index(ie, inb, iq - 1)];
-            init_approx = {2.0 * x.T - y.T, 2.0 * x.mub - y.mub,
-                           2.0 * x.mus - y.mus, 2.0 * x.muq - y.muq};
-          } else {
-            init_approx = eos.solve_eos_initial_approximation(e, nb, q);
-          }
-          const std::array<double, 4> res =
-              eos.solve_eos(e, nb, ns, q, init_approx);
-          const double T = res[0];
-          const double mub = res[1];
-          const double mus = res[2];
-          const double muq = res[3];
-          const bool w = eos.account_for_resonance_widths();
-          table_[index(ie, inb, iq)] = {eos.pressure(T, mub, mus, muq, w), T,
-                                        mub, mus, muq};
-        }
+  return context.finalize();
+}
+
+bool EosTable::map_table(const std::string &filename,
+                         const sha256::Hash &hash) {
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  const size_t size = sizeof(EosTableHeader) +
+                      sizeof(table_element) * n_e_ * n_nb_ * n_q_;
+  struct stat file_status;
+  void *address = MAP_FAILED;
+  if (fstat(fd, &file_status) == 0 &&
+      static_cast<size_t>(file_status.st_size) == size) {
+    address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  // The mapping stays valid after closing the file
+  close(fd);
+  if (address == MAP_FAILED) {
+    return false;
+  }
+  std::shared_ptr<const char> mapping(
+      static_cast<const char *>(address),
+      [size](const char *p) { munmap(const_cast<char *>(p), size); });
+  EosTableHeader header;
+  std::memcpy(&header, mapping.get(), sizeof(header));
+  // The grid is part of the hash, its size is checked for robustness.
+  if (!std::equal(std::begin(eos_table_magic), std::end(eos_table_magic),
+                  header.magic) ||
+      header.version != eos_table_version || header.hash != hash ||
+      header.n[0] != n_e_ || header.n[1] != n_nb_ || header.n[2] != n_q_) {
+    return false;
+  }
+  mapped_table_ = std::shared_ptr<const table_element>(
+      mapping, reinterpret_cast<const table_element *>(
+                   mapping.get() + sizeof(EosTableHeader)));
+  std::vector<table_element>().swap(table_);
+  return true;
+}
+
+void EosTable::compile_table(HadronGasEos &eos,
+                             const std::string &eos_savefile_name) {
+  const bool w = eos.account_for_resonance_widths();
+  const sha256::Hash table_hash = hash(w);
+  mapped_table_.reset();
+  if (map_table(eos_savefile_name, table_hash)) {
+    std::cout << "Mapped EoS table from file " << eos_savefile_name
+              << std::endl;
+    return;
+  }
+
+  std::cout << "Compiling an EoS table..." << std::endl;
+  table_.resize(n_e_ * n_nb_ * n_q_);
+  if (w) {
+    // The spectral functions fill their caches lazily, which is not thread
+    // safe, so this is done before the slices are distributed.
+    for (const ParticleType &ptype : ParticleType::list_all()) {
+      if (HadronGasEos::is_eos_particle(ptype)) {
+        ptype.fill_caches();
       }
     }
-    // Save table to file
-    std::cout << "Saving table to file " << eos_savefile_name << std::endl;
-    std::ofstream file;
-    file.open(eos_savefile_name, std::ios::out);
-    file << de_ << " " << dnb_ << " " << dq_ << std::endl;
-    file << n_e_ << " " << n_nb_ << " " << n_q_ << std::endl;
-    file << std::setprecision(7);
-    file << std::fixed;
-    for (size_t ie = 0; ie < n_e_; ie++) {
-      for (size_t inb = 0; inb < n_nb_; inb++) {
-        for (size_t iq = 0; iq < n_q_; iq++) {
-          const EosTable::table_element x = table_[index(ie, inb, iq)];
-          file << x.p << " " << x.T << " " << x.mub << " " << x.mus << " "
-               << x.muq << std::endl;
-        }
+  }
+  /* Every thread solves whole energy density slices with its own solver, the
+   * slices are distributed dynamically because their cost varies. */
+  ThreadPool &pool = ThreadPool::global();
+  std::vector<std::unique_ptr<HadronGasEos>> slice_eos(pool.size());
+  size_t n_done = 0;
+  std::mutex cout_mutex;
+  pool.for_each_index(n_e_, 1, [&](size_t ie, size_t thread) {
+    if (!slice_eos[thread]) {
+      slice_eos[thread] = make_unique<HadronGasEos>(false, w);
+    }
+    compile_slice(*slice_eos[thread], ie);
+    std::lock_guard<std::mutex> cout_lock(cout_mutex);
+    std::cout << ++n_done << "/" << n_e_ << "\r" << std::flush;
+  });
+  save_table(eos_savefile_name, table_hash);
+}
+
+void EosTable::compile_slice(HadronGasEos &eos, size_t ie) {
+  const double ns = 0.0;
+  const double e = de_ * ie;
+  for (size_t inb = 0; inb < n_nb_; inb++) {
+    const double nb = dnb_ * inb;
+    for (size_t iq = 0; iq < n_q_; iq++) {
+      const double q = dq_ * iq;
+      // It is physically impossible to have energy density > nucleon
+      // mass*nb, therefore eqns have no solutions.
+      if (nb >= e || q >= e) {
+        table_[index(ie, inb, iq)] = {0.0, 0.0, 0.0, 0.0, 0.0};
+        continue;
+      }
+      // Take extrapolated (T, mub, mus, muq) as initial approximation
+      std::array<double, 4> init_approx;
+      if (inb >= 2) {
+        const table_element y = table_[index(ie, inb - 2, iq)];
+        const table_element x = table_[index(ie, inb - 1, iq)];
+        init_approx = {2.0 * x.T - y.T, 2.0 * x.mub - y.mub,
+                       2.0 * x.mus - y.mus, 2.0 * x.muq - y.muq};
+      } else if (iq >= 2) {
+        const table_element y = table_[index(ie, inb, iq - 2)];
+        const table_element x = table_[index(ie, inb, iq - 1)];
+        init_approx = {2.0 * x.T - y.T, 2.0 * x.mub - y.mub,
+                       2.0 * x.mus - y.mus, 2.0 * x.muq - y.muq};
+      } else {
+        init_approx = eos.solve_eos_initial_approximation(e, nb, q);
       }
+      const std::array<double, 4> res =
+          eos.solve_eos(e, nb, ns, q, init_approx);
+      const double T = res[0];
+      const double mub = res[1];
+      const double mus = res[2];
+      const double muq = res[3];
+      const bool w = eos.account_for_resonance_widths();
+      table_[index(ie, inb, iq)] = {eos.pressure(T, mub, mus, muq, w), T, mub,
+                                    mus, muq};
+    }
+  }
+}
+
+void EosTable::save_table(const std::string &filename,
+                          const sha256::Hash &hash) const {
+  std::cout << "Saving table to file " << filename << std::endl;
+  EosTableHeader header;
+  std::copy(std::begin(eos_table_magic), std::end(eos_table_magic),
+            header.magic);
+  header.version = eos_table_version;
+  header.hash = hash;
+  header.n[0] = n_e_;
+  header.n[1] = n_nb_;
+  header.n[2] = n_q_;
+  // Write to a temporary file first, such that concurrent runs never map a
+  // partially written table.
+  const std::string tmp_filename = filename + ".tmp";
+  {
+    std::ofstream file(tmp_filename, std::ios::out | std::ios::binary);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(table_.data()),
+               sizeof(table_element) * table_.size());
+    if (!file) {
+      logg[LResonances].warn("EoS table could not be saved to ", filename);
+      return;
     }
   }
+  boost::filesystem::rename(tmp_filename, filename);
 }
 
 void EosTable::get(EosTable::table_element &res, double e, double nb,
@@ -172,14 +258,15 @@ void EosTable::get(EosTable::table_element &res, double e, double nb,
     const double ae = e / de_ - ie;
     const double an = nb / dnb_ - inb;
     const double aq = q / dq_ - iq;
-    const EosTable::table_element s1 = table_[index(ie, inb, iq)];
-    const EosTable::table_element s2 = table_[index(ie + 1, inb, iq)];
-    const EosTable::table_element s3 = table_[index(ie, inb + 1, iq)];
-    const EosTable::table_element s4 = table_[index(ie + 1, inb + 1, iq)];
-    const EosTable::table_element s5 = table_[index(ie, inb, iq + 1)];
-    const EosTable::table_element s6 = table_[index(ie + 1, inb, iq + 1)];
-    const EosTable::table_element s7 = table_[index(ie, inb + 1, iq + 1)];
-    const EosTable::table_element s8 = table_[index(ie + 1, inb + 1, iq + 1)];
+    const EosTable::table_element *table = elements();
+    const EosTable::table_element s1 = table[index(ie, inb, iq)];
+    const EosTable::table_element s2 = table[index(ie + 1, inb, iq)];
+    const EosTable::table_element s3 = table[index(ie, inb + 1, iq)];
+    const EosTable::table_element s4 = table[index(ie + 1, inb + 1, iq)];
+    const EosTable::table_element s5 = table[index(ie, inb, iq + 1)];
+    const EosTable::table_element s6 = table[index(ie + 1, inb, iq + 1)];
+    const EosTable::table_element s7 = table[index(ie, inb + 1, iq + 1)];
+    const EosTable::table_element s8 = table[index(ie + 1, inb + 1, iq + 1)];
 
     res.p = interpolate_trilinear(ae, an, aq, s1.p, s2.p, s3.p, s4.p, s5.p,
                                   s6.p, s7.p, s8.p);
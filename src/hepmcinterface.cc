@@ -121,39 +121,36 @@ void HepMcInterface::at_eventstart(const Particles& particles,
   }
 }
 
-void HepMcInterface::at_interaction(const Action& action,
-                                    const double /* density */) {
-  HepMC3::GenVertexPtr vp;
-  auto type = action.get_type();
-  int status = get_status(type);
+void HepMcInterface::at_interactions(ConstSpan<InteractionRecord> records) {
+  // Only the full event contains the interactions
+  if (!full_event_) {
+    return;
+  }
+  for (const InteractionRecord& record : records) {
+    int status = get_status(record.type);
 
-  if (full_event_) {
-    FourVector v = action.get_interaction_point();
-    vp = std::make_shared<HepMC3::GenVertex>(
+    const FourVector& v = record.interaction_point;
+    HepMC3::GenVertexPtr vp = std::make_shared<HepMC3::GenVertex>(
         HepMC3::FourVector(v.x1(), v.x2(), v.x3(), v.x0()));
     event_.add_vertex(vp);
     vp->add_attribute("weight", std::make_shared<HepMC3::FloatAttribute>(
-                                    action.get_total_weight()));
+                                    record.total_weight));
     vp->add_attribute(
         "partial_weight",
-        std::make_shared<HepMC3::FloatAttribute>(action.get_partial_weight()));
-  }
+        std::make_shared<HepMC3::FloatAttribute>(record.partial_weight));
 
-  // Now mark participants
-  if (full_event_) {
-    for (auto& i : action.incoming_particles()) {
+    // Now mark participants
+    for (auto& i : record.incoming) {
       // Create tree
       HepMC3::GenParticlePtr ip = find_or_make(i, status);
       ip->set_status(status);
       vp->add_particle_in(ip);
     }
-  } else {
-    return;
-  }
 
-  // Add outgoing particles
-  for (auto& o : action.outgoing_particles()) {
-    vp->add_particle_out(make_register(o, Status::fnal));
+    // Add outgoing particles
+    for (auto& o : record.outgoing) {
+      vp->add_particle_out(make_register(o, Status::fnal));
+    }
   }
 }
 
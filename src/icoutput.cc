@@ -13,8 +13,6 @@
 
 #include <boost/filesystem.hpp>
 
-#include "smash/action.h"
-
 namespace smash {
 static constexpr int LHyperSurfaceCrossing = LogArea::HyperSurfaceCrossing::id;
 
@@ -99,7 +97,7 @@ static constexpr int LHyperSurfaceCrossing = LogArea::HyperSurfaceCrossing::id;
 ICOutput::ICOutput(const bf::path &path, const std::string &name,
                    const OutputParameters &out_par)
     : OutputInterface(name),
-      file_{path / "SMASH_IC.dat", "w"},
+      file_{path / "SMASH_IC.dat", "w", out_par.async_write},
       out_par_(out_par) {
   std::fprintf(
       file_.get(),
@@ -137,12 +135,16 @@ void ICOutput::at_intermediate_time(const Particles &,
   // Dummy, but virtual function needs to be declared.
 }
 
-void ICOutput::at_interaction(const Action &action, const double) {
-  assert(action.get_type() == ProcessType::HyperSurfaceCrossing);
-  assert(action.incoming_particles().size() == 1);
-
-  ParticleData particle = action.incoming_particles()[0];
+void ICOutput::at_interactions(ConstSpan<InteractionRecord> records) {
+  for (const InteractionRecord &record : records) {
+    if (record.type == ProcessType::HyperSurfaceCrossing) {
+      assert(record.incoming.size() == 1);
+      write_crossing_particle(record.incoming[0]);
+    }
+  }
+}
 
+void ICOutput::write_crossing_particle(const ParticleData &particle) {
   // transverse mass
   const double m_trans =
       std::sqrt(particle.type().mass() * particle.type().mass() +
@@ -0,0 +1,317 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_ANALYSISOUTPUT_H_
+#define SRC_INCLUDE_SMASH_ANALYSISOUTPUT_H_
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "file.h"
+#include "forwarddeclarations.h"
+#include "outputinterface.h"
+#include "outputparameters.h"
+#include "pdgcode.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Histogram with bins of equal width. Entries outside of the range are not
+ * counted.
+ */
+class UniformHistogram {
+ public:
+  /**
+   * Create an empty histogram.
+   *
+   * \param[in] min Lower edge of the first bin.
+   * \param[in] max Upper edge of the last bin.
+   * \param[in] n_bins Number of bins.
+   * \throws invalid_argument if the range is empty or there are no bins.
+   */
+  UniformHistogram(double min, double max, int n_bins);
+
+  /**
+   * Add an entry.
+   *
+   * \param[in] x Position of the entry.
+   * \param[in] weight Weight of the entry.
+   */
+  void fill(double x, double weight = 1.) {
+    const int bin = find_bin(x);
+    if (bin >= 0) {
+      contents_[bin] += weight;
+    }
+  }
+
+  /**
+   * \param[in] x Position.
+   * \return Index of the bin containing x or -1 if x is outside the range.
+   */
+  int find_bin(double x) const {
+    const double i = (x - min_) / width_;
+    if (!(i >= 0. && i < contents_.size())) {
+      return -1;
+    }
+    return static_cast<int>(i);
+  }
+
+  /// \return Number of bins.
+  int n_bins() const { return contents_.size(); }
+  /// \return Width of the bins.
+  double bin_width() const { return width_; }
+  /**
+   * \param[in] bin Index of the bin.
+   * \return Center of the bin.
+   */
+  double bin_center(int bin) const { return min_ + (bin + 0.5) * width_; }
+  /**
+   * \param[in] bin Index of the bin.
+   * \return Sum of the weights in the bin.
+   */
+  double content(int bin) const { return contents_[bin]; }
+
+ private:
+  /// Lower edge of the first bin
+  double min_;
+  /// Width of the bins
+  double width_;
+  /// Sum of the weights in every bin
+  std::vector<double> contents_;
+};
+
+/**
+ * \ingroup output
+ *
+ * \brief Interface of the observables computed by the AnalysisOutput.
+ *
+ * An observable is filled from the particles at the end of every event and/or
+ * from every interaction and writes its result once at the end of the run.
+ * Observables only see the simulation through these hooks, such that new ones
+ * can be added by implementing this interface and registering them in
+ * AnalysisOutput::create_observable.
+ */
+class AnalysisObservable {
+ public:
+  virtual ~AnalysisObservable() = default;
+
+  /// \return Name of the observable, used for the name of the output file.
+  virtual std::string name() const = 0;
+
+  /**
+   * Fill the observable with the final particles of an event.
+   * \param[in] particles Final particles of the event.
+   * \param[in] info Event info, see \ref event_info
+   */
+  virtual void at_eventend(const Particles &particles, const EventInfo &info) {
+    SMASH_UNUSED(particles);
+    SMASH_UNUSED(info);
+  }
+
+  /**
+   * Fill the observable with an interaction.
+   * \param[in] interaction Interaction that was performed.
+   */
+  virtual void at_interaction(const InteractionRecord &interaction) {
+    SMASH_UNUSED(interaction);
+  }
+
+  /**
+   * Write the normalized result.
+   * \param[in] file File to write to.
+   * \param[in] n_events Number of events the observable was filled with.
+   */
+  virtual void write(std::FILE *file, int n_events) const = 0;
+};
+
+/**
+ * \ingroup output
+ *
+ * Rapidity spectra dN/dy and transverse momentum spectra dN/dpT at
+ * midrapidity of identified hadrons.
+ */
+class IdentifiedSpectra : public AnalysisObservable {
+ public:
+  /**
+   * \param[in] par Binning and species.
+   */
+  explicit IdentifiedSpectra(const AnalysisParameters &par);
+  std::string name() const override { return "spectra"; }
+  void at_eventend(const Particles &particles, const EventInfo &info) override;
+  void write(std::FILE *file, int n_events) const override;
+
+ private:
+  /// Identified species
+  std::vector<PdgCode> species_;
+  /// Rapidity window of the pT spectra
+  double rapidity_cut_;
+  /// Rapidity spectra, one per species
+  std::vector<UniformHistogram> dN_dy_;
+  /// Transverse momentum spectra, one per species
+  std::vector<UniformHistogram> dN_dpT_;
+};
+
+/**
+ * \ingroup output
+ *
+ * Anisotropic flow coefficients \f$v_n = \langle \cos(n\phi) \rangle\f$ of
+ * identified hadrons at midrapidity, with respect to the reaction plane,
+ * which is the x-z plane in SMASH, as function of the transverse momentum.
+ */
+class FlowCoefficients : public AnalysisObservable {
+ public:
+  /**
+   * \param[in] par Binning, species and harmonics.
+   */
+  explicit FlowCoefficients(const AnalysisParameters &par);
+  std::string name() const override { return "flow"; }
+  void at_eventend(const Particles &particles, const EventInfo &info) override;
+  void write(std::FILE *file, int n_events) const override;
+
+ private:
+  /// Identified species
+  std::vector<PdgCode> species_;
+  /// Rapidity window
+  double rapidity_cut_;
+  /// Highest harmonic
+  int max_harmonic_;
+  /// Number of particles per pT bin, one histogram per species
+  std::vector<UniformHistogram> counts_;
+  /**
+   * Sums of \f$\cos(n\phi)\f$ and \f$\cos^2(n\phi)\f$ per pT bin, for every
+   * species and harmonic (index species * max_harmonic + n - 1)
+   */
+  std::vector<UniformHistogram> cos_sum_, cos2_sum_;
+};
+
+/**
+ * \ingroup output
+ *
+ * Event-by-event distribution of the number of charged hadrons at
+ * midrapidity.
+ */
+class MultiplicityDistribution : public AnalysisObservable {
+ public:
+  /**
+   * \param[in] par Rapidity window.
+   */
+  explicit MultiplicityDistribution(const AnalysisParameters &par);
+  std::string name() const override { return "multiplicity"; }
+  void at_eventend(const Particles &particles, const EventInfo &info) override;
+  void write(std::FILE *file, int n_events) const override;
+
+ private:
+  /// Rapidity window
+  double rapidity_cut_;
+  /// Number of events for every multiplicity
+  std::map<int, int> events_;
+};
+
+/**
+ * \ingroup output
+ *
+ * Number of interactions per time, split into elastic scatterings, inelastic
+ * scatterings, string excitations and decays.
+ */
+class CollisionRate : public AnalysisObservable {
+ public:
+  /**
+   * \param[in] par Time binning.
+   */
+  explicit CollisionRate(const AnalysisParameters &par);
+  std::string name() const override { return "collision_rate"; }
+  void at_interaction(const InteractionRecord &interaction) override;
+  void write(std::FILE *file, int n_events) const override;
+
+ private:
+  /// Histograms of the execution times of all, elastic, inelastic, string
+  /// and decay processes
+  std::vector<UniformHistogram> rates_;
+};
+
+/**
+ * \ingroup output
+ *
+ * \brief Computes observables during the run instead of writing particles.
+ *
+ * The observables are filled at the end of every event and at every
+ * interaction, and only the results are written at the end of the run. This
+ * avoids writing and reading the full particle or collision output if only
+ * histograms are needed. Every ensemble is treated as an independent event.
+ */
+class AnalysisOutput : public OutputInterface {
+ public:
+  /**
+   * Create the analysis output.
+   *
+   * \param[in] path Output path.
+   * \param[in] name Name of the output.
+   * \param[in] out_par Output parameters, the observables are configured in
+   *            OutputParameters::analysis.
+   * \throws invalid_argument for unknown observables.
+   */
+  AnalysisOutput(const bf::path &path, const std::string &name,
+                 const OutputParameters &out_par);
+
+  /**
+   * Close the files. They keep their ".unfinished" name if at_runend() was
+   * not called.
+   */
+  ~AnalysisOutput();
+
+  /**
+   * Fill the observables with the final particles.
+   * \param[in] particles Current list of particles.
+   * \param[in] event_number Number of event.
+   * \param[in] info Event info, see \ref event_info
+   */
+  void at_eventend(const Particles &particles, const int event_number,
+                   const EventInfo &info) override;
+
+  /**
+   * Fill the observables with interactions.
+   * \param[in] records Interactions that were performed.
+   */
+  void at_interactions(ConstSpan<InteractionRecord> records) override;
+
+  /// Write the results of all observables.
+  void at_runend() override;
+
+  /**
+   * Create a built-in observable.
+   *
+   * \param[in] name Name of the observable in the configuration.
+   * \param[in] par Parameters of the observables.
+   * \return The observable.
+   * \throws invalid_argument for unknown names.
+   */
+  static std::unique_ptr<AnalysisObservable> create_observable(
+      const std::string &name, const AnalysisParameters &par);
+
+ private:
+  /// Observables with the files their results are written to
+  std::vector<std::pair<std::unique_ptr<AnalysisObservable>,
+                        std::unique_ptr<RenamingFilePtr>>>
+      observables_;
+  /// Number of events, counting every ensemble as an event
+  int n_events_ = 0;
+  /// Whether the results were written
+  bool finished_ = false;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_ANALYSISOUTPUT_H_
@@ -10,8 +10,10 @@
 #ifndef SRC_INCLUDE_SMASH_BINARYOUTPUT_H_
 #define SRC_INCLUDE_SMASH_BINARYOUTPUT_H_
 
+#include <cstring>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <boost/numeric/conversion/cast.hpp>
 
@@ -25,8 +27,16 @@ namespace smash {
 /**
  * \ingroup output
  * Base class for SMASH binary output.
+ *
+ * The write functions encode the values into a buffer, which is written to
+ * the file with a single call once a block is finished and the buffer is
+ * full, and at the end of every event.
  */
 class BinaryOutputBase : public OutputInterface {
+ public:
+  /// Write the remaining buffered blocks.
+  ~BinaryOutputBase();
+
  protected:
   /**
    * Create binary output base.
@@ -35,9 +45,16 @@ class BinaryOutputBase : public OutputInterface {
    * \param[in] mode Is used to determine the file access mode.
    * \param[in] name Name of the output.
    * \param[in] extended_format Is the written output extended.
+   * \param[in] async_write Whether and how the file is written in a separate
+   *                        thread.
+   * \param[in] selection Written particles and fields. If fields are selected,
+   *                      the file has format variant 2 and lists them in the
+   *                      header.
    */
-  explicit BinaryOutputBase(const bf::path &path, const std::string &mode,
-                            const std::string &name, bool extended_format);
+  explicit BinaryOutputBase(
+      const bf::path &path, const std::string &mode, const std::string &name,
+      bool extended_format, const AsyncWriteParameters &async_write,
+      const OutputSelection &selection = OutputSelection());
 
   /**
    * Write byte to binary output.
@@ -67,25 +84,19 @@ class BinaryOutputBase : public OutputInterface {
    * Write integer (32 bit) to binary output.
    * \param[in] x Value to be written.
    */
-  void write(const std::int32_t x) {
-    std::fwrite(&x, sizeof(x), 1, file_.get());
-  }
+  void write(const std::int32_t x) { append(&x, sizeof(x)); }
 
   /**
    * Write unsigned integer (32 bit) to binary output.
    * \param[in] x Value to be written.
    */
-  void write(const std::uint32_t x) {
-    std::fwrite(&x, sizeof(x), 1, file_.get());
-  }
+  void write(const std::uint32_t x) { append(&x, sizeof(x)); }
 
   /**
    * Write unsigned integer (16 bit) to binary output.
    * \param[in] x Value to be written.
    */
-  void write(const std::uint16_t x) {
-    std::fwrite(&x, sizeof(x), 1, file_.get());
-  }
+  void write(const std::uint16_t x) { append(&x, sizeof(x)); }
 
   /**
    * Write a std::size_t to binary output.
@@ -94,7 +105,8 @@ class BinaryOutputBase : public OutputInterface {
   void write(const size_t x) { write(boost::numeric_cast<uint32_t>(x)); }
 
   /**
-   * Write particle data of each particle in particles to binary output.
+   * Write particle data of each selected particle in particles to binary
+   * output.
    * \param[in] particles List of particles, whose data is to be written.
    */
   void write(const Particles &particles);
@@ -103,7 +115,7 @@ class BinaryOutputBase : public OutputInterface {
    * Write each particle data entry to binary output.
    * \param[in] particles List of particles, whose data is to be written.
    */
-  void write(const ParticleList &particles);
+  void write(ParticleSpan particles);
 
   /**
    * Write particle data to binary output.
@@ -111,10 +123,45 @@ class BinaryOutputBase : public OutputInterface {
    */
   void write_particledata(const ParticleData &p);
 
+  /**
+   * Mark the end of an output block. The buffer is written to the file, if
+   * it exceeds block_buffer_size_.
+   */
+  void finish_block() {
+    if (buffer_.size() >= block_buffer_size_) {
+      write_buffer();
+    }
+  }
+
+  /// Write the buffer to the file, if not empty, and flush the file.
+  void flush();
+
   /// Binary particles output file path
   RenamingFilePtr file_;
 
+  /// Written particles, interactions and fields
+  const OutputSelection selection_;
+
  private:
+  /**
+   * Append raw bytes to the buffer.
+   * \param[in] data Bytes to be written.
+   * \param[in] size Number of bytes.
+   */
+  void append(const void *data, size_t size) {
+    const size_t old_size = buffer_.size();
+    buffer_.resize(old_size + size);
+    std::memcpy(buffer_.data() + old_size, data, size);
+  }
+
+  /// Write the whole buffer to the file with a single call and clear it.
+  void write_buffer();
+
+  /// Size in bytes above which the buffer is written after a finished block
+  static constexpr size_t block_buffer_size_ = 1 << 16;
+  /// Encoded blocks not yet written to the file
+  std::vector<char> buffer_;
+
   /// Binary file format version number
   const uint16_t format_version_ = 7;
   /// Option for extended output
@@ -166,12 +213,11 @@ class BinaryOutputCollisions : public BinaryOutputBase {
                    const EventInfo &event) override;
 
   /**
-   * Writes an interaction block, including information about the incoming and
-   * outgoing particles, to the binary output.
-   * \param[in] action Action that holds the information of the interaction.
-   * \param[in] density Density at the interaction point.
+   * Writes an interaction block for every interaction, including information
+   * about the incoming and outgoing particles, to the binary output.
+   * \param[in] records Records of the interactions.
    */
-  void at_interaction(const Action &action, const double density) override;
+  void at_interactions(ConstSpan<InteractionRecord> records) override;
 
  private:
   /// Write initial and final particles additonally to collisions?
@@ -284,9 +330,10 @@ class BinaryOutputInitialConditions : public BinaryOutputBase {
    * Writes particles that are removed when crossing the hypersurface to the
    * output. Note that the particle information is written as a particle block,
    * not as an interaction block.
-   * \param[in] action Action that holds the information of the interaction.
+   * \param[in] records Records of the interactions, of which only the
+   *            hypersurface crossings are written.
    */
-  void at_interaction(const Action &action, const double) override;
+  void at_interactions(ConstSpan<InteractionRecord> records) override;
 };
 
 }  // namespace smash
@@ -10,8 +10,11 @@
 #ifndef SRC_INCLUDE_SMASH_BREMSSTRAHLUNGACTION_H_
 #define SRC_INCLUDE_SMASH_BREMSSTRAHLUNGACTION_H_
 
+#include <memory>
 #include <utility>
+#include <vector>
 
+#include "interpolation2D.h"
 #include "scatteraction.h"
 
 namespace smash {
@@ -135,6 +138,21 @@ class BremsstrahlungAction : public ScatterAction {
     return bremsstrahlung_reaction_type(in) != ReactionType::no_reaction;
   }
 
+  /**
+   * Create interpolation objects for tabularized cross sections:
+   * total cross section, differential dSigma/dk, differential dSigma/dtheta.
+   * They are created on first use with the default accuracy, if this is not
+   * called before.
+   *
+   * \param[in] accuracy If positive, the bicubic splines of the differential
+   *                     cross sections are resampled on uniform grids, which
+   *                     deviate from them by less than this fraction of the
+   *                     largest value at the same energy, see
+   *                     make_brems_interpolation(). Otherwise the splines
+   *                     are used.
+   */
+  static void create_interpolations(double accuracy);
+
  private:
   /**
    * Holds the bremsstrahlung branch. As of now, this will always
@@ -167,12 +185,6 @@ class BremsstrahlungAction : public ScatterAction {
   /// Sampled value of theta (angle of the photon)
   double theta_;
 
-  /**
-   * Create interpolation objects for tabularized cross sections:
-   * total cross section, differential dSigma/dk, differential dSigma/dtheta
-   */
-  void create_interpolations();
-
   /**
    * Computes the total cross section of the bremsstrahlung process.
    *
@@ -190,6 +202,27 @@ class BremsstrahlungAction : public ScatterAction {
   std::pair<double, double> brems_diff_cross_sections();
 };
 
+/**
+ * Interpolate a tabulated bremsstrahlung differential cross section by a
+ * bicubic spline. If an accuracy is given, the spline is resampled on a
+ * uniform grid, such that it can be evaluated without searching the grid
+ * cells. The grid starts with the smallest spacing of the tabulated energies
+ * and half the spacing of the photon momenta or angles and is refined by up
+ * to a factor of four, until it deviates from the spline in the middle of its
+ * cells by less than the accuracy times the largest value at the same energy.
+ *
+ * \param[in] x Tabulated photon momenta or angles.
+ * \param[in] sqrts Tabulated center-of-mass energies [GeV].
+ * \param[in] dsigma Tabulated differential cross section.
+ * \param[in] logarithmic_x Whether x is spaced logarithmically.
+ * \param[in] accuracy Accuracy of the uniform grid. If it is not positive,
+ *                     the spline is returned.
+ * \return Interpolation of the differential cross section.
+ */
+std::unique_ptr<InterpolateData2D> make_brems_interpolation(
+    const std::vector<double> &x, const std::vector<double> &sqrts,
+    const std::vector<double> &dsigma, bool logarithmic_x, double accuracy);
+
 }  // namespace smash
 
 #endif  // SRC_INCLUDE_SMASH_BREMSSTRAHLUNGACTION_H_
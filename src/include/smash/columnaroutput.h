@@ -0,0 +1,261 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_COLUMNAROUTPUT_H_
+#define SRC_INCLUDE_SMASH_COLUMNAROUTPUT_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "file.h"
+#include "forwarddeclarations.h"
+#include "outputinterface.h"
+#include "outputparameters.h"
+
+namespace smash {
+
+/// Type of the values stored in a column of the columnar output
+enum class ColumnType : char {
+  /// 8 byte floating point numbers
+  Double = 'd',
+  /// 4 byte signed integers
+  Int32 = 'i',
+};
+
+/// Name and type of a column of the columnar output
+using ColumnDescription = std::pair<std::string, ColumnType>;
+
+/**
+ * Entry of the index at the end of a columnar output file, describing one
+ * chunk, i.e. one particle list written at a given time.
+ */
+struct ColumnarChunkInfo {
+  /// Position of the chunk in the file
+  std::uint64_t offset;
+  /// Number of the event
+  std::int32_t event_number;
+  /// Number of particles, i.e. number of values in every column
+  std::uint32_t n_particles;
+  /// Time at which the particle list was written
+  double time;
+  /// Impact parameter of the event
+  double impact_parameter;
+  /// Whether there was no interaction between projectile and target
+  bool empty_event;
+};
+
+/**
+ * \ingroup output
+ *
+ * \brief Writes particle lists column-wise into a seekable binary file.
+ *
+ * Every particle list is stored as one chunk, in which all values of one
+ * particle property are contiguous. An index at the end of the file gives the
+ * position of every chunk, such that single events or single columns can be
+ * read without scanning the file, see ColumnarReader.
+ *
+ * The particle lists are written at the same moments as for the binary
+ * particles output, controlled by the Only_Final option.
+ */
+class ColumnarOutput : public OutputInterface {
+ public:
+  /**
+   * Create columnar particle output.
+   *
+   * \param[in] path Output path.
+   * \param[in] name Name of the output.
+   * \param[in] out_par A structure containing the parameters of the output.
+   */
+  ColumnarOutput(const bf::path &path, const std::string &name,
+                 const OutputParameters &out_par);
+
+  /**
+   * Close the file. It keeps its ".unfinished" name if at_runend() was not
+   * called, since it has no index then.
+   */
+  ~ColumnarOutput();
+
+  /**
+   * Writes the initial particle list of an event.
+   * \param[in] particles Current list of all particles.
+   * \param[in] event_number Number of event.
+   * \param[in] event Event info, see \ref event_info
+   */
+  void at_eventstart(const Particles &particles, const int event_number,
+                     const EventInfo &event) override;
+
+  /**
+   * Writes the final particle list of an event.
+   * \param[in] particles Current list of particles.
+   * \param[in] event_number Number of event.
+   * \param[in] event Event info, see \ref event_info
+   */
+  void at_eventend(const Particles &particles, const int event_number,
+                   const EventInfo &event) override;
+
+  /**
+   * Writes the particle list at each output time.
+   * \param[in] particles Current list of particles.
+   * \param[in] clock Unused, needed since inherited.
+   * \param[in] dens_param Unused, needed since inherited.
+   * \param[in] event Event info, see \ref event_info.
+   */
+  void at_intermediate_time(const Particles &particles,
+                            const std::unique_ptr<Clock> &clock,
+                            const DensityParameters &dens_param,
+                            const EventInfo &event) override;
+
+  /// Writes the index at the end of the file.
+  void at_runend() override;
+
+  /**
+   * \param[in] extended Whether the extended particle information is written.
+   * \return Names and types of the columns, in the order of the file.
+   */
+  static std::vector<ColumnDescription> columns(bool extended);
+
+  /// Columnar file format version number
+  static constexpr std::uint16_t format_version = 1;
+
+ private:
+  /**
+   * Encode the particle list column by column and write it as one chunk.
+   * \param[in] particles Particles to be written.
+   * \param[in] event_number Number of the event.
+   * \param[in] event Event info, see \ref event_info
+   */
+  void write_chunk(const Particles &particles, const int event_number,
+                   const EventInfo &event);
+
+  /**
+   * Append raw bytes to the buffer.
+   * \param[in] data Bytes to be written.
+   * \param[in] size Number of bytes.
+   */
+  void append(const void *data, size_t size);
+
+  /// Write the buffer to the file and keep track of the file position.
+  void write_buffer();
+
+  /// Output file
+  RenamingFilePtr file_;
+  /// Whether the extended particle information is written
+  const bool extended_;
+  /// Whether final- or initial-state particles should be written
+  const OutputOnlyFinal only_final_;
+  /// Written particles and columns
+  const OutputSelection selection_;
+  /// Particle fields of the columns, in the order of the file
+  const std::vector<ParticleField> fields_;
+  /// Particles of the current chunk accepted by the selection
+  std::vector<const ParticleData *> selected_;
+  /// Number of the current event
+  int current_event_ = 0;
+  /// Number of bytes written to the file so far
+  std::uint64_t position_ = 0;
+  /// Encoded data not yet written to the file
+  std::vector<char> buffer_;
+  /// Index of all chunks written so far
+  std::vector<ColumnarChunkInfo> index_;
+  /// Whether the index was written
+  bool finished_ = false;
+};
+
+/**
+ * Reads files written by ColumnarOutput.
+ *
+ * Only the header and the index are read on construction. Columns of single
+ * chunks are read on request, seeking directly to their position.
+ */
+class ColumnarReader {
+ public:
+  /**
+   * Open a columnar output file and read its index.
+   *
+   * \param[in] path Path of the file.
+   * \throws runtime_error if the file cannot be opened, is not a columnar
+   *         output file or was not finished.
+   */
+  explicit ColumnarReader(const bf::path &path);
+
+  /// \return Whether the file contains the extended particle information.
+  bool extended() const { return extended_; }
+
+  /// \return Names and types of the columns in the file.
+  const std::vector<ColumnDescription> &columns() const { return columns_; }
+
+  /// \return Index entries of all chunks, in the order they were written.
+  const std::vector<ColumnarChunkInfo> &chunks() const { return chunks_; }
+
+  /**
+   * \param[in] event_number Number of the event.
+   * \return Indices of the chunks belonging to the given event.
+   */
+  std::vector<size_t> chunks_of_event(int event_number) const;
+
+  /**
+   * Read a column of floating point numbers.
+   *
+   * \param[in] chunk Index of the chunk.
+   * \param[in] column Name of the column, e.g. "px".
+   * \return Values of the column, one per particle.
+   * \throws invalid_argument if the chunk or the column do not exist or the
+   *         column does not hold floating point numbers.
+   */
+  std::vector<double> read_doubles(size_t chunk, const std::string &column);
+
+  /**
+   * Read a column of integers.
+   *
+   * \param[in] chunk Index of the chunk.
+   * \param[in] column Name of the column, e.g. "pdg".
+   * \return Values of the column, one per particle.
+   * \throws invalid_argument if the chunk or the column do not exist or the
+   *         column does not hold integers.
+   */
+  std::vector<std::int32_t> read_ints(size_t chunk, const std::string &column);
+
+ private:
+  /**
+   * Seek to the start of a column.
+   *
+   * \param[in] chunk Index of the chunk.
+   * \param[in] column Name of the column.
+   * \param[in] type Expected type of the column.
+   * \throws invalid_argument if the chunk or the column do not exist or the
+   *         column is not of the expected type.
+   */
+  void seek_column(size_t chunk, const std::string &column, ColumnType type);
+
+  /**
+   * Read raw bytes at the current position.
+   * \param[out] data Destination.
+   * \param[in] size Number of bytes.
+   * \throws runtime_error if the file ends before.
+   */
+  void read(void *data, size_t size);
+
+  /// The file
+  FilePtr file_;
+  /// Whether the file contains the extended particle information
+  bool extended_;
+  /// Names and types of the columns
+  std::vector<ColumnDescription> columns_;
+  /// Index of all chunks
+  std::vector<ColumnarChunkInfo> chunks_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_COLUMNAROUTPUT_H_
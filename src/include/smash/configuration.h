@@ -299,6 +299,23 @@ namespace smash {
  * Number of fractional photons sampled per single perturbatively produced
  * photon.
  *
+ * \key Tabulation_Accuracy (double, optional, default = 0.0):\n
+ * Relative accuracy of the tabulated cross sections of the photon producing
+ * scatterings. If positive, the total and differential cross sections are
+ * tabulated at the start and interpolated, where the interpolation reaches
+ * this accuracy in the middle of the grid cells. For the differential cross
+ * sections it refers to their average over Mandelstam-t. Elsewhere the cross
+ * sections are computed from the analytic expressions, which are always used
+ * for zero.
+ *
+ * \key Bremsstrahlung_Tabulation_Accuracy (double, optional, default = 0.0):\n
+ * Accuracy of the differential cross sections of the bremsstrahlung
+ * processes. By default they are interpolated by bicubic splines of their
+ * tables. If positive, the splines are resampled at the start on uniform
+ * grids, which are faster to evaluate. The grids are refined until they
+ * deviate from the splines by less than this fraction of the largest
+ * differential cross section at the same energy.
+ *
  * Remember to also activate the photon output in the output section.
  *
  * \n
@@ -87,9 +87,9 @@ const std::initializer_list<double> BREMS_THETA = {
 ///@{
 static std::unique_ptr<InterpolateDataLinear<double>>
     pipi_pipi_opp_interpolation = nullptr;
-static std::unique_ptr<InterpolateData2DSpline>
+static std::unique_ptr<InterpolateData2D>
     pipi_pipi_opp_dsigma_dk_interpolation = nullptr;
-static std::unique_ptr<InterpolateData2DSpline>
+static std::unique_ptr<InterpolateData2D>
     pipi_pipi_opp_dsigma_dtheta_interpolation = nullptr;
 ///@}
 
@@ -8967,9 +8967,9 @@ const std::initializer_list<double> BREMS_PIPI_PIPI_OPP_DIFF_SIG_THETA = {
 ///@{
 static std::unique_ptr<InterpolateDataLinear<double>>
     pipi_pipi_same_interpolation = nullptr;
-static std::unique_ptr<InterpolateData2DSpline>
+static std::unique_ptr<InterpolateData2D>
     pipi_pipi_same_dsigma_dk_interpolation = nullptr;
-static std::unique_ptr<InterpolateData2DSpline>
+static std::unique_ptr<InterpolateData2D>
     pipi_pipi_same_dsigma_dtheta_interpolation = nullptr;
 ///@}
 
@@ -18752,9 +18752,9 @@ const std::initializer_list<double> BREMS_PIPI_PIPI_SAME_DIFF_SIG_THETA = {
 ///@{
 static std::unique_ptr<InterpolateDataLinear<double>>
     pipi0_pipi0_interpolation = nullptr;
-static std::unique_ptr<InterpolateData2DSpline>
+static std::unique_ptr<InterpolateData2D>
     pipi0_pipi0_dsigma_dk_interpolation = nullptr;
-static std::unique_ptr<InterpolateData2DSpline>
+static std::unique_ptr<InterpolateData2D>
     pipi0_pipi0_dsigma_dtheta_interpolation = nullptr;
 ///@}
 
@@ -27637,9 +27637,9 @@ const std::initializer_list<double> BREMS_PIPI0_PIPI0_DIFF_SIG_THETA = {
 ///@{
 static std::unique_ptr<InterpolateDataLinear<double>>
     pipi_pi0pi0_interpolation = nullptr;
-static std::unique_ptr<InterpolateData2DSpline>
+static std::unique_ptr<InterpolateData2D>
     pipi_pi0pi0_dsigma_dk_interpolation = nullptr;
-static std::unique_ptr<InterpolateData2DSpline>
+static std::unique_ptr<InterpolateData2D>
     pipi_pi0pi0_dsigma_dtheta_interpolation = nullptr;
 ///@}
 
@@ -35880,9 +35880,9 @@ const std::initializer_list<double> BREMS_PIPI_PI0PI0_DIFF_SIG_THETA = {
 ///@{
 static std::unique_ptr<InterpolateDataLinear<double>>
     pi0pi0_pipi_interpolation = nullptr;
-static std::unique_ptr<InterpolateData2DSpline>
+static std::unique_ptr<InterpolateData2D>
     pi0pi0_pipi_dsigma_dk_interpolation = nullptr;
-static std::unique_ptr<InterpolateData2DSpline>
+static std::unique_ptr<InterpolateData2D>
     pi0pi0_pipi_dsigma_dtheta_interpolation = nullptr;
 ///@}
 
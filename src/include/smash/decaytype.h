@@ -11,6 +11,7 @@
 #include <memory>
 #include <vector>
 
+#include "cxx14compat.h"
 #include "forwarddeclarations.h"
 #include "particletype.h"
 #include "tabulation.h"
@@ -79,6 +80,23 @@ class DecayType {
   virtual double in_width(double m0, double G0, double m, double m1,
                           double m2) const = 0;
 
+  /**
+   * \return the tabulation used to calculate the width, which is created when
+   *         the width is needed first, or nullptr if it was not created yet
+   *         or the width is not tabulated.
+   */
+  virtual const Tabulation *tabulation() const { return nullptr; }
+  /**
+   * Use the given tabulation to calculate the width instead of creating it,
+   * e.g. when restoring it from a cache. Decay types without a tabulation
+   * ignore it.
+   *
+   * \param[in] tabulation Tabulation previously returned by tabulation().
+   */
+  virtual void set_tabulation(const Tabulation &tabulation) const {
+    SMASH_UNUSED(tabulation);
+  }
+
  protected:
   /// final-state particles of the decay
   ParticleTypePtrList particle_types_;
@@ -204,6 +222,10 @@ class TwoBodyDecaySemistable : public TwoBodyDecay {
    */
   double in_width(double m0, double G0, double m, double m1,
                   double m2) const override;
+  const Tabulation *tabulation() const override { return tabulation_.get(); }
+  void set_tabulation(const Tabulation &tabulation) const override {
+    tabulation_ = make_unique<Tabulation>(tabulation);
+  }
 
  protected:
   double rho(double m) const override;
@@ -246,6 +268,10 @@ class TwoBodyDecayUnstable : public TwoBodyDecay {
   double width(double m0, double G0, double m) const override;
   double in_width(double m0, double G0, double m, double m1,
                   double m2) const override;
+  const Tabulation *tabulation() const override { return tabulation_.get(); }
+  void set_tabulation(const Tabulation &tabulation) const override {
+    tabulation_ = make_unique<Tabulation>(tabulation);
+  }
 
  protected:
   double rho(double m) const override;
@@ -342,6 +368,10 @@ class ThreeBodyDecayDilepton : public ThreeBodyDecay {
                            double m_other, ParticleTypePtr other,
                            ParticleTypePtr t);
   double width(double m0, double G0, double m) const override;
+  const Tabulation *tabulation() const override { return tabulation_.get(); }
+  void set_tabulation(const Tabulation &tabulation) const override {
+    tabulation_ = make_unique<Tabulation>(tabulation);
+  }
 
  protected:
   /// Tabulation of the resonance integrals.
@@ -9,6 +9,7 @@
 #ifndef SRC_INCLUDE_SMASH_DENSITY_H_
 #define SRC_INCLUDE_SMASH_DENSITY_H_
 
+#include <array>
 #include <iostream>
 #include <tuple>
 #include <typeinfo>
@@ -280,6 +281,158 @@ current_eckart(const ThreeVector &r, const Particles &plist,
                const DensityParameters &par, DensityType dens_type,
                bool compute_gradient, bool smearing);
 
+/**
+ * A cell list of particles for the evaluation of smeared densities at
+ * arbitrary points.
+ *
+ * The Gaussian smearing kernel vanishes beyond \f$ r_{\rm cut} \f$, so only
+ * particles closer than that to a point contribute to the density there.
+ * Particles are sorted into cells with an edge length of at least
+ * \f$ r_{\rm cut} \f$, which guarantees that all contributing particles are
+ * found in the cell containing the point and its 26 neighbors. This replaces
+ * the sum over all particles in current_eckart by a sum over the local
+ * neighborhood.
+ *
+ * The particles are copied upon construction, so the cell list is a snapshot
+ * which stays valid while the original particles are modified. They are
+ * stored ordered by cell in one contiguous list, such that the three
+ * neighboring cells along x form one contiguous range. Densities can be
+ * evaluated from one cell list by several threads concurrently.
+ */
+class DensityCellList {
+ public:
+  /**
+   * A range over the particles in the cells neighboring a given point. It
+   * behaves like a read-only container of ParticleData, so that it can be
+   * passed wherever a particle list is iterated.
+   */
+  class NeighborRange {
+   public:
+    /// A pair of pointers delimiting a contiguous range of particles
+    using Span = std::pair<const ParticleData *, const ParticleData *>;
+
+    /// Forward iterator over the particles of all spans of the range
+    class const_iterator {
+     public:
+      /**
+       * Construct an iterator pointing to particle \p p of span \p span.
+       *
+       * \param[in] range The range that is iterated.
+       * \param[in] span Index of the current span.
+       * \param[in] p Pointer to the current particle.
+       */
+      const_iterator(const NeighborRange *range, int span,
+                     const ParticleData *p)
+          : range_(range), span_(span), p_(p) {}
+      /// \return the current particle
+      const ParticleData &operator*() const { return *p_; }
+      /// \return pointer to the current particle
+      const ParticleData *operator->() const { return p_; }
+      /// Advance to the next particle, continuing with the next span if needed.
+      const_iterator &operator++() {
+        ++p_;
+        if (p_ == range_->spans_[span_].second) {
+          ++span_;
+          p_ = (span_ < range_->n_spans_) ? range_->spans_[span_].first
+                                          : nullptr;
+        }
+        return *this;
+      }
+      /// \return whether the two iterators point to different particles
+      bool operator!=(const const_iterator &other) const {
+        return p_ != other.p_;
+      }
+      /// \return whether the two iterators point to the same particle
+      bool operator==(const const_iterator &other) const {
+        return p_ == other.p_;
+      }
+
+     private:
+      /// The range that is iterated
+      const NeighborRange *range_;
+      /// Index of the current span
+      int span_;
+      /// Pointer to the current particle, nullptr at the end of the range
+      const ParticleData *p_;
+    };
+
+    /// \return iterator to the first particle in the range
+    const_iterator begin() const {
+      return const_iterator(this, 0, n_spans_ > 0 ? spans_[0].first : nullptr);
+    }
+    /// \return iterator past the last particle in the range
+    const_iterator end() const {
+      return const_iterator(this, n_spans_, nullptr);
+    }
+
+    /**
+     * Add a contiguous range of particles; empty spans are ignored.
+     *
+     * \param[in] first Pointer to the first particle of the span.
+     * \param[in] last Pointer past the last particle of the span.
+     */
+    void add_span(const ParticleData *first, const ParticleData *last) {
+      if (first != last) {
+        assert(n_spans_ < static_cast<int>(spans_.size()));
+        spans_[n_spans_++] = Span(first, last);
+      }
+    }
+
+   private:
+    /// Up to 3x3 contiguous x-rows of neighboring cells
+    std::array<Span, 9> spans_;
+    /// Number of non-empty spans
+    int n_spans_ = 0;
+  };
+
+  /**
+   * Sorts all particles contributing to the given density type into cells.
+   *
+   * \param[in] ensembles The particles of all ensembles.
+   * \param[in] par Density parameters, from which the cutoff radius is taken.
+   * \param[in] dens_type Only particles with a non-zero density factor for
+   *            this density type are stored.
+   */
+  DensityCellList(const std::vector<Particles> &ensembles,
+                  const DensityParameters &par, DensityType dens_type);
+
+  /**
+   * \param[in] r Point of interest [fm]
+   * \return the particles in the cell containing \p r and its neighbors, i.e.
+   *         a superset of all stored particles closer than
+   *         \f$ r_{\rm cut} \f$ to \p r.
+   */
+  NeighborRange neighbors(const ThreeVector &r) const;
+
+  /// \return Number of stored particles
+  std::size_t size() const { return particles_.size(); }
+
+ private:
+  /// Stored particles, ordered by cell index
+  ParticleList particles_;
+  /// Index of the first particle of each cell, with one extra entry at the end
+  std::vector<std::size_t> cell_begin_;
+  /// Coordinates of the corner of the first cell [fm]
+  std::array<double, 3> origin_ = {{0., 0., 0.}};
+  /// Cell lengths in x, y, z directions [fm]
+  std::array<double, 3> cell_length_ = {{1., 1., 1.}};
+  /// Number of cells in x, y, z directions
+  std::array<int, 3> n_cells_ = {{1, 1, 1}};
+};
+
+/**
+ * Convenience overload of current_eckart for the neighbors of \p r found in a
+ * DensityCellList, i.e. plist = cells.neighbors(r). The result is identical to
+ * the one from the full particle list, as long as smearing is on and the cell
+ * list was built for a density type covering \p dens_type.
+ */
+std::tuple<double, FourVector, ThreeVector, ThreeVector, FourVector, FourVector,
+           FourVector, FourVector>
+current_eckart(const ThreeVector &r,
+               const DensityCellList::NeighborRange &plist,
+               const DensityParameters &par, DensityType dens_type,
+               bool compute_gradient, bool smearing);
+
 /**
  * A class for time-efficient (time-memory trade-off) calculation of density
  * on the lattice. It holds six FourVectors - positive and negative
@@ -376,7 +529,7 @@ class DensityOnLattice {
    * \param[in] norm_factor Normalization factor
    * \return Net Eckart density on the local lattice \f$\rho\f$ [fm\f$^{-3}\f$]
    */
-  double rho(const double norm_factor = 1.0) {
+  double rho(const double norm_factor = 1.0) const {
     return (jmu_pos_.abs() - jmu_neg_.abs()) * norm_factor;
   }
 
@@ -386,7 +539,7 @@ class DensityOnLattice {
    * \param[in] norm_factor Normalization factor
    * \return \f$\vec{\nabla}\times\vec{j}\f$ [fm \f$^{-4}\f$]
    */
-  ThreeVector curl_vecj(const double norm_factor = 1.0) {
+  ThreeVector curl_vecj(const double norm_factor = 1.0) const {
     ThreeVector curl_vec_j = ThreeVector();
     curl_vec_j.set_x1(djmu_dxnu_[2].x3() - djmu_dxnu_[3].x2());
     curl_vec_j.set_x2(djmu_dxnu_[3].x1() - djmu_dxnu_[1].x3());
@@ -402,7 +555,7 @@ class DensityOnLattice {
    * \param[in] norm_factor Normalization factor
    * \return \f$\vec{\nabla} j^0\f$ [fm \f$^{-4}\f$]
    */
-  ThreeVector grad_j0(const double norm_factor = 1.0) {
+  ThreeVector grad_j0(const double norm_factor = 1.0) const {
     ThreeVector j0_grad = ThreeVector();
     for (int i = 1; i < 4; i++) {
       j0_grad[i - 1] = djmu_dxnu_[i].x0() * norm_factor;
@@ -416,7 +569,7 @@ class DensityOnLattice {
    * \param[in] norm_factor Normalization factor
    * \return \f$\partial_t \vec j\f$ [fm \f$^{-4}\f$]
    */
-  ThreeVector dvecj_dt(const double norm_factor = 1.0) {
+  ThreeVector dvecj_dt(const double norm_factor = 1.0) const {
     return djmu_dxnu_[0].threevec() * norm_factor;
   }
 
@@ -26,6 +26,7 @@
 #include "grandcan_thermalizer.h"
 #include "grid.h"
 #include "hypersurfacecrossingaction.h"
+#include "interactionrecord.h"
 #include "outputparameters.h"
 #include "pauliblocking.h"
 #include "potential_globals.h"
@@ -37,7 +38,9 @@
 #include "stringprocess.h"
 #include "thermalizationaction.h"
 // Output
+#include "analysisoutput.h"
 #include "binaryoutput.h"
+#include "columnaroutput.h"
 #ifdef SMASH_USE_HEPMC
 #include "hepmcoutput.h"
 #endif
@@ -284,12 +287,28 @@ class Experiment : public ExperimentBase {
   void run_time_evolution_timestepless(Actions &actions, int i_ensemble,
                                        double end_time_propagation);
 
+  /**
+   * Pass the interactions performed since the last call to all outputs
+   * except for the dilepton and photon outputs and clear them.
+   */
+  void write_interactions();
+
   /// Intermediate output during an event
   void intermediate_output();
 
   /// Recompute potentials on lattices if necessary.
   void update_potentials();
 
+  /**
+   * Refits origin and number of cells of the lattices, which are updated every
+   * time step, to the current particle distribution. The cell sizes are kept
+   * and the values of the cells are carried over, such that time derivatives
+   * stay available. Refitting is only done if particles (together with their
+   * smearing range) left the lattices or if the lattices became much larger
+   * than needed.
+   */
+  void adapt_lattices();
+
   /**
    * Calculate the minimal size for the grid cells such that the
    * ScatterActionsFinder will find all collisions within the maximal
@@ -353,6 +372,19 @@ class Experiment : public ExperimentBase {
   /// The Photon output
   OutputPtr photon_output_;
 
+  /**
+   * Interactions performed since they were last passed to the outputs. They
+   * are written in one batch at the end of every propagation interval.
+   */
+  InteractionBatch interaction_records_;
+
+  /**
+   * Whether any output receives interactions, i.e. an output which is neither
+   * the dilepton nor the photon output. Otherwise interactions are not
+   * collected in \ref interaction_records_.
+   */
+  bool has_interaction_outputs_ = false;
+
   /**
    * Whether the projectile and the target collided.
    * One value for each ensemble.
@@ -478,6 +510,12 @@ class Experiment : public ExperimentBase {
   /// point by point, in any format
   bool printout_full_lattice_any_td_ = false;
 
+  /// Whether the lattices for potentials follow the particle distribution
+  bool adaptive_lattice_ = false;
+
+  /// Maximal number of cells of an adaptive lattice in x, y, z directions
+  std::array<int, 3> adaptive_max_n_cells_;
+
   /// Instance of class used for forced thermalization
   std::unique_ptr<GrandCanThermalizer> thermalizer_;
 
@@ -645,9 +683,9 @@ void Experiment<Modus>::create_output(const std::string &format,
   logg[LExperiment].info() << "Adding output " << content << " of format "
                            << format << std::endl;
 
-  if (format == "VTK" && content == "Particles") {
-    outputs_.emplace_back(
-        make_unique<VtkOutput>(output_path, content, out_par));
+  if ((format == "VTK" || format == "VTK_Binary") && content == "Particles") {
+    outputs_.emplace_back(make_unique<VtkOutput>(output_path, content, out_par,
+                                                 format == "VTK_Binary"));
   } else if (format == "Root") {
 #ifdef SMASH_USE_ROOT
     if (content == "Initial_Conditions") {
@@ -673,6 +711,12 @@ void Experiment<Modus>::create_output(const std::string &format,
       outputs_.emplace_back(make_unique<BinaryOutputInitialConditions>(
           output_path, content, out_par));
     }
+  } else if (content == "Analysis" && format == "ASCII") {
+    outputs_.emplace_back(
+        make_unique<AnalysisOutput>(output_path, content, out_par));
+  } else if (format == "Columnar" && content == "Particles") {
+    outputs_.emplace_back(
+        make_unique<ColumnarOutput>(output_path, content, out_par));
   } else if (format == "Oscar1999" || format == "Oscar2013") {
     outputs_.emplace_back(
         create_oscar_output(format, content, output_path, out_par));
@@ -691,10 +735,11 @@ void Experiment<Modus>::create_output(const std::string &format,
     outputs_.emplace_back(make_unique<ThermodynamicLatticeOutput>(
         output_path, content, out_par, printout_full_lattice_ascii_td_,
         printout_full_lattice_binary_td_));
-  } else if (content == "Thermodynamics" && format == "VTK") {
+  } else if (content == "Thermodynamics" &&
+             (format == "VTK" || format == "VTK_Binary")) {
     printout_lattice_td_ = true;
-    outputs_.emplace_back(
-        make_unique<VtkOutput>(output_path, content, out_par));
+    outputs_.emplace_back(make_unique<VtkOutput>(output_path, content, out_par,
+                                                 format == "VTK_Binary"));
   } else if (content == "Initial_Conditions" && format == "ASCII") {
     outputs_.emplace_back(
         make_unique<ICOutput>(output_path, "SMASH_IC", out_par));
@@ -716,9 +761,10 @@ void Experiment<Modus>::create_output(const std::string &format,
     logg[LExperiment].error(
         "HepMC output requested, but HepMC support not compiled in");
 #endif
-  } else if (content == "Coulomb" && format == "VTK") {
-    outputs_.emplace_back(
-        make_unique<VtkOutput>(output_path, "Fields", out_par));
+  } else if (content == "Coulomb" &&
+             (format == "VTK" || format == "VTK_Binary")) {
+    outputs_.emplace_back(make_unique<VtkOutput>(output_path, "Fields", out_par,
+                                                 format == "VTK_Binary"));
   } else if (content == "Rivet") {
 #ifdef SMASH_USE_RIVET
     // flag to ensure that the Rivet format has not been already assigned
@@ -906,6 +952,23 @@ ExperimentParameters create_experiment_parameters(Configuration config);
  * relationship between the width and lifetime of resonances. Note as well that
  * in such gases, using a value of 0.0 is known to make SMASH hang; it is
  * recommended to use a small non-zero value instead in these cases.
+ *
+ * \key Tabulated_Resonance_Masses (bool, optional, default = \key false): \n
+ * \li \key true - The mass of a resonance produced together with a stable
+ *                 particle is drawn by inverting its cumulative distribution,
+ *                 which is tabulated on first use for every stable particle
+ *                 mass and angular momentum, up to 3 GeV above threshold.
+ * \li \key false - The mass is drawn by rejection sampling from a
+ *                  Cauchy distribution.
+ *
+ * \key Width_Tabulation_Accuracy (double, optional, default = 0.0): \n
+ * If positive, the mass-dependent total widths of all resonances, and with
+ * them their spectral functions, are interpolated linearly on an adaptive mass
+ * grid, which is computed at startup (and stored with the tabulations of the
+ * resonance integrals). The grid reaches 5 GeV above the pole mass and is
+ * refined until the interpolation error is below the given fraction of the
+ * width at the pole mass. If zero, the widths are computed from the partial
+ * widths of all decay modes in every evaluation.
 
  * \key Strings_with_Probability (bool, optional, default = \key true): \n
  * \li \key true - String processes are triggered according to a probability
@@ -992,6 +1055,17 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
     n_fractional_photons_ =
         config.take({"Collision_Term", "Photons", "Fractional_Photons"}, 100);
   }
+  if (photons_switch_) {
+    const double accuracy = config.take(
+        {"Collision_Term", "Photons", "Tabulation_Accuracy"}, 0.);
+    ScatterActionPhoton::tabulate_cross_sections(accuracy);
+  }
+  if (bremsstrahlung_switch_) {
+    const double accuracy = config.take(
+        {"Collision_Term", "Photons", "Bremsstrahlung_Tabulation_Accuracy"},
+        0.);
+    BremsstrahlungAction::create_interpolations(accuracy);
+  }
   if (parameters_.two_to_one) {
     if (parameters_.res_lifetime_factor < 0.) {
       throw std::invalid_argument(
@@ -1063,6 +1137,8 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
   ParticleData::formation_power_ =
       config.take({"Collision_Term", "Power_Particle_Formation"},
                   modus_.sqrt_s_NN() >= 200. ? -1. : 1.);
+  ParticleType::tabulated_resonance_masses_ =
+      config.take({"Collision_Term", "Tabulated_Resonance_Masses"}, false);
 
   /*!\Userguide
    * \page input_general_
@@ -1135,8 +1211,8 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
    * - \b Particles  List of particles at regular time intervals in the
    *                 computational frame or (optionally) only at the event end.
    *   - Available formats: \ref format_oscar_particlelist,
-   *      \ref format_binary_, \ref format_root, \ref format_vtk, \ref
-   * output_hepmc_
+   *      \ref format_binary_, \ref format_columnar_, \ref format_root,
+   *      \ref format_vtk, \ref output_hepmc_
    * - \b Collisions List of interactions: collisions, decays, box wall
    *                 crossings and forced thermalizations. Information about
    *                 incoming, outgoing particles and the interaction itself
@@ -1158,6 +1234,10 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
    *                          \subpage input_ic for details
    *   - Available formats: \ref format_oscar_particlelist, \ref
    * IC_output_user_guide_
+   * - \b Analysis Histograms of spectra, flow, multiplicities and collision
+   *   rates filled during the run, see \subpage analysis_output_user_guide_
+   *   for details.
+   *    - Available formats: \ref analysis_output_user_guide_
    * - \b Rivet Run Rivet analysis on generated events and output
    *    results, see \subpage rivet_output_user_guide_ for details.
    *    - Available formats: \ref rivet_output_user_guide_
@@ -1179,6 +1259,11 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
    *   - Saves coordinates and momenta with the full double precision
    *   - General file structure is similar to \ref oscar_general_
    *   - Detailed description: \subpage format_binary_
+   * - \b "Columnar" - binary output storing particle properties column-wise
+   *   - Only for "Particles" content
+   *   - Single events and single columns can be read without reading the
+   *     whole file
+   *   - Detailed description: \subpage format_columnar_
    * - \b "Root" - binary output in the format used by ROOT software
    *     (http://root.cern.ch)
    *   - Even faster to read and write, requires less disk space
@@ -1188,11 +1273,18 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
    *   - This output can be opened by paraview to see the visulalization.
    *   - For "Particles" content \subpage format_vtk
    *   - For "Thermodynamics" content \subpage output_vtk_lattice_
+   * - \b "VTK_Binary" - same as "VTK", but the values are written in the
+   *     binary legacy VTK format
+   *   - Several times smaller and faster to write and to read than "VTK"
+   *   - Optionally in single precision, see \ref format_vtk and
+   *     \ref output_vtk_lattice_
    * - \b "ASCII" - a human-readable text-format table of values
-   *   - Used for "Thermodynamics", "Initial_Conditions" and "HepMC", see
+   *   - Used for "Thermodynamics", "Initial_Conditions", "Analysis" and
+   *     "HepMC", see
    * \subpage thermodyn_output_user_guide_
    * \subpage thermodyn_lattice_output_
    * \subpage IC_output_user_guide_
+   * \ref analysis_output_user_guide_
    * - \b "HepMC" - human-readble asciiv3 format see \ref
    * output_hepmc_ for details
    *
@@ -1345,6 +1437,11 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
       create_output(format, content, output_path, output_parameters);
     }
   }
+  for (const auto &output : outputs_) {
+    if (!output->is_dilepton_output() && !output->is_photon_output()) {
+      has_interaction_outputs_ = true;
+    }
+  }
 
   /* We can take away the Fermi motion flag, because the collider modus is
    * already initialized. We only need it when potentials are enabled, but we
@@ -1530,6 +1627,26 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
    * Include potential effects, since mean field potentials change the threshold
    * energies of the actions.
    *
+   * \key Adaptive (bool, optional, default = false): \n
+   * Let the lattices used for the potentials follow the particles. Every time
+   * step, origin and number of cells are refitted to cover the particles which
+   * contribute to the densities (baryons, and charged particles if the Coulomb
+   * potential is used; only participants with Output: Thermodynamics:
+   * Only_Participants) and their smearing range, if such particles left the
+   * lattice or if the lattice became more than twice as large as needed. The
+   * cell sizes given by \key Sizes and \key Cell_Number are kept, such that
+   * \key Sizes only needs to match the initial extent of the system. Cannot be
+   * combined with \key Periodic or the thermodynamic lattice output, which
+   * rely on a fixed lattice.
+   *
+   * \key Adaptive_Max_Cell_Number (array<int,3>, optional,
+   *                                default = 4 * \key Cell_Number): \n
+   * Maximal number of cells of an adaptive lattice in x, y, z directions. If
+   * the particles are spread further, the lattice is centered on their mean
+   * position and particles outside of it get their potentials from their
+   * neighbors directly. Must not be smaller than \key Cell_Number. Only read
+   * if \key Adaptive is true.
+   *
    * For information on the format of the lattice output see
    * \ref output_vtk_lattice_ or \ref thermodyn_lattice_output_. To configure
    * the thermodynamic output, see \ref input_output_options_.
@@ -1625,6 +1742,30 @@ Experiment<Modus>::Experiment(Configuration config, const bf::path &output_path)
         config.take({"Lattice", "Origin"}, origin_default);
     const bool periodic =
         config.take({"Lattice", "Periodic"}, periodic_default);
+    adaptive_lattice_ = config.take({"Lattice", "Adaptive"}, false);
+    if (adaptive_lattice_) {
+      const std::array<int, 3> max_n_default = {4 * n[0], 4 * n[1],
+                                                4 * n[2]};
+      adaptive_max_n_cells_ =
+          config.take({"Lattice", "Adaptive_Max_Cell_Number"}, max_n_default);
+      for (int i = 0; i < 3; i++) {
+        if (adaptive_max_n_cells_[i] < n[i]) {
+          throw std::invalid_argument(
+              "Lattice: Adaptive_Max_Cell_Number must not be smaller than "
+              "Lattice: Cell_Number.");
+        }
+      }
+    }
+    if (adaptive_lattice_ && periodic) {
+      throw std::invalid_argument(
+          "An adaptive lattice cannot be periodic. Please set "
+          "Lattice: Periodic: False or switch off Lattice: Adaptive.");
+    }
+    if (adaptive_lattice_ && printout_full_lattice_any_td_) {
+      throw std::invalid_argument(
+          "The thermodynamic lattice output needs a fixed lattice, it cannot "
+          "be combined with Lattice: Adaptive.");
+    }
 
     logg[LExperiment].info()
         << "Lattice is ON. Origin = (" << origin[0] << "," << origin[1] << ","
@@ -1813,10 +1954,39 @@ std::string format_measurements(const std::vector<Particles> &ensembles,
  */
 double calculate_mean_field_energy(
     const Potentials &potentials,
-    RectangularLattice<smash::DensityOnLattice> &jmu_B_lat,
+    const RectangularLattice<smash::DensityOnLattice> &jmu_B_lat,
     RectangularLattice<std::pair<ThreeVector, ThreeVector>> *em_lattice,
     const ExperimentParameters &parameters);
 
+/**
+ * Fit the geometry of an adaptive lattice to the particles which contribute
+ * to the densities on it, keeping the cell sizes. The lattice is refitted if
+ * such particles left it or if it became more than twice as large as needed.
+ * A margin of a quarter of the needed extent is left on each side. If more
+ * than the maximal number of cells would be needed in a direction, the
+ * lattice is limited to it and centered on the mean position of the
+ * contributing particles.
+ *
+ * \param[in] ensembles The simulated particles: one Particles object per
+ *            ensemble.
+ * \param[in] par Parameters of the density calculation, giving the smearing
+ *            range and whether only participants contribute.
+ * \param[in] include_charged Whether charged particles contribute (as for
+ *            the Coulomb potential); otherwise only baryons do.
+ * \param[in] cell_sizes Sizes of the lattice cells [fm].
+ * \param[in] max_n_cells Maximal number of cells in x, y, z directions.
+ * \param[in,out] origin Origin of the lattice [fm], updated on a refit.
+ * \param[in,out] n_cells Number of cells in x, y, z directions, updated on a
+ *                refit.
+ * \return Whether the lattice has to be refitted.
+ */
+bool fit_adaptive_lattice(const std::vector<Particles> &ensembles,
+                          const DensityParameters &par, bool include_charged,
+                          const std::array<double, 3> &cell_sizes,
+                          const std::array<int, 3> &max_n_cells,
+                          std::array<double, 3> &origin,
+                          std::array<int, 3> &n_cells);
+
 /**
  * Generate the EventInfo object which is passed to outputs_.
  *
@@ -1935,6 +2105,9 @@ void Experiment<Modus>::initialize_new_event() {
   logg[LExperiment].info() << hline;
   double E_mean_field = 0.0;
   if (potentials_) {
+    if (adaptive_lattice_) {
+      adapt_lattices();
+    }
     // update_potentials();
     // if (parameters.outputclock->current_time() == 0.0 )
     // using the lattice is necessary
@@ -1947,10 +2120,10 @@ void Experiment<Modus>::initialize_new_event() {
       // Because there was no lattice at t=-Delta_t, the time derivatives
       // drho_dt and dj^mu/dt at t=0 are huge, while they shouldn't be; we
       // overwrite the time derivative to zero by hand.
-      for (auto &node : *jmu_B_lat_) {
+      jmu_B_lat_->iterate_occupied([](DensityOnLattice &node, int) {
         node.overwrite_drho_dt_to_zero();
         node.overwrite_djmu_dt_to_zero();
-      }
+      });
       E_mean_field = calculate_mean_field_energy(*potentials_, *jmu_B_lat_,
                                                  EM_lat_.get(), parameters_);
     }
@@ -2103,15 +2276,8 @@ bool Experiment<Modus>::perform_action(Action &action, int i_ensemble) {
    * their x coordinates would be 0.1 and 9.9 fm and interaction point
    * position could be either at 10 fm or at 5 fm.
    */
-  for (const auto &output : outputs_) {
-    if (!output->is_dilepton_output() && !output->is_photon_output()) {
-      if (output->is_IC_output() &&
-          action.get_type() == ProcessType::HyperSurfaceCrossing) {
-        output->at_interaction(action, rho);
-      } else if (!output->is_IC_output()) {
-        output->at_interaction(action, rho);
-      }
-    }
+  if (has_interaction_outputs_) {
+    interaction_records_.add(action, rho);
   }
 
   // At every collision photons can be produced.
@@ -2396,6 +2562,21 @@ void Experiment<Modus>::run_time_evolution_timestepless(
   }
 
   propagate_and_shine(end_time_propagation, particles);
+  write_interactions();
+}
+
+template <typename Modus>
+void Experiment<Modus>::write_interactions() {
+  if (interaction_records_.empty()) {
+    return;
+  }
+  const ConstSpan<InteractionRecord> records = interaction_records_.records();
+  for (const auto &output : outputs_) {
+    if (!output->is_dilepton_output() && !output->is_photon_output()) {
+      output->at_interactions(records);
+    }
+  }
+  interaction_records_.clear();
 }
 
 template <typename Modus>
@@ -2547,6 +2728,9 @@ void Experiment<Modus>::intermediate_output() {
 template <typename Modus>
 void Experiment<Modus>::update_potentials() {
   if (potentials_) {
+    if (adaptive_lattice_) {
+      adapt_lattices();
+    }
     if (potentials_->use_symmetry() && jmu_I3_lat_ != nullptr) {
       update_lattice(jmu_I3_lat_.get(), old_jmu_auxiliary_.get(),
                      new_jmu_auxiliary_.get(), four_gradient_auxiliary_.get(),
@@ -2561,9 +2745,17 @@ void Experiment<Modus>::update_potentials() {
                      LatticeUpdate::EveryTimestep, DensityType::Baryon,
                      density_param_, ensembles_,
                      parameters_.labclock->timestep_duration(), true);
-      const size_t UBlattice_size = UB_lat_->size();
-      for (size_t i = 0; i < UBlattice_size; i++) {
-        auto jB = (*jmu_B_lat_)[i];
+      /* Potentials and forces vanish in empty cells, so only the occupied
+       * tiles of the baryon density lattice are updated. The isospin density
+       * stems from a subset of the baryons and occupies no other tiles. */
+      UB_lat_->reset();
+      FB_lat_->reset();
+      if (potentials_->use_symmetry() && jmu_I3_lat_ != nullptr) {
+        UI3_lat_->reset();
+        FI3_lat_->reset();
+      }
+      const DensityLattice *jmu_I3_lat = jmu_I3_lat_.get();
+      jmu_B_lat_->iterate_occupied([&](DensityOnLattice &jB, int i) {
         const FourVector flow_four_velocity_B =
             std::abs(jB.rho()) > very_small_double ? jB.jmu_net() / jB.rho()
                                                    : FourVector();
@@ -2572,26 +2764,28 @@ void Experiment<Modus>::update_potentials() {
         ThreeVector baryon_dvecj_dt = jB.dvecj_dt();
         ThreeVector baryon_curl_vecj = jB.curl_vecj();
         if (potentials_->use_skyrme()) {
-          (*UB_lat_)[i] =
-              flow_four_velocity_B * potentials_->skyrme_pot(baryon_density);
-          (*FB_lat_)[i] =
-              potentials_->skyrme_force(baryon_density, baryon_grad_j0,
-                                        baryon_dvecj_dt, baryon_curl_vecj);
+          UB_lat_->assign_value(
+              i, flow_four_velocity_B * potentials_->skyrme_pot(baryon_density));
+          FB_lat_->assign_value(
+              i, potentials_->skyrme_force(baryon_density, baryon_grad_j0,
+                                           baryon_dvecj_dt, baryon_curl_vecj));
         }
         if (potentials_->use_symmetry() && jmu_I3_lat_ != nullptr) {
-          auto jI3 = (*jmu_I3_lat_)[i];
+          auto jI3 = (*jmu_I3_lat)[i];
           const FourVector flow_four_velocity_I3 =
               std::abs(jI3.rho()) > very_small_double
                   ? jI3.jmu_net() / jI3.rho()
                   : FourVector();
-          (*UI3_lat_)[i] = flow_four_velocity_I3 *
-                           potentials_->symmetry_pot(jI3.rho(), baryon_density);
-          (*FI3_lat_)[i] = potentials_->symmetry_force(
-              jI3.rho(), jI3.grad_j0(), jI3.dvecj_dt(), jI3.curl_vecj(),
-              baryon_density, baryon_grad_j0, baryon_dvecj_dt,
-              baryon_curl_vecj);
+          UI3_lat_->assign_value(
+              i, flow_four_velocity_I3 *
+                     potentials_->symmetry_pot(jI3.rho(), baryon_density));
+          FI3_lat_->assign_value(
+              i, potentials_->symmetry_force(
+                     jI3.rho(), jI3.grad_j0(), jI3.dvecj_dt(),
+                     jI3.curl_vecj(), baryon_density, baryon_grad_j0,
+                     baryon_dvecj_dt, baryon_curl_vecj));
         }
-      }
+      });
     }
     if (potentials_->use_coulomb()) {
       update_lattice(jmu_el_lat_.get(), LatticeUpdate::EveryTimestep,
@@ -2622,25 +2816,98 @@ void Experiment<Modus>::update_potentials() {
             jmu_B_lat_.get(), LatticeUpdate::EveryTimestep, *potentials_,
             parameters_.labclock->timestep_duration());
       }
-      const size_t UBlattice_size = UB_lat_->size();
-      for (size_t i = 0; i < UBlattice_size; i++) {
-        auto jB = (*jmu_B_lat_)[i];
-        (*UB_lat_)[i] = potentials_->vdf_pot(jB.rho(), jB.jmu_net());
+      /* Potentials and forces vanish in empty cells, so only the occupied
+       * tiles are updated. With direct field derivatives, the finite
+       * differences reach into empty cells next to occupied ones, therefore
+       * the tiles of the fields lattice are used in this case. */
+      UB_lat_->reset();
+      FB_lat_->reset();
+      const DensityLattice &jmu_B_lat = *jmu_B_lat_;
+      const FieldsLattice *fields_lat = fields_lat_.get();
+      auto update_node = [&](int i) {
+        auto jB = jmu_B_lat[i];
+        UB_lat_->assign_value(i, potentials_->vdf_pot(jB.rho(), jB.jmu_net()));
         switch (parameters_.field_derivatives_mode) {
           case FieldDerivativesMode::ChainRule:
-            (*FB_lat_)[i] = potentials_->vdf_force(
-                jB.rho(), jB.drho_dxnu().x0(), jB.drho_dxnu().threevec(),
-                jB.grad_rho_cross_vecj(), jB.jmu_net().x0(), jB.grad_j0(),
-                jB.jmu_net().threevec(), jB.dvecj_dt(), jB.curl_vecj());
+            FB_lat_->assign_value(
+                i, potentials_->vdf_force(
+                       jB.rho(), jB.drho_dxnu().x0(), jB.drho_dxnu().threevec(),
+                       jB.grad_rho_cross_vecj(), jB.jmu_net().x0(),
+                       jB.grad_j0(), jB.jmu_net().threevec(), jB.dvecj_dt(),
+                       jB.curl_vecj()));
             break;
           case FieldDerivativesMode::Direct:
-            auto Amu = (*fields_lat_)[i];
-            (*FB_lat_)[i] = potentials_->vdf_force(
-                Amu.grad_A0(), Amu.dvecA_dt(), Amu.curl_vecA());
+            auto Amu = (*fields_lat)[i];
+            FB_lat_->assign_value(
+                i, potentials_->vdf_force(Amu.grad_A0(), Amu.dvecA_dt(),
+                                          Amu.curl_vecA()));
             break;
         }
-      }  // for (size_t i = 0; i < UBlattice_size; i++)
-    }    // if potentials_->use_vdf()
+      };
+      if (parameters_.field_derivatives_mode == FieldDerivativesMode::Direct) {
+        fields_lat_->iterate_occupied(
+            [&](const FieldsOnLattice &, int i) { update_node(i); });
+      } else {
+        jmu_B_lat_->iterate_occupied(
+            [&](const DensityOnLattice &, int i) { update_node(i); });
+      }
+    }  // if potentials_->use_vdf()
+  }
+}
+
+/**
+ * Replaces a lattice by one with the same cell sizes, but different origin and
+ * number of cells, keeping the values of the shared cells.
+ *
+ * \tparam T Type of the lattice values.
+ * \param[in,out] lat The lattice to refit, nothing is done if it is nullptr.
+ * \param[in] n Number of cells in x, y, z directions.
+ * \param[in] origin Coordinates of the left, down, near corner [fm].
+ */
+template <typename T>
+void refit_lattice(std::unique_ptr<RectangularLattice<T>> &lat,
+                   const std::array<int, 3> &n,
+                   const std::array<double, 3> &origin) {
+  if (lat != nullptr) {
+    lat = make_unique<RectangularLattice<T>>(*lat, n, origin);
+  }
+}
+
+template <typename Modus>
+void Experiment<Modus>::adapt_lattices() {
+  // All lattices updated every time step share the geometry of this one
+  std::array<double, 3> new_origin = old_jmu_auxiliary_->origin();
+  std::array<int, 3> new_n = old_jmu_auxiliary_->n_cells();
+  if (!fit_adaptive_lattice(ensembles_, density_param_,
+                            potentials_->use_coulomb(),
+                            old_jmu_auxiliary_->cell_sizes(),
+                            adaptive_max_n_cells_, new_origin, new_n)) {
+    return;
+  }
+  logg[LExperiment].debug()
+      << "Refitting lattices: origin = (" << new_origin[0] << ","
+      << new_origin[1] << "," << new_origin[2] << "), number of cells = ("
+      << new_n[0] << "," << new_n[1] << "," << new_n[2] << ")";
+
+  refit_lattice(jmu_B_lat_, new_n, new_origin);
+  refit_lattice(jmu_I3_lat_, new_n, new_origin);
+  refit_lattice(jmu_el_lat_, new_n, new_origin);
+  refit_lattice(fields_lat_, new_n, new_origin);
+  refit_lattice(UB_lat_, new_n, new_origin);
+  refit_lattice(UI3_lat_, new_n, new_origin);
+  refit_lattice(FB_lat_, new_n, new_origin);
+  refit_lattice(FI3_lat_, new_n, new_origin);
+  refit_lattice(EM_lat_, new_n, new_origin);
+  refit_lattice(old_jmu_auxiliary_, new_n, new_origin);
+  refit_lattice(new_jmu_auxiliary_, new_n, new_origin);
+  refit_lattice(four_gradient_auxiliary_, new_n, new_origin);
+  refit_lattice(old_fields_auxiliary_, new_n, new_origin);
+  refit_lattice(new_fields_auxiliary_, new_n, new_origin);
+  refit_lattice(fields_four_gradient_auxiliary_, new_n, new_origin);
+
+  if (parameters_.potential_affect_threshold) {
+    UB_lat_pointer = UB_lat_.get();
+    UI3_lat_pointer = UI3_lat_.get();
   }
 }
 
@@ -2685,6 +2952,8 @@ void Experiment<Modus>::do_final_decays() {
 
 template <typename Modus>
 void Experiment<Modus>::final_output() {
+  // interactions of the final decays
+  write_interactions();
   /* make sure the experiment actually ran (note: we should compare this
    * to the start time, but we don't know that. Therefore, we check that
    * the time is positive, which should heuristically be the same). */
@@ -2837,6 +3106,10 @@ void Experiment<Modus>::run() {
     // Output at event end
     final_output();
   }
+
+  for (const auto &output : outputs_) {
+    output->at_runend();
+  }
 }
 
 }  // namespace smash
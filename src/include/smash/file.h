@@ -11,11 +11,17 @@
 #define SRC_INCLUDE_SMASH_FILE_H_
 
 #include <cerrno>
+#include <condition_variable>
 #include <cstdio>
 #include <cstring>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <boost/filesystem.hpp>
 
@@ -62,13 +68,144 @@ struct FileDeleter {
  */
 using FilePtr = std::unique_ptr<std::FILE, FileDeleter>;
 
+/**
+ * Parameters for writing an output file asynchronously, see
+ * \ref input_output_options_.
+ */
+struct AsyncWriteParameters {
+  /// Whether the file is written by a separate writer thread
+  bool enabled = false;
+  /// Size of the buffers handed over to the writer thread in bytes
+  size_t buffer_size = 4 * 1024 * 1024;
+  /**
+   * Maximal number of filled buffers waiting to be written. If the writer
+   * thread falls behind that far, the simulation waits for it.
+   */
+  size_t max_pending_buffers = 4;
+};
+
+/**
+ * Writes a file in a separate thread.
+ *
+ * The simulation thread appends the already formatted output to a front
+ * buffer. Once the front buffer is full (or on flush()), it is queued and
+ * written to the file by the writer thread, while the simulation thread
+ * continues with an empty buffer. The number of queued buffers is limited,
+ * such that memory usage stays bounded if the file system is slower than the
+ * simulation.
+ *
+ * Outputs can also hand over a copy of the data they write together with a
+ * task that formats it, see post(). Then the formatting runs in the writer
+ * thread as well. The data is written as is, without compression.
+ */
+class AsyncFileWriter {
+ public:
+  /**
+   * Start the writer thread.
+   *
+   * \param[in] file File the buffers are written to. It is not closed by the
+   *                 writer.
+   * \param[in] par Sizes of the buffers and of the queue.
+   * \throws invalid_argument if the buffer size or the queue length is zero.
+   */
+  AsyncFileWriter(std::FILE* file, const AsyncWriteParameters& par);
+  /// Write all remaining buffers and stop the writer thread.
+  ~AsyncFileWriter();
+  /// Cannot be copied
+  AsyncFileWriter(const AsyncFileWriter&) = delete;
+  /// Cannot be copied
+  AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+  /**
+   * Append data to the front buffer, which is queued for writing once full.
+   *
+   * \param[in] data Data to be written.
+   * \param[in] size Number of bytes.
+   */
+  void append(const char* data, size_t size);
+
+  /**
+   * Queue a task that writes to the file in the writer thread, after all data
+   * appended so far. The task counts as one buffer for the length of the
+   * queue. It must only use data that is not modified by the simulation, e.g.
+   * copies of the particles it formats.
+   *
+   * \param[in] task Function writing to the file.
+   */
+  void post(std::function<void(std::FILE*)> task);
+
+  /**
+   * Queue the front buffer for writing, even if it is not full. This does not
+   * wait for the data to actually reach the file.
+   *
+   * \throws runtime_error if writing a previous buffer failed.
+   */
+  void flush();
+
+  /**
+   * Queue the front buffer, wait until everything is written and stop the
+   * writer thread.
+   *
+   * \return Error number of the first failed write, 0 on success.
+   */
+  int finish();
+
+ private:
+  /// Buffer or task waiting to be written by the writer thread
+  struct PendingWrite {
+    /// Data to be written
+    std::vector<char> buffer;
+    /// Task writing to the file, if set instead of the buffer
+    std::function<void(std::FILE*)> task;
+  };
+
+  /// Write queued buffers until finish() is called; runs in the writer thread.
+  void run();
+  /// Hand the front buffer over to the writer thread.
+  void queue_front_buffer();
+  /**
+   * Hand a buffer or task over to the writer thread, waiting if the queue is
+   * full.
+   *
+   * \param[in] write Buffer or task to be written.
+   */
+  void queue(PendingWrite&& write);
+  /// \throws runtime_error if the writer thread reported an error
+  void check_error();
+
+  /// File the buffers are written to
+  std::FILE* file_;
+  /// Size of a buffer
+  const size_t buffer_size_;
+  /// Maximal number of queued buffers
+  const size_t max_pending_;
+  /// Buffer the simulation thread currently appends to
+  std::vector<char> front_;
+  /// Buffers and tasks waiting to be written
+  std::deque<PendingWrite> pending_;
+  /// Written buffers kept for reuse, such that no memory is reallocated
+  std::vector<std::vector<char>> spare_;
+  /// Protects pending_, spare_, done_ and error_
+  std::mutex mutex_;
+  /// Signals queued buffers to the writer thread
+  std::condition_variable has_work_;
+  /// Signals free queue slots to the simulation thread
+  std::condition_variable has_space_;
+  /// Whether the writer thread should stop once the queue is empty
+  bool done_ = false;
+  /// Error number of the first failed write
+  int error_ = 0;
+  /// The writer thread
+  std::thread thread_;
+};
+
 /**
  * A RAII type to replace `std::FILE *`.
  *
  * While open, the file name ends with ".unfinished".
  *
  * Automatically closes and renames the file to the original when it goes out of
- * scope.
+ * scope, unless writing it failed or keep_unfinished() was called.
  */
 class RenamingFilePtr {
  public:
@@ -78,21 +215,55 @@ class RenamingFilePtr {
    * \param[in] filename Path to the file.
    * \param[in] mode The mode in which the file should be opened (see
    *                 `std::fopen`).
+   * \param[in] async Whether and how the file is written in a separate
+   *                  thread. In this case get() returns a stream that hands
+   *                  its data to the writer thread.
    * \return The constructed object.
    */
-  RenamingFilePtr(const bf::path& filename, const std::string& mode);
+  RenamingFilePtr(const bf::path& filename, const std::string& mode,
+                  const AsyncWriteParameters& async = AsyncWriteParameters());
   /// Get the underlying `FILE*` pointer.
   FILE* get();
-  /// Close the file and rename it.
+  /// \return Whether the file is written by a separate writer thread.
+  bool asynchronous() const { return writer_ != nullptr; }
+  /**
+   * Run a task writing to the file after the data written so far. When
+   * writing asynchronously, it runs in the writer thread, see
+   * AsyncFileWriter::post(), otherwise it is called directly with get().
+   *
+   * \param[in] task Function writing to the file.
+   */
+  void post(std::function<void(std::FILE*)> task);
+  /**
+   * Keep the ".unfinished" name when the file is closed, e.g. because the
+   * run was aborted before the output was complete.
+   */
+  void keep_unfinished() { keep_unfinished_ = true; }
+  /**
+   * Flush the written data. When writing asynchronously, the data is handed
+   * to the writer thread.
+   */
+  void flush();
+  /**
+   * Close the file and rename it, after all data has been written. If the
+   * writer thread failed to write some of the data, the error is logged and
+   * the file keeps its ".unfinished" name.
+   */
   ~RenamingFilePtr();
 
  private:
   /// Internal file pointer.
   FILE* file_;
+  /// File on disk, if file_ is the stream feeding the writer thread.
+  FILE* target_ = nullptr;
+  /// Writer thread, if the file is written asynchronously.
+  std::unique_ptr<AsyncFileWriter> writer_;
   /// Path of the finished file.
   bf::path filename_;
   /// Path of the unfinished file.
   bf::path filename_unfinished_;
+  /// Whether the file is not renamed when it is closed.
+  bool keep_unfinished_ = false;
 };
 
 /**
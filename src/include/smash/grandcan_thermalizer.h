@@ -13,6 +13,7 @@
 #include "angles.h"
 #include "clock.h"
 #include "configuration.h"
+#include "cxx14compat.h"
 #include "density.h"
 #include "distributions.h"
 #include "forwarddeclarations.h"
@@ -20,6 +21,7 @@
 #include "lattice.h"
 #include "particledata.h"
 #include "quantumnumbers.h"
+#include "random.h"
 
 namespace smash {
 
@@ -356,6 +358,11 @@ class GrandCanThermalizer {
       N_in_cells_.push_back(N_tot);
       N_total_in_cells_ += N_tot;
     }
+    if (N_total_in_cells_ > 0.0) {
+      mode_cell_sampler_ = make_unique<random::AliasSampler>(N_in_cells_);
+    } else {
+      mode_cell_sampler_.reset();
+    }
   }
 
   /**
@@ -372,20 +379,14 @@ class GrandCanThermalizer {
   ParticleData sample_in_random_cell_mode_algo(const double time,
                                                F&& condition) {
     // Choose random cell, probability = N_in_cell/N_total
-    double r = random::uniform(0.0, N_total_in_cells_);
-    double partial_sum = 0.0;
-    int index_only_thermalized = -1;
-    while (partial_sum < r) {
-      index_only_thermalized++;
-      partial_sum += N_in_cells_[index_only_thermalized];
-    }
+    const size_t index_only_thermalized = mode_cell_sampler_->sample();
     const int cell_index = cells_to_sample_[index_only_thermalized];
     const ThermLatticeNode cell = (*lat_)[cell_index];
     const ThreeVector cell_center = lat_->cell_center(cell_index);
     const double gamma = 1.0 / std::sqrt(1.0 - cell.v().sqr());
     const double N_in_cell = N_in_cells_[index_only_thermalized];
     // Which sort to sample - probability N_i/N_tot
-    r = random::uniform(0.0, N_in_cell);
+    const double r = random::uniform(0.0, N_in_cell);
     double N_sum = 0.0;
     ParticleTypePtr type_to_sample;
     for (ParticleTypePtr i : eos_typelist_) {
@@ -519,6 +520,14 @@ class GrandCanThermalizer {
   std::array<double, 7> mult_classes_;
   /// Total number of particles over all cells in thermalization region
   double N_total_in_cells_;
+  /**
+   * Alias tables to sample the cell of a particle of each species in the
+   * BF algorithm, built when the species is sampled first in a
+   * thermalization
+   */
+  std::vector<std::unique_ptr<random::AliasSampler>> cell_samplers_;
+  /// Alias table to sample the cell of a particle in the current mode
+  std::unique_ptr<random::AliasSampler> mode_cell_sampler_;
   /**
    * Volume of a single lattice cell, necessary to convert thermal densities to
    * actual particle numbers
@@ -14,11 +14,13 @@
 #include <gsl/gsl_vector.h>
 
 #include <array>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "constants.h"
 #include "particletype.h"
+#include "sha256.h"
 
 namespace smash {
 
@@ -71,12 +73,19 @@ class EosTable {
    * Computes the actual content of the table (for EosTable description see
    * documentation of the constructor).
    *
+   * If the file eos_savefile_name contains a table, which was computed for
+   * the same grid and the same hadrons, it is memory-mapped instead. This is
+   * recognized by a hash of the grid and the properties of all hadrons in the
+   * EoS, which is stored in the file. Otherwise the table is computed, in
+   * parallel over the energy density slices, and stored in binary form in
+   * the file.
+   *
    * \param[in] eos equation of state
    * \param[in] eos_savefile_name name of the file to save tabulated equation
    *            of state
    */
   void compile_table(HadronGasEos& eos,
-                     const std::string& eos_savefile_name = "hadgas_eos.dat");
+                     const std::string& eos_savefile_name = "hadgas_eos.bin");
   /**
    * Obtain interpolated p/T/muB/muS/muQ from the tabulated equation of state
    * given energy density, net baryon density and net charge density
@@ -93,8 +102,48 @@ class EosTable {
   size_t index(size_t ie, size_t inb, size_t inq) const {
     return n_q_ * (ie * n_nb_ + inb) + inq;
   }
-  /// Storage for the tabulated equation of state
+  /// \return the first element of the table, mapped or computed
+  const table_element* elements() const {
+    return mapped_table_ ? mapped_table_.get() : table_.data();
+  }
+  /**
+   * Compute the hash, which identifies the table in a file.
+   *
+   * \param[in] account_for_width whether the EoS accounts for resonance
+   *            spectral functions
+   * \return hash of the grid and of the properties of all hadrons in the EoS
+   */
+  sha256::Hash hash(bool account_for_width) const;
+  /**
+   * Memory-map a table from a file, if it was stored with the given hash.
+   *
+   * \param[in] filename name of the file
+   * \param[in] hash expected hash of the table
+   * \return whether the table was mapped
+   */
+  bool map_table(const std::string& filename, const sha256::Hash& hash);
+  /**
+   * Compute the table for one energy density. The solutions for the
+   * neighboring net baryon (or net charge) densities of the slice are
+   * extrapolated as initial approximation, such that the slices are
+   * independent of each other.
+   *
+   * \param[in] eos equation of state used to solve for T and the chemical
+   *            potentials
+   * \param[in] ie index of the energy density
+   */
+  void compile_slice(HadronGasEos& eos, size_t ie);
+  /**
+   * Store the computed table in binary form.
+   *
+   * \param[in] filename name of the file
+   * \param[in] hash hash of the table
+   */
+  void save_table(const std::string& filename, const sha256::Hash& hash) const;
+  /// Storage for the computed equation of state
   std::vector<table_element> table_;
+  /// Memory-mapped table from a file, preferred over table_ if set
+  std::shared_ptr<const table_element> mapped_table_;
   /// Step in energy density
   double de_;
   /// Step in net-baryon density
@@ -106,11 +106,10 @@ class HepMcInterface : public OutputInterface {
   /**
    * Writes collisions to event.
    *
-   * \param[in] action an Action object containing incoming,
-   *                   outgoing particles and type of interactions.
-   * \param[in] density Unused, needed since inherited.
+   * \param[in] records Records of the interactions containing incoming,
+   *                    outgoing particles and type of interactions.
    */
-  void at_interaction(const Action& action, const double density) override;
+  void at_interactions(ConstSpan<InteractionRecord> records) override;
   /**
    * Add the final particles information of an event to the central vertex.
    * Store impact paramter and write event.
@@ -66,11 +66,19 @@ class ICOutput : public OutputInterface {
   /**
    * Write particle data at the hypersurface crossing point to the IC output.
    *
-   * \param[in] action Details about the action
+   * \param[in] records Records of the interactions, of which only the
+   *            hypersurface crossings are written.
    */
-  void at_interaction(const Action &action, const double) override;
+  void at_interactions(ConstSpan<InteractionRecord> records) override;
 
  private:
+  /**
+   * Write the data of a particle which crossed the hypersurface.
+   *
+   * \param[in] particle The particle at the crossing point.
+   */
+  void write_crossing_particle(const ParticleData &particle);
+
   /// Pointer to output file
   RenamingFilePtr file_;
   /// Structure that holds all the information about what to printout
@@ -83,7 +91,7 @@ class ICOutput : public OutputInterface {
    * actually removed particles.
    * By construction, tau > 0. Nevertheless it is initialized with a negative
    * number to easily find the first particle that is removed from the evolution
-   * in at_interaction().
+   * in at_interactions().
    */
   double IC_proper_time_ = -1.0;
 };
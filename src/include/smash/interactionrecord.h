@@ -0,0 +1,201 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_INTERACTIONRECORD_H_
+#define SRC_INCLUDE_SMASH_INTERACTIONRECORD_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "fourvector.h"
+#include "particledata.h"
+#include "processbranch.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Read-only view of consecutive elements of an array, which does not own
+ * them.
+ *
+ * \tparam T Type of the elements.
+ */
+template <typename T>
+class ConstSpan {
+ public:
+  /// Construct an empty span.
+  ConstSpan() = default;
+
+  /**
+   * Construct a view of an array.
+   *
+   * \param[in] data Pointer to the first element.
+   * \param[in] size Number of elements.
+   */
+  ConstSpan(const T *data, size_t size) : data_(data), size_(size) {}
+
+  /**
+   * Construct a view of all elements of a vector, e.g. a ParticleList. The
+   * view is invalidated when the vector is reallocated.
+   *
+   * \param[in] v Vector to view.
+   */
+  ConstSpan(const std::vector<T> &v)  // NOLINT(runtime/explicit)
+      : data_(v.data()), size_(v.size()) {}
+
+  /// \return Pointer to the first element.
+  const T *begin() const { return data_; }
+  /// \return Pointer behind the last element.
+  const T *end() const { return data_ + size_; }
+  /// \return Number of elements.
+  size_t size() const { return size_; }
+  /// \return Whether the span has no elements.
+  bool empty() const { return size_ == 0; }
+  /**
+   * \param[in] i Index of the element.
+   * \return The i-th element.
+   */
+  const T &operator[](size_t i) const { return data_[i]; }
+
+ private:
+  /// First element
+  const T *data_ = nullptr;
+  /// Number of elements
+  size_t size_ = 0;
+};
+
+/// Read-only view of consecutive particles
+using ParticleSpan = ConstSpan<ParticleData>;
+
+/**
+ * \ingroup output
+ *
+ * \brief Everything the outputs write about a performed interaction.
+ *
+ * The record does not own the particles, they are views of the particle
+ * lists of an action or of the storage of an InteractionBatch. It is passed
+ * to OutputInterface::at_interactions instead of the Action, such that
+ * interactions can be collected and written in batches and interactions like
+ * wall crossings can be reported without constructing actions.
+ */
+struct InteractionRecord {
+  /// Process type of the interaction
+  ProcessType type = ProcessType::None;
+  /// Time of execution of the interaction [fm]
+  double time = 0.;
+  /// Total weight of the interaction, e.g. the cross section
+  double total_weight = 0.;
+  /// Partial weight of the performed channel
+  double partial_weight = 0.;
+  /// Density at the interaction point
+  double density = 0.;
+  /// Estimate of the interaction point in the calculational frame [fm]
+  FourVector interaction_point;
+  /// Incoming particles
+  ParticleSpan incoming;
+  /// Outgoing particles
+  ParticleSpan outgoing;
+};
+
+/**
+ * Describe a performed action by a record. The particles of the record are
+ * views of the particle lists of the action.
+ *
+ * \param[in] action Performed action.
+ * \param[in] density Density at the interaction point.
+ * \return The record of the action.
+ */
+InteractionRecord make_interaction_record(const Action &action,
+                                          double density);
+
+/**
+ * \ingroup output
+ *
+ * \brief Collects the records of interactions, e.g. of a time step, together
+ * with copies of their particles, such that they can be passed to the outputs
+ * at once.
+ */
+class InteractionBatch {
+ public:
+  /**
+   * Add a performed action, copying its incoming and outgoing particles.
+   *
+   * \param[in] action Performed action.
+   * \param[in] density Density at the interaction point.
+   */
+  void add(const Action &action, double density);
+
+  /**
+   * Add a copy of a record together with its particles, e.g. to keep it
+   * beyond the lifetime of the particles it views.
+   *
+   * \param[in] record Record to be copied.
+   */
+  void add(const InteractionRecord &record);
+
+  /**
+   * Add the crossing of a wall of a periodic box, without an action.
+   *
+   * \param[in] incoming Particle before the crossing.
+   * \param[in] outgoing Particle at its new position.
+   */
+  void add_wall_crossing(const ParticleData &incoming,
+                         const ParticleData &outgoing);
+
+  /**
+   * \return The records in the order in which they were added. They are
+   *         invalidated by adding records or clearing the batch.
+   */
+  ConstSpan<InteractionRecord> records();
+
+  /// \return Whether no interaction was added since the last clear().
+  bool empty() const { return records_.empty(); }
+
+  /// Remove all records, keeping the allocated memory.
+  void clear() {
+    records_.clear();
+    extents_.clear();
+    particles_.clear();
+  }
+
+ private:
+  /// Position of the particles of a record in particles_
+  struct Extent {
+    /// Index of the first incoming particle
+    size_t first;
+    /// Number of incoming particles
+    size_t n_incoming;
+    /// Number of outgoing particles, which follow the incoming ones
+    size_t n_outgoing;
+  };
+
+  /**
+   * Append copies of the particles of a record and remember their position.
+   *
+   * \param[in] incoming Incoming particles of the record.
+   * \param[in] outgoing Outgoing particles of the record.
+   */
+  void add_particles(ParticleSpan incoming, ParticleSpan outgoing);
+
+  /// Incoming and outgoing particles of all records, one after the other
+  std::vector<ParticleData> particles_;
+  /// Position of the particles of every record in particles_
+  std::vector<Extent> extents_;
+  /**
+   * Records, whose particle views are only set when they are requested, since
+   * adding particles may reallocate particles_
+   */
+  std::vector<InteractionRecord> records_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_INTERACTIONRECORD_H_
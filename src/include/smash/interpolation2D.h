@@ -12,12 +12,29 @@
 
 #include <gsl/gsl_spline2d.h>
 
+#include <functional>
 #include <vector>
 
 namespace smash {
 
+/// Interface of the interpolations of a function of two variables.
+class InterpolateData2D {
+ public:
+  /// Virtual destructor
+  virtual ~InterpolateData2D() = default;
+
+  /**
+   * Calculate the interpolation for given x and y.
+   *
+   *  \param xi Interpolation argument in first dimension.
+   *  \param yi Interpolation argument in second dimension.
+   *  \return Interpolated value.
+   */
+  virtual double operator()(double xi, double yi) const = 0;
+};
+
 /// Represent a bicubic spline interpolation.
-class InterpolateData2DSpline {
+class InterpolateData2DSpline : public InterpolateData2D {
  public:
   /**
    * Interpolate function f given discrete samples f(x_i, y_i) = z_i.
@@ -36,7 +53,7 @@ class InterpolateData2DSpline {
                           const std::vector<double>& z);
 
   /// Destructor
-  ~InterpolateData2DSpline();
+  ~InterpolateData2DSpline() override;
 
   /**
    * Calculate bicubic interpolation for given x and y.
@@ -45,7 +62,7 @@ class InterpolateData2DSpline {
    *  \param yi Interpolation argument in second dimension.
    *  \return Interpolated value.
    */
-  double operator()(double xi, double yi) const;
+  double operator()(double xi, double yi) const override;
 
  private:
   /// First x value.
@@ -65,6 +82,66 @@ class InterpolateData2DSpline {
   gsl_spline2d* spline_;
 };
 
+/**
+ * Represent a function of two variables by its values on a uniform grid,
+ * which is interpolated bicubically (Catmull-Rom). In contrast to
+ * InterpolateData2DSpline, the grid cell of a point is computed directly
+ * instead of searching for it, which makes it suited for functions, which
+ * are evaluated very often, e.g. resampled from a spline on a finer grid.
+ */
+class InterpolateData2DUniform : public InterpolateData2D {
+ public:
+  /**
+   * Sample a function on a uniform grid.
+   *
+   * \param f Function of x and y to sample.
+   * \param x_min Smallest x value.
+   * \param x_max Largest x value.
+   * \param n_x Number of x values, at least 2.
+   * \param y_min Smallest y value.
+   * \param y_max Largest y value.
+   * \param n_y Number of y values, at least 2.
+   * \param logarithmic_x Whether the grid is uniform in the logarithm of x
+   *                      instead of x, which requires positive x values.
+   * \throw std::invalid_argument if a grid has less than two points or
+   *        does not increase.
+   *
+   * Values outside the grid will use the outmost sample as a constant
+   * extrapolation.
+   */
+  InterpolateData2DUniform(const std::function<double(double, double)>& f,
+                           double x_min, double x_max, size_t n_x,
+                           double y_min, double y_max, size_t n_y,
+                           bool logarithmic_x = false);
+
+  /**
+   * Calculate the bicubic interpolation for given x and y.
+   *
+   *  \param xi Interpolation argument in first dimension.
+   *  \param yi Interpolation argument in second dimension.
+   *  \return Interpolated value.
+   */
+  double operator()(double xi, double yi) const override;
+
+ private:
+  /// Number of x values.
+  size_t n_x_;
+  /// Number of y values.
+  size_t n_y_;
+  /// Smallest x value, or its logarithm.
+  double x_min_;
+  /// Inverse spacing of the x values, or of their logarithms.
+  double inv_dx_;
+  /// Smallest y value.
+  double y_min_;
+  /// Inverse spacing of the y values.
+  double inv_dy_;
+  /// Whether the grid is uniform in the logarithm of x.
+  bool logarithmic_x_;
+  /// Function values, with x running fastest.
+  std::vector<double> z_;
+};
+
 }  // namespace smash
 
 #endif  // SRC_INCLUDE_SMASH_INTERPOLATION2D_H_
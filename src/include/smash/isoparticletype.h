@@ -205,6 +205,9 @@ class IsoParticleType {
   /**
    * Tabulate all relevant integrals.
    *
+   * The integrals are independent and tabulated concurrently by a pool of
+   * threads. Cached tabulations are replaced atomically.
+   *
    * \param hash The hash of the particle properties.
    *             This is used to determine whether a cached tabulation can be
    *             reused or not.
@@ -10,9 +10,11 @@
 #ifndef SRC_INCLUDE_SMASH_LATTICE_H_
 #define SRC_INCLUDE_SMASH_LATTICE_H_
 
+#include <algorithm>
 #include <array>
 #include <cstring>
 #include <functional>
+#include <numeric>
 #include <utility>
 #include <vector>
 
@@ -20,6 +22,7 @@
 #include "fourvector.h"
 #include "logging.h"
 #include "numerics.h"
+#include "threadpool.h"
 
 namespace smash {
 static constexpr int LLattice = LogArea::Lattice::id;
@@ -41,6 +44,20 @@ enum class LatticeUpdate {
 
 /**
  * A container class to hold all the arrays on the lattice and access them.
+ *
+ * The lattice is subdivided into tiles of tile_edge_^3 cells, and it is kept
+ * track of which tiles were written to since the last reset(). In expanding
+ * systems most tiles stay empty for most of the time, so resetting the lattice
+ * and looping over its content with iterate_occupied() only touches the cells
+ * of occupied tiles. Non-const operator[] marks the tile of the accessed cell.
+ * Writes through the (non-const) iterators are not tracked per tile, after
+ * those all tiles are treated as occupied until the next reset(), so code
+ * which only reads the lattice should access it through a const reference.
+ * This is occupancy tracking only: the values of all cells are still stored in
+ * one dense array, which saves time spent on empty cells, but no memory. The
+ * flat cell index, used by the finite differences and by the callers, maps
+ * directly into the array, which tiles allocated on demand would not allow.
+ *
  * \tparam T The type of the contained values.
  */
 template <typename T>
@@ -73,8 +90,12 @@ class RectangularLattice {
         cell_volume_{cell_sizes_[0] * cell_sizes_[1] * cell_sizes_[2]},
         origin_(orig),
         periodic_(per),
-        when_update_(upd) {
+        when_update_(upd),
+        n_tiles_{(n[0] + tile_edge_ - 1) / tile_edge_,
+                 (n[1] + tile_edge_ - 1) / tile_edge_,
+                 (n[2] + tile_edge_ - 1) / tile_edge_} {
     lattice_.resize(n_cells_[0] * n_cells_[1] * n_cells_[2]);
+    tile_occupied_.resize(n_tiles_[0] * n_tiles_[1] * n_tiles_[2], 0);
     logg[LLattice].debug(
         "Rectangular lattice created: sizes[fm] = (", lattice_sizes_[0], ",",
         lattice_sizes_[1], ",", lattice_sizes_[2], "), dims = (", n_cells_[0],
@@ -98,10 +119,73 @@ class RectangularLattice {
         cell_volume_(rl.cell_volume_),
         origin_(rl.origin_),
         periodic_(rl.periodic_),
-        when_update_(rl.when_update_) {}
+        when_update_(rl.when_update_),
+        n_tiles_(rl.n_tiles_),
+        tile_occupied_(rl.tile_occupied_),
+        all_occupied_(rl.all_occupied_) {}
 
-  /// Sets all values on lattice to zeros.
-  void reset() { std::fill(lattice_.begin(), lattice_.end(), T()); }
+  /**
+   * Constructor of a lattice with the same cell sizes as another lattice, but
+   * a different number of cells and origin, e.g. to follow an expanding
+   * system. The cells of both lattices have to be aligned. Values of cells
+   * covered by both lattices are copied, all other cells are set to the
+   * default value. Periodicity is not taken into account for the copy.
+   *
+   * \param[in] rl The lattice to take the cell sizes and the values from.
+   * \param[in] n Number of cells in x, y, z directions.
+   * \param[in] orig Coordinates of the origin [fm]. The distance to the origin
+   *            of rl has to be a multiple of the cell sizes.
+   * \throw std::invalid_argument if the cells of the lattices are not aligned.
+   */
+  RectangularLattice(RectangularLattice<T> const& rl,
+                     const std::array<int, 3>& n,
+                     const std::array<double, 3>& orig)
+      : RectangularLattice({n[0] * rl.cell_sizes_[0], n[1] * rl.cell_sizes_[1],
+                            n[2] * rl.cell_sizes_[2]},
+                           n, orig, rl.periodic_, rl.when_update_) {
+    std::array<int, 3> offset, lower, upper;
+    for (int i = 0; i < 3; i++) {
+      const double shift = (origin_[i] - rl.origin_[i]) / cell_sizes_[i];
+      offset[i] = std::round(shift);
+      if (std::abs(shift - offset[i]) > 1.e-6) {
+        throw std::invalid_argument(
+            "Lattice origins differ by a fraction of a cell, values cannot be "
+            "copied.");
+      }
+      // range of cells of this lattice, which are also in rl
+      lower[i] = std::max(0, -offset[i]);
+      upper[i] = std::min(n_cells_[i], rl.n_cells_[i] - offset[i]);
+      if (upper[i] <= lower[i]) {
+        return;
+      }
+    }
+    mark_tiles(lower, upper);
+    for (int iz = lower[2]; iz < upper[2]; iz++) {
+      for (int iy = lower[1]; iy < upper[1]; iy++) {
+        const int y_offset = n_cells_[0] * (iy + n_cells_[1] * iz);
+        const int rl_y_offset =
+            offset[0] +
+            rl.n_cells_[0] * (iy + offset[1] + rl.n_cells_[1] * (iz + offset[2]));
+        for (int ix = lower[0]; ix < upper[0]; ix++) {
+          lattice_[ix + y_offset] = rl.lattice_[ix + rl_y_offset];
+        }
+      }
+    }
+  }
+
+  /**
+   * Sets all values on lattice to zeros. Only the cells of occupied tiles are
+   * touched, all other cells are still zero from the previous reset.
+   */
+  void reset() {
+    if (all_occupied_) {
+      std::fill(lattice_.begin(), lattice_.end(), T());
+    } else {
+      iterate_occupied([](T& node, int) { node = T(); });
+    }
+    std::fill(tile_occupied_.begin(), tile_occupied_.end(), 0);
+    all_occupied_ = false;
+  }
 
   /**
    * Checks if 3D index is out of lattice bounds.
@@ -172,16 +256,25 @@ class RectangularLattice {
   using iterator = typename std::vector<T>::iterator;
   /// Const interator of lattice.
   using const_iterator = typename std::vector<T>::const_iterator;
-  /// \return First element of lattice.
-  iterator begin() { return lattice_.begin(); }
+  /// \return First element of lattice (marks all tiles as occupied).
+  iterator begin() {
+    all_occupied_ = true;
+    return lattice_.begin();
+  }
   /// \return First element of lattice (const).
   const_iterator begin() const { return lattice_.begin(); }
-  /// \return Last element of lattice.
-  iterator end() { return lattice_.end(); }
+  /// \return Last element of lattice (marks all tiles as occupied).
+  iterator end() {
+    all_occupied_ = true;
+    return lattice_.end();
+  }
   /// \return Last element of lattice (const).
   const_iterator end() const { return lattice_.end(); }
-  /// \return ith element of lattice.
-  T& operator[](std::size_t i) { return lattice_[i]; }
+  /// \return ith element of lattice (marks its tile as occupied).
+  T& operator[](std::size_t i) {
+    mark_tile_of(i);
+    return lattice_[i];
+  }
   /// \return ith element of lattice (const).
   const T& operator[](std::size_t i) const { return lattice_[i]; }
   /// \return Size of lattice.
@@ -191,6 +284,7 @@ class RectangularLattice {
    * Overwrite with a template value T at a given node
    */
   void assign_value(int lattice_index, T value) {
+    mark_tile_of(lattice_index);
     lattice_[lattice_index] = value;
   }
 
@@ -522,12 +616,13 @@ class RectangularLattice {
    * \return Physical quantity evaluated at the cell center.
    */
   T& node(int ix, int iy, int iz) {
-    return periodic_
-               ? lattice_[positive_modulo(ix, n_cells_[0]) +
-                          n_cells_[0] *
-                              (positive_modulo(iy, n_cells_[1]) +
-                               n_cells_[1] * positive_modulo(iz, n_cells_[2]))]
-               : lattice_[ix + n_cells_[0] * (iy + n_cells_[1] * iz)];
+    if (periodic_) {
+      ix = positive_modulo(ix, n_cells_[0]);
+      iy = positive_modulo(iy, n_cells_[1]);
+      iz = positive_modulo(iz, n_cells_[2]);
+    }
+    mark_tile(ix, iy, iz);
+    return lattice_[ix + n_cells_[0] * (iy + n_cells_[1] * iz)];
   }
 
   /**
@@ -544,22 +639,122 @@ class RectangularLattice {
    *
    * \todo (oliiny): maybe 1-order interpolation instead of 0-order?
    */
-  bool value_at(const ThreeVector& r, T& value) {
-    const int ix = std::floor((r.x1() - origin_[0]) / cell_sizes_[0]);
-    const int iy = std::floor((r.x2() - origin_[1]) / cell_sizes_[1]);
-    const int iz = std::floor((r.x3() - origin_[2]) / cell_sizes_[2]);
-    if (out_of_bounds(ix, iy, iz)) {
+  bool value_at(const ThreeVector& r, T& value) const {
+    const int index = index_at(r);
+    if (index < 0) {
       value = T();
       return false;
     } else {
-      value = node(ix, iy, iz);
+      value = lattice_[index];
       return true;
     }
   }
 
+  /**
+   * Finds the cell containing the given position.
+   *
+   * \param[in] r Position [fm].
+   * \return 1-dimensional index of the cell containing r, or -1 if r is out
+   *         of the lattice.
+   */
+  int index_at(const ThreeVector& r) const {
+    const int ix = std::floor((r.x1() - origin_[0]) / cell_sizes_[0]);
+    const int iy = std::floor((r.x2() - origin_[1]) / cell_sizes_[1]);
+    const int iz = std::floor((r.x3() - origin_[2]) / cell_sizes_[2]);
+    if (out_of_bounds(ix, iy, iz)) {
+      return -1;
+    }
+    return periodic_
+               ? positive_modulo(ix, n_cells_[0]) +
+                     n_cells_[0] *
+                         (positive_modulo(iy, n_cells_[1]) +
+                          n_cells_[1] * positive_modulo(iz, n_cells_[2]))
+               : ix + n_cells_[0] * (iy + n_cells_[1] * iz);
+  }
+
+  /**
+   * Find the cell indices of many positions, as index_at(). For lattices
+   * which are not periodic, the loop has no branches, such that it can be
+   * vectorized. The floor of the cell coordinates is computed by truncation
+   * for that purpose.
+   *
+   * \param[in] r Positions [fm].
+   * \param[in] n Number of positions.
+   * \param[out] indices Cell indices, or -1 for positions out of the
+   *             lattice.
+   */
+  void indices_at(const ThreeVector* r, std::size_t n, int* indices) const {
+    if (periodic_) {
+      for (std::size_t i = 0; i < n; i++) {
+        indices[i] = index_at(r[i]);
+      }
+      return;
+    }
+    for (std::size_t i = 0; i < n; i++) {
+      const double ux = (r[i].x1() - origin_[0]) / cell_sizes_[0];
+      const double uy = (r[i].x2() - origin_[1]) / cell_sizes_[1];
+      const double uz = (r[i].x3() - origin_[2]) / cell_sizes_[2];
+      const int tx = static_cast<int>(ux);
+      const int ty = static_cast<int>(uy);
+      const int tz = static_cast<int>(uz);
+      const int ix = tx - (ux < tx);
+      const int iy = ty - (uy < ty);
+      const int iz = tz - (uz < tz);
+      const bool inside = (ix >= 0) & (ix < n_cells_[0]) & (iy >= 0) &
+                          (iy < n_cells_[1]) & (iz >= 0) & (iz < n_cells_[2]);
+      indices[i] = inside ? ix + n_cells_[0] * (iy + n_cells_[1] * iz) : -1;
+    }
+  }
+
+  /**
+   * Batched version of value_at(): looks up the lattice quantity for many
+   * positions at once. The positions are split into batches, which are
+   * distributed over the threads of ThreadPool::global(). Within a batch, the
+   * cell indices are computed first in a loop without branches or data
+   * dependencies, which the compiler can vectorize, before the values are
+   * gathered from the lattice.
+   *
+   * \param[in] positions Positions where the quantity is evaluated [fm].
+   * \param[out] values Physical quantity at the cells containing the
+   *             positions, or the default value (usually 0) for positions
+   *             out of the lattice. Resized to the number of positions.
+   * \param[out] on_lattice Whether each position is located inside the
+   *             lattice (stored as char, such that it can be written in a
+   *             vectorized loop). Resized to the number of positions.
+   * \return Number of positions located inside the lattice.
+   */
+  std::size_t values_at(const std::vector<ThreeVector>& positions,
+                        std::vector<T>& values,
+                        std::vector<char>& on_lattice) const {
+    const std::size_t n = positions.size();
+    values.resize(n);
+    on_lattice.resize(n);
+    ThreadPool& pool = ThreadPool::global();
+    std::vector<std::size_t> n_on_lattice(pool.size(), 0);
+    const std::size_t n_batches =
+        (n + values_at_batch_size - 1) / values_at_batch_size;
+    pool.for_each_index(
+        n_batches, 1, [&](std::size_t batch, std::size_t thread) {
+          const std::size_t begin = batch * values_at_batch_size;
+          const std::size_t size = n - begin < values_at_batch_size
+                                       ? n - begin
+                                       : values_at_batch_size;
+          std::array<int, values_at_batch_size> indices;
+          indices_at(&positions[begin], size, indices.data());
+          for (std::size_t i = 0; i < size; i++) {
+            on_lattice[begin + i] = indices[i] >= 0;
+            values[begin + i] = indices[i] >= 0 ? lattice_[indices[i]] : T();
+            n_on_lattice[thread] += indices[i] >= 0;
+          }
+        });
+    return std::accumulate(n_on_lattice.begin(), n_on_lattice.end(),
+                           std::size_t(0));
+  }
+
   /**
    * A sub-lattice iterator, which iterates in a 3D-structured manner and
-   * calls a function on every cell.
+   * calls a function on every cell. The tiles of the sub-lattice are marked
+   * as occupied.
    *
    * \tparam F Type of the function. Arguments are the current node and the 3
    * integer indices of the cell.
@@ -570,34 +765,25 @@ class RectangularLattice {
   template <typename F>
   void iterate_sublattice(const std::array<int, 3>& lower_bounds,
                           const std::array<int, 3>& upper_bounds, F&& func) {
-    logg[LLattice].debug(
-        "Iterating sublattice with lower bound index (", lower_bounds[0], ",",
-        lower_bounds[1], ",", lower_bounds[2], "), upper bound index (",
-        upper_bounds[0], ",", upper_bounds[1], ",", upper_bounds[2], ")");
+    mark_tiles(lower_bounds, upper_bounds);
+    iterate_sublattice_impl(*this, lower_bounds, upper_bounds, func);
+  }
 
-    if (periodic_) {
-      for (int iz = lower_bounds[2]; iz < upper_bounds[2]; iz++) {
-        const int z_offset = positive_modulo(iz, n_cells_[2]) * n_cells_[1];
-        for (int iy = lower_bounds[1]; iy < upper_bounds[1]; iy++) {
-          const int y_offset =
-              n_cells_[0] * (positive_modulo(iy, n_cells_[1]) + z_offset);
-          for (int ix = lower_bounds[0]; ix < upper_bounds[0]; ix++) {
-            const int index = positive_modulo(ix, n_cells_[0]) + y_offset;
-            func(lattice_[index], ix, iy, iz);
-          }
-        }
-      }
-    } else {
-      for (int iz = lower_bounds[2]; iz < upper_bounds[2]; iz++) {
-        const int z_offset = iz * n_cells_[1];
-        for (int iy = lower_bounds[1]; iy < upper_bounds[1]; iy++) {
-          const int y_offset = n_cells_[0] * (iy + z_offset);
-          for (int ix = lower_bounds[0]; ix < upper_bounds[0]; ix++) {
-            func(lattice_[ix + y_offset], ix, iy, iz);
-          }
-        }
-      }
-    }
+  /**
+   * Const version of the sub-lattice iterator, which does not change the
+   * occupation of the tiles.
+   *
+   * \tparam F Type of the function. Arguments are the current node and the 3
+   * integer indices of the cell.
+   * \param[in] lower_bounds Starting numbers for iterating ix, iy, iz.
+   * \param[in] upper_bounds Ending numbers for iterating ix, iy, iz.
+   * \param[in] func Function acting on the cells (such as taking value).
+   */
+  template <typename F>
+  void iterate_sublattice(const std::array<int, 3>& lower_bounds,
+                          const std::array<int, 3>& upper_bounds,
+                          F&& func) const {
+    iterate_sublattice_impl(*this, lower_bounds, upper_bounds, func);
   }
 
   /**
@@ -615,32 +801,7 @@ class RectangularLattice {
    */
   template <typename F>
   void iterate_in_cube(const ThreeVector& point, const double r_cut, F&& func) {
-    std::array<int, 3> l_bounds, u_bounds;
-
-    /* Array holds value at the cell center: r_center = r_0 + (i+0.5)cell_size,
-     * where i is index in any direction. Therefore we want cells with condition
-     * (r-r_cut)/csize - 0.5 < i < (r+r_cut)/csize - 0.5, r = r_center - r_0 */
-    for (int i = 0; i < 3; i++) {
-      l_bounds[i] =
-          std::ceil((point[i] - origin_[i] - r_cut) / cell_sizes_[i] - 0.5);
-      u_bounds[i] =
-          std::ceil((point[i] - origin_[i] + r_cut) / cell_sizes_[i] - 0.5);
-    }
-
-    if (!periodic_) {
-      for (int i = 0; i < 3; i++) {
-        if (l_bounds[i] < 0) {
-          l_bounds[i] = 0;
-        }
-        if (u_bounds[i] > n_cells_[i]) {
-          u_bounds[i] = n_cells_[i];
-        }
-        if (l_bounds[i] > n_cells_[i] || u_bounds[i] < 0) {
-          return;
-        }
-      }
-    }
-    iterate_sublattice(l_bounds, u_bounds, std::forward<F>(func));
+    iterate_in_rectangle(point, {r_cut, r_cut, r_cut}, std::forward<F>(func));
   }
 
   /**
@@ -657,7 +818,7 @@ class RectangularLattice {
   template <typename F>
   void integrate_volume(F& integral,
                         F (*integrand)(ThreeVector, T&, ThreeVector),
-                        const double rcut, const ThreeVector& point) {
+                        const double rcut, const ThreeVector& point) const {
     iterate_in_rectangle(
         point, {rcut, rcut, rcut},
         [&point, &integral, &integrand, this](T value, int ix, int iy, int iz) {
@@ -683,33 +844,30 @@ class RectangularLattice {
   void iterate_in_rectangle(const ThreeVector& point,
                             const std::array<double, 3>& rectangle, F&& func) {
     std::array<int, 3> l_bounds, u_bounds;
-
-    /* Array holds value at the cell center: r_center = r_0 + (i+0.5)cell_size,
-     * where i is index in any direction. Therefore we want cells with condition
-     * (r[i]-rectangle[i])/csize - 0.5 < i < (r[i]+rectangle[i])/csize - 0.5,
-     * r[i] = r_center[i] - r_0[i]
-     */
-    for (int i = 0; i < 3; i++) {
-      l_bounds[i] = std::ceil(
-          (point[i] - origin_[i] - rectangle[i]) / cell_sizes_[i] - 0.5);
-      u_bounds[i] = std::ceil(
-          (point[i] - origin_[i] + rectangle[i]) / cell_sizes_[i] - 0.5);
+    if (rectangle_bounds(point, rectangle, l_bounds, u_bounds)) {
+      iterate_sublattice(l_bounds, u_bounds, std::forward<F>(func));
     }
+  }
 
-    if (!periodic_) {
-      for (int i = 0; i < 3; i++) {
-        if (l_bounds[i] < 0) {
-          l_bounds[i] = 0;
-        }
-        if (u_bounds[i] > n_cells_[i]) {
-          u_bounds[i] = n_cells_[i];
-        }
-        if (l_bounds[i] > n_cells_[i] || u_bounds[i] < 0) {
-          return;
-        }
-      }
+  /**
+   * Const version of iterate_in_rectangle(), which does not change the
+   * occupation of the tiles.
+   *
+   * \tparam F Type of the function. Arguments are the current node and the 3
+   * integer indices of the cell.
+   * \param[in] point Position, usually the position of particle [fm].
+   * \param[in] rectangle Maximum distances in the x-, y-, and z-directions
+   * from the cell center to the given position. [fm]
+   * \param[in] func Function acting on the cells (such as taking value).
+   */
+  template <typename F>
+  void iterate_in_rectangle(const ThreeVector& point,
+                            const std::array<double, 3>& rectangle,
+                            F&& func) const {
+    std::array<int, 3> l_bounds, u_bounds;
+    if (rectangle_bounds(point, rectangle, l_bounds, u_bounds)) {
+      iterate_sublattice(l_bounds, u_bounds, std::forward<F>(func));
     }
-    iterate_sublattice(l_bounds, u_bounds, std::forward<F>(func));
   }
 
   /**
@@ -734,6 +892,8 @@ class RectangularLattice {
         "Iterating over nearest neighbors of the cell at ix = ", ix,
         ", iy = ", iy, ", iz = ", iz);
 
+    mark_tiles({ix - 1, iy - 1, iz - 1}, {ix + 2, iy + 2, iz + 2});
+
     // determine the 1D index of the center cell
     const int i = index1d(ix, iy, iz);
     func(lattice_[i], i, i);
@@ -758,6 +918,33 @@ class RectangularLattice {
     func(lattice_[iforward], iforward, i);
   }
 
+  /**
+   * Iterates over the cells of all occupied tiles, i.e. over all cells which
+   * may hold a value different from the default one, and applies a function
+   * to each node. The cells of the other tiles are left out, they are unchanged
+   * since the last reset().
+   *
+   * \tparam F Type of the function. Arguments are the current node and its
+   * 1-dimensional index.
+   * \param[in] func Function acting on the cells (such as taking value).
+   */
+  template <typename F>
+  void iterate_occupied(F&& func) {
+    iterate_occupied_impl(*this, func);
+  }
+
+  /**
+   * Const version of iterate_occupied().
+   *
+   * \tparam F Type of the function. Arguments are the current node and its
+   * 1-dimensional index.
+   * \param[in] func Function acting on the cells (such as taking value).
+   */
+  template <typename F>
+  void iterate_occupied(F&& func) const {
+    iterate_occupied_impl(*this, func);
+  }
+
   /**
    * Checks if lattices of possibly different types have identical structure.
    *
@@ -800,8 +987,253 @@ class RectangularLattice {
   const bool periodic_;
   /// When the lattice should be recalculated.
   const LatticeUpdate when_update_;
+  /// Number of cells along each edge of a tile.
+  static constexpr int tile_edge_ = 8;
+  /// Number of positions handled at once by values_at().
+  static constexpr std::size_t values_at_batch_size = 256;
+  /// Number of tiles in x, y, z directions.
+  const std::array<int, 3> n_tiles_;
+  /// Whether a tile was written to since the last reset, for each tile.
+  std::vector<char> tile_occupied_;
+  /// Whether all tiles are treated as occupied, after untracked writes.
+  bool all_occupied_ = false;
 
  private:
+  /**
+   * Marks the tile containing the given cell as occupied.
+   *
+   * \param[in] ix The index of the cell in x direction.
+   * \param[in] iy The index of the cell in y direction.
+   * \param[in] iz The index of the cell in z direction.
+   */
+  void mark_tile(int ix, int iy, int iz) {
+    tile_occupied_[ix / tile_edge_ +
+                   n_tiles_[0] * (iy / tile_edge_ +
+                                  n_tiles_[1] * (iz / tile_edge_))] = 1;
+  }
+
+  /**
+   * Marks the tile containing a cell as occupied.
+   *
+   * \param[in] index 1D index of the cell.
+   */
+  void mark_tile_of(std::size_t index) {
+    const int ix = index % n_cells_[0];
+    const int iy = (index / n_cells_[0]) % n_cells_[1];
+    const int iz = index / (n_cells_[0] * n_cells_[1]);
+    mark_tile(ix, iy, iz);
+  }
+
+  /**
+   * Finds the tiles covering the cells from lower to upper (exclusive) in one
+   * direction. On a periodic lattice the cells can wrap around the lattice
+   * boundary, which splits the tiles into two ranges.
+   *
+   * \param[in] dir Direction (0, 1, 2 for x, y, z).
+   * \param[in] lower First cell index.
+   * \param[in] upper Cell index after the last one.
+   * \param[out] first First tile of each range.
+   * \param[out] last Last tile (inclusive) of each range.
+   * \return Number of tile ranges (0, 1 or 2).
+   */
+  int tile_ranges(int dir, int lower, int upper, std::array<int, 2>& first,
+                  std::array<int, 2>& last) const {
+    const int n = n_cells_[dir];
+    if (!periodic_) {
+      lower = std::max(lower, 0);
+      upper = std::min(upper, n);
+      if (upper <= lower) {
+        return 0;
+      }
+      first[0] = lower / tile_edge_;
+      last[0] = (upper - 1) / tile_edge_;
+      return 1;
+    }
+    const int width = upper - lower;
+    if (width <= 0) {
+      return 0;
+    }
+    if (width >= n) {
+      first[0] = 0;
+      last[0] = n_tiles_[dir] - 1;
+      return 1;
+    }
+    const int begin = positive_modulo(lower, n);
+    // last cell, without wrapping around the boundary
+    const int end = begin + width - 1;
+    first[0] = begin / tile_edge_;
+    if (end < n) {
+      last[0] = end / tile_edge_;
+      return 1;
+    }
+    last[0] = n_tiles_[dir] - 1;
+    first[1] = 0;
+    last[1] = (end - n) / tile_edge_;
+    return 2;
+  }
+
+  /**
+   * Marks all tiles overlapping with a sub-lattice as occupied.
+   *
+   * \param[in] lower_bounds Starting numbers of ix, iy, iz.
+   * \param[in] upper_bounds Ending numbers of ix, iy, iz.
+   */
+  void mark_tiles(const std::array<int, 3>& lower_bounds,
+                  const std::array<int, 3>& upper_bounds) {
+    if (all_occupied_) {
+      return;
+    }
+    std::array<std::array<int, 2>, 3> first, last;
+    std::array<int, 3> n_ranges;
+    for (int i = 0; i < 3; i++) {
+      n_ranges[i] =
+          tile_ranges(i, lower_bounds[i], upper_bounds[i], first[i], last[i]);
+    }
+    for (int rz = 0; rz < n_ranges[2]; rz++) {
+      for (int tz = first[2][rz]; tz <= last[2][rz]; tz++) {
+        for (int ry = 0; ry < n_ranges[1]; ry++) {
+          for (int ty = first[1][ry]; ty <= last[1][ry]; ty++) {
+            const int offset = n_tiles_[0] * (ty + n_tiles_[1] * tz);
+            for (int rx = 0; rx < n_ranges[0]; rx++) {
+              for (int tx = first[0][rx]; tx <= last[0][rx]; tx++) {
+                tile_occupied_[tx + offset] = 1;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Finds the index bounds of the cells whose centers lie within a rectangle
+   * around the given point, see iterate_in_rectangle().
+   *
+   * \param[in] point Center of the rectangle [fm].
+   * \param[in] rectangle Half side lengths of the rectangle [fm].
+   * \param[out] l_bounds Starting numbers for iterating ix, iy, iz.
+   * \param[out] u_bounds Ending numbers for iterating ix, iy, iz.
+   * \return False if the rectangle does not overlap with the lattice.
+   */
+  bool rectangle_bounds(const ThreeVector& point,
+                        const std::array<double, 3>& rectangle,
+                        std::array<int, 3>& l_bounds,
+                        std::array<int, 3>& u_bounds) const {
+    /* Array holds value at the cell center: r_center = r_0 + (i+0.5)cell_size,
+     * where i is index in any direction. Therefore we want cells with condition
+     * (r[i]-rectangle[i])/csize - 0.5 < i < (r[i]+rectangle[i])/csize - 0.5,
+     * r[i] = r_center[i] - r_0[i]
+     */
+    for (int i = 0; i < 3; i++) {
+      l_bounds[i] = std::ceil(
+          (point[i] - origin_[i] - rectangle[i]) / cell_sizes_[i] - 0.5);
+      u_bounds[i] = std::ceil(
+          (point[i] - origin_[i] + rectangle[i]) / cell_sizes_[i] - 0.5);
+    }
+
+    if (!periodic_) {
+      for (int i = 0; i < 3; i++) {
+        if (l_bounds[i] < 0) {
+          l_bounds[i] = 0;
+        }
+        if (u_bounds[i] > n_cells_[i]) {
+          u_bounds[i] = n_cells_[i];
+        }
+        if (l_bounds[i] > n_cells_[i] || u_bounds[i] < 0) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Implementation of iterate_sublattice() for const and non-const lattices.
+   *
+   * \tparam L Type of the lattice, possibly const qualified.
+   * \tparam F Type of the function.
+   * \param[in] lat The lattice to iterate.
+   * \param[in] lower_bounds Starting numbers for iterating ix, iy, iz.
+   * \param[in] upper_bounds Ending numbers for iterating ix, iy, iz.
+   * \param[in] func Function acting on the cells.
+   */
+  template <typename L, typename F>
+  static void iterate_sublattice_impl(L& lat,
+                                      const std::array<int, 3>& lower_bounds,
+                                      const std::array<int, 3>& upper_bounds,
+                                      F& func) {
+    logg[LLattice].debug(
+        "Iterating sublattice with lower bound index (", lower_bounds[0], ",",
+        lower_bounds[1], ",", lower_bounds[2], "), upper bound index (",
+        upper_bounds[0], ",", upper_bounds[1], ",", upper_bounds[2], ")");
+
+    const std::array<int, 3>& n_cells = lat.n_cells_;
+    if (lat.periodic_) {
+      for (int iz = lower_bounds[2]; iz < upper_bounds[2]; iz++) {
+        const int z_offset = lat.positive_modulo(iz, n_cells[2]) * n_cells[1];
+        for (int iy = lower_bounds[1]; iy < upper_bounds[1]; iy++) {
+          const int y_offset =
+              n_cells[0] * (lat.positive_modulo(iy, n_cells[1]) + z_offset);
+          for (int ix = lower_bounds[0]; ix < upper_bounds[0]; ix++) {
+            const int index = lat.positive_modulo(ix, n_cells[0]) + y_offset;
+            func(lat.lattice_[index], ix, iy, iz);
+          }
+        }
+      }
+    } else {
+      for (int iz = lower_bounds[2]; iz < upper_bounds[2]; iz++) {
+        const int z_offset = iz * n_cells[1];
+        for (int iy = lower_bounds[1]; iy < upper_bounds[1]; iy++) {
+          const int y_offset = n_cells[0] * (iy + z_offset);
+          for (int ix = lower_bounds[0]; ix < upper_bounds[0]; ix++) {
+            func(lat.lattice_[ix + y_offset], ix, iy, iz);
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Implementation of iterate_occupied() for const and non-const lattices.
+   *
+   * \tparam L Type of the lattice, possibly const qualified.
+   * \tparam F Type of the function.
+   * \param[in] lat The lattice to iterate.
+   * \param[in] func Function acting on the cells.
+   */
+  template <typename L, typename F>
+  static void iterate_occupied_impl(L& lat, F& func) {
+    const std::array<int, 3>& n_cells = lat.n_cells_;
+    if (lat.all_occupied_) {
+      const int n_nodes = n_cells[0] * n_cells[1] * n_cells[2];
+      for (int i = 0; i < n_nodes; i++) {
+        func(lat.lattice_[i], i);
+      }
+      return;
+    }
+    const std::array<int, 3>& n_tiles = lat.n_tiles_;
+    for (int tz = 0; tz < n_tiles[2]; tz++) {
+      const int z_end = std::min((tz + 1) * tile_edge_, n_cells[2]);
+      for (int ty = 0; ty < n_tiles[1]; ty++) {
+        const int y_end = std::min((ty + 1) * tile_edge_, n_cells[1]);
+        for (int tx = 0; tx < n_tiles[0]; tx++) {
+          if (!lat.tile_occupied_[tx + n_tiles[0] * (ty + n_tiles[1] * tz)]) {
+            continue;
+          }
+          const int x_end = std::min((tx + 1) * tile_edge_, n_cells[0]);
+          for (int iz = tz * tile_edge_; iz < z_end; iz++) {
+            for (int iy = ty * tile_edge_; iy < y_end; iy++) {
+              const int y_offset = n_cells[0] * (iy + n_cells[1] * iz);
+              for (int ix = tx * tile_edge_; ix < x_end; ix++) {
+                func(lat.lattice_[ix + y_offset], ix + y_offset);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
   /**
    * Returns division modulo, which is always between 0 and n-1
    * i%n is not suitable, because it returns results from -(n-1) to n-1
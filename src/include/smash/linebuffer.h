@@ -0,0 +1,109 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_LINEBUFFER_H_
+#define SRC_INCLUDE_SMASH_LINEBUFFER_H_
+
+#include <cstdio>
+#include <ostream>
+#include <string>
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * \brief Reusable buffer to format lines of text outputs.
+ *
+ * Numbers are converted to text without going through printf or iostreams:
+ * the significant decimal digits are obtained by scaling with an exactly
+ * representable power of ten, where the rounding error of the scaling is
+ * recovered with a fused multiply-add. This decides the rounding of almost all
+ * numbers. Only if a number lies too close to the middle between two decimal
+ * representations, or outside of the range of the fast path, std::snprintf
+ * is used. The text is therefore always identical to the one printf creates
+ * with the corresponding conversion.
+ *
+ * The buffer keeps its memory when it is written, such that formatting does
+ * not allocate once the longest line has been written.
+ */
+class LineBuffer {
+ public:
+  /**
+   * Append a number in the same way as printf with "%.<precision>g".
+   *
+   * \param[in] x Number.
+   * \param[in] precision Number of significant digits.
+   */
+  void append_general(double x, int precision = 6);
+
+  /**
+   * Append a number in the same way as printf with "%.<precision>e", which
+   * is also the output of streams with std::scientific.
+   *
+   * \param[in] x Number.
+   * \param[in] precision Number of digits after the decimal point.
+   */
+  void append_scientific(double x, int precision);
+
+  /**
+   * Append an integer.
+   * \param[in] x Integer.
+   */
+  void append(long long x);
+  /// \copydoc LineBuffer::append(long long)
+  void append(int x) { append(static_cast<long long>(x)); }
+  /// \copydoc LineBuffer::append(long long)
+  void append(size_t x);
+
+  /**
+   * Append text.
+   * \param[in] s Text.
+   */
+  void append(const std::string &s) { text_.append(s); }
+  /// \copydoc LineBuffer::append(const std::string&)
+  void append(const char *s) { text_.append(s); }
+  /**
+   * Append a single character.
+   * \param[in] c Character.
+   */
+  void append(char c) { text_.push_back(c); }
+
+  /// \return The formatted text.
+  const std::string &str() const { return text_; }
+
+  /// Discard the formatted text.
+  void clear() { text_.clear(); }
+
+  /**
+   * Write the formatted text and clear the buffer.
+   * \param[in] file File to write to.
+   */
+  void write_to(std::FILE *file);
+  /// \copydoc LineBuffer::write_to(std::FILE*)
+  void write_to(std::ostream &file);
+
+ private:
+  /**
+   * Append a number with std::snprintf, which is used when the fast path
+   * cannot decide on the rounding.
+   *
+   * \param[in] x Number.
+   * \param[in] precision Precision of the conversion.
+   * \param[in] scientific Whether to use "%e" instead of "%g".
+   */
+  void append_printf(double x, int precision, bool scientific);
+
+  /// The formatted text
+  std::string text_;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_LINEBUFFER_H_
@@ -15,6 +15,7 @@
 
 #include "file.h"
 #include "forwarddeclarations.h"
+#include "linebuffer.h"
 #include "outputinterface.h"
 #include "outputparameters.h"
 
@@ -69,8 +70,14 @@ class OscarOutput : public OutputInterface {
    *
    * \param[in] path Output path.
    * \param[in] name Name of the ouput.
+   * \param[in] async_write Whether and how the file is written in a separate
+   *                        thread.
+   * \param[in] selection Written particles, interactions and fields. Only the
+   *                      OSCAR2013 formats support a selection of the fields.
    */
-  OscarOutput(const bf::path &path, const std::string &name);
+  OscarOutput(const bf::path &path, const std::string &name,
+              const AsyncWriteParameters &async_write,
+              const OutputSelection &selection = OutputSelection());
 
   /**
    * Writes the initial particle information of an event to the oscar output.
@@ -91,12 +98,11 @@ class OscarOutput : public OutputInterface {
                    const EventInfo &) override;
 
   /**
-   * Writes a interaction prefix line and a line for every incoming and
-   * outgoing particle to the oscar output.
-   * \param[in] action Action that holds the information of the interaction.
-   * \param[in] density Density at the interaction point.
+   * Writes for every interaction a prefix line and a line for every incoming
+   * and outgoing particle to the oscar output.
+   * \param[in] records Records of the interactions.
    */
-  void at_interaction(const Action &action, const double density) override;
+  void at_interactions(ConstSpan<InteractionRecord> records) override;
 
   /**
    * Writes a prefix line then write out all current particles.
@@ -114,21 +120,53 @@ class OscarOutput : public OutputInterface {
  private:
   /**
    * Write single particle information line to output.
+   * \param[in] file File to write to.
    * \param[in] data Data of particle.
    */
-  void write_particledata(const ParticleData &data);
+  void write_particledata(std::FILE *file, const ParticleData &data);
+
+  /**
+   * Write the selected fields of a particle as a line to the output.
+   * \param[in] file File to write to.
+   * \param[in] data Data of particle.
+   */
+  void write_selected_fields(std::FILE *file, const ParticleData &data);
 
   /**
    * Write the particle information of a list of particles to the output.
-   * One line per particle.
+   * One line per particle. When writing asynchronously, the selected
+   * particles are copied and formatted by the writer thread.
    * \param[in] particles List of particles to be written
    */
   void write(const Particles &particles);
 
+  /**
+   * \param[in] record Record of an interaction.
+   * \return Whether the interaction is written by this output.
+   */
+  bool writes(const InteractionRecord &record) const;
+
+  /**
+   * Write the blocks of the interactions written by this output.
+   * \param[in] file File to write to.
+   * \param[in] records Records of the interactions.
+   */
+  void write_interactions(std::FILE *file,
+                          ConstSpan<InteractionRecord> records);
+
   /// Keep track of event number.
   int current_event_ = 0;
 
-  /// Full filepath of the output file.
+  /// Buffer in which the particle lines are formatted
+  LineBuffer line_;
+
+  /// Written particles, interactions and fields
+  const OutputSelection selection_;
+
+  /**
+   * Full filepath of the output file. It is declared last, such that the
+   * writer thread is done before the members its tasks use are destroyed.
+   */
   RenamingFilePtr file_;
 };
 
@@ -19,6 +19,7 @@
 #include "energymomentumtensor.h"
 #include "forwarddeclarations.h"
 #include "grandcan_thermalizer.h"
+#include "interactionrecord.h"
 #include "lattice.h"
 #include "macros.h"
 
@@ -65,7 +66,7 @@ struct EventInfo {
  * be called at predefined moments:
  * 1) At event start and event end: at_eventstart, at_eventend
  * 2) After every fixed time period: at_intermediate_time, thermodynamics_output
- * 3) At each interaction: at_interaction
+ * 3) For the interactions, e.g. of a time step: at_interactions
  */
 class OutputInterface {
  public:
@@ -189,15 +190,34 @@ class OutputInterface {
   }
 
   /**
-   * Called whenever an action modified one or more particles.
+   * Output launched once after the last event, if the run ended normally. It
+   * is not called if the run is aborted by an exception, such that outputs can
+   * leave their files incomplete in this case.
+   */
+  virtual void at_runend() {}
+
+  /**
+   * Called with the records of interactions which modified one or more
+   * particles, in the order in which they were performed. The records and
+   * their particles are only valid during the call.
+   *
+   * \param records The interactions, containing the initial and final state
+   *                etc.
+   */
+  virtual void at_interactions(ConstSpan<InteractionRecord> records) {
+    SMASH_UNUSED(records);
+  }
+
+  /**
+   * Pass a single action to at_interactions.
    *
    * \param action The action object, containing the initial and final state
    * etc.
    * \param density The density at the interaction point.
    */
-  virtual void at_interaction(const Action &action, const double density) {
-    SMASH_UNUSED(action);
-    SMASH_UNUSED(density);
+  void at_interaction(const Action &action, const double density) {
+    const InteractionRecord record = make_interaction_record(action, density);
+    at_interactions(ConstSpan<InteractionRecord>(&record, 1));
   }
 
   /**
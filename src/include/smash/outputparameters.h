@@ -7,17 +7,47 @@
 #ifndef SRC_INCLUDE_SMASH_OUTPUTPARAMETERS_H_
 #define SRC_INCLUDE_SMASH_OUTPUTPARAMETERS_H_
 
+#include <algorithm>
+#include <array>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "configuration.h"
 #include "density.h"
+#include "file.h"
 #include "forwarddeclarations.h"
 #include "logging.h"
+#include "outputselection.h"
 
 namespace smash {
 static constexpr int LExperiment = LogArea::Experiment::id;
 
+/// Parameters of the observables computed by the AnalysisOutput
+struct AnalysisParameters {
+  /// Names of the observables
+  std::vector<std::string> observables = {"Spectra", "Flow", "Multiplicity",
+                                          "Collision_Rate"};
+  /// PDG codes of the identified hadrons for spectra and flow
+  std::vector<int> species = {211, -211, 111, 321, -321, 2212, -2212};
+  /// Particles with |y| below this value are considered at midrapidity
+  double rapidity_cut = 0.5;
+  /// Range of the rapidity spectra
+  std::array<double, 2> rapidity_range = {{-4., 4.}};
+  /// Number of rapidity bins
+  int rapidity_bins = 40;
+  /// Range of the transverse momentum spectra and flow in GeV
+  std::array<double, 2> pt_range = {{0., 3.}};
+  /// Number of transverse momentum bins
+  int pt_bins = 30;
+  /// Highest harmonic of the flow coefficients
+  int max_harmonic = 4;
+  /// Range of the collision rate in fm
+  std::array<double, 2> time_range = {{0., 100.}};
+  /// Number of time bins
+  int time_bins = 100;
+};
+
 /**
  * Helper structure for Experiment to hold output options and parameters.
  * Experiment has one member of this struct.
@@ -34,8 +64,10 @@ struct OutputParameters {
         td_jQBS(false),
         td_smearing(true),
         td_only_participants(false),
+        td_single_precision(false),
         part_extended(false),
         part_only_final(OutputOnlyFinal::Yes),
+        part_single_precision(false),
         coll_extended(false),
         coll_printstartend(false),
         dil_extended(false),
@@ -68,25 +100,32 @@ struct OutputParameters {
       }
       td_smearing = subcon.take({"Smearing"}, true);
       td_only_participants = subcon.take({"Only_Participants"}, false);
+      td_single_precision = subcon.take({"Single_Precision"}, false);
     }
 
     if (conf.has_value({"Particles"})) {
       part_extended = conf.take({"Particles", "Extended"}, false);
       part_only_final =
           conf.take({"Particles", "Only_Final"}, OutputOnlyFinal::Yes);
+      part_single_precision =
+          conf.take({"Particles", "Single_Precision"}, false);
+      part_selection = read_selection(&conf, "Particles");
     }
 
     if (conf.has_value({"Collisions"})) {
       coll_extended = conf.take({"Collisions", "Extended"}, false);
       coll_printstartend = conf.take({"Collisions", "Print_Start_End"}, false);
+      coll_selection = read_selection(&conf, "Collisions");
     }
 
     if (conf.has_value({"Dileptons"})) {
       dil_extended = conf.take({"Dileptons", "Extended"}, false);
+      dil_selection = read_selection(&conf, "Dileptons");
     }
 
     if (conf.has_value({"Photons"})) {
       photons_extended = conf.take({"Photons", "Extended"}, false);
+      photons_selection = read_selection(&conf, "Photons");
     }
 
     if (conf.has_value({"Initial_Conditions"})) {
@@ -96,6 +135,43 @@ struct OutputParameters {
     if (conf.has_value({"Rivet"})) {
       subcon_for_rivet = conf["Rivet"];
     }
+
+    if (conf.has_value({"Analysis"})) {
+      analysis.observables =
+          conf.take({"Analysis", "Observables"}, analysis.observables);
+      analysis.species = conf.take({"Analysis", "Species"}, analysis.species);
+      analysis.rapidity_cut =
+          conf.take({"Analysis", "Rapidity_Cut"}, analysis.rapidity_cut);
+      analysis.rapidity_range =
+          conf.take({"Analysis", "Rapidity_Range"}, analysis.rapidity_range);
+      analysis.rapidity_bins =
+          conf.take({"Analysis", "Rapidity_Bins"}, analysis.rapidity_bins);
+      analysis.pt_range =
+          conf.take({"Analysis", "Pt_Range"}, analysis.pt_range);
+      analysis.pt_bins = conf.take({"Analysis", "Pt_Bins"}, analysis.pt_bins);
+      analysis.max_harmonic =
+          conf.take({"Analysis", "Max_Harmonic"}, analysis.max_harmonic);
+      analysis.time_range =
+          conf.take({"Analysis", "Time_Range"}, analysis.time_range);
+      analysis.time_bins =
+          conf.take({"Analysis", "Time_Bins"}, analysis.time_bins);
+    }
+
+    if (conf.has_value({"Asynchronous"})) {
+      async_write.enabled = conf.take({"Asynchronous", "Enable"}, true);
+      const double buffer_size_MiB =
+          conf.take({"Asynchronous", "Buffer_Size"}, 4.0);
+      const int max_pending =
+          conf.take({"Asynchronous", "Max_Pending_Buffers"}, 4);
+      if (buffer_size_MiB <= 0.0 || max_pending < 1) {
+        throw std::invalid_argument(
+            "Asynchronous output needs a positive Buffer_Size and at least "
+            "one pending buffer.");
+      }
+      async_write.buffer_size =
+          std::max<size_t>(1, buffer_size_MiB * 1024 * 1024);
+      async_write.max_pending_buffers = max_pending;
+    }
   }
 
   /**
@@ -115,6 +191,77 @@ struct OutputParameters {
     }
   }
 
+  /**
+   * Pass the selection of the written particles, interactions and fields to
+   * the output constructors
+   * \param[in] content Output content.
+   * \return Selection of the content, which accepts everything for contents
+   *         without selection.
+   */
+  const OutputSelection &get_selection(const std::string &content) const {
+    static const OutputSelection accept_all;
+    if (content == "Particles") {
+      return part_selection;
+    } else if (content == "Collisions") {
+      return coll_selection;
+    } else if (content == "Dileptons") {
+      return dil_selection;
+    } else if (content == "Photons") {
+      return photons_selection;
+    } else {
+      return accept_all;
+    }
+  }
+
+  /**
+   * Read the \c Filter and \c Columns options of an output content.
+   * \param[in,out] conf Output configuration, the options are taken from it.
+   * \param[in] content Output content.
+   * \return Selection of the written particles, interactions and fields.
+   * \throws invalid_argument for unknown fields or empty ranges.
+   */
+  static OutputSelection read_selection(Configuration *conf,
+                                        const char *content) {
+    OutputSelection selection;
+    if (conf->has_value({content, "Filter"})) {
+      const std::vector<int> pdg_codes =
+          conf->take({content, "Filter", "PDG"}, std::vector<int>());
+      for (int pdg : pdg_codes) {
+        selection.pdg_codes.push_back(PdgCode::from_decimal(pdg));
+      }
+      selection.rapidity_range = conf->take(
+          {content, "Filter", "Rapidity_Range"}, selection.rapidity_range);
+      selection.pt_range =
+          conf->take({content, "Filter", "Pt_Range"}, selection.pt_range);
+      selection.only_participants =
+          conf->take({content, "Filter", "Only_Participants"}, false);
+      selection.time_range =
+          conf->take({content, "Filter", "Time_Range"}, selection.time_range);
+      if (std::string(content) != "Particles") {
+        selection.process_types = conf->take(
+            {content, "Filter", "Process_Types"}, std::vector<int>());
+      }
+      for (const auto &range : {selection.rapidity_range, selection.pt_range,
+                                selection.time_range}) {
+        if (!(range[0] <= range[1])) {
+          throw std::invalid_argument(std::string("Output filter of ") +
+                                      content + ": empty range.");
+        }
+      }
+    }
+    if (conf->has_value({content, "Columns"})) {
+      const std::vector<std::string> names = conf->take({content, "Columns"});
+      for (const std::string &name : names) {
+        selection.fields.push_back(field_from_name(name));
+      }
+      if (selection.fields.empty()) {
+        throw std::invalid_argument(std::string("Output columns of ") +
+                                    content + ": no columns given.");
+      }
+    }
+    return selection;
+  }
+
   /// Point, where thermodynamic quantities are calculated
   ThreeVector td_position;
 
@@ -151,12 +298,18 @@ struct OutputParameters {
    */
   bool td_only_participants;
 
+  /// Whether the binary lattice and VTK outputs are written in single precision
+  bool td_single_precision;
+
   /// Extended format for particles output
   bool part_extended;
 
   /// Print only final particles in event
   OutputOnlyFinal part_only_final;
 
+  /// Whether the binary VTK particles output is written in single precision
+  bool part_single_precision;
+
   /// Extended format for collisions output
   bool coll_extended;
 
@@ -172,8 +325,26 @@ struct OutputParameters {
   /// Extended initial conditions output
   bool ic_extended;
 
+  /// Written particles and fields of the particles output
+  OutputSelection part_selection;
+
+  /// Written interactions and fields of the collisions output
+  OutputSelection coll_selection;
+
+  /// Written interactions and fields of the dilepton output
+  OutputSelection dil_selection;
+
+  /// Written interactions and fields of the photon output
+  OutputSelection photons_selection;
+
   /// Rivet specfic setup configurations
   Configuration subcon_for_rivet;
+
+  /// Whether and how the output files are written in a separate thread
+  AsyncWriteParameters async_write;
+
+  /// Observables of the analysis output
+  AnalysisParameters analysis;
 };
 
 }  // namespace smash
@@ -0,0 +1,217 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_OUTPUTSELECTION_H_
+#define SRC_INCLUDE_SMASH_OUTPUTSELECTION_H_
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "forwarddeclarations.h"
+#include "interactionrecord.h"
+#include "particledata.h"
+#include "pdgcode.h"
+
+namespace smash {
+
+/**
+ * \ingroup output
+ *
+ * Per-particle quantities that can be written by the particle based outputs.
+ * The enumerators are in the order of the extended OSCAR2013 format.
+ */
+enum class ParticleField {
+  /// Time coordinate
+  T,
+  /// x coordinate
+  X,
+  /// y coordinate
+  Y,
+  /// z coordinate
+  Z,
+  /// Effective mass
+  Mass,
+  /// Energy
+  P0,
+  /// x component of the momentum
+  Px,
+  /// y component of the momentum
+  Py,
+  /// z component of the momentum
+  Pz,
+  /// PDG code
+  Pdg,
+  /// Unique id of the particle
+  ID,
+  /// Electric charge
+  Charge,
+  /// Number of interactions of the particle
+  Ncoll,
+  /// Formation time
+  FormTime,
+  /// Cross section scaling factor
+  XsecFac,
+  /// Id of the process the particle was produced in
+  ProcIdOrigin,
+  /// Type of the process the particle was produced in
+  ProcTypeOrigin,
+  /// Time of the last interaction
+  TimeLastColl,
+  /// PDG code of the first mother
+  PdgMother1,
+  /// PDG code of the second mother
+  PdgMother2,
+};
+
+/**
+ * \param[in] field Particle field.
+ * \return Name of the field, as in the header of the OSCAR2013 format.
+ */
+const char *field_name(ParticleField field);
+
+/**
+ * \param[in] field Particle field.
+ * \return Unit of the field, as in the header of the OSCAR2013 format.
+ */
+const char *field_unit(ParticleField field);
+
+/**
+ * \param[in] field Particle field.
+ * \return Whether the field is an integer (otherwise a floating point number).
+ */
+bool field_is_integer(ParticleField field);
+
+/**
+ * \param[in] name Name of a field, as in the header of the OSCAR2013 format.
+ * \return The field.
+ * \throws invalid_argument for unknown names.
+ */
+ParticleField field_from_name(const std::string &name);
+
+/**
+ * \param[in] p Particle.
+ * \param[in] field Floating point field.
+ * \return Value of the field of the particle.
+ */
+double field_value(const ParticleData &p, ParticleField field);
+
+/**
+ * \param[in] p Particle.
+ * \param[in] field Integer field. PDG codes are returned in decimal
+ *            representation.
+ * \return Value of the field of the particle.
+ */
+std::int32_t integer_field_value(const ParticleData &p, ParticleField field);
+
+/**
+ * \param[in] extended Whether the extended particle information is included.
+ * \return The fields of the default or extended particle output, in the order
+ *         of the OSCAR2013 format.
+ */
+std::vector<ParticleField> default_fields(bool extended);
+
+/**
+ * \ingroup output
+ *
+ * \brief Selects which particles, interactions and particle fields an output
+ * writes.
+ *
+ * The criteria are evaluated before anything is serialized, such that
+ * outputs only written for a small subset of the particles or interactions,
+ * like dilepton or photon studies, do not have to format and write the rest.
+ * A default constructed selection accepts everything and keeps the fields of
+ * the output format.
+ */
+struct OutputSelection {
+  /// Accepted particle species, all if empty
+  std::vector<PdgCode> pdg_codes;
+  /// Accepted range of the longitudinal momentum rapidity
+  std::array<double, 2> rapidity_range = {
+      {-std::numeric_limits<double>::infinity(),
+       std::numeric_limits<double>::infinity()}};
+  /// Accepted range of the transverse momentum in GeV
+  std::array<double, 2> pt_range = {
+      {0., std::numeric_limits<double>::infinity()}};
+  /// Whether only particles which interacted at least once are accepted
+  bool only_participants = false;
+  /// Accepted process types of interactions, all if empty
+  std::vector<int> process_types;
+  /**
+   * Accepted time range in fm, compared with the time coordinate of the
+   * particles and the execution time of the interactions
+   */
+  std::array<double, 2> time_range = {
+      {-std::numeric_limits<double>::infinity(),
+       std::numeric_limits<double>::infinity()}};
+  /// Written particle fields in this order, the format's own if empty
+  std::vector<ParticleField> fields;
+
+  /// \return Whether particles are rejected based on their properties.
+  bool selects_particles() const;
+
+  /**
+   * \param[in] p Particle.
+   * \return Whether the particle is written.
+   */
+  bool accepts(const ParticleData &p) const {
+    const double t = p.position().x0();
+    return t >= time_range[0] && t <= time_range[1] &&
+           accepts_properties(p);
+  }
+
+  /**
+   * An interaction is written if its type and execution time are accepted
+   * and, if there are criteria on the particles, at least one incoming or
+   * outgoing particle fulfills them. The interaction is then written with
+   * all of its particles.
+   *
+   * \param[in] interaction Interaction.
+   * \return Whether the interaction is written.
+   */
+  bool accepts(const InteractionRecord &interaction) const;
+
+  /**
+   * \param[in] action Interaction.
+   * \return Whether the interaction is written, see above.
+   */
+  bool accepts(const Action &action) const {
+    return accepts(make_interaction_record(action, 0.));
+  }
+
+  /**
+   * \param[in] particles Particles.
+   * \return Number of accepted particles.
+   */
+  template <typename Container>
+  size_t count(const Container &particles) const {
+    if (!selects_particles()) {
+      return particles.size();
+    }
+    size_t n = 0;
+    for (const ParticleData &p : particles) {
+      n += accepts(p);
+    }
+    return n;
+  }
+
+ private:
+  /**
+   * \param[in] p Particle.
+   * \return Whether the species, kinematics and history of the particle are
+   *         accepted.
+   */
+  bool accepts_properties(const ParticleData &p) const;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_OUTPUTSELECTION_H_
@@ -8,6 +8,8 @@
 #define SRC_INCLUDE_SMASH_PARTICLETYPE_H_
 
 #include <cassert>
+#include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -15,6 +17,7 @@
 #include "forwarddeclarations.h"
 #include "macros.h"
 #include "pdgcode.h"
+#include "sha256.h"
 
 namespace smash {
 
@@ -291,11 +294,25 @@ class ParticleType {
   /**
    * Get the mass-dependent total width of a particle with mass m.
    *
+   * If width_tabulation_accuracy_ is positive, the width is interpolated from
+   * a table, which is computed when it is needed first.
+   *
    * \param[in] m Invariant mass of the decaying particle.
    * \return the total width for all modes for this mass
    */
   double total_width(const double m) const;
 
+  /**
+   * Accuracy of the tabulated total widths, relative to the width at the pole
+   * mass. If it is positive, total_width interpolates the width of every
+   * unstable type linearly on an adaptive mass grid, which is refined until
+   * the interpolation error in the middle and at the quarters of every
+   * interval is below the accuracy. This also speeds up the spectral
+   * functions. If it is zero, the widths are summed over the decay modes in
+   * every call.
+   */
+  static double width_tabulation_accuracy_;
+
   /**
    * Helper Function that containes the if-statement logic that decides if a
    * decay mode is either a hadronic and dilepton decay mode.
@@ -400,6 +417,14 @@ class ParticleType {
   double sample_resonance_mass(const double mass_stable,
                                const double cms_energy, int L = 0) const;
 
+  /**
+   * Whether sample_resonance_mass draws the mass by inverting a tabulated
+   * cumulative distribution instead of rejection sampling. The tables are
+   * built on first use for every mass of the stable particle and angular
+   * momentum.
+   */
+  static bool tabulated_resonance_masses_;
+
   /**
    * Resonance mass sampling for 2-particle final state with two resonances.
    *
@@ -547,6 +572,31 @@ class ParticleType {
     return pdgcode() < rhs.pdgcode();
   }
 
+  /**
+   * Compute the properties, which are otherwise computed when they are needed
+   * first: the minimal masses, the normalization of the spectral function,
+   * the tabulations of the widths of all decay modes and the tabulated total
+   * width (if width_tabulation_accuracy_ is positive).
+   */
+  void fill_caches() const;
+
+  /**
+   * Fill the caches (see fill_caches()) of all particle types. If the
+   * snapshot in \p tabulations_path was written for the same \p hash and
+   * width_tabulation_accuracy_, they
+   * are restored from it, otherwise they are computed and a new snapshot is
+   * stored.
+   *
+   * Nothing is done if \p tabulations_path is empty or locked by another
+   * process, the caches are then filled when they are needed.
+   *
+   * \param[in] hash The hash of the particle properties and decay modes.
+   * \param[in] tabulations_path The directory of the cached tabulations.
+   * \throw runtime_error if the snapshot cannot be written
+   */
+  static void fill_all_caches(sha256::Hash hash,
+                              const bf::path &tabulations_path);
+
   /**
    * \throw runtime_error if unstable particles have no decay modes
    *
@@ -641,11 +691,56 @@ class ParticleType {
   /// Container for the isospin multiplet information
   IsoParticleType *iso_multiplet_ = nullptr;
 
+  /**
+   * Sum of the partial widths of all decay modes, which is tabulated for
+   * total_width.
+   *
+   * \param[in] m Invariant mass of the decaying particle.
+   * \return the total width for all modes for this mass
+   */
+  double sum_of_partial_widths(double m) const;
+  /// Tabulate the total width on an adaptive mass grid, cf. total_width.
+  void tabulate_total_width() const;
+  /// Masses of the grid of the tabulated total width, empty if not tabulated
+  mutable std::vector<double> width_grid_masses_;
+  /// Total widths at the masses of width_grid_masses_
+  mutable std::vector<double> width_grid_values_;
+
   /// Maximum factor for single-res mass sampling, cf. sample_resonance_mass.
   mutable double max_factor1_ = 1.;
   /// Maximum factor for double-res mass sampling, cf. sample_resonance_masses.
   mutable double max_factor2_ = 1.;
 
+  /**
+   * Cumulative distributions of the resonance mass for one mass of the
+   * stable particle and one angular momentum, cf. sample_resonance_mass.
+   */
+  struct MassCdfTable;
+  /**
+   * Get the cumulative distributions of the resonance mass, which are
+   * tabulated on the first call.
+   *
+   * \param[in] mass_stable Mass of the stable particle.
+   * \param[in] L relative angular momentum of the final-state particles
+   * \return The table for the given stable mass and angular momentum.
+   */
+  const MassCdfTable &mass_cdf_table(double mass_stable, int L) const;
+  /**
+   * Sample the resonance mass of sample_resonance_mass from the tabulated
+   * cumulative distributions.
+   *
+   * \param[in] mass_stable Mass of the stable particle.
+   * \param[in] cms_energy center-of-mass energy of the 2-particle final state.
+   * \param[in] L relative angular momentum of the final-state particles
+   * \return The mass of the resonance particle or a negative value, if the
+   *         energy is not covered by the table.
+   */
+  double sample_tabulated_resonance_mass(double mass_stable, double cms_energy,
+                                         int L) const;
+  /// Mass CDF tables by angular momentum and mass of the stable particle
+  mutable std::map<std::pair<int, double>, std::shared_ptr<const MassCdfTable>>
+      mass_cdf_tables_;
+
   /**\ingroup logging
    * Writes all information about the particle type to the output stream.
    *
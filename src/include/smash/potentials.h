@@ -18,6 +18,7 @@
 #include "density.h"
 #include "forwarddeclarations.h"
 #include "particledata.h"
+#include "tabulation.h"
 #include "threevector.h"
 
 namespace smash {
@@ -116,6 +117,21 @@ class Potentials {
   double potential(const ThreeVector &r, const ParticleList &plist,
                    const ParticleType &acts_on) const;
 
+  /**
+   * Evaluates potential at point r, summing only over the particles in the
+   * neighborhood of r.
+   *
+   * \param[in] r Arbitrary space point where potential is calculated
+   * \param[in] cells Cell list of all particles to be used in \f$j^{\mu}\f$
+   *            calculation, built for the baryon density.
+   * \param[in] acts_on Type of particle on which potential is going to act.
+   * \return Total potential energy acting on the particle, see
+   *         potential(const ThreeVector &, const ParticleList &,
+   *         const ParticleType &).
+   */
+  double potential(const ThreeVector &r, const DensityCellList &cells,
+                   const ParticleType &acts_on) const;
+
   /**
    * Evaluates the scaling factor of the forces acting on the particles.
    *
@@ -301,6 +317,21 @@ class Potentials {
   virtual std::tuple<ThreeVector, ThreeVector, ThreeVector, ThreeVector>
   all_forces(const ThreeVector &r, const ParticleList &plist) const;
 
+  /**
+   * Evaluates the electric and magnetic components of the forces at point r,
+   * summing only over the particles in the neighborhood of r. This is used
+   * by update_momenta for particles, for which the forces are not available
+   * from the lattice.
+   *
+   * \param[in] r Arbitrary space point where potential gradient is calculated
+   * \param[in] cells Cell list of all particles to be used in \f$j^{\mu}\f$
+   *            calculation, built for the baryon density.
+   * \return (\f$E_B, B_B, E_{I3}, B_{I3}\f$) [GeV/fm], see
+   *         all_forces(const ThreeVector &, const ParticleList &).
+   */
+  virtual std::tuple<ThreeVector, ThreeVector, ThreeVector, ThreeVector>
+  all_forces(const ThreeVector &r, const DensityCellList &cells) const;
+
   /// \return Is Skyrme potential on?
   virtual bool use_skyrme() const { return use_skyrme_; }
   /// \return Is symmetry potential on?
@@ -331,6 +362,9 @@ class Potentials {
   /// \return cutoff radius in ntegration for coulomb potential in fm
   double coulomb_r_cut() const { return coulomb_r_cut_; }
 
+  /// \return Parameters of the density calculation used for the potentials
+  const DensityParameters &density_parameters() const { return param_; }
+
  private:
   /**
    * Struct that contains the gaussian smearing width \f$\sigma\f$,
@@ -398,6 +432,33 @@ class Potentials {
   /// Parameters of the VDF potential: exponents \f$b_i\f$
   std::vector<double> powers_;
 
+  /// Lower bound of the tabulated densities, in units of the saturation density
+  static constexpr double table_x_min = 0.05;
+  /// Upper bound of the tabulated densities, in units of the saturation density
+  static constexpr double table_x_max = 16.0;
+  /// Number of intervals of the tabulated density dependences
+  static constexpr size_t table_num = 8000;
+
+  /**
+   * Tabulation of \f$x^\tau\f$ and its derivative, with
+   * \f$x=|\rho_B|/\rho_0\f$, used by the Skyrme potential and force.
+   * Densities outside of the tabulated range are evaluated directly.
+   */
+  HermiteTabulation skyrme_table_;
+
+  /**
+   * Tabulation of \f$S(\rho_B)\f$ and its derivative with respect to
+   * \f$x=\rho_B/\rho_0\f$ in MeV, see symmetry_S().
+   */
+  HermiteTabulation symmetry_S_table_;
+
+  /**
+   * Tabulation of \f$G(y)=\sum_i C_i y^{b_i-2}\f$ and its derivative, with
+   * \f$y=|\rho_B|/\rho_0\f$, from which the factors \f$F_1\f$ and
+   * \f$F_2\f$ of the VDF potential and force follow.
+   */
+  HermiteTabulation vdf_table_;
+
   /**
    * Calculate the derivative of the symmetry potential with respect to
    * the isospin density in GeV * fm^3
@@ -434,6 +495,26 @@ class Potentials {
    *         net baryon density.
    */
   double dVsym_drhoB(const double rhoB, const double rhoI3) const;
+
+  /**
+   * Implementation of potential() for any container of the particles
+   * contributing to the densities at r.
+   *
+   * \tparam T Type of the particle container
+   */
+  template <typename T>
+  double potential_impl(const ThreeVector &r, const T &plist,
+                        const ParticleType &acts_on) const;
+
+  /**
+   * Implementation of all_forces() for any container of the particles
+   * contributing to the densities at r.
+   *
+   * \tparam T Type of the particle container
+   */
+  template <typename T>
+  std::tuple<ThreeVector, ThreeVector, ThreeVector, ThreeVector>
+  all_forces_impl(const ThreeVector &r, const T &plist) const;
 };
 
 }  // namespace smash
@@ -438,6 +438,38 @@ class BesselSampler {
   double sigma_;
 };
 
+/**
+ * Samples indices i with probabilities proportional to given weights w_i in
+ * constant time, using the alias method of Walker in the formulation of Vose
+ * \cite Vose1991. Building the table takes linear time in the number of
+ * weights, so it pays off compared to a cumulative scan if many indices are
+ * sampled from the same weights.
+ */
+class AliasSampler {
+ public:
+  /**
+   * Construct the alias table.
+   *
+   * \param[in] weights Non-negative weights, which do not have to be
+   *            normalized.
+   * \throw std::invalid_argument if there are no weights or their sum is not
+   *        positive.
+   */
+  explicit AliasSampler(const std::vector<double> &weights);
+
+  /// \return Randomly sampled index, i with probability w_i / sum_j w_j.
+  size_t sample() const;
+
+  /// \return Number of weights.
+  size_t size() const { return probability_.size(); }
+
+ private:
+  /// Probability to keep the index of a bin, else its alias is returned.
+  std::vector<double> probability_;
+  /// Alias of every bin.
+  std::vector<size_t> alias_;
+};
+
 }  // namespace random
 }  // namespace smash
 
@@ -122,11 +122,10 @@ class RootOutput : public OutputInterface {
                             const EventInfo &event) override;
   /**
    * Writes collisions to a tree defined by treename.
-   * \param[in] action an Action object containing incoming, outgoing particles
-   *            and type of interactions.
-   * \param[in] density Unused, needed since inherited.
+   * \param[in] records Records of the interactions containing incoming,
+   *            outgoing particles and type of interactions.
    */
-  void at_interaction(const Action &action, const double density) override;
+  void at_interactions(ConstSpan<InteractionRecord> records) override;
 
  private:
   /// Filename of output
@@ -162,9 +161,8 @@ class RootOutput : public OutputInterface {
    * \param[in] weight Total weight of the collision.
    * \param[in] partial_weight Partial weight of the collision
    */
-  void collisions_to_tree(const ParticleList &incoming,
-                          const ParticleList &outgoing, const double weight,
-                          const double partial_weight);
+  void collisions_to_tree(ParticleSpan incoming, ParticleSpan outgoing,
+                          const double weight, const double partial_weight);
   /// Number of output in a given event.
   int output_counter_ = 0;
   /// Number of current event.
@@ -10,6 +10,8 @@
 #ifndef SRC_INCLUDE_SMASH_SCATTERACTIONPHOTON_H_
 #define SRC_INCLUDE_SMASH_SCATTERACTIONPHOTON_H_
 
+#include <map>
+#include <memory>
 #include <utility>
 
 #include "scatteraction.h"
@@ -180,6 +182,23 @@ class ScatterActionPhoton : public ScatterAction {
   static bool is_kinematically_possible(const double s_sqrt,
                                         const ParticleList &in);
 
+  /**
+   * Tabulate the total and differential cross sections of all photon
+   * processes on grids in the rho mass, the center-of-mass energy above
+   * threshold and Mandelstam t. Afterwards, the cross sections are
+   * interpolated linearly in the mass and energy and cubically in t instead
+   * of evaluating the analytic expressions. The interpolation is compared to
+   * the analytic cross sections in the middle of every grid cell. Cells,
+   * where it deviates by more than the given accuracy, and points outside of
+   * the grids are still evaluated analytically.
+   *
+   * \param[in] accuracy Relative accuracy of the interpolation. For the
+   *                     differential cross sections, it refers to their
+   *                     average over t. If it is not positive, the tables
+   *                     are removed.
+   */
+  static void tabulate_cross_sections(double accuracy);
+
  private:
   /**
    * Holds the photon branch. As of now, this will always
@@ -219,6 +238,76 @@ class ScatterActionPhoton : public ScatterAction {
   /// Value used for default exchange particle. See MediatorType.
   static constexpr MediatorType default_mediator_ = MediatorType::SUM;
 
+  /**
+   * Cross section of one photon process on a grid, cf.
+   * tabulate_cross_sections.
+   */
+  struct CrossSectionTable;
+
+  /// Photon process and mediator, for which a cross section is tabulated
+  using CrossSectionKey = std::pair<ReactionType, MediatorType>;
+
+  /**
+   * \param[in] reaction Photon process.
+   * \param[in] mediator Mediating particle.
+   * \return The key of the tables of the cross sections. Charge conjugated
+   *         processes share the same tables, and the mediator is only
+   *         distinguished where several mediators contribute.
+   */
+  static CrossSectionKey cross_section_key(ReactionType reaction,
+                                           MediatorType mediator);
+
+  /// Tabulated total cross sections
+  static std::map<CrossSectionKey, std::shared_ptr<const CrossSectionTable>>
+      total_xs_tables_;
+
+  /// Tabulated differential cross sections
+  static std::map<CrossSectionKey, std::shared_ptr<const CrossSectionTable>>
+      diff_xs_tables_;
+
+  /**
+   * Compute the total cross section of a photon process from the analytic
+   * expressions. Formfactors are not included.
+   *
+   * \param[in] reaction Photon process.
+   * \param[in] s Mandelstam-s [GeV^2].
+   * \param[in] m_rho Mass of the incoming or outgoing rho-particle [GeV]
+   * \param[in] mediator Switch for determing which mediating particle to use
+   * \return Total cross section. [mb]
+   */
+  static double total_cross_section_analytic(ReactionType reaction, double s,
+                                             double m_rho,
+                                             MediatorType mediator);
+
+  /**
+   * Compute the differential cross section of a photon process from the
+   * analytic expressions. Formfactors are not included.
+   *
+   * \param[in] reaction Photon process.
+   * \param[in] s Mandelstam-s [GeV^2].
+   * \param[in] t Mandelstam-t [GeV^2].
+   * \param[in] m_rho Mass of the incoming or outgoing rho-particle [GeV]
+   * \param[in] mediator Switch for determing which mediating particle to use
+   * \return Differential cross section. [mb/\f$GeV^2\f$]
+   */
+  static double diff_cross_section_analytic(ReactionType reaction, double s,
+                                            double t, double m_rho,
+                                            MediatorType mediator);
+
+  /**
+   * Interpolate a cross section from its table.
+   *
+   * \param[in] table Tabulated cross section.
+   * \param[in] sqrts Center-of-mass energy [GeV].
+   * \param[in] m_rho Mass of the incoming or outgoing rho-particle [GeV]
+   * \param[in] t Mandelstam-t [GeV^2], ignored for total cross sections.
+   * \param[out] xs Interpolated cross section.
+   * \return Whether the point is covered by an accurate cell of the table.
+   */
+  static bool interpolate_cross_section(const CrossSectionTable &table,
+                                        double sqrts, double m_rho, double t,
+                                        double *xs);
+
   /// Weight of the produced photon.
   double weight_ = 0.0;
 
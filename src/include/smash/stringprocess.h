@@ -10,6 +10,7 @@
 #ifndef SRC_INCLUDE_SMASH_STRINGPROCESS_H_
 #define SRC_INCLUDE_SMASH_STRINGPROCESS_H_
 
+#include <array>
 #include <map>
 #include <memory>
 #include <string>
@@ -21,6 +22,7 @@
 #include "constants.h"
 #include "logging.h"
 #include "particledata.h"
+#include "tabulation.h"
 
 namespace smash {
 static constexpr int LPythia = LogArea::Pythia::id;
@@ -186,6 +188,28 @@ class StringProcess {
   /// An object to compute cross-sections
   Pythia8::SigmaTotal pythia_sigmatot_;
 
+  /// Tabulated diffractive cross sections of a pair of particles
+  struct DiffractiveXsTabulation {
+    /// Energy below which the cross sections are constant [GeV]
+    double sqrts_threshold;
+    /**
+     * Single diffractive cross sections AB->AX and AB->XB and double
+     * diffractive cross section AB->XX as a function of \f$\ln\sqrt{s}\f$,
+     * starting at the threshold
+     */
+    std::array<Tabulation, 3> xs;
+  };
+
+  /// Diffractive cross sections for every pair of PDG codes (A, B)
+  std::map<std::pair<int, int>, DiffractiveXsTabulation>
+      diffractive_xs_tabulations_;
+
+  /// Largest tabulated energy of the diffractive cross sections [GeV]
+  static constexpr double diffractive_xs_sqrts_max_ = 1.e4;
+
+  /// Step in \f$\ln\sqrt{s}\f$ of the diffractive cross section tabulations
+  static constexpr double diffractive_xs_dlog_sqrts_ = 0.005;
+
   /**
    * An object for the flavor selection in string fragmentation
    * in the case of separate fragmentation function for leading baryon
@@ -297,9 +321,33 @@ class StringProcess {
 
   // clang-format on
 
+  /**
+   * Initialize the PYTHIA objects for the hard string routine of the given
+   * beam particles in advance, such that the first hard string process of
+   * these particles does not have to wait for it. The particles are mapped
+   * with pdg_map_for_pythia() and both orders of every pair are initialized.
+   * Hard string processes of other particles still initialize their PYTHIA
+   * object when they first occur.
+   *
+   * \param[in] beams pairs of PDG codes of the beam particles
+   * \param[in] sqrts center of mass energy at which PYTHIA is initialized,
+   *            the energy is changed event by event afterwards [GeV]
+   */
+  void warm_up_hard_pythia(const std::vector<std::array<PdgCode, 2>> &beams,
+                           double sqrts);
+
+  /// \return number of initialized PYTHIA objects for the hard routine
+  size_t number_of_hard_pythia() const { return hard_map_.size(); }
+
   /**
    * Interface to pythia_sigmatot_ to compute cross-sections of A+B->
    * different final states \iref{Schuler:1993wr}.
+   *
+   * The cross sections only depend on the particles and the energy, so they
+   * are tabulated on a grid in \f$\ln\sqrt{s}\f$ for every pair of
+   * particles when they are first requested and interpolated linearly.
+   * Energies above the tabulated range are computed directly.
+   *
    * \param[in] pdg_a pdg code of incoming particle A
    * \param[in] pdg_b pdg code of incoming particle B
    * \param[in] sqrt_s collision energy in the center of mass frame [GeV]
@@ -307,26 +355,29 @@ class StringProcess {
    * double diffractive AB->XX.
    */
   std::array<double, 3> cross_sections_diffractive(int pdg_a, int pdg_b,
-                                                   double sqrt_s) {
-    // This threshold magic is following Pythia. Todo(ryu): take care of this.
-    double sqrts_threshold = 2. * (1. + 1.0e-6);
-    /* In the case of mesons, the corresponding vector meson masses
-     * are used to evaluate the energy threshold. */
-    const int pdg_a_mod =
-        (std::abs(pdg_a) > 1000) ? pdg_a : 10 * (std::abs(pdg_a) / 10) + 3;
-    const int pdg_b_mod =
-        (std::abs(pdg_b) > 1000) ? pdg_b : 10 * (std::abs(pdg_b) / 10) + 3;
-    sqrts_threshold += pythia_hadron_->particleData.m0(pdg_a_mod) +
-                       pythia_hadron_->particleData.m0(pdg_b_mod);
-    /* Constant cross-section for sub-processes below threshold equal to
-     * cross-section at the threshold. */
-    if (sqrt_s < sqrts_threshold) {
-      sqrt_s = sqrts_threshold;
-    }
-    pythia_sigmatot_.calc(pdg_a, pdg_b, sqrt_s);
-    return {pythia_sigmatot_.sigmaAX(), pythia_sigmatot_.sigmaXB(),
-            pythia_sigmatot_.sigmaXX()};
-  }
+                                                   double sqrt_s);
+
+  /**
+   * Compute the cross sections of cross_sections_diffractive() with PYTHIA,
+   * without using the tabulation.
+   *
+   * \param[in] pdg_a pdg code of incoming particle A
+   * \param[in] pdg_b pdg code of incoming particle B
+   * \param[in] sqrt_s collision energy in the center of mass frame [GeV]
+   * \return array with single diffractive cross-sections AB->AX, AB->XB and
+   * double diffractive AB->XX.
+   */
+  std::array<double, 3> compute_cross_sections_diffractive(int pdg_a,
+                                                           int pdg_b,
+                                                           double sqrt_s);
+
+  /**
+   * \param[in] pdg_a pdg code of incoming particle A
+   * \param[in] pdg_b pdg code of incoming particle B
+   * \return energy below which the diffractive cross sections are taken to be
+   *         constant [GeV]
+   */
+  double sqrts_threshold_diffractive(int pdg_a, int pdg_b) const;
 
   /**
    * \todo The following set_ functions are replaced with
@@ -475,6 +526,18 @@ class StringProcess {
    * \return whether the process is successfully implemented.
    */
   bool next_NDiffHard();
+  /**
+   * Find the PYTHIA object for the hard string routine of the given
+   * (mapped) beam particles, or initialize it if there is none yet.
+   *
+   * \param[in] idAB PDG codes of the beam particles used in PYTHIA
+   * \param[in] sqrts center of mass energy at which a new PYTHIA object is
+   *            initialized [GeV]
+   * \return the PYTHIA object
+   *
+   * \throw std::runtime_error if PYTHIA fails to initialize
+   */
+  Pythia8::Pythia *hard_pythia(std::pair<int, int> idAB, double sqrts);
   /**
    * Baryon-antibaryon annihilation process
    * Based on what UrQMD \iref{Bass:1998ca}, \iref{Bleicher:1999xi} does,
@@ -8,10 +8,13 @@
 #ifndef SRC_INCLUDE_SMASH_TABULATION_H_
 #define SRC_INCLUDE_SMASH_TABULATION_H_
 
+#include <algorithm>
+#include <cassert>
 #include <fstream>
 #include <functional>
 #include <map>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "forwarddeclarations.h"
@@ -119,6 +122,92 @@ class Tabulation {
   double inv_dx_;
 };
 
+/**
+ * Tabulation of a smooth function together with its derivative on an
+ * equidistant grid. Intermediate values are obtained by cubic Hermite
+ * interpolation, which reproduces function and derivative at the grid points.
+ * The derivative returned along with the value is the exact derivative of the
+ * interpolating polynomial, such that both are consistent with each other.
+ */
+class HermiteTabulation {
+ public:
+  /// Construct an empty tabulation object.
+  HermiteTabulation() : x_min_(0.0), x_max_(0.0), dx_(0.0), inv_dx_(0.0) {}
+
+  /**
+   * Construct a new tabulation object.
+   *
+   * \param x_min lower bound of tabulation domain
+   * \param range range (x_max-x_min) of tabulation domain
+   * \param num number of intervals (the number of tabulated points is actually
+   * num+1)
+   * \param f function returning the value f(x) and the derivative f'(x) of the
+   * function which is supposed to be tabulated
+   * \throws if less than two values are tabulated.
+   */
+  HermiteTabulation(double x_min, double range, size_t num,
+                    std::function<std::pair<double, double>(double)> f);
+
+  /// \returns whether the tabulation is empty.
+  bool is_empty() const { return values_.empty(); }
+
+  /**
+   * \param x Argument to tabulated function.
+   * \returns whether x lies within the tabulation domain.
+   */
+  bool covers(double x) const {
+    return !values_.empty() && x >= x_min_ && x <= x_max_;
+  }
+
+  /**
+   * Look up value and derivative from the tabulation using cubic Hermite
+   * interpolation. The argument has to be within the tabulation domain, see
+   * covers().
+   *
+   * \param x Argument to tabulated function.
+   * \return Interpolated value and its derivative with respect to x.
+   */
+  std::pair<double, double> get_value_and_derivative(double x) const {
+    assert(covers(x));
+    const double index_double = (x - x_min_) * inv_dx_;
+    // here n is the lower index
+    const size_t n =
+        std::min(static_cast<size_t>(index_double), values_.size() - 2);
+    const double t = index_double - n;
+    const double t2 = t * t;
+    const double f0 = values_[n];
+    const double f1 = values_[n + 1];
+    // derivatives with respect to t
+    const double d0 = derivatives_[n] * dx_;
+    const double d1 = derivatives_[n + 1] * dx_;
+    const double value = f0 + t * d0 +
+                         t2 * (3. * (f1 - f0) - 2. * d0 - d1) +
+                         t2 * t * (2. * (f0 - f1) + d0 + d1);
+    const double derivative = d0 + 2. * t * (3. * (f1 - f0) - 2. * d0 - d1) +
+                              3. * t2 * (2. * (f0 - f1) + d0 + d1);
+    return std::make_pair(value, derivative * inv_dx_);
+  }
+
+ private:
+  /// vector for storing tabulated values
+  std::vector<double> values_;
+
+  /// vector for storing tabulated derivatives
+  std::vector<double> derivatives_;
+
+  /// lower bound for tabulation
+  double x_min_;
+
+  /// upper bound for tabulation
+  double x_max_;
+
+  /// step size dx
+  double dx_;
+
+  /// inverse step size 1/dx
+  double inv_dx_;
+};
+
 /**
  * Spectral function integrand for GSL integration, with one resonance in the
  * final state (the second particle is stable).
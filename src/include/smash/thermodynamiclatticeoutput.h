@@ -10,6 +10,8 @@
 #ifndef SRC_INCLUDE_SMASH_THERMODYNAMICLATTICEOUTPUT_H_
 #define SRC_INCLUDE_SMASH_THERMODYNAMICLATTICEOUTPUT_H_
 
+#include <array>
+#include <cstring>
 #include <map>
 #include <memory>
 #include <set>
@@ -22,6 +24,9 @@
 #include "experimentparameters.h"
 #include "file.h"
 #include "forwarddeclarations.h"
+#include "fourvector.h"
+#include "lattice.h"
+#include "linebuffer.h"
 #include "logging.h"
 #include "outputinterface.h"
 #include "outputparameters.h"
@@ -45,6 +50,9 @@ class ThermodynamicLatticeOutput : public OutputInterface {
   /// Version of the thermodynamic lattice output
   static const double_t version;
 
+  /// Version of the binary thermodynamic lattice output in single precision
+  static const double_t single_precision_version;
+
   /**
    * Construct Output
    * \param[in] path Path to output
@@ -105,7 +113,9 @@ class ThermodynamicLatticeOutput : public OutputInterface {
    * \param[in] lattice DensityOnLattice lattice to use.
    * \param[in] current_time The output time in the computational frame
    * \param[in] ensembles Particles, from which the 4-currents j_{Q,B,S} are
-   *            computed
+   *            computed. With smearing every particle is deposited once onto
+   *            the nodes within the cutoff radius, in the same way as in
+   *            update_lattice().
    * * \param[in] dens_param set of parameters, defining smearing.
    *            For more info about
    *            smearing see \ref thermodyn_output_user_guide_.
@@ -172,6 +182,47 @@ class ThermodynamicLatticeOutput : public OutputInterface {
   void write_therm_lattice_binary_header(std::shared_ptr<std::ofstream> file,
                                          const ThermodynamicQuantity &tq);
 
+  /**
+   * Start the binary encoding of a time slice in slab_.
+   *
+   * \param[in] ctime The output time in the computational frame.
+   */
+  void begin_binary_slice(double ctime);
+
+  /**
+   * Append a value of the current time slice to slab_, in single or double
+   * precision.
+   *
+   * \param[in] x Value to be written.
+   */
+  void append_binary_value(double x) {
+    if (single_precision_) {
+      const float f = static_cast<float>(x);
+      append_binary_raw(&f, sizeof(f));
+    } else {
+      append_binary_raw(&x, sizeof(x));
+    }
+  }
+
+  /**
+   * Append raw bytes to slab_.
+   *
+   * \param[in] data Bytes to be written.
+   * \param[in] size Number of bytes.
+   */
+  void append_binary_raw(const void *data, size_t size) {
+    const size_t old_size = slab_.size();
+    slab_.resize(old_size + size);
+    std::memcpy(slab_.data() + old_size, data, size);
+  }
+
+  /**
+   * Write the encoded time slice to a binary file with a single call.
+   *
+   * \param[in] fp Output file.
+   */
+  void write_binary_slice(std::ofstream *fp);
+
   /**
    * Convert a ThermodynamicQuantity into an int
    * \param[in] tq The quantity to be converted, see ThermodynamicQuantity.
@@ -209,6 +260,26 @@ class ThermodynamicLatticeOutput : public OutputInterface {
 
   /// enable output, of any kind (if False, the object does nothing)
   bool enable_output_;
+
+  /// write the binary output in single instead of double precision
+  bool single_precision_;
+
+  /**
+   * Binary encoding of the current time slice, which is written with a single
+   * call instead of one call per value
+   */
+  std::vector<char> slab_;
+
+  /// Buffer in which the lines of the ASCII output are formatted
+  LineBuffer line_;
+
+  /**
+   * Lattice on which the 4-currents j_Q, j_B and j_S of every particle are
+   * deposited once per output time, instead of summing over all particles
+   * for every node
+   */
+  std::unique_ptr<RectangularLattice<std::array<FourVector, 3>>>
+      jQBS_lattice_;
 };
 
 }  // namespace smash
@@ -0,0 +1,157 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#ifndef SRC_INCLUDE_SMASH_THREADPOOL_H_
+#define SRC_INCLUDE_SMASH_THREADPOOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace smash {
+
+/**
+ * \ingroup data
+ * A fixed set of threads, which are started once and then repeatedly share
+ * the work of loops over independent indices with the calling thread.
+ *
+ * All parallel parts of SMASH use the pool returned by global(), such that
+ * the number of threads is set in a single place (see \key Threads in
+ * \ref input_general_) and no threads are started while the simulation runs.
+ * If a loop is started while the pool is already busy, e.g. from within
+ * another loop, it runs in the calling thread only.
+ */
+class ThreadPool {
+ public:
+  /**
+   * Start the threads of the pool.
+   *
+   * \param[in] n_threads Number of threads working on a loop, including the
+   *            calling thread. 0 means one thread per hardware thread.
+   */
+  explicit ThreadPool(std::size_t n_threads);
+
+  /// Stop and join the threads of the pool.
+  ~ThreadPool();
+
+  /// Cannot be copied
+  ThreadPool(const ThreadPool &) = delete;
+  /// Cannot be copied
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /// \return Number of threads working on a loop, including the caller.
+  std::size_t size() const { return workers_.size() + 1; }
+
+  /**
+   * Call a function for all indices in [0, n). The indices are handed out in
+   * chunks of consecutive indices, in the order of the indices, to the
+   * threads of the pool and to the calling thread. If the function throws,
+   * the remaining chunks are skipped and the first exception is rethrown
+   * after all threads have finished.
+   *
+   * \tparam F Type of the function.
+   * \param[in] n Number of indices.
+   * \param[in] chunk Number of consecutive indices handed out at once. Fewer
+   *            threads are used if there are less than size() chunks.
+   * \param[in] f Function of the index and of the number of the thread in
+   *            [0, size()), which can be used to access per thread data. It
+   *            has to be safe to call concurrently for different indices.
+   */
+  template <typename F>
+  void for_each_index(std::size_t n, std::size_t chunk, const F &f) {
+    chunk = std::max<std::size_t>(chunk, 1);
+    const std::size_t n_chunks = (n + chunk - 1) / chunk;
+    std::atomic<std::size_t> next_chunk{0};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    run(std::min(n_chunks, size()), [&](std::size_t thread) {
+      for (std::size_t c = next_chunk++; c < n_chunks; c = next_chunk++) {
+        try {
+          for (std::size_t i = c * chunk; i < std::min((c + 1) * chunk, n);
+               i++) {
+            f(i, thread);
+          }
+        } catch (...) {
+          std::lock_guard<std::mutex> error_lock(error_mutex);
+          if (!error) {
+            error = std::current_exception();
+          }
+          next_chunk = n_chunks;
+        }
+      }
+    });
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  /**
+   * \return The pool shared by all parallel parts of SMASH. It consists of
+   *         the calling thread only, unless set_global_size() was called.
+   */
+  static ThreadPool &global();
+
+  /**
+   * Replace the global pool by one with the given number of threads. Must not
+   * be called while the global pool is in use.
+   *
+   * \param[in] n_threads Number of threads, see ThreadPool().
+   */
+  static void set_global_size(std::size_t n_threads);
+
+ private:
+  /**
+   * Run a task in the calling thread and in n_threads - 1 threads of the
+   * pool, and wait until all of them are done. If the pool is busy, the task
+   * runs in the calling thread only.
+   *
+   * \param[in] n_threads Number of threads to use, at most size().
+   * \param[in] task Task, called with the number of the thread.
+   */
+  void run(std::size_t n_threads,
+           const std::function<void(std::size_t)> &task);
+
+  /**
+   * Loop of a thread of the pool, waiting for tasks.
+   *
+   * \param[in] thread Number of the thread, starting at 1.
+   */
+  void work(std::size_t thread);
+
+  /// Threads of the pool, besides the calling thread.
+  std::vector<std::thread> workers_;
+  /// Whether a task is running.
+  std::atomic<bool> busy_{false};
+  /// Protects the members below.
+  std::mutex mutex_;
+  /// Signals a new task or the end of the pool to the threads.
+  std::condition_variable start_;
+  /// Signals the calling thread that all threads are done.
+  std::condition_variable done_;
+  /// Current task.
+  const std::function<void(std::size_t)> *task_ = nullptr;
+  /// Number of threads of the pool that take part in the current task.
+  std::size_t n_task_threads_ = 0;
+  /// Number of threads of the pool still working on the current task.
+  std::size_t n_running_ = 0;
+  /// Counts the tasks, such that the threads recognize a new one.
+  std::size_t generation_ = 0;
+  /// Whether the threads should stop.
+  bool stop_ = false;
+};
+
+}  // namespace smash
+
+#endif  // SRC_INCLUDE_SMASH_THREADPOOL_H_
@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2020
+ *    Copyright (c) 2014-2021
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -10,6 +10,8 @@
 #ifndef SRC_INCLUDE_SMASH_VTKOUTPUT_H_
 #define SRC_INCLUDE_SMASH_VTKOUTPUT_H_
 
+#include <cstdio>
+#include <fstream>
 #include <memory>
 #include <string>
 #include <utility>
@@ -35,9 +37,11 @@ class VtkOutput : public OutputInterface {
    * \param path Path to the output file.
    * \param name Name of the output.
    * \param out_par Additional information on the configured output.
+   * \param binary Whether the data is written in the binary instead of the
+   *               ASCII legacy VTK format.
    */
   VtkOutput(const bf::path &path, const std::string &name,
-            const OutputParameters &out_par);
+            const OutputParameters &out_par, bool binary = false);
   ~VtkOutput();
 
   /**
@@ -121,6 +125,51 @@ class VtkOutput : public OutputInterface {
    */
   void write(const Particles &particles);
 
+  /**
+   * Encode the given particles in the binary legacy VTK format and write them
+   * to the file with a single call.
+   *
+   * \param file Output file.
+   * \param particles The particles.
+   */
+  void write_binary(std::FILE *file, const Particles &particles);
+
+  /**
+   * Append a value to buffer_ in big-endian byte order, as required by the
+   * binary legacy VTK format.
+   *
+   * \param value Value to be appended.
+   */
+  template <typename T>
+  void append_big_endian(T value);
+
+  /**
+   * Append a floating point value to buffer_, in single or double precision.
+   *
+   * \param value Value to be appended.
+   */
+  void append_real(double value) {
+    if (single_precision_) {
+      append_big_endian(static_cast<float>(value));
+    } else {
+      append_big_endian(value);
+    }
+  }
+
+  /// \return VTK data type of the floating point values.
+  const char *real_type() const {
+    return single_precision_ ? "float" : "double";
+  }
+
+  /**
+   * Write the binary encoding of a lattice output from buffer_ to the file
+   * with a single call. Does nothing for the ASCII format, which is written
+   * directly.
+   *
+   * \param file Output file.
+   */
+  void write_buffer(std::ofstream &file);
+
   /**
    * Make a file name given a description and a counter.
    *
@@ -197,6 +246,18 @@ class VtkOutput : public OutputInterface {
   bool is_thermodynamics_output_;
   /// Is the VTK output an output for fields
   bool is_fields_output_;
+  /// Is the data written in the binary legacy VTK format
+  bool binary_;
+  /**
+   * Are floating point values written in single precision (binary only,
+   * never for the fields output)
+   */
+  bool single_precision_;
+  /**
+   * Binary encoding of the current file, which is written with a single
+   * call instead of one call per value
+   */
+  std::string buffer_;
 };
 
 }  // namespace smash
@@ -0,0 +1,68 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/interactionrecord.h"
+
+#include "smash/action.h"
+
+namespace smash {
+
+InteractionRecord make_interaction_record(const Action &action,
+                                          double density) {
+  InteractionRecord record;
+  record.type = action.get_type();
+  record.time = action.time_of_execution();
+  record.total_weight = action.get_total_weight();
+  record.partial_weight = action.get_partial_weight();
+  record.density = density;
+  record.interaction_point = action.get_interaction_point();
+  record.incoming = action.incoming_particles();
+  record.outgoing = action.outgoing_particles();
+  return record;
+}
+
+void InteractionBatch::add(const Action &action, double density) {
+  records_.push_back(make_interaction_record(action, density));
+  add_particles(action.incoming_particles(), action.outgoing_particles());
+}
+
+void InteractionBatch::add(const InteractionRecord &record) {
+  records_.push_back(record);
+  add_particles(record.incoming, record.outgoing);
+}
+
+void InteractionBatch::add_wall_crossing(const ParticleData &incoming,
+                                         const ParticleData &outgoing) {
+  InteractionRecord record;
+  record.type = ProcessType::Wall;
+  record.time = incoming.position().x0();
+  record.interaction_point = incoming.position();
+  records_.push_back(record);
+  add_particles(ParticleSpan(&incoming, 1), ParticleSpan(&outgoing, 1));
+}
+
+void InteractionBatch::add_particles(ParticleSpan incoming,
+                                     ParticleSpan outgoing) {
+  extents_.push_back({particles_.size(), incoming.size(), outgoing.size()});
+  particles_.insert(particles_.end(), incoming.begin(), incoming.end());
+  particles_.insert(particles_.end(), outgoing.begin(), outgoing.end());
+}
+
+ConstSpan<InteractionRecord> InteractionBatch::records() {
+  for (size_t i = 0; i < records_.size(); i++) {
+    const Extent &extent = extents_[i];
+    const ParticleData *first = particles_.data() + extent.first;
+    records_[i].incoming = ParticleSpan(first, extent.n_incoming);
+    records_[i].outgoing =
+        ParticleSpan(first + extent.n_incoming, extent.n_outgoing);
+  }
+  return records_;
+}
+
+}  // namespace smash
@@ -7,6 +7,9 @@
 
 #include "smash/interpolation2D.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <initializer_list>
 #include <iostream>
 #include <stdexcept>
@@ -68,4 +71,99 @@ double InterpolateData2DSpline::operator()(double xi, double yi) const {
   return gsl_spline2d_eval(spline_, xi, yi, xacc_, yacc_);
 }
 
+InterpolateData2DUniform::InterpolateData2DUniform(
+    const std::function<double(double, double)>& f, double x_min,
+    double x_max, size_t n_x, double y_min, double y_max, size_t n_y,
+    bool logarithmic_x)
+    : n_x_(n_x), n_y_(n_y), logarithmic_x_(logarithmic_x) {
+  if (n_x < 2 || n_y < 2 || !(x_max > x_min) || !(y_max > y_min) ||
+      (logarithmic_x && !(x_min > 0.))) {
+    throw std::invalid_argument(
+        "Need at least 2 increasing values in each dimension for uniform 2D "
+        "interpolation.");
+  }
+  x_min_ = logarithmic_x ? std::log(x_min) : x_min;
+  const double dx = ((logarithmic_x ? std::log(x_max) : x_max) - x_min_) /
+                    (n_x - 1);
+  const double dy = (y_max - y_min) / (n_y - 1);
+  inv_dx_ = 1. / dx;
+  y_min_ = y_min;
+  inv_dy_ = 1. / dy;
+  z_.resize(n_x * n_y);
+  for (size_t j = 0; j < n_y; j++) {
+    // the last values are set exactly to avoid rounding beyond the range
+    const double y = (j + 1 == n_y) ? y_max : y_min + j * dy;
+    for (size_t i = 0; i < n_x; i++) {
+      const double x_i = x_min_ + i * dx;
+      const double x = (i == 0)         ? x_min
+                       : (i + 1 == n_x) ? x_max
+                       : logarithmic_x  ? std::exp(x_i)
+                                        : x_i;
+      z_[j * n_x + i] = f(x, y);
+    }
+  }
+}
+
+/**
+ * Compute the cell and the weights of the Catmull-Rom interpolation of the
+ * four nodes around it in one dimension. Beyond the edges, the missing node is
+ * extrapolated linearly from the two outmost nodes, which keeps the edge cells
+ * as accurate as the inner ones for smooth functions.
+ *
+ * \param[in] u Position in units of the grid spacing, starting at 0.
+ * \param[in] n Number of nodes.
+ * \param[out] nodes Indices of the four nodes. At the edges, the extrapolated
+ *                   node is replaced by a valid index with zero weight.
+ * \return Weights of the nodes.
+ */
+static std::array<double, 4> catmull_rom_weights(double u, size_t n,
+                                                 std::array<size_t, 4>* nodes) {
+  // constant extrapolation at the edges
+  u = std::min(std::max(u, 0.), static_cast<double>(n - 1));
+  const size_t i = std::min(static_cast<size_t>(u), n - 2);
+  const double t = u - i;
+  const double t2 = t * t;
+  const double t3 = t2 * t;
+  std::array<double, 4> w = {
+      0.5 * (-t3 + 2. * t2 - t), 0.5 * (3. * t3 - 5. * t2 + 2.),
+      0.5 * (-3. * t3 + 4. * t2 + t), 0.5 * (t3 - t2)};
+  (*nodes)[1] = i;
+  (*nodes)[2] = i + 1;
+  if (i == 0) {
+    // ghost node z[-1] = 2 z[0] - z[1]
+    w[1] += 2. * w[0];
+    w[2] -= w[0];
+    w[0] = 0.;
+    (*nodes)[0] = 0;
+  } else {
+    (*nodes)[0] = i - 1;
+  }
+  if (i + 2 == n) {
+    // ghost node z[n] = 2 z[n - 1] - z[n - 2]
+    w[2] += 2. * w[3];
+    w[1] -= w[3];
+    w[3] = 0.;
+    (*nodes)[3] = n - 1;
+  } else {
+    (*nodes)[3] = i + 2;
+  }
+  return w;
+}
+
+double InterpolateData2DUniform::operator()(double xi, double yi) const {
+  const double u =
+      ((logarithmic_x_ ? std::log(xi) : xi) - x_min_) * inv_dx_;
+  std::array<size_t, 4> ix, iy;
+  const std::array<double, 4> wx = catmull_rom_weights(u, n_x_, &ix);
+  const std::array<double, 4> wy =
+      catmull_rom_weights((yi - y_min_) * inv_dy_, n_y_, &iy);
+  double result = 0.;
+  for (size_t b = 0; b < 4; b++) {
+    const double* row = &z_[iy[b] * n_x_];
+    result += wy[b] * (wx[0] * row[ix[0]] + wx[1] * row[ix[1]] +
+                       wx[2] * row[ix[2]] + wx[3] * row[ix[3]]);
+  }
+  return result;
+}
+
 }  // namespace smash
@@ -7,12 +7,18 @@
 
 #include "smash/isoparticletype.h"
 
+#include <algorithm>
+#include <mutex>
+#include <unordered_set>
+
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
 
+#include "smash/decaymodes.h"
 #include "smash/filelock.h"
 #include "smash/integrate.h"
 #include "smash/logging.h"
+#include "smash/threadpool.h"
 
 namespace smash {
 static constexpr int LParticleType = LogArea::ParticleType::id;
@@ -179,9 +185,6 @@ void IsoParticleType::create_multiplet(const ParticleType &type) {
   multiplet.add_state(type);
 }
 
-static Integrator integrate;
-static Integrator2d integrate2d;
-
 /**
  * Tabulation of all N R integrals.
  *
@@ -223,45 +226,101 @@ static bf::path generate_tabulation_path(const bf::path &dir,
   return dir / (prefix + res_name + ".bin");
 }
 
-inline void cache_integral(
-    std::unordered_map<std::string, Tabulation> &tabulations,
-    const bf::path &dir, sha256::Hash hash, const IsoParticleType &part,
-    const IsoParticleType &res, const IsoParticleType *antires, bool unstable) {
+/// An integral over the spectral functions of a particle and a resonance.
+struct SpectralIntegral {
+  /// Tabulations the integral is stored in
+  std::unordered_map<std::string, Tabulation> *tabulations;
+  /// Multiplet of the particle
+  const IsoParticleType *part;
+  /// Multiplet of the resonance
+  const IsoParticleType *res;
+  /// Anti-multiplet of the resonance, which shares the integral, or nullptr
+  const IsoParticleType *antires;
+  /// Whether the particle is unstable, requiring a 2D integration
+  bool unstable;
+  /// The tabulated integral
+  Tabulation integral;
+};
+
+/**
+ * Initialize everything the spectral functions of the given type and of its
+ * decay products initialize lazily, i.e. minimal masses, normalizations,
+ * thresholds and the tabulations of the decay widths. Afterwards the spectral
+ * functions can be evaluated concurrently.
+ *
+ * \param[in] type Particle type whose spectral function is integrated.
+ * \param[in, out] done Types that were already initialized.
+ */
+static void prepare_spectral_function(
+    const ParticleType &type, std::unordered_set<const ParticleType *> *done) {
+  if (!done->insert(std::addressof(type)).second) {
+    return;
+  }
+  if (!type.is_stable()) {
+    for (const auto &mode : type.decay_modes().decay_mode_list()) {
+      for (const ParticleTypePtr daughter : mode->particle_types()) {
+        prepare_spectral_function(*daughter, done);
+      }
+    }
+  }
+  type.fill_caches();
+}
+
+/**
+ * Read the tabulated integral from the cache or calculate it and store it in
+ * the cache. The cache file is replaced atomically, such that it is never
+ * found incomplete.
+ *
+ * \param[in, out] integral Integral to tabulate.
+ * \param[in] dir Directory of the cache, empty if no cache is used.
+ * \param[in] hash Hash of the particle properties.
+ * \param[in] integrate Integrator of the calling thread.
+ * \param[in] integrate2d 2D integrator of the calling thread.
+ * \param[in] cout_mutex Mutex protecting the progress messages.
+ */
+static void cache_integral(SpectralIntegral *integral, const bf::path &dir,
+                           sha256::Hash hash, Integrator *integrate,
+                           Integrator2d *integrate2d, std::mutex *cout_mutex) {
   constexpr double spacing = 2.0;
   constexpr double spacing2d = 3.0;
+  const IsoParticleType &part = *integral->part;
+  const IsoParticleType &res = *integral->res;
   const auto path = generate_tabulation_path(dir, part.name_filtered_prime(),
                                              res.name_filtered_prime());
-  Tabulation integral;
+  Tabulation &tab = integral->integral;
   if (!dir.empty() && bf::exists(path)) {
     std::ifstream file(path.string());
-    integral = Tabulation::from_file(file, hash);
-    if (!integral.is_empty()) {
+    tab = Tabulation::from_file(file, hash);
+    if (!tab.is_empty()) {
       // Only print message if the found tabulation was valid.
+      std::lock_guard<std::mutex> lock(*cout_mutex);
       std::cout << "Tabulation found at " << path.filename() << '\r'
                 << std::flush;
     }
   }
-  if (integral.is_empty()) {
+  if (tab.is_empty()) {
     if (!dir.empty()) {
+      std::lock_guard<std::mutex> lock(*cout_mutex);
       std::cout << "Caching tabulation to " << path.filename() << '\r'
                 << std::flush;
     }
-    if (!unstable) {
-      integral = spectral_integral_semistable(integrate, *res.get_states()[0],
-                                              *part.get_states()[0], spacing);
+    if (!integral->unstable) {
+      tab = spectral_integral_semistable(*integrate, *res.get_states()[0],
+                                         *part.get_states()[0], spacing);
     } else {
-      integral = spectral_integral_unstable(integrate2d, *res.get_states()[0],
-                                            *part.get_states()[0], spacing2d);
+      tab = spectral_integral_unstable(*integrate2d, *res.get_states()[0],
+                                       *part.get_states()[0], spacing2d);
     }
     if (!dir.empty()) {
-      std::ofstream file(path.string());
-      integral.write(file, hash);
+      bf::path tmp_path = path;
+      tmp_path += ".tmp";
+      {
+        std::ofstream file(tmp_path.string());
+        tab.write(file, hash);
+      }
+      bf::rename(tmp_path, path);
     }
   }
-  tabulations.emplace(std::make_pair(res.name(), integral));
-  if (antires != nullptr) {
-    tabulations.emplace(std::make_pair(antires->name(), integral));
-  }
 }
 
 void IsoParticleType::tabulate_integrals(sha256::Hash hash,
@@ -278,27 +337,53 @@ void IsoParticleType::tabulate_integrals(sha256::Hash hash,
   const auto delta = IsoParticleType::try_find("Δ");
   const auto rho = IsoParticleType::try_find("ρ");
   const auto h1 = IsoParticleType::try_find("h₁(1170)");
+  std::vector<SpectralIntegral> integrals;
   for (const auto &res : IsoParticleType::list_baryon_resonances()) {
     const auto antires = res->anti_multiplet();
     if (nuc) {
-      cache_integral(NR_tabulations, dir, hash, *nuc, *res, antires, false);
+      integrals.push_back({&NR_tabulations, nuc, res, antires, false, {}});
     }
     if (pion) {
-      cache_integral(piR_tabulations, dir, hash, *pion, *res, antires, false);
+      integrals.push_back({&piR_tabulations, pion, res, antires, false, {}});
     }
     if (kaon) {
-      cache_integral(RK_tabulations, dir, hash, *kaon, *res, antires, false);
+      integrals.push_back({&RK_tabulations, kaon, res, antires, false, {}});
     }
     if (delta) {
-      cache_integral(DeltaR_tabulations, dir, hash, *delta, *res, antires,
-                     true);
+      integrals.push_back({&DeltaR_tabulations, delta, res, antires, true, {}});
     }
   }
   if (rho) {
-    cache_integral(rhoR_tabulations, dir, hash, *rho, *rho, nullptr, true);
+    integrals.push_back({&rhoR_tabulations, rho, rho, nullptr, true, {}});
   }
   if (rho && h1) {
-    cache_integral(rhoR_tabulations, dir, hash, *rho, *h1, nullptr, true);
+    integrals.push_back({&rhoR_tabulations, rho, h1, nullptr, true, {}});
+  }
+
+  std::unordered_set<const ParticleType *> prepared;
+  for (const SpectralIntegral &integral : integrals) {
+    prepare_spectral_function(*integral.part->get_states()[0], &prepared);
+    prepare_spectral_function(*integral.res->get_states()[0], &prepared);
+  }
+
+  /* The integrals are independent, so they are distributed over the threads
+   * of the pool, each with its own integrators. */
+  ThreadPool &pool = ThreadPool::global();
+  std::vector<Integrator> integrate(pool.size());
+  std::vector<Integrator2d> integrate2d(pool.size());
+  std::mutex cout_mutex;
+  pool.for_each_index(integrals.size(), 1, [&](size_t i, size_t thread) {
+    cache_integral(&integrals[i], dir, hash, &integrate[thread],
+                   &integrate2d[thread], &cout_mutex);
+  });
+
+  for (const SpectralIntegral &integral : integrals) {
+    integral.tabulations->emplace(
+        std::make_pair(integral.res->name(), integral.integral));
+    if (integral.antires != nullptr) {
+      integral.tabulations->emplace(
+          std::make_pair(integral.antires->name(), integral.integral));
+    }
   }
 }
 
@@ -0,0 +1,280 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/linebuffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+namespace smash {
+
+namespace {
+/// Powers of ten which are exactly representable as doubles
+constexpr double powers_of_ten[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/// Largest exponent in powers_of_ten
+constexpr int max_exact_power = 22;
+
+/**
+ * Maximal number of significant digits handled by the fast path. The scaled
+ * number then stays below 2^50, such that its fractional part is known to
+ * better than 1/8.
+ */
+constexpr int max_fast_digits = 15;
+
+/**
+ * Round a positive, normal number to a given number of significant decimal
+ * digits.
+ *
+ * The number is scaled into [10^(n_digits-1), 10^n_digits) by multiplying or
+ * dividing by an exact power of ten. The rounding error of that operation is
+ * obtained exactly with std::fma, such that the decision to round up or
+ * down is exact unless the number is close to a tie.
+ *
+ * \param[in] x Number to be rounded.
+ * \param[in] n_digits Number of significant digits (at most max_fast_digits).
+ * \param[out] digits The n_digits significant digits as an integer.
+ * \param[out] exponent Decimal exponent of the first digit.
+ * \return Whether the rounding could be decided, otherwise the slow path has
+ *         to be used.
+ */
+bool round_to_digits(double x, int n_digits, std::uint64_t *digits,
+                     int *exponent) {
+  const double lower = powers_of_ten[n_digits - 1];
+  const double upper = powers_of_ten[n_digits];
+  // estimate of the decimal exponent from the binary one, which is at most
+  // one too small
+  int e2;
+  std::frexp(x, &e2);
+  int e10 = static_cast<int>(std::floor((e2 - 1) * 0.30102999566398120));
+  for (int attempt = 0; attempt < 3; attempt++) {
+    const int shift = n_digits - 1 - e10;
+    if (shift > max_exact_power || shift < -max_exact_power) {
+      return false;
+    }
+    // x * 10^shift = hi + lo
+    double hi, lo;
+    if (shift >= 0) {
+      const double p = powers_of_ten[shift];
+      hi = x * p;
+      lo = std::fma(x, p, -hi);
+    } else {
+      const double p = powers_of_ten[-shift];
+      hi = x / p;
+      lo = std::fma(-hi, p, x) / p;
+    }
+    if (hi < lower) {
+      e10--;
+      continue;
+    }
+    if (hi >= upper) {
+      e10++;
+      continue;
+    }
+    const double integral = std::floor(hi);
+    const double fraction = (hi - integral) + lo;
+    if (std::abs(fraction - 0.5) < 1e-9) {
+      return false;
+    }
+    *digits = static_cast<std::uint64_t>(integral) + (fraction > 0.5 ? 1 : 0);
+    *exponent = e10;
+    if (*digits == static_cast<std::uint64_t>(upper)) {
+      // rounded up to the next power of ten
+      *digits /= 10;
+      (*exponent)++;
+    }
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Write the decimal digits of an integer.
+ *
+ * \param[in] x Integer.
+ * \param[out] out End of the destination, the digits are written backwards.
+ * \return Position of the first digit.
+ */
+char *write_digits_backwards(std::uint64_t x, char *out) {
+  do {
+    *--out = static_cast<char>('0' + x % 10);
+    x /= 10;
+  } while (x != 0);
+  return out;
+}
+
+/**
+ * Write the exponent of the scientific notation like printf, i.e. with sign
+ * and at least two digits.
+ *
+ * \param[in] exponent Exponent.
+ * \param[out] out Destination.
+ * \return Position after the last character.
+ */
+char *write_exponent(int exponent, char *out) {
+  *out++ = 'e';
+  *out++ = exponent < 0 ? '-' : '+';
+  const unsigned int abs_exponent = std::abs(exponent);
+  if (abs_exponent < 10) {
+    *out++ = '0';
+  }
+  char digits[8];
+  char *end = digits + sizeof(digits);
+  char *begin = write_digits_backwards(abs_exponent, end);
+  while (begin != end) {
+    *out++ = *begin++;
+  }
+  return out;
+}
+}  // unnamed namespace
+
+void LineBuffer::append_general(double x, int precision) {
+  if (precision == 0) {
+    precision = 1;
+  }
+  if (!std::isnormal(x) && x != 0.) {
+    append_printf(x, precision, false);
+    return;
+  }
+  if (std::signbit(x)) {
+    text_.push_back('-');
+    x = -x;
+  }
+  if (x == 0.) {
+    text_.push_back('0');
+    return;
+  }
+  std::uint64_t value;
+  int exponent;
+  if (precision > max_fast_digits ||
+      !round_to_digits(x, precision, &value, &exponent)) {
+    append_printf(x, precision, false);
+    return;
+  }
+  char digits[max_fast_digits];
+  write_digits_backwards(value, digits + precision);
+  // drop trailing zeros, as %g does
+  int n_digits = precision;
+  while (n_digits > 1 && digits[n_digits - 1] == '0') {
+    n_digits--;
+  }
+
+  char out[32];
+  char *pos = out;
+  if (exponent >= -4 && exponent < precision) {
+    // fixed notation
+    if (exponent >= 0) {
+      for (int i = 0; i <= exponent; i++) {
+        *pos++ = i < n_digits ? digits[i] : '0';
+      }
+      if (n_digits > exponent + 1) {
+        *pos++ = '.';
+        for (int i = exponent + 1; i < n_digits; i++) {
+          *pos++ = digits[i];
+        }
+      }
+    } else {
+      *pos++ = '0';
+      *pos++ = '.';
+      for (int i = -1; i > exponent; i--) {
+        *pos++ = '0';
+      }
+      for (int i = 0; i < n_digits; i++) {
+        *pos++ = digits[i];
+      }
+    }
+  } else {
+    *pos++ = digits[0];
+    if (n_digits > 1) {
+      *pos++ = '.';
+      for (int i = 1; i < n_digits; i++) {
+        *pos++ = digits[i];
+      }
+    }
+    pos = write_exponent(exponent, pos);
+  }
+  text_.append(out, pos);
+}
+
+void LineBuffer::append_scientific(double x, int precision) {
+  const int n_digits = precision + 1;
+  if ((!std::isnormal(x) && x != 0.) || n_digits > max_fast_digits) {
+    append_printf(x, precision, true);
+    return;
+  }
+  if (std::signbit(x)) {
+    text_.push_back('-');
+    x = -x;
+  }
+  std::uint64_t value = 0;
+  int exponent = 0;
+  if (x != 0. && !round_to_digits(x, n_digits, &value, &exponent)) {
+    append_printf(x, precision, true);
+    return;
+  }
+  char digits[max_fast_digits];
+  if (x == 0.) {
+    std::fill(digits, digits + n_digits, '0');
+  } else {
+    write_digits_backwards(value, digits + n_digits);
+  }
+  char out[32];
+  char *pos = out;
+  *pos++ = digits[0];
+  if (n_digits > 1) {
+    *pos++ = '.';
+    for (int i = 1; i < n_digits; i++) {
+      *pos++ = digits[i];
+    }
+  }
+  pos = write_exponent(exponent, pos);
+  text_.append(out, pos);
+}
+
+void LineBuffer::append(long long x) {
+  std::uint64_t abs_x = static_cast<std::uint64_t>(x);
+  if (x < 0) {
+    text_.push_back('-');
+    abs_x = 0 - abs_x;
+  }
+  char out[24];
+  char *end = out + sizeof(out);
+  text_.append(write_digits_backwards(abs_x, end), end);
+}
+
+void LineBuffer::append(size_t x) {
+  char out[24];
+  char *end = out + sizeof(out);
+  text_.append(write_digits_backwards(x, end), end);
+}
+
+void LineBuffer::write_to(std::FILE *file) {
+  std::fwrite(text_.data(), 1, text_.size(), file);
+  text_.clear();
+}
+
+void LineBuffer::write_to(std::ostream &file) {
+  file.write(text_.data(), text_.size());
+  text_.clear();
+}
+
+void LineBuffer::append_printf(double x, int precision, bool scientific) {
+  // enough for all finite numbers with the precisions of the fast path
+  char out[512];
+  const int n =
+      scientific ? std::snprintf(out, sizeof(out), "%.*e", precision, x)
+                 : std::snprintf(out, sizeof(out), "%.*g", precision, x);
+  text_.append(out, std::min(static_cast<size_t>(n), sizeof(out) - 1));
+}
+
+}  // namespace smash
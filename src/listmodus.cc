@@ -9,6 +9,7 @@
 
 #include "smash/listmodus.h"
 
+#include <cfloat>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
@@ -29,9 +30,9 @@
 #include "smash/experimentparameters.h"
 #include "smash/fourvector.h"
 #include "smash/inputfunctions.h"
+#include "smash/interactionrecord.h"
 #include "smash/logging.h"
 #include "smash/threevector.h"
-#include "smash/wallcrossingaction.h"
 
 namespace smash {
 static constexpr int LList = LogArea::List::id;
@@ -413,6 +414,7 @@ ListBoxModus::ListBoxModus(Configuration modus_config,
 int ListBoxModus::impose_boundary_conditions(Particles *particles,
                                              const OutputsList &output_list) {
   int wraps = 0;
+  InteractionBatch wall_crossings;
   for (ParticleData &data : *particles) {
     FourVector position = data.position();
     bool wall_hit = enforce_periodic_boundaries(position.begin() + 1,
@@ -421,12 +423,14 @@ int ListBoxModus::impose_boundary_conditions(Particles *particles,
       const ParticleData incoming_particle(data);
       data.set_4position(position);
       ++wraps;
-      ActionPtr action =
-          make_unique<WallcrossingAction>(incoming_particle, data);
-      for (const auto &output : output_list) {
-        if (!output->is_dilepton_output() && !output->is_photon_output()) {
-          output->at_interaction(*action, 0.);
-        }
+      wall_crossings.add_wall_crossing(incoming_particle, data);
+    }
+  }
+  if (!wall_crossings.empty()) {
+    const ConstSpan<InteractionRecord> records = wall_crossings.records();
+    for (const auto &output : output_list) {
+      if (!output->is_dilepton_output() && !output->is_photon_output()) {
+        output->at_interactions(records);
       }
     }
   }
@@ -9,11 +9,11 @@
 
 #include "smash/oscaroutput.h"
 
+#include <memory>
 #include <string>
 
 #include <boost/filesystem.hpp>
 
-#include "smash/action.h"
 #include "smash/clock.h"
 #include "smash/config.h"
 #include "smash/cxx14compat.h"
@@ -23,12 +23,15 @@ namespace smash {
 static constexpr int LHyperSurfaceCrossing = LogArea::HyperSurfaceCrossing::id;
 
 template <OscarOutputFormat Format, int Contents>
-OscarOutput<Format, Contents>::OscarOutput(const bf::path &path,
-                                           const std::string &name)
+OscarOutput<Format, Contents>::OscarOutput(
+    const bf::path &path, const std::string &name,
+    const AsyncWriteParameters &async_write,
+    const OutputSelection &selection)
     : OutputInterface(name),
+      selection_(selection),
       file_{path /
                 (name + ".oscar" + ((Format == OscarFormat1999) ? "1999" : "")),
-            "w"} {
+            "w", async_write} {
   /*!\Userguide
    * \page oscar_general_ OSCAR Block Structure
    * OSCAR outputs are a family of ASCII and binary formats that follow
@@ -78,7 +81,19 @@ OscarOutput<Format, Contents>::OscarOutput(const bf::path &path,
    * The collisions output contains all collisions / decays / box wall crossings
    * and optionally the initial and final configuration.
    */
-  if (Format == OscarFormat2013) {
+  if (Format != OscarFormat1999 && !selection_.fields.empty()) {
+    // only the selected fields, in the order of the configuration
+    std::string names, units;
+    for (ParticleField field : selection_.fields) {
+      names += std::string(" ") + field_name(field);
+      units += std::string(" ") + field_unit(field);
+    }
+    std::fprintf(file_.get(), "#!%s %s%s\n",
+                 Format == OscarFormat2013 ? "OSCAR2013" : "OSCAR2013Extended",
+                 name.c_str(), names.c_str());
+    std::fprintf(file_.get(), "# Units:%s\n", units.c_str());
+    std::fprintf(file_.get(), "# %s\n", VERSION_MAJOR);
+  } else if (Format == OscarFormat2013) {
     std::fprintf(file_.get(),
                  "#!OSCAR2013 %s t x y z mass "
                  "p0 px py pz pdg ID charge\n",
@@ -117,8 +132,26 @@ OscarOutput<Format, Contents>::OscarOutput(const bf::path &path,
 
 template <OscarOutputFormat Format, int Contents>
 inline void OscarOutput<Format, Contents>::write(const Particles &particles) {
+  const bool select = selection_.selects_particles();
+  if (file_.asynchronous()) {
+    auto selected = std::make_shared<ParticleList>();
+    selected->reserve(particles.size());
+    for (const ParticleData &data : particles) {
+      if (!select || selection_.accepts(data)) {
+        selected->push_back(data);
+      }
+    }
+    file_.post([this, selected](std::FILE *file) {
+      for (const ParticleData &data : *selected) {
+        write_particledata(file, data);
+      }
+    });
+    return;
+  }
   for (const ParticleData &data : particles) {
-    write_particledata(data);
+    if (!select || selection_.accepts(data)) {
+      write_particledata(file_.get(), data);
+    }
   }
 }
 
@@ -130,14 +163,14 @@ void OscarOutput<Format, Contents>::at_eventstart(const Particles &particles,
   if (Contents & OscarAtEventstart) {
     if (Format == OscarFormat2013 || Format == OscarFormat2013Extended) {
       std::fprintf(file_.get(), "# event %i in %zu\n", event_number,
-                   particles.size());
+                   selection_.count(particles));
     } else {
       /* OSCAR line prefix : initial particles; final particles; event id
        * First block of an event: initial = 0, final = number of particles
        */
       const size_t zero = 0;
-      std::fprintf(file_.get(), "%zu %zu %i\n", zero, particles.size(),
-                   event_number);
+      std::fprintf(file_.get(), "%zu %zu %i\n", zero,
+                   selection_.count(particles), event_number);
     }
     if (!(Contents & OscarParticlesIC)) {
       // We do not want the inital particle list to be printed in case of IC
@@ -155,7 +188,7 @@ void OscarOutput<Format, Contents>::at_eventend(const Particles &particles,
     if (Contents & OscarParticlesAtEventend ||
         (Contents & OscarParticlesAtEventendIfNotEmpty && !event.empty_event)) {
       std::fprintf(file_.get(), "# event %i out %zu\n", event_number,
-                   particles.size());
+                   selection_.count(particles));
       write(particles);
     }
     // Comment end of an event
@@ -171,8 +204,8 @@ void OscarOutput<Format, Contents>::at_eventend(const Particles &particles,
     const size_t zero = 0;
     if (Contents & OscarParticlesAtEventend ||
         (Contents & OscarParticlesAtEventendIfNotEmpty && !event.empty_event)) {
-      std::fprintf(file_.get(), "%zu %zu %i\n", particles.size(), zero,
-                   event_number);
+      std::fprintf(file_.get(), "%zu %zu %i\n", selection_.count(particles),
+                   zero, event_number);
       write(particles);
     }
     // Null interaction marks the end of an event
@@ -180,7 +213,7 @@ void OscarOutput<Format, Contents>::at_eventend(const Particles &particles,
                  event.impact_parameter);
   }
   // Flush to disk
-  std::fflush(file_.get());
+  file_.flush();
 
   if (Contents & OscarParticlesIC) {
     // If the runtime is too short some particles might not yet have
@@ -195,39 +228,76 @@ void OscarOutput<Format, Contents>::at_eventend(const Particles &particles,
 }
 
 template <OscarOutputFormat Format, int Contents>
-void OscarOutput<Format, Contents>::at_interaction(const Action &action,
-                                                   const double density) {
+bool OscarOutput<Format, Contents>::writes(
+    const InteractionRecord &record) const {
   if (Contents & OscarInteractions) {
-    if (Format == OscarFormat2013 || Format == OscarFormat2013Extended) {
-      std::fprintf(file_.get(),
-                   "# interaction in %zu out %zu rho %12.7f weight %12.7g"
-                   " partial %12.7f type %5i\n",
-                   action.incoming_particles().size(),
-                   action.outgoing_particles().size(), density,
-                   action.get_total_weight(), action.get_partial_weight(),
-                   static_cast<int>(action.get_type()));
-    } else {
-      /* OSCAR line prefix : initial final
-       * particle creation: 0 1
-       * particle 2<->2 collision: 2 2
-       * resonance formation: 2 1
-       * resonance decay: 1 2
-       * etc.*/
-      std::fprintf(file_.get(), "%zu %zu %12.7f %12.7f %12.7f %5i\n",
-                   action.incoming_particles().size(),
-                   action.outgoing_particles().size(), density,
-                   action.get_total_weight(), action.get_partial_weight(),
-                   static_cast<int>(action.get_type()));
-    }
-    for (const auto &p : action.incoming_particles()) {
-      write_particledata(p);
+    return selection_.accepts(record);
+  }
+  return (Contents & OscarParticlesIC) &&
+         record.type == ProcessType::HyperSurfaceCrossing;
+}
+
+template <OscarOutputFormat Format, int Contents>
+void OscarOutput<Format, Contents>::at_interactions(
+    ConstSpan<InteractionRecord> records) {
+  if (!(Contents & (OscarInteractions | OscarParticlesIC))) {
+    return;
+  }
+  if (!file_.asynchronous()) {
+    write_interactions(file_.get(), records);
+    return;
+  }
+  // Copy the written interactions, they are formatted by the writer thread.
+  auto batch = std::make_shared<InteractionBatch>();
+  for (const InteractionRecord &record : records) {
+    if (writes(record)) {
+      batch->add(record);
     }
-    for (const auto &p : action.outgoing_particles()) {
-      write_particledata(p);
+  }
+  if (!batch->empty()) {
+    file_.post([this, batch](std::FILE *file) {
+      write_interactions(file, batch->records());
+    });
+  }
+}
+
+template <OscarOutputFormat Format, int Contents>
+void OscarOutput<Format, Contents>::write_interactions(
+    std::FILE *file, ConstSpan<InteractionRecord> records) {
+  for (const InteractionRecord &record : records) {
+    if (!writes(record)) {
+      continue;
     }
-  } else if (Contents & OscarParticlesIC) {
-    for (const auto &p : action.incoming_particles()) {
-      write_particledata(p);
+    if (Contents & OscarInteractions) {
+      if (Format == OscarFormat2013 || Format == OscarFormat2013Extended) {
+        std::fprintf(file,
+                     "# interaction in %zu out %zu rho %12.7f weight %12.7g"
+                     " partial %12.7f type %5i\n",
+                     record.incoming.size(), record.outgoing.size(),
+                     record.density, record.total_weight,
+                     record.partial_weight, static_cast<int>(record.type));
+      } else {
+        /* OSCAR line prefix : initial final
+         * particle creation: 0 1
+         * particle 2<->2 collision: 2 2
+         * resonance formation: 2 1
+         * resonance decay: 1 2
+         * etc.*/
+        std::fprintf(file, "%zu %zu %12.7f %12.7f %12.7f %5i\n",
+                     record.incoming.size(), record.outgoing.size(),
+                     record.density, record.total_weight,
+                     record.partial_weight, static_cast<int>(record.type));
+      }
+      for (const auto &p : record.incoming) {
+        write_particledata(file, p);
+      }
+      for (const auto &p : record.outgoing) {
+        write_particledata(file, p);
+      }
+    } else {
+      for (const auto &p : record.incoming) {
+        write_particledata(file, p);
+      }
     }
   }
 }
@@ -239,11 +309,11 @@ void OscarOutput<Format, Contents>::at_intermediate_time(
   if (Contents & OscarTimesteps) {
     if (Format == OscarFormat2013 || Format == OscarFormat2013Extended) {
       std::fprintf(file_.get(), "# event %i out %zu\n", current_event_,
-                   particles.size());
+                   selection_.count(particles));
     } else {
       const size_t zero = 0;
-      std::fprintf(file_.get(), "%zu %zu %i\n", particles.size(), zero,
-                   current_event_);
+      std::fprintf(file_.get(), "%zu %zu %i\n", selection_.count(particles),
+                   zero, current_event_);
     }
     write(particles);
   }
@@ -703,33 +773,112 @@ void OscarOutput<Format, Contents>::at_intermediate_time(
 
 template <OscarOutputFormat Format, int Contents>
 void OscarOutput<Format, Contents>::write_particledata(
-    const ParticleData &data) {
+    std::FILE *file, const ParticleData &data) {
+  if (Format != OscarFormat1999 && !selection_.fields.empty()) {
+    write_selected_fields(file, data);
+    return;
+  }
   const FourVector pos = data.position();
   const FourVector mom = data.momentum();
-  if (Format == OscarFormat2013) {
-    std::fprintf(file_.get(), "%g %g %g %g %g %.9g %.9g %.9g %.9g %s %i %i\n",
-                 pos.x0(), pos.x1(), pos.x2(), pos.x3(), data.effective_mass(),
-                 mom.x0(), mom.x1(), mom.x2(), mom.x3(),
-                 data.pdgcode().string().c_str(), data.id(),
-                 data.type().charge());
-  } else if (Format == OscarFormat2013Extended) {
+  if (Format == OscarFormat2013 || Format == OscarFormat2013Extended) {
+    // "%g %g %g %g %g %.9g %.9g %.9g %.9g %s %i %i"
+    for (int mu = 0; mu < 4; mu++) {
+      line_.append_general(pos[mu]);
+      line_.append(' ');
+    }
+    line_.append_general(data.effective_mass());
+    for (int mu = 0; mu < 4; mu++) {
+      line_.append(' ');
+      line_.append_general(mom[mu], 9);
+    }
+    line_.append(' ');
+    line_.append(data.pdgcode().string());
+    line_.append(' ');
+    line_.append(data.id());
+    line_.append(' ');
+    line_.append(data.type().charge());
+  }
+  if (Format == OscarFormat2013Extended) {
+    // " %i %g %g %i %i %g %s %s"
     const auto h = data.get_history();
-    std::fprintf(
-        file_.get(),
-        "%g %g %g %g %g %.9g %.9g %.9g"
-        " %.9g %s %i %i %i %g %g %i %i %g %s %s\n",
-        pos.x0(), pos.x1(), pos.x2(), pos.x3(), data.effective_mass(), mom.x0(),
-        mom.x1(), mom.x2(), mom.x3(), data.pdgcode().string().c_str(),
-        data.id(), data.type().charge(), h.collisions_per_particle,
-        data.formation_time(), data.xsec_scaling_factor(), h.id_process,
-        static_cast<int>(h.process_type), h.time_last_collision,
-        h.p1.string().c_str(), h.p2.string().c_str());
-  } else {
-    std::fprintf(file_.get(), "%i %s %i %g %g %g %g %g %g %g %g %g\n",
-                 data.id(), data.pdgcode().string().c_str(), 0, mom.x1(),
-                 mom.x2(), mom.x3(), mom.x0(), data.effective_mass(), pos.x1(),
-                 pos.x2(), pos.x3(), pos.x0());
+    line_.append(' ');
+    line_.append(h.collisions_per_particle);
+    line_.append(' ');
+    line_.append_general(data.formation_time());
+    line_.append(' ');
+    line_.append_general(data.xsec_scaling_factor());
+    line_.append(' ');
+    line_.append(h.id_process);
+    line_.append(' ');
+    line_.append(static_cast<int>(h.process_type));
+    line_.append(' ');
+    line_.append_general(h.time_last_collision);
+    line_.append(' ');
+    line_.append(h.p1.string());
+    line_.append(' ');
+    line_.append(h.p2.string());
   }
+  if (Format == OscarFormat1999) {
+    // "%i %s %i %g %g %g %g %g %g %g %g %g"
+    line_.append(data.id());
+    line_.append(' ');
+    line_.append(data.pdgcode().string());
+    line_.append(" 0");
+    for (int mu = 1; mu < 4; mu++) {
+      line_.append(' ');
+      line_.append_general(mom[mu]);
+    }
+    line_.append(' ');
+    line_.append_general(mom.x0());
+    line_.append(' ');
+    line_.append_general(data.effective_mass());
+    for (int mu = 1; mu < 4; mu++) {
+      line_.append(' ');
+      line_.append_general(pos[mu]);
+    }
+    line_.append(' ');
+    line_.append_general(pos.x0());
+  }
+  line_.append('\n');
+  line_.write_to(file);
+}
+
+template <OscarOutputFormat Format, int Contents>
+void OscarOutput<Format, Contents>::write_selected_fields(
+    std::FILE *file, const ParticleData &data) {
+  bool first = true;
+  for (ParticleField field : selection_.fields) {
+    if (!first) {
+      line_.append(' ');
+    }
+    first = false;
+    // same representation and precision as in the full particle lines
+    switch (field) {
+      case ParticleField::Pdg:
+        line_.append(data.pdgcode().string());
+        break;
+      case ParticleField::PdgMother1:
+        line_.append(data.get_history().p1.string());
+        break;
+      case ParticleField::PdgMother2:
+        line_.append(data.get_history().p2.string());
+        break;
+      case ParticleField::P0:
+      case ParticleField::Px:
+      case ParticleField::Py:
+      case ParticleField::Pz:
+        line_.append_general(field_value(data, field), 9);
+        break;
+      default:
+        if (field_is_integer(field)) {
+          line_.append(integer_field_value(data, field));
+        } else {
+          line_.append_general(field_value(data, field));
+        }
+    }
+  }
+  line_.append('\n');
+  line_.write_to(file);
 }
 
 namespace {
@@ -750,18 +899,23 @@ std::unique_ptr<OutputInterface> create_select_format(
     const std::string &name) {
   bool extended_format = (Contents & OscarInteractions) ? out_par.coll_extended
                                                         : out_par.part_extended;
+  const OutputSelection &selection = out_par.get_selection(
+      (Contents & OscarInteractions) ? "Collisions" : "Particles");
   if (modern_format && extended_format) {
-    return make_unique<OscarOutput<OscarFormat2013Extended, Contents>>(path,
-                                                                       name);
+    return make_unique<OscarOutput<OscarFormat2013Extended, Contents>>(
+        path, name, out_par.async_write, selection);
   } else if (modern_format && !extended_format) {
-    return make_unique<OscarOutput<OscarFormat2013, Contents>>(path, name);
+    return make_unique<OscarOutput<OscarFormat2013, Contents>>(
+        path, name, out_par.async_write, selection);
   } else if (!modern_format && !extended_format) {
-    return make_unique<OscarOutput<OscarFormat1999, Contents>>(path, name);
+    return make_unique<OscarOutput<OscarFormat1999, Contents>>(
+        path, name, out_par.async_write, selection);
   } else {
     // Only remaining possibility: (!modern_format && extended_format)
     logg[LOutput].warn() << "Creating Oscar output: "
                          << "There is no extended Oscar1999 format.";
-    return make_unique<OscarOutput<OscarFormat1999, Contents>>(path, name);
+    return make_unique<OscarOutput<OscarFormat1999, Contents>>(
+        path, name, out_par.async_write, selection);
   }
 }
 }  // unnamed namespace
@@ -773,6 +927,10 @@ std::unique_ptr<OutputInterface> create_oscar_output(
     throw std::invalid_argument("Creating Oscar output: unknown format");
   }
   const bool modern_format = (format == "Oscar2013");
+  if (!modern_format && !out_par.get_selection(content).fields.empty()) {
+    throw std::invalid_argument(
+        "Creating Oscar output: the Oscar1999 format has fixed columns.");
+  }
   if (content == "Particles") {
     if (out_par.part_only_final == OutputOnlyFinal::Yes) {
       return create_select_format<OscarParticlesAtEventend>(
@@ -798,14 +956,17 @@ std::unique_ptr<OutputInterface> create_oscar_output(
   } else if (content == "Dileptons") {
     if (modern_format && out_par.dil_extended) {
       return make_unique<
-          OscarOutput<OscarFormat2013Extended, OscarInteractions>>(path,
-                                                                   "Dileptons");
+          OscarOutput<OscarFormat2013Extended, OscarInteractions>>(
+          path, "Dileptons", out_par.async_write,
+          out_par.get_selection("Dileptons"));
     } else if (modern_format && !out_par.dil_extended) {
       return make_unique<OscarOutput<OscarFormat2013, OscarInteractions>>(
-          path, "Dileptons");
+          path, "Dileptons", out_par.async_write,
+          out_par.get_selection("Dileptons"));
     } else if (!modern_format && !out_par.dil_extended) {
       return make_unique<OscarOutput<OscarFormat1999, OscarInteractions>>(
-          path, "Dileptons");
+          path, "Dileptons", out_par.async_write,
+          out_par.get_selection("Dileptons"));
     } else if (!modern_format && out_par.dil_extended) {
       logg[LOutput].warn()
           << "Creating Oscar output: "
@@ -814,14 +975,17 @@ std::unique_ptr<OutputInterface> create_oscar_output(
   } else if (content == "Photons") {
     if (modern_format && !out_par.photons_extended) {
       return make_unique<OscarOutput<OscarFormat2013, OscarInteractions>>(
-          path, "Photons");
+          path, "Photons", out_par.async_write,
+          out_par.get_selection("Photons"));
     } else if (modern_format && out_par.photons_extended) {
       return make_unique<
-          OscarOutput<OscarFormat2013Extended, OscarInteractions>>(path,
-                                                                   "Photons");
+          OscarOutput<OscarFormat2013Extended, OscarInteractions>>(
+          path, "Photons", out_par.async_write,
+          out_par.get_selection("Photons"));
     } else if (!modern_format && !out_par.photons_extended) {
       return make_unique<OscarOutput<OscarFormat1999, OscarInteractions>>(
-          path, "Photons");
+          path, "Photons", out_par.async_write,
+          out_par.get_selection("Photons"));
     } else if (!modern_format && out_par.photons_extended) {
       logg[LOutput].warn()
           << "Creating Oscar output: "
@@ -831,15 +995,15 @@ std::unique_ptr<OutputInterface> create_oscar_output(
     if (modern_format && !out_par.ic_extended) {
       return make_unique<
           OscarOutput<OscarFormat2013, OscarParticlesIC | OscarAtEventstart>>(
-          path, "SMASH_IC");
+          path, "SMASH_IC", out_par.async_write);
     } else if (modern_format && out_par.ic_extended) {
       return make_unique<OscarOutput<OscarFormat2013Extended,
                                      OscarParticlesIC | OscarAtEventstart>>(
-          path, "SMASH_IC");
+          path, "SMASH_IC", out_par.async_write);
     } else if (!modern_format && !out_par.ic_extended) {
       return make_unique<
           OscarOutput<OscarFormat1999, OscarParticlesIC | OscarAtEventstart>>(
-          path, "SMASH_IC");
+          path, "SMASH_IC", out_par.async_write);
     } else if (!modern_format && out_par.ic_extended) {
       logg[LOutput].warn()
           << "Creating Oscar output: "
@@ -0,0 +1,198 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/outputselection.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace smash {
+
+namespace {
+/// Name, unit and kind of a particle field
+struct FieldDescription {
+  /// Name in the OSCAR2013 header
+  const char *name;
+  /// Unit in the OSCAR2013 header
+  const char *unit;
+  /// Whether the field is an integer
+  bool is_integer;
+};
+
+/// Descriptions of all fields, in the order of ParticleField
+constexpr FieldDescription field_descriptions[] = {
+    {"t", "fm", false},
+    {"x", "fm", false},
+    {"y", "fm", false},
+    {"z", "fm", false},
+    {"mass", "GeV", false},
+    {"p0", "GeV", false},
+    {"px", "GeV", false},
+    {"py", "GeV", false},
+    {"pz", "GeV", false},
+    {"pdg", "none", true},
+    {"ID", "none", true},
+    {"charge", "e", true},
+    {"ncoll", "none", true},
+    {"form_time", "fm", false},
+    {"xsecfac", "none", false},
+    {"proc_id_origin", "none", true},
+    {"proc_type_origin", "none", true},
+    {"time_last_coll", "fm", false},
+    {"pdg_mother1", "none", true},
+    {"pdg_mother2", "none", true}};
+
+/// Number of particle fields
+constexpr int n_fields =
+    sizeof(field_descriptions) / sizeof(field_descriptions[0]);
+}  // unnamed namespace
+
+const char *field_name(ParticleField field) {
+  return field_descriptions[static_cast<int>(field)].name;
+}
+
+const char *field_unit(ParticleField field) {
+  return field_descriptions[static_cast<int>(field)].unit;
+}
+
+bool field_is_integer(ParticleField field) {
+  return field_descriptions[static_cast<int>(field)].is_integer;
+}
+
+ParticleField field_from_name(const std::string &name) {
+  for (int i = 0; i < n_fields; i++) {
+    if (name == field_descriptions[i].name) {
+      return static_cast<ParticleField>(i);
+    }
+  }
+  throw std::invalid_argument("Unknown particle output field: " + name);
+}
+
+double field_value(const ParticleData &p, ParticleField field) {
+  switch (field) {
+    case ParticleField::T:
+    case ParticleField::X:
+    case ParticleField::Y:
+    case ParticleField::Z:
+      return p.position()[static_cast<int>(field)];
+    case ParticleField::Mass:
+      return p.effective_mass();
+    case ParticleField::P0:
+    case ParticleField::Px:
+    case ParticleField::Py:
+    case ParticleField::Pz:
+      return p.momentum()[static_cast<int>(field) -
+                          static_cast<int>(ParticleField::P0)];
+    case ParticleField::FormTime:
+      return p.formation_time();
+    case ParticleField::XsecFac:
+      return p.xsec_scaling_factor();
+    case ParticleField::TimeLastColl:
+      return p.get_history().time_last_collision;
+    default:
+      throw std::invalid_argument(std::string("Particle output field ") +
+                                  field_name(field) +
+                                  " is not a floating point number.");
+  }
+}
+
+std::int32_t integer_field_value(const ParticleData &p, ParticleField field) {
+  switch (field) {
+    case ParticleField::Pdg:
+      return p.pdgcode().get_decimal();
+    case ParticleField::ID:
+      return p.id();
+    case ParticleField::Charge:
+      return p.type().charge();
+    case ParticleField::Ncoll:
+      return p.get_history().collisions_per_particle;
+    case ParticleField::ProcIdOrigin:
+      return p.get_history().id_process;
+    case ParticleField::ProcTypeOrigin:
+      return static_cast<std::int32_t>(p.get_history().process_type);
+    case ParticleField::PdgMother1:
+      return p.get_history().p1.get_decimal();
+    case ParticleField::PdgMother2:
+      return p.get_history().p2.get_decimal();
+    default:
+      throw std::invalid_argument(std::string("Particle output field ") +
+                                  field_name(field) + " is not an integer.");
+  }
+}
+
+std::vector<ParticleField> default_fields(bool extended) {
+  const int n = extended ? n_fields : static_cast<int>(ParticleField::Ncoll);
+  std::vector<ParticleField> fields;
+  fields.reserve(n);
+  for (int i = 0; i < n; i++) {
+    fields.push_back(static_cast<ParticleField>(i));
+  }
+  return fields;
+}
+
+bool OutputSelection::selects_particles() const {
+  return !pdg_codes.empty() || only_participants ||
+         std::isfinite(rapidity_range[0]) || std::isfinite(rapidity_range[1]) ||
+         pt_range[0] > 0. || std::isfinite(pt_range[1]) ||
+         std::isfinite(time_range[0]) || std::isfinite(time_range[1]);
+}
+
+bool OutputSelection::accepts_properties(const ParticleData &p) const {
+  if (!pdg_codes.empty() && std::find(pdg_codes.begin(), pdg_codes.end(),
+                                      p.pdgcode()) == pdg_codes.end()) {
+    return false;
+  }
+  if (only_participants && p.get_history().collisions_per_particle == 0) {
+    return false;
+  }
+  const FourVector mom = p.momentum();
+  const double pt = std::sqrt(mom.x1() * mom.x1() + mom.x2() * mom.x2());
+  if (!(pt >= pt_range[0] && pt <= pt_range[1])) {
+    return false;
+  }
+  if (std::isfinite(rapidity_range[0]) || std::isfinite(rapidity_range[1])) {
+    const double y = 0.5 * std::log((mom.x0() + mom.x3()) /
+                                    (mom.x0() - mom.x3()));
+    if (!(y >= rapidity_range[0] && y <= rapidity_range[1])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool OutputSelection::accepts(const InteractionRecord &interaction) const {
+  if (!process_types.empty() &&
+      std::find(process_types.begin(), process_types.end(),
+                static_cast<int>(interaction.type)) == process_types.end()) {
+    return false;
+  }
+  const double t = interaction.time;
+  if (!(t >= time_range[0] && t <= time_range[1])) {
+    return false;
+  }
+  if (pdg_codes.empty() && !only_participants &&
+      !std::isfinite(rapidity_range[0]) && !std::isfinite(rapidity_range[1]) &&
+      pt_range[0] <= 0. && !std::isfinite(pt_range[1])) {
+    return true;
+  }
+  for (const ParticleData &p : interaction.incoming) {
+    if (accepts_properties(p)) {
+      return true;
+    }
+  }
+  for (const ParticleData &p : interaction.outgoing) {
+    if (accepts_properties(p)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace smash
@@ -11,13 +11,21 @@
 
 #include <assert.h>
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
 #include <map>
+#include <unordered_set>
 #include <vector>
 
+#include <boost/filesystem.hpp>
+
 #include "smash/constants.h"
 #include "smash/cxx14compat.h"
 #include "smash/decaymodes.h"
+#include "smash/decaytype.h"
 #include "smash/distributions.h"
+#include "smash/filelock.h"
 #include "smash/formfactors.h"
 #include "smash/inputfunctions.h"
 #include "smash/integrate.h"
@@ -426,11 +434,46 @@ const DecayModes &ParticleType::decay_modes() const {
   return modes;
 }
 
+double ParticleType::width_tabulation_accuracy_ = 0.;
+
+/// Mass range above the pole mass of the tabulated total widths [GeV]
+static constexpr double width_grid_range = 5.;
+/// Spacing of the initial grid of the tabulated total widths [GeV]
+static constexpr double width_grid_spacing = 0.05;
+/// Smallest interval of the adaptive grid of the tabulated total widths [GeV]
+static constexpr double width_grid_min_spacing = 1e-6;
+
 double ParticleType::total_width(const double m) const {
-  double w = 0.;
   if (is_stable()) {
-    return w;
+    return 0.;
   }
+  if (width_tabulation_accuracy_ > 0.) {
+    if (width_grid_masses_.empty()) {
+      tabulate_total_width();
+    }
+    // all decay modes are closed below the grid
+    if (m < width_grid_masses_.front()) {
+      return 0.;
+    }
+    if (m <= width_grid_masses_.back()) {
+      // interval i with width_grid_masses_[i] <= m < width_grid_masses_[i + 1]
+      const size_t i =
+          std::min<size_t>(std::upper_bound(width_grid_masses_.begin(),
+                                            width_grid_masses_.end(), m) -
+                               width_grid_masses_.begin(),
+                           width_grid_masses_.size() - 1) -
+          1;
+      const double m0 = width_grid_masses_[i], m1 = width_grid_masses_[i + 1];
+      const double w0 = width_grid_values_[i], w1 = width_grid_values_[i + 1];
+      const double w = w0 + (w1 - w0) * (m - m0) / (m1 - m0);
+      return w < width_cutoff ? 0. : w;
+    }
+  }
+  return sum_of_partial_widths(m);
+}
+
+double ParticleType::sum_of_partial_widths(const double m) const {
+  double w = 0.;
   /* Loop over decay modes and sum up all partial widths. */
   const auto &modes = decay_modes().decay_mode_list();
   for (unsigned int i = 0; i < modes.size(); i++) {
@@ -442,6 +485,254 @@ double ParticleType::total_width(const double m) const {
   return w;
 }
 
+/**
+ * Add the nodes of an adaptive grid of a function within an interval to the
+ * grid. The interval is bisected until the linear interpolation deviates from
+ * the function by less than the tolerance in the middle and at the quarters
+ * of the interval.
+ *
+ * \param[in] f Function to be tabulated.
+ * \param[in] a Lower bound of the interval, which is already in the grid.
+ * \param[in] fa Function value at a.
+ * \param[in] b Upper bound of the interval.
+ * \param[in] fb Function value at b.
+ * \param[in] tolerance Maximal absolute deviation.
+ * \param[in, out] x Positions of the nodes, to which those above a are added.
+ * \param[in, out] y Function values at the nodes.
+ */
+template <typename F>
+static void refine_grid(const F &f, double a, double fa, double b, double fb,
+                        double tolerance, std::vector<double> *x,
+                        std::vector<double> *y) {
+  const double c = 0.5 * (a + b);
+  const double fc = f(c);
+  bool refine = std::abs(fc - 0.5 * (fa + fb)) > tolerance;
+  const std::array<double, 2> quarters = {0.5 * (a + c), 0.5 * (c + b)};
+  std::array<double, 2> f_quarters = {};
+  for (size_t i = 0; i < 2 && !refine; i++) {
+    f_quarters[i] = f(quarters[i]);
+    const double linear = fa + (fb - fa) * (quarters[i] - a) / (b - a);
+    refine = std::abs(f_quarters[i] - linear) > tolerance;
+  }
+  if (refine && b - a > 2. * width_grid_min_spacing) {
+    refine_grid(f, a, fa, c, fc, tolerance, x, y);
+    refine_grid(f, c, fc, b, fb, tolerance, x, y);
+    return;
+  }
+  if (!refine) {
+    x->insert(x->end(), {quarters[0], c, quarters[1]});
+    y->insert(y->end(), {f_quarters[0], fc, f_quarters[1]});
+  }
+  x->push_back(b);
+  y->push_back(fb);
+}
+
+void ParticleType::tabulate_total_width() const {
+  // The initial grid contains the thresholds, where the width has kinks.
+  std::vector<double> masses;
+  for (const auto &mode : decay_modes().decay_mode_list()) {
+    masses.push_back(mode->threshold());
+  }
+  const double m_min = *std::min_element(masses.begin(), masses.end());
+  const double m_max = std::max(mass(), m_min) + width_grid_range;
+  const size_t n = std::ceil((m_max - m_min) / width_grid_spacing);
+  for (size_t i = 0; i <= n; i++) {
+    masses.push_back(m_min + (m_max - m_min) * i / n);
+  }
+  masses.push_back(mass());
+  std::sort(masses.begin(), masses.end());
+  masses.erase(std::unique(masses.begin(), masses.end()), masses.end());
+
+  const double tolerance = width_tabulation_accuracy_ * width_at_pole();
+  const auto f = [this](double m) { return sum_of_partial_widths(m); };
+  std::vector<double> grid_masses = {masses[0]};
+  std::vector<double> grid_values = {f(masses[0])};
+  for (size_t i = 1; i < masses.size(); i++) {
+    refine_grid(f, masses[i - 1], grid_values.back(), masses[i], f(masses[i]),
+                tolerance, &grid_masses, &grid_values);
+  }
+  logg[LResonances].debug("Tabulated total width of ", name(), " at ",
+                          grid_masses.size(), " masses");
+  width_grid_masses_ = std::move(grid_masses);
+  width_grid_values_ = std::move(grid_values);
+}
+
+void ParticleType::fill_caches() const {
+  if (!is_stable()) {
+    double max_threshold = 0.;
+    for (const auto &mode : decay_modes().decay_mode_list()) {
+      max_threshold = std::max(max_threshold, mode->threshold());
+    }
+    // evaluates the width of every decay mode
+    total_width(std::max(mass(), max_threshold));
+  }
+  min_mass_spectral();
+}
+
+/// Identifies a snapshot of the particle caches
+static constexpr char particle_caches_magic[8] = {'S', 'M', 'A', 'S',
+                                                  'H', 'P', 'T', 'C'};
+/// Version of the snapshot format of the particle caches
+static constexpr std::uint32_t particle_caches_version = 2;
+
+/**
+ * Write the binary representation of a value to the stream.
+ *
+ * \param[in] stream Output stream.
+ * \param[in] x Value to be written.
+ */
+template <typename T>
+static void write_value(std::ofstream &stream, const T &x) {
+  stream.write(reinterpret_cast<const char *>(&x), sizeof(x));
+}
+
+/**
+ * Read the binary representation of a value from the stream.
+ *
+ * \param[in] stream Input stream.
+ * \return Read value.
+ */
+template <typename T>
+static T read_value(std::ifstream &stream) {
+  T x{};
+  stream.read(reinterpret_cast<char *>(&x), sizeof(x));
+  return x;
+}
+
+/**
+ * \return the decay types of all particle types, each once, in the order of
+ *         the particle types and their decay modes.
+ */
+static std::vector<const DecayType *> decay_types_of_all_particles() {
+  std::vector<const DecayType *> decay_types;
+  std::unordered_set<const DecayType *> found;
+  for (const ParticleType &ptype : ParticleType::list_all()) {
+    if (ptype.is_stable()) {
+      continue;
+    }
+    for (const auto &mode : ptype.decay_modes().decay_mode_list()) {
+      if (found.insert(&mode->type()).second) {
+        decay_types.push_back(&mode->type());
+      }
+    }
+  }
+  return decay_types;
+}
+
+void ParticleType::fill_all_caches(sha256::Hash hash,
+                                   const bf::path &tabulations_path) {
+  if (tabulations_path.empty()) {
+    return;
+  }
+  // Only one process may read and write the snapshot at once.
+  FileLock lock(tabulations_path / "tabulations.lock");
+  if (!lock.acquire()) {
+    return;
+  }
+  const ParticleTypeList &types = list_all();
+  const std::vector<const DecayType *> decay_types =
+      decay_types_of_all_particles();
+  const bf::path path = tabulations_path / "particle_caches.bin";
+
+  if (bf::exists(path)) {
+    std::ifstream file(path.string(), std::ios::binary);
+    char magic[sizeof(particle_caches_magic)];
+    file.read(magic, sizeof(magic));
+    bool valid =
+        file.good() &&
+        std::equal(magic, magic + sizeof(magic), particle_caches_magic) &&
+        read_value<std::uint32_t>(file) == particle_caches_version &&
+        read_value<sha256::Hash>(file) == hash &&
+        read_value<std::uint64_t>(file) == types.size();
+    // minimal kinematic mass, minimal spectral mass and norm of every type
+    std::vector<std::array<double, 3>> masses(types.size());
+    std::vector<Tabulation> tabulations(decay_types.size());
+    if (valid) {
+      file.read(reinterpret_cast<char *>(masses.data()),
+                sizeof(masses[0]) * masses.size());
+      valid = read_value<std::uint64_t>(file) == decay_types.size();
+    }
+    for (size_t i = 0; valid && i < decay_types.size(); i++) {
+      if (read_value<std::uint8_t>(file)) {
+        tabulations[i] = Tabulation::from_file(file, hash);
+        valid = !tabulations[i].is_empty();
+      }
+    }
+    // masses and values of the tabulated total width of every type
+    std::vector<std::vector<double>> width_grids(2 * types.size());
+    valid = valid && read_value<double>(file) == width_tabulation_accuracy_;
+    for (size_t i = 0; valid && i < types.size(); i++) {
+      const std::uint64_t n = read_value<std::uint64_t>(file);
+      valid = file.good() && n < (std::uint64_t(1) << 32);
+      for (size_t k = 2 * i; valid && k < 2 * i + 2; k++) {
+        width_grids[k].resize(n);
+        file.read(reinterpret_cast<char *>(width_grids[k].data()),
+                  sizeof(double) * n);
+      }
+    }
+    if (valid && file.good()) {
+      for (size_t i = 0; i < types.size(); i++) {
+        types[i].min_mass_kinematic_ = masses[i][0];
+        types[i].min_mass_spectral_ = masses[i][1];
+        types[i].norm_factor_ = masses[i][2];
+        types[i].width_grid_masses_ = std::move(width_grids[2 * i]);
+        types[i].width_grid_values_ = std::move(width_grids[2 * i + 1]);
+      }
+      for (size_t i = 0; i < decay_types.size(); i++) {
+        if (!tabulations[i].is_empty()) {
+          decay_types[i]->set_tabulation(tabulations[i]);
+        }
+      }
+      logg[LParticleType].info("Particle caches restored from ", path);
+      return;
+    }
+  }
+
+  for (const ParticleType &type : types) {
+    type.fill_caches();
+  }
+  // Write to a temporary file first, such that the snapshot is never found
+  // incomplete.
+  bf::path tmp_path = path;
+  tmp_path += ".tmp";
+  {
+    std::ofstream file(tmp_path.string(), std::ios::binary);
+    file.write(particle_caches_magic, sizeof(particle_caches_magic));
+    write_value(file, particle_caches_version);
+    write_value(file, hash);
+    write_value(file, static_cast<std::uint64_t>(types.size()));
+    for (const ParticleType &type : types) {
+      write_value(file, type.min_mass_kinematic_);
+      write_value(file, type.min_mass_spectral_);
+      write_value(file, type.norm_factor_);
+    }
+    write_value(file, static_cast<std::uint64_t>(decay_types.size()));
+    for (const DecayType *decay_type : decay_types) {
+      const Tabulation *tabulation = decay_type->tabulation();
+      write_value(file, static_cast<std::uint8_t>(tabulation != nullptr));
+      if (tabulation != nullptr) {
+        tabulation->write(file, hash);
+      }
+    }
+    write_value(file, width_tabulation_accuracy_);
+    for (const ParticleType &type : types) {
+      write_value(file,
+                  static_cast<std::uint64_t>(type.width_grid_masses_.size()));
+      for (const auto *grid :
+           {&type.width_grid_masses_, &type.width_grid_values_}) {
+        file.write(reinterpret_cast<const char *>(grid->data()),
+                   sizeof(double) * grid->size());
+      }
+    }
+    if (!file) {
+      throw std::runtime_error("Could not write the particle caches to " +
+                               tmp_path.string());
+    }
+  }
+  bf::rename(tmp_path, path);
+  logg[LParticleType].info("Particle caches stored to ", path);
+}
+
 void ParticleType::check_consistency() {
   for (const ParticleType &ptype : ParticleType::list_all()) {
     if (!ptype.is_stable() && ptype.decay_modes().is_empty()) {
@@ -611,10 +902,162 @@ double ParticleType::spectral_function_simple(double m) const {
   return breit_wigner_nonrel(m, mass(), width_at_pole());
 }
 
+bool ParticleType::tabulated_resonance_masses_ = false;
+
+/// Largest sqrt(s) above threshold covered by the mass CDF tables [GeV]
+static constexpr double mass_cdf_sqrts_range = 3.;
+/// Number of rows of the mass CDF tables
+static constexpr size_t mass_cdf_rows = 150;
+/// Number of intervals of the mass variable in every row of the CDF tables
+static constexpr size_t mass_cdf_intervals = 64;
+
+/**
+ * \param[in] j Index of a node in a row of the mass CDF tables.
+ * \return Value of the mass variable at the node. The nodes are spaced like
+ *         Chebyshev nodes, which resolves the densities close to the edges of
+ *         the mass range, where they behave like powers of the momenta.
+ */
+static double mass_cdf_node(size_t j) {
+  return 0.5 * (1. - std::cos(M_PI * j / mass_cdf_intervals));
+}
+
+/**
+ * \param[in] x Position between the rows of the mass CDF tables, row i is at
+ *              x = i + 1.
+ * \return sqrt(s) above threshold at the position [GeV]. The rows are spaced
+ *         quadratically, such that they are dense close to the threshold,
+ *         where the mass distribution changes fastest with the energy. Mixing
+ *         neighboring rows thus stays accurate there.
+ */
+static double mass_cdf_row_sqrts(double x) {
+  const double r = x / mass_cdf_rows;
+  return mass_cdf_sqrts_range * r * r;
+}
+
+/**
+ * The mass is described by the variable v in [0, 1], which maps the allowed
+ * mass range linearly onto the arctangent of the Cauchy distribution, such
+ * that the density in v is the ratio of the full to the simple spectral
+ * function times the Blatt-Weisskopf factor. Row i holds the density and the
+ * CDF of v at the nodes mass_cdf_node(j) for sqrt(s) = threshold +
+ * mass_cdf_row_sqrts(i + 1), normalized to one. Rows without allowed masses
+ * are zero.
+ */
+struct ParticleType::MassCdfTable {
+  /// Smallest sqrt(s), where the resonance can be produced
+  double sqrts_threshold;
+  /// Density of v at the nodes of all rows, one row after the other
+  std::vector<double> density;
+  /// CDF of v at the nodes of all rows, one row after the other
+  std::vector<double> cdf;
+};
+
+const ParticleType::MassCdfTable &ParticleType::mass_cdf_table(
+    double mass_stable, int L) const {
+  const auto key = std::make_pair(L, mass_stable);
+  const auto found = mass_cdf_tables_.find(key);
+  if (found != mass_cdf_tables_.end()) {
+    return *found->second;
+  }
+  const double min_mass = min_mass_spectral();
+  const double half_width = width_at_pole() / 2.;
+  const double t_min = std::atan((min_mass - mass()) / half_width);
+  const size_t n_nodes = mass_cdf_intervals + 1;
+  auto table = std::make_shared<MassCdfTable>();
+  table->sqrts_threshold = mass_stable + min_mass;
+  table->density.resize(mass_cdf_rows * n_nodes);
+  table->cdf.resize(mass_cdf_rows * n_nodes);
+  for (size_t row = 0; row < mass_cdf_rows; row++) {
+    const double sqrts = table->sqrts_threshold + mass_cdf_row_sqrts(row + 1);
+    const double max_mass = sqrts - mass_stable;
+    const double t_max = std::atan((max_mass - mass()) / half_width);
+    double *density = &table->density[row * n_nodes];
+    double *cdf = &table->cdf[row * n_nodes];
+    for (size_t j = 0; j < n_nodes; j++) {
+      const double t = t_min + (t_max - t_min) * mass_cdf_node(j);
+      const double m =
+          std::min(std::max(mass() + half_width * std::tan(t), min_mass),
+                   max_mass);
+      const double pcm = pCM(sqrts, mass_stable, m);
+      const double blw = pcm * blatt_weisskopf_sqr(pcm, L);
+      density[j] = spectral_function(m) / spectral_function_simple(m) * blw;
+      cdf[j] = (j == 0) ? 0.
+                        : cdf[j - 1] + 0.5 * (density[j - 1] + density[j]) *
+                                           (mass_cdf_node(j) -
+                                            mass_cdf_node(j - 1));
+    }
+    const double norm = cdf[mass_cdf_intervals];
+    for (size_t j = 0; j < n_nodes; j++) {
+      density[j] = norm > 0. ? density[j] / norm : 0.;
+      cdf[j] = norm > 0. ? cdf[j] / norm : 0.;
+    }
+  }
+  logg[LResonances].debug("Tabulated mass CDF of ", name(), " with ",
+                          mass_stable, " GeV partner and L = ", L);
+  mass_cdf_tables_[key] = table;
+  return *table;
+}
+
+double ParticleType::sample_tabulated_resonance_mass(const double mass_stable,
+                                                     const double cms_energy,
+                                                     int L) const {
+  const MassCdfTable &table = mass_cdf_table(mass_stable, L);
+  const double x =
+      mass_cdf_rows *
+      std::sqrt(std::max(0., cms_energy - table.sqrts_threshold) /
+                mass_cdf_sqrts_range);
+  if (!(x >= 1.) || x >= mass_cdf_rows) {
+    return -1.;
+  }
+  // pick one of the neighboring rows with the weights of linear interpolation
+  size_t row = static_cast<size_t>(x) - 1;
+  if (random::uniform(0., 1.) < x - std::floor(x)) {
+    row++;
+  }
+  const size_t n_nodes = mass_cdf_intervals + 1;
+  const double *density = &table.density[row * n_nodes];
+  const double *cdf = &table.cdf[row * n_nodes];
+  if (!(cdf[mass_cdf_intervals] > 0.)) {
+    return -1.;
+  }
+  const double u = random::uniform(0., 1.);
+  // interval j with cdf[j] <= u < cdf[j + 1]
+  const size_t j =
+      std::min<size_t>(std::upper_bound(cdf, cdf + n_nodes, u) - cdf,
+                       mass_cdf_intervals) -
+      1;
+  /* The density is linear within the interval, so the fraction s of the
+   * interval solves a quadratic equation. */
+  const double width = mass_cdf_node(j + 1) - mass_cdf_node(j);
+  const double du = (u - cdf[j]) / width;
+  const double slope = density[j + 1] - density[j];
+  const double denominator =
+      density[j] +
+      std::sqrt(std::max(0., density[j] * density[j] + 2. * slope * du));
+  const double s = denominator > 0. ? std::min(2. * du / denominator, 1.) : 0.;
+  const double v = mass_cdf_node(j) + s * width;
+  // map v back onto the mass range at the actual energy
+  const double min_mass = min_mass_spectral();
+  const double max_mass = std::nextafter(cms_energy - mass_stable, 0.);
+  const double half_width = width_at_pole() / 2.;
+  const double t_min = std::atan((min_mass - mass()) / half_width);
+  const double t_max = std::atan((max_mass - mass()) / half_width);
+  const double m = mass() + half_width * std::tan(t_min + v * (t_max - t_min));
+  return std::min(std::max(m, min_mass), max_mass);
+}
+
 /* Resonance mass sampling for 2-particle final state */
 double ParticleType::sample_resonance_mass(const double mass_stable,
                                            const double cms_energy,
                                            int L) const {
+  if (tabulated_resonance_masses_) {
+    const double mass_res =
+        sample_tabulated_resonance_mass(mass_stable, cms_energy, L);
+    if (mass_res > 0.) {
+      return mass_res;
+    }
+  }
+
   /* largest possible mass: Use 'nextafter' to make sure it is not above the
    * physical limit by numerical error. */
   const double max_mass = std::nextafter(cms_energy - mass_stable, 0.);
@@ -227,6 +227,43 @@ Potentials::Potentials(Configuration conf, const DensityParameters &param)
       powers_.push_back(aux_powers[i]);
     }
   }
+
+  /* The density dependent powers are tabulated once, such that the potentials
+   * and forces evaluated on every lattice node and at every particle position
+   * only need a polynomial interpolation instead of several calls to pow. */
+  if (use_skyrme_) {
+    const double tau = skyrme_tau_;
+    skyrme_table_ = HermiteTabulation(
+        table_x_min, table_x_max - table_x_min, table_num, [tau](double x) {
+          const double x_tau = std::pow(x, tau);
+          return std::make_pair(x_tau, tau * x_tau / x);
+        });
+  }
+  if (use_symmetry_ && symmetry_is_rhoB_dependent_) {
+    const double gamma = symmetry_gamma_;
+    symmetry_S_table_ = HermiteTabulation(
+        table_x_min, table_x_max - table_x_min, table_num, [gamma](double x) {
+          const double S =
+              12.3 * std::pow(x, 2. / 3.) + 20.0 * std::pow(x, gamma);
+          const double dS_dx = 8.2 * std::pow(x, -1. / 3.) +
+                               20.0 * gamma * std::pow(x, gamma - 1.);
+          return std::make_pair(S, dS_dx);
+        });
+  }
+  if (use_vdf_) {
+    const std::vector<double> coeffs = coeffs_, powers = powers_;
+    vdf_table_ = HermiteTabulation(
+        table_x_min, table_x_max - table_x_min, table_num,
+        [coeffs, powers](double y) {
+          double G = 0.0, dG_dy = 0.0;
+          for (size_t i = 0; i < coeffs.size(); i++) {
+            const double y_pow = coeffs[i] * std::pow(y, powers[i] - 2.0);
+            G += y_pow;
+            dG_dy += (powers[i] - 2.0) * y_pow / y;
+          }
+          return std::make_pair(G, dG_dy);
+        });
+  }
 }
 
 Potentials::~Potentials() {}
@@ -236,13 +273,20 @@ double Potentials::skyrme_pot(const double baryon_density) const {
   /* U = U(|rho|) * sgn , because the sign of the potential changes
    * under a charge reversal transformation. */
   const int sgn = tmp > 0 ? 1 : -1;
+  const double abs_tmp = std::abs(tmp);
+  const double tmp_tau =
+      skyrme_table_.covers(abs_tmp)
+          ? skyrme_table_.get_value_and_derivative(abs_tmp).first
+          : std::pow(abs_tmp, skyrme_tau_);
   // Return in GeV
-  return mev_to_gev * sgn *
-         (skyrme_a_ * std::abs(tmp) +
-          skyrme_b_ * std::pow(std::abs(tmp), skyrme_tau_));
+  return mev_to_gev * sgn * (skyrme_a_ * abs_tmp + skyrme_b_ * tmp_tau);
 }
 double Potentials::symmetry_S(const double baryon_density) const {
   if (symmetry_is_rhoB_dependent_) {
+    const double x = baryon_density / nuclear_density;
+    if (symmetry_S_table_.covers(x)) {
+      return symmetry_S_table_.get_value_and_derivative(x).first;
+    }
     return 12.3 * std::pow(baryon_density / nuclear_density, 2. / 3.) +
            20.0 * std::pow(baryon_density / nuclear_density, symmetry_gamma_);
   } else {
@@ -273,17 +317,23 @@ FourVector Potentials::vdf_pot(double rhoB, const FourVector jmuB_net) const {
   // F_2 is a multiplicative factor in front of the baryon current
   // in the VDF potential
   double F_2 = 0.0;
-  for (int i = 0; i < number_of_terms(); i++) {
-    F_2 += coeffs_[i] * std::pow(abs_rhoB, powers_[i] - 2.0) /
-           std::pow(saturation_density_, powers_[i] - 1.0);
+  const double y = abs_rhoB / saturation_density_;
+  if (vdf_table_.covers(y)) {
+    F_2 = vdf_table_.get_value_and_derivative(y).first / saturation_density_;
+  } else {
+    for (int i = 0; i < number_of_terms(); i++) {
+      F_2 += coeffs_[i] * std::pow(abs_rhoB, powers_[i] - 2.0) /
+             std::pow(saturation_density_, powers_[i] - 1.0);
+    }
   }
   F_2 = F_2 * sgn;
   // Return in GeV
   return F_2 * jmuB_net;
 }
 
-double Potentials::potential(const ThreeVector &r, const ParticleList &plist,
-                             const ParticleType &acts_on) const {
+template <typename T>
+double Potentials::potential_impl(const ThreeVector &r, const T &plist,
+                                  const ParticleType &acts_on) const {
   double total_potential = 0.0;
   const bool compute_gradient = false;
   const bool smearing = true;
@@ -315,6 +365,16 @@ double Potentials::potential(const ThreeVector &r, const ParticleList &plist,
   return total_potential;
 }
 
+double Potentials::potential(const ThreeVector &r, const ParticleList &plist,
+                             const ParticleType &acts_on) const {
+  return potential_impl(r, plist, acts_on);
+}
+
+double Potentials::potential(const ThreeVector &r, const DensityCellList &cells,
+                             const ParticleType &acts_on) const {
+  return potential_impl(r, cells.neighbors(r), acts_on);
+}
+
 std::pair<double, int> Potentials::force_scale(const ParticleType &data) {
   const auto &pdg = data.pdgcode();
   const double skyrme_or_VDF_scale =
@@ -329,11 +389,13 @@ std::pair<ThreeVector, ThreeVector> Potentials::skyrme_force(
   ThreeVector E_component(0.0, 0.0, 0.0), B_component(0.0, 0.0, 0.0);
   if (use_skyrme_) {
     const int sgn = rhoB > 0 ? 1 : -1;
-    const double abs_rhoB = std::abs(rhoB);
-    const double dV_drho = sgn *
-                           (skyrme_a_ + skyrme_b_ * skyrme_tau_ *
-                                            std::pow(abs_rhoB / nuclear_density,
-                                                     skyrme_tau_ - 1)) *
+    const double x = std::abs(rhoB) / nuclear_density;
+    // derivative of x^tau with respect to x
+    const double dxtau_dx =
+        skyrme_table_.covers(x)
+            ? skyrme_table_.get_value_and_derivative(x).second
+            : skyrme_tau_ * std::pow(x, skyrme_tau_ - 1);
+    const double dV_drho = sgn * (skyrme_a_ + skyrme_b_ * dxtau_dx) *
                            mev_to_gev / nuclear_density;
     E_component -= dV_drho * (grad_j0B + dvecjB_dt);
     B_component += dV_drho * curl_vecjB;
@@ -374,18 +436,22 @@ std::pair<ThreeVector, ThreeVector> Potentials::vdf_force(
     // F_1 and F_2 are multiplicative factors in front of the baryon current
     // in the VDF potential
     double F_1 = 0.0;
-    for (int i = 0; i < number_of_terms(); i++) {
-      F_1 += coeffs_[i] * (powers_[i] - 2.0) *
-             std::pow(abs_rhoB, powers_[i] - 3.0) /
-             std::pow(saturation_density_, powers_[i] - 1.0);
-    }
-    F_1 = F_1 * sgn;
-
     double F_2 = 0.0;
-    for (int i = 0; i < number_of_terms(); i++) {
-      F_2 += coeffs_[i] * std::pow(abs_rhoB, powers_[i] - 2.0) /
-             std::pow(saturation_density_, powers_[i] - 1.0);
+    const double y = abs_rhoB / saturation_density_;
+    if (vdf_table_.covers(y)) {
+      const auto G_and_dG = vdf_table_.get_value_and_derivative(y);
+      F_1 = G_and_dG.second / (saturation_density_ * saturation_density_);
+      F_2 = G_and_dG.first / saturation_density_;
+    } else {
+      for (int i = 0; i < number_of_terms(); i++) {
+        F_1 += coeffs_[i] * (powers_[i] - 2.0) *
+               std::pow(abs_rhoB, powers_[i] - 3.0) /
+               std::pow(saturation_density_, powers_[i] - 1.0);
+        F_2 += coeffs_[i] * std::pow(abs_rhoB, powers_[i] - 2.0) /
+               std::pow(saturation_density_, powers_[i] - 1.0);
+      }
     }
+    F_1 = F_1 * sgn;
     F_2 = F_2 * sgn;
 
     E_component -= (F_1 * (grad_rhoB * j0B + drhoB_dt * vecjB) +
@@ -420,18 +486,27 @@ double Potentials::dVsym_drhoI3(const double rhoB, const double rhoI3) const {
 double Potentials::dVsym_drhoB(const double rhoB, const double rhoI3) const {
   if (symmetry_is_rhoB_dependent_) {
     double rhoB_over_rho0 = rhoB / nuclear_density;
-    double term1 = 8.2 * std::pow(rhoB_over_rho0, -1. / 3.) / nuclear_density +
-                   20. * symmetry_gamma_ *
-                       std::pow(rhoB_over_rho0, symmetry_gamma_) / rhoB;
-    double term2 = -2. * symmetry_S(rhoB) / rhoB;
+    double term1, term2;
+    if (symmetry_S_table_.covers(rhoB_over_rho0)) {
+      const auto S_and_dS =
+          symmetry_S_table_.get_value_and_derivative(rhoB_over_rho0);
+      term1 = S_and_dS.second / nuclear_density;
+      term2 = -2. * S_and_dS.first / rhoB;
+    } else {
+      term1 = 8.2 * std::pow(rhoB_over_rho0, -1. / 3.) / nuclear_density +
+              20. * symmetry_gamma_ *
+                  std::pow(rhoB_over_rho0, symmetry_gamma_) / rhoB;
+      term2 = -2. * symmetry_S(rhoB) / rhoB;
+    }
     return mev_to_gev * (term1 + term2) * rhoI3 * rhoI3 / (rhoB * rhoB);
   } else {
     return 0.;
   }
 }
 
+template <typename T>
 std::tuple<ThreeVector, ThreeVector, ThreeVector, ThreeVector>
-Potentials::all_forces(const ThreeVector &r, const ParticleList &plist) const {
+Potentials::all_forces_impl(const ThreeVector &r, const T &plist) const {
   const bool compute_gradient = true;
   const bool smearing = true;
   auto F_skyrme_or_VDF =
@@ -506,4 +581,15 @@ Potentials::all_forces(const ThreeVector &r, const ParticleList &plist) const {
                          F_symmetry.first, F_symmetry.second);
 }
 
+std::tuple<ThreeVector, ThreeVector, ThreeVector, ThreeVector>
+Potentials::all_forces(const ThreeVector &r, const ParticleList &plist) const {
+  return all_forces_impl(r, plist);
+}
+
+std::tuple<ThreeVector, ThreeVector, ThreeVector, ThreeVector>
+Potentials::all_forces(const ThreeVector &r,
+                       const DensityCellList &cells) const {
+  return all_forces_impl(r, cells.neighbors(r));
+}
+
 }  // namespace smash
@@ -9,11 +9,14 @@
 
 #include "smash/propagation.h"
 
+#include <algorithm>
+
 #include "smash/boxmodus.h"
 #include "smash/collidermodus.h"
 #include "smash/listmodus.h"
 #include "smash/logging.h"
 #include "smash/spheremodus.h"
+#include "smash/threadpool.h"
 
 namespace smash {
 static constexpr int LPropagation = LogArea::Propagation::id;
@@ -108,81 +111,119 @@ void expand_space_time(Particles *particles,
   }
 }
 
+/**
+ * Number of consecutive particles handed to a thread at once when updating
+ * the momenta. Consecutive particles are close in memory and, off the
+ * lattices, share neighbors.
+ */
+static constexpr std::size_t update_momenta_chunk = 64;
+
 void update_momenta(
     std::vector<Particles> &ensembles, double dt, const Potentials &pot,
     RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FB_lat,
     RectangularLattice<std::pair<ThreeVector, ThreeVector>> *FI3_lat,
     RectangularLattice<std::pair<ThreeVector, ThreeVector>> *EM_lat) {
-  // Copy particles from ALL ensembles to a single list before propagation
-  // and calculate potentials from this list
-  ParticleList plist;
-  for (Particles &particles : ensembles) {
-    const ParticleList tmp = particles.copy_to_vector();
-    plist.insert(plist.end(), tmp.begin(), tmp.end());
-  }
-
   bool possibly_use_lattice =
       (pot.use_skyrme() ? (FB_lat != nullptr) : true) &&
       (pot.use_vdf() ? (FB_lat != nullptr) : true) &&
       (pot.use_symmetry() ? (FI3_lat != nullptr) : true);
-  std::pair<ThreeVector, ThreeVector> FB, FI3, EM_fields;
-  double min_time_scale = std::numeric_limits<double>::infinity();
 
+  // Only baryons and nuclei will be affected by the potentials
+  std::vector<ParticleData *> affected;
+  std::vector<ThreeVector> positions;
   for (Particles &particles : ensembles) {
     for (ParticleData &data : particles) {
-      // Only baryons and nuclei will be affected by the potentials
-      if (!(data.is_baryon() || data.is_nucleus())) {
-        continue;
-      }
-      const auto scale = pot.force_scale(data.type());
-      const ThreeVector r = data.position().threevec();
-      /* Lattices can be used for calculation if 1-2 are fulfilled:
-       * 1) Required lattices are not nullptr - possibly_use_lattice
-       * 2) r is not out of required lattices */
-      const bool use_lattice =
-          possibly_use_lattice &&
-          (pot.use_skyrme() ? FB_lat->value_at(r, FB) : true) &&
-          (pot.use_vdf() ? FB_lat->value_at(r, FB) : true) &&
-          (pot.use_symmetry() ? FI3_lat->value_at(r, FI3) : true);
-      if (!pot.use_skyrme() && !pot.use_vdf()) {
-        FB = std::make_pair(ThreeVector(0., 0., 0.), ThreeVector(0., 0., 0.));
-      }
-      if (!pot.use_symmetry()) {
-        FI3 = std::make_pair(ThreeVector(0., 0., 0.), ThreeVector(0., 0., 0.));
-      }
-      if (!use_lattice) {
-        const auto tmp = pot.all_forces(r, plist);
-        FB = std::make_pair(std::get<0>(tmp), std::get<1>(tmp));
-        FI3 = std::make_pair(std::get<2>(tmp), std::get<3>(tmp));
-      }
-      ThreeVector Force =
-          scale.first *
-              (FB.first + data.momentum().velocity().cross_product(FB.second)) +
-          scale.second * data.type().isospin3_rel() *
-              (FI3.first +
-               data.momentum().velocity().cross_product(FI3.second));
-      // Potentially add Lorentz force
-      if (pot.use_coulomb() && EM_lat->value_at(r, EM_fields)) {
-        // factor hbar*c to convert fields from 1/fm^2 to GeV/fm
-        Force += hbarc * data.type().charge() * elementary_charge *
-                 (EM_fields.first +
-                  data.momentum().velocity().cross_product(EM_fields.second));
-      }
-      logg[LPropagation].debug("Update momenta: F [GeV/fm] = ", Force);
-      data.set_4momentum(data.effective_mass(),
-                         data.momentum().threevec() + Force * dt);
-
-      // calculate the time scale of the change in momentum
-      const double Force_abs = Force.abs();
-      if (Force_abs < really_small) {
-        continue;
-      }
-      const double time_scale = data.momentum().x0() / Force_abs;
-      if (time_scale < min_time_scale) {
-        min_time_scale = time_scale;
+      if (data.is_baryon() || data.is_nucleus()) {
+        affected.push_back(&data);
+        positions.push_back(data.position().threevec());
       }
     }
   }
+  const std::size_t n_affected = affected.size();
+
+  /* The fields acting on all particles are gathered before any momentum is
+   * updated. Lattices can be used for calculation if 1-2 are fulfilled:
+   * 1) Required lattices are not nullptr - possibly_use_lattice
+   * 2) r is not out of required lattices */
+  const std::pair<ThreeVector, ThreeVector> no_field(ThreeVector(0., 0., 0.),
+                                                     ThreeVector(0., 0., 0.));
+  std::vector<std::pair<ThreeVector, ThreeVector>> FB(n_affected, no_field),
+      FI3(n_affected, no_field), EM_fields(n_affected, no_field);
+  std::vector<char> use_lattice(n_affected, possibly_use_lattice), on_lattice;
+  if (possibly_use_lattice && (pot.use_skyrme() || pot.use_vdf())) {
+    FB_lat->values_at(positions, FB, on_lattice);
+    for (std::size_t i = 0; i < n_affected; i++) {
+      use_lattice[i] = use_lattice[i] && on_lattice[i];
+    }
+  }
+  if (possibly_use_lattice && pot.use_symmetry()) {
+    FI3_lat->values_at(positions, FI3, on_lattice);
+    for (std::size_t i = 0; i < n_affected; i++) {
+      use_lattice[i] = use_lattice[i] && on_lattice[i];
+    }
+  }
+  // Out of the lattice the fields are zero, i.e. there is no Lorentz force.
+  if (pot.use_coulomb()) {
+    EM_lat->values_at(positions, EM_fields, on_lattice);
+  }
+
+  /* For particles outside of the lattices the forces are calculated from the
+   * particles within the smearing cutoff. The cell list is only built if any
+   * particle needs it. The baryon density cell list also holds all particles
+   * contributing to the baryonic isospin density. These sums are the
+   * expensive part of the update and only read the cell list, so they are
+   * shared among threads, each writing the forces of its own particles. */
+  std::vector<std::size_t> off_lattice;
+  for (std::size_t i = 0; i < n_affected; i++) {
+    if (!use_lattice[i]) {
+      off_lattice.push_back(i);
+    }
+  }
+  if (!off_lattice.empty()) {
+    const DensityCellList cells(ensembles, pot.density_parameters(),
+                                DensityType::Baryon);
+    ThreadPool::global().for_each_index(
+        off_lattice.size(), update_momenta_chunk,
+        [&](std::size_t k, std::size_t) {
+          const std::size_t i = off_lattice[k];
+          const auto tmp = pot.all_forces(positions[i], cells);
+          FB[i] = std::make_pair(std::get<0>(tmp), std::get<1>(tmp));
+          FI3[i] = std::make_pair(std::get<2>(tmp), std::get<3>(tmp));
+        });
+  }
+
+  /* Every particle is updated by one thread only. The time scale of the
+   * change in momentum is reduced to a minimum per thread first. */
+  std::vector<double> min_time_scales(ThreadPool::global().size(),
+                                      std::numeric_limits<double>::infinity());
+  ThreadPool::global().for_each_index(
+      n_affected, update_momenta_chunk, [&](std::size_t i, std::size_t thread) {
+        ParticleData &data = *affected[i];
+        const auto scale = pot.force_scale(data.type());
+        const ThreeVector v = data.momentum().velocity();
+        ThreeVector Force =
+            scale.first * (FB[i].first + v.cross_product(FB[i].second)) +
+            scale.second * data.type().isospin3_rel() *
+                (FI3[i].first + v.cross_product(FI3[i].second));
+        // Potentially add Lorentz force
+        if (pot.use_coulomb()) {
+          // factor hbar*c to convert fields from 1/fm^2 to GeV/fm
+          Force += hbarc * data.type().charge() * elementary_charge *
+                   (EM_fields[i].first + v.cross_product(EM_fields[i].second));
+        }
+        logg[LPropagation].debug("Update momenta: F [GeV/fm] = ", Force);
+        data.set_4momentum(data.effective_mass(),
+                           data.momentum().threevec() + Force * dt);
+
+        // calculate the time scale of the change in momentum
+        const double Force_abs = Force.abs();
+        if (Force_abs >= really_small) {
+          min_time_scales[thread] = std::min(
+              min_time_scales[thread], data.momentum().x0() / Force_abs);
+        }
+      });
+  const double min_time_scale =
+      *std::min_element(min_time_scales.begin(), min_time_scales.end());
   // warn if the time step is too big
   constexpr double safety_factor = 0.1;
   if (dt > safety_factor * min_time_scale) {
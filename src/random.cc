@@ -8,7 +8,10 @@
  */
 
 #include "smash/random.h"
+#include <algorithm>
+#include <numeric>
 #include <random>
+#include <stdexcept>
 #include "smash/logging.h"
 
 namespace smash {
@@ -76,6 +79,52 @@ std::pair<int, int> random::BesselSampler::sample() {
                         : std::make_pair(N_smaller, N_smaller + N_);
 }
 
+random::AliasSampler::AliasSampler(const std::vector<double> &weights)
+    : probability_(weights.size()), alias_(weights.size()) {
+  const size_t n = weights.size();
+  const double sum = std::accumulate(weights.begin(), weights.end(), 0.0);
+  if (n == 0 || !(sum > 0.0)) {
+    throw std::invalid_argument(
+        "AliasSampler needs weights with a positive sum.");
+  }
+  // Weights scaled such that their mean is 1, bins below and above the mean
+  std::vector<double> scaled(n);
+  std::vector<size_t> small, large;
+  for (size_t i = 0; i < n; i++) {
+    scaled[i] = weights[i] * n / sum;
+    (scaled[i] < 1.0 ? small : large).push_back(i);
+  }
+  // Fill up every small bin with the excess of a large one
+  while (!small.empty() && !large.empty()) {
+    const size_t s = small.back();
+    const size_t l = large.back();
+    small.pop_back();
+    probability_[s] = scaled[s];
+    alias_[s] = l;
+    scaled[l] -= 1.0 - scaled[s];
+    if (scaled[l] < 1.0) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // The remaining bins are full up to rounding errors
+  for (size_t i : large) {
+    probability_[i] = 1.0;
+    alias_[i] = i;
+  }
+  for (size_t i : small) {
+    probability_[i] = 1.0;
+    alias_[i] = i;
+  }
+}
+
+size_t random::AliasSampler::sample() const {
+  const size_t n = probability_.size();
+  const double x = uniform(0.0, static_cast<double>(n));
+  const size_t i = std::min(static_cast<size_t>(x), n - 1);
+  return (x - i < probability_[i]) ? i : alias_[i];
+}
+
 double random::BesselSampler::r_(int n, double a) {
   const double a_inv = 1.0 / a;
   double res = 0.0;
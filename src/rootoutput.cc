@@ -10,7 +10,6 @@
 #include "smash/rootoutput.h"
 #include "TFile.h"
 #include "TTree.h"
-#include "smash/action.h"
 #include "smash/clock.h"
 #include "smash/forwarddeclarations.h"
 #include "smash/particles.h"
@@ -422,16 +421,17 @@ void RootOutput::at_eventend(const Particles &particles,
   }
 }
 
-void RootOutput::at_interaction(const Action &action,
-                                const double /*density*/) {
-  if (write_collisions_) {
-    collisions_to_tree(action.incoming_particles(), action.outgoing_particles(),
-                       action.get_total_weight(), action.get_partial_weight());
-  }
+void RootOutput::at_interactions(ConstSpan<InteractionRecord> records) {
+  for (const InteractionRecord &record : records) {
+    if (write_collisions_) {
+      collisions_to_tree(record.incoming, record.outgoing, record.total_weight,
+                         record.partial_weight);
+    }
 
-  if (write_initial_conditions_ &&
-      action.get_type() == ProcessType::HyperSurfaceCrossing) {
-    particles_to_tree(action.incoming_particles());
+    if (write_initial_conditions_ &&
+        record.type == ProcessType::HyperSurfaceCrossing) {
+      particles_to_tree(record.incoming);
+    }
   }
 }
 
@@ -497,9 +497,8 @@ void RootOutput::particles_to_tree(T &particles) {
   }
 }
 
-void RootOutput::collisions_to_tree(const ParticleList &incoming,
-                                    const ParticleList &outgoing,
-                                    const double weight,
+void RootOutput::collisions_to_tree(ParticleSpan incoming,
+                                    ParticleSpan outgoing, const double weight,
                                     const double partial_weight) {
   ev_ = current_event_;
   nin_ = incoming.size();
@@ -515,7 +514,7 @@ void RootOutput::collisions_to_tree(const ParticleList &incoming,
    * But if one wants initial/final particles written to collisions
    * then implementation should be updated. */
 
-  for (const ParticleList &plist : {incoming, outgoing}) {
+  for (const ParticleSpan &plist : {incoming, outgoing}) {
     for (const auto &p : plist) {
       pdgcode_[i] = p.pdgcode().get_decimal();
       charge_[i] = p.type().charge();
@@ -10,16 +10,23 @@
 #include "smash/scatteractionphoton.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <vector>
 
 #include "smash/angles.h"
 #include "smash/constants.h"
 #include "smash/crosssectionsphoton.h"
 #include "smash/cxx14compat.h"
 #include "smash/forwarddeclarations.h"
+#include "smash/fpenvironment.h"
 #include "smash/outputinterface.h"
 #include "smash/particletype.h"
 #include "smash/pow.h"
 #include "smash/random.h"
+#include "smash/threadpool.h"
 
 namespace smash {
 static constexpr int LScatterAction = LogArea::ScatterAction::id;
@@ -348,18 +355,12 @@ CollisionBranchList ScatterActionPhoton::create_collision_branch() {
   return process_list;
 }
 
-double ScatterActionPhoton::total_cross_section(MediatorType mediator) const {
-  CollisionBranchList process_list;
+double ScatterActionPhoton::total_cross_section_analytic(
+    ReactionType reaction, double s, double m_rho, MediatorType mediator) {
   CrosssectionsPhoton<ComputationMethod::Analytic> xs_object;
-
-  const double s = mandelstam_s();
-  // the mass of the mediating particle depends on the channel. For an incoming
-  // rho it is the mass of the incoming particle, for an outgoing rho it is the
-  // sampled mass
-  const double m_rho = rho_mass();
   double xsection = 0.0;
 
-  switch (reac_) {
+  switch (reaction) {
     case ReactionType::pi_p_pi_m_rho_z:
       xsection = xs_object.xs_pi_pi_rho0(s, m_rho);
       break;
@@ -412,6 +413,24 @@ double ScatterActionPhoton::total_cross_section(MediatorType mediator) const {
       break;
   }
 
+  return xsection;
+}
+
+double ScatterActionPhoton::total_cross_section(MediatorType mediator) const {
+  const double s = mandelstam_s();
+  // the mass of the mediating particle depends on the channel. For an incoming
+  // rho it is the mass of the incoming particle, for an outgoing rho it is the
+  // sampled mass
+  const double m_rho = rho_mass();
+  double xsection = 0.0;
+
+  const auto table = total_xs_tables_.find(cross_section_key(reac_, mediator));
+  if (table == total_xs_tables_.end() ||
+      !interpolate_cross_section(*table->second, std::sqrt(s), m_rho, 0.,
+                                 &xsection)) {
+    xsection = total_cross_section_analytic(reac_, s, m_rho, mediator);
+  }
+
   if (xsection == 0.0) {
     // Vanishing cross sections are problematic for the creation of a
     // CollisionBranch. For infrastructure reasons it is however necessary to
@@ -500,15 +519,13 @@ double ScatterActionPhoton::total_cross_section_w_ff(const double E_photon) {
   }
 }
 
-double ScatterActionPhoton::diff_cross_section(const double t,
-                                               const double m_rho,
-                                               MediatorType mediator) const {
-  const double s = mandelstam_s();
-  double diff_xsection = 0.0;
-
+double ScatterActionPhoton::diff_cross_section_analytic(
+    ReactionType reaction, double s, double t, double m_rho,
+    MediatorType mediator) {
   CrosssectionsPhoton<ComputationMethod::Analytic> xs_object;
+  double diff_xsection = 0.0;
 
-  switch (reac_) {
+  switch (reaction) {
     case ReactionType::pi_p_pi_m_rho_z:
       diff_xsection = xs_object.xs_diff_pi_pi_rho0(s, t, m_rho);
       break;
@@ -559,6 +576,22 @@ double ScatterActionPhoton::diff_cross_section(const double t,
       break;
   }
 
+  return diff_xsection;
+}
+
+double ScatterActionPhoton::diff_cross_section(const double t,
+                                               const double m_rho,
+                                               MediatorType mediator) const {
+  const double s = mandelstam_s();
+  double diff_xsection = 0.0;
+
+  const auto table = diff_xs_tables_.find(cross_section_key(reac_, mediator));
+  if (table == diff_xs_tables_.end() ||
+      !interpolate_cross_section(*table->second, std::sqrt(s), m_rho, t,
+                                 &diff_xsection)) {
+    diff_xsection = diff_cross_section_analytic(reac_, s, t, m_rho, mediator);
+  }
+
   // Rarely, it can happen that the computed differential cross sections slip
   // slightly below zero for numerical reasons. This is unphysical. We
   // approximate them with dSigma/dt = 0.01 mb/GeV^2, which is a reasonable
@@ -681,4 +714,326 @@ std::pair<double, double> ScatterActionPhoton::diff_cross_section_pair(
   return std::pair<double, double>(diff_xs_pion, diff_xs_omega);
 }
 
+/// Smallest rho mass of the photon cross section tables [GeV]
+static constexpr double xs_table_m_rho_min = 2. * pion_mass;
+/// Largest rho mass of the photon cross section tables [GeV]
+static constexpr double xs_table_m_rho_max = 1.6;
+/// Number of intervals in the rho mass of the photon cross section tables
+static constexpr size_t xs_table_n_m_rho = 66;
+/// Smallest energy above threshold of the photon cross section tables [GeV]
+static constexpr double xs_table_dsqrts_min = 1e-3;
+/// Largest energy above threshold of the photon cross section tables [GeV]
+static constexpr double xs_table_dsqrts_max = 3.;
+/// Number of intervals in the energy of the photon cross section tables
+static constexpr size_t xs_table_n_sqrts = 64;
+/// Number of intervals in t of the differential photon cross section tables
+static constexpr size_t xs_table_n_t = 32;
+
+/**
+ * The cross section is tabulated at the nodes of a regular grid in the rho
+ * mass, the variable w in [0, 1], which maps the energy above threshold
+ * quadratically onto [xs_table_dsqrts_min, xs_table_dsqrts_max] to resolve
+ * the threshold, and the variable u in [0, 1], which maps onto the allowed
+ * range of t at the given rho mass and energy such that the nodes cluster at
+ * both ends, where the differential cross sections are steep. The kinematics
+ * use the pion mass of the analytic expressions.
+ */
+struct ScatterActionPhoton::CrossSectionTable {
+  /// Whether the rho is incoming, otherwise it is outgoing
+  bool rho_incoming;
+  /// Number of intervals in u, zero for total cross sections
+  size_t n_t;
+  /// Cross sections at the nodes, u running fastest and the rho mass slowest
+  std::vector<double> values;
+  /// Whether the interpolation is accurate in a cell in rho mass, w and u
+  std::vector<std::uint8_t> accurate;
+};
+
+std::map<ScatterActionPhoton::CrossSectionKey,
+         std::shared_ptr<const ScatterActionPhoton::CrossSectionTable>>
+    ScatterActionPhoton::total_xs_tables_;
+
+std::map<ScatterActionPhoton::CrossSectionKey,
+         std::shared_ptr<const ScatterActionPhoton::CrossSectionTable>>
+    ScatterActionPhoton::diff_xs_tables_;
+
+/**
+ * \param[in] rho_incoming Whether the rho is incoming, otherwise outgoing.
+ * \param[in] m_rho Mass of the rho [GeV].
+ * \param[in] w Energy variable of the photon cross section tables.
+ * \return Center-of-mass energy [GeV].
+ */
+static double xs_table_sqrts(bool rho_incoming, double m_rho, double w) {
+  const double threshold = rho_incoming ? pion_mass + m_rho : m_rho;
+  return threshold + xs_table_dsqrts_min +
+         (xs_table_dsqrts_max - xs_table_dsqrts_min) * w * w;
+}
+
+/**
+ * \param[in] rho_incoming Whether the rho is incoming, otherwise outgoing.
+ * \param[in] m_rho Mass of the rho [GeV].
+ * \param[in] sqrts Center-of-mass energy [GeV].
+ * \return Energy variable of the photon cross section tables, negative below
+ *         the tabulated range.
+ */
+static double xs_table_w(bool rho_incoming, double m_rho, double sqrts) {
+  const double threshold = rho_incoming ? pion_mass + m_rho : m_rho;
+  const double x = (sqrts - threshold - xs_table_dsqrts_min) /
+                   (xs_table_dsqrts_max - xs_table_dsqrts_min);
+  return x >= 0. ? std::sqrt(x) : -1.;
+}
+
+/**
+ * \param[in] rho_incoming Whether the rho is incoming, otherwise outgoing.
+ * \param[in] m_rho Mass of the rho [GeV].
+ * \param[in] sqrts Center-of-mass energy [GeV].
+ * \return Upper and lower bound of Mandelstam-t [GeV^2], as used by the
+ *         analytic expressions.
+ */
+static std::array<double, 2> xs_table_t_range(bool rho_incoming, double m_rho,
+                                              double sqrts) {
+  return rho_incoming
+             ? get_t_range(sqrts, pion_mass, m_rho, pion_mass, 0.)
+             : get_t_range(sqrts, pion_mass, pion_mass, m_rho, 0.);
+}
+
+/**
+ * \param[in] t_range Upper and lower bound of Mandelstam-t [GeV^2].
+ * \param[in] u Variable of t of the photon cross section tables.
+ * \return Mandelstam-t [GeV^2].
+ */
+static double xs_table_t(const std::array<double, 2> &t_range, double u) {
+  const double tau = 0.5 * (1. - std::cos(M_PI * u));
+  return t_range[1] + tau * (t_range[0] - t_range[1]);
+}
+
+/**
+ * Call a function for all indices in [0, n) in the threads of
+ * ThreadPool::global(), with the floating point traps disabled, since the
+ * analytic expressions may overflow close to the thresholds.
+ *
+ * \param[in] n Number of indices.
+ * \param[in] f Function of the index.
+ */
+template <typename F>
+static void for_each_index_in_parallel(size_t n, const F &f) {
+  ThreadPool::global().for_each_index(n, 1, [&f](size_t i, size_t) {
+    DisableFloatTraps guard;
+    f(i);
+  });
+}
+
+ScatterActionPhoton::CrossSectionKey ScatterActionPhoton::cross_section_key(
+    ReactionType reaction, MediatorType mediator) {
+  switch (reaction) {
+    case ReactionType::pi_z_pi_m_rho_m:
+      return {ReactionType::pi_z_pi_p_rho_p, MediatorType::SUM};
+    case ReactionType::pi_m_rho_z_pi_m:
+      return {ReactionType::pi_p_rho_z_pi_p, MediatorType::SUM};
+    case ReactionType::pi_m_rho_p_pi_z:
+      return {ReactionType::pi_p_rho_m_pi_z, mediator};
+    case ReactionType::pi_z_rho_m_pi_m:
+      return {ReactionType::pi_z_rho_p_pi_p, mediator};
+    case ReactionType::pi_p_rho_m_pi_z:
+    case ReactionType::pi_z_rho_p_pi_p:
+      return {reaction, mediator};
+    default:
+      return {reaction, MediatorType::SUM};
+  }
+}
+
+bool ScatterActionPhoton::interpolate_cross_section(
+    const CrossSectionTable &table, double sqrts, double m_rho, double t,
+    double *xs) {
+  const double dm = (xs_table_m_rho_max - xs_table_m_rho_min) /
+                    xs_table_n_m_rho;
+  const double fm = (m_rho - xs_table_m_rho_min) / dm;
+  if (!(fm >= 0. && fm <= xs_table_n_m_rho)) {
+    return false;
+  }
+  const size_t i = std::min<size_t>(fm, xs_table_n_m_rho - 1);
+  /* t is mapped onto its allowed range at the given rho mass and energy and
+   * interpolated by a cubic polynomial through the four closest nodes */
+  size_t l = 0, first_node = 0;
+  std::array<double, 4> c = {1., 0., 0., 0.};
+  if (table.n_t > 0) {
+    const std::array<double, 2> t_range =
+        xs_table_t_range(table.rho_incoming, m_rho, sqrts);
+    // t may lie slightly outside, if the actual pion masses differ
+    const double tau = (t - t_range[1]) / (t_range[0] - t_range[1]);
+    if (!(tau >= -really_small && tau <= 1. + really_small)) {
+      return false;
+    }
+    const double u =
+        std::acos(1. - 2. * std::min(std::max(tau, 0.), 1.)) / M_PI;
+    const double ft = u * table.n_t;
+    l = std::min<size_t>(ft, table.n_t - 1);
+    first_node = std::min(std::max<size_t>(l, 1) - 1, table.n_t - 3);
+    const double x = ft - first_node;
+    c = {-(x - 1.) * (x - 2.) * (x - 3.) / 6., x * (x - 2.) * (x - 3.) / 2.,
+         -x * (x - 1.) * (x - 3.) / 2., x * (x - 1.) * (x - 2.) / 6.};
+  }
+  const size_t n_t_nodes = table.n_t + 1;
+  const size_t n_t_cells = std::max<size_t>(table.n_t, 1);
+  double result = 0.;
+  // interpolate at the same energy and u at both neighboring rho masses
+  for (size_t k = 0; k < 2; k++) {
+    const double m_node = xs_table_m_rho_min + (i + k) * dm;
+    const double fw =
+        xs_table_w(table.rho_incoming, m_node, sqrts) * xs_table_n_sqrts;
+    if (!(fw >= 0. && fw <= xs_table_n_sqrts)) {
+      return false;
+    }
+    const size_t j = std::min<size_t>(fw, xs_table_n_sqrts - 1);
+    if (k == 0 &&
+        !table.accurate[(i * xs_table_n_sqrts + j) * n_t_cells + l]) {
+      return false;
+    }
+    const double *row =
+        &table.values[(i + k) * (xs_table_n_sqrts + 1) * n_t_nodes];
+    auto value_at = [&](size_t jj) {
+      const double *v = row + jj * n_t_nodes + first_node;
+      if (table.n_t == 0) {
+        return v[0];
+      }
+      return c[0] * v[0] + c[1] * v[1] + c[2] * v[2] + c[3] * v[3];
+    };
+    const double b = fw - j;
+    const double value = (1. - b) * value_at(j) + b * value_at(j + 1);
+    const double a = fm - i;
+    result += (k == 0 ? 1. - a : a) * value;
+  }
+  *xs = result;
+  return true;
+}
+
+void ScatterActionPhoton::tabulate_cross_sections(double accuracy) {
+  total_xs_tables_.clear();
+  diff_xs_tables_.clear();
+  if (!(accuracy > 0.)) {
+    return;
+  }
+  // one of every pair of charge conjugated processes
+  const std::array<ReactionType, 6> reactions = {
+      ReactionType::pi_z_pi_p_rho_p, ReactionType::pi_p_rho_z_pi_p,
+      ReactionType::pi_p_rho_m_pi_z, ReactionType::pi_z_rho_p_pi_p,
+      ReactionType::pi_p_pi_m_rho_z, ReactionType::pi_z_rho_z_pi_z};
+  struct Job {
+    CrossSectionKey key;
+    bool differential;
+    std::shared_ptr<CrossSectionTable> table;
+  };
+  std::vector<Job> jobs;
+  for (ReactionType reaction : reactions) {
+    // the mediator is only distinguished where several mediators contribute
+    const bool several_mediators =
+        cross_section_key(reaction, MediatorType::PION).second ==
+        MediatorType::PION;
+    for (MediatorType mediator :
+         {MediatorType::SUM, MediatorType::PION, MediatorType::OMEGA}) {
+      if (!several_mediators && mediator != MediatorType::SUM) {
+        continue;
+      }
+      // the sum of the differential cross sections is not used
+      for (bool differential : {false, true}) {
+        if (differential && several_mediators &&
+            mediator == MediatorType::SUM) {
+          continue;
+        }
+        auto table = std::make_shared<CrossSectionTable>();
+        table->rho_incoming =
+            outgoing_hadron_type(reaction)->pdgcode().is_pion();
+        table->n_t = differential ? xs_table_n_t : 0;
+        table->values.resize((xs_table_n_m_rho + 1) * (xs_table_n_sqrts + 1) *
+                             (table->n_t + 1));
+        table->accurate.assign(xs_table_n_m_rho * xs_table_n_sqrts *
+                                   std::max<size_t>(table->n_t, 1),
+                               1);
+        jobs.push_back({{reaction, mediator}, differential, table});
+      }
+    }
+  }
+
+  const double dm = (xs_table_m_rho_max - xs_table_m_rho_min) /
+                    xs_table_n_m_rho;
+  auto cross_section = [](const Job &job, double sqrts, double t,
+                          double m_rho) {
+    const double s = sqrts * sqrts;
+    return job.differential
+               ? diff_cross_section_analytic(job.key.first, s, t, m_rho,
+                                             job.key.second)
+               : total_cross_section_analytic(job.key.first, s, m_rho,
+                                              job.key.second);
+  };
+  // Evaluate the cross sections at the nodes, one rho mass per work item.
+  const size_t n_rows = xs_table_n_m_rho + 1;
+  for_each_index_in_parallel(jobs.size() * n_rows, [&](size_t index) {
+    const Job &job = jobs[index / n_rows];
+    CrossSectionTable &table = *job.table;
+    const size_t i = index % n_rows;
+    const double m_rho = xs_table_m_rho_min + i * dm;
+    double *value = &table.values[i * (xs_table_n_sqrts + 1) * (table.n_t + 1)];
+    for (size_t j = 0; j <= xs_table_n_sqrts; j++) {
+      const double sqrts = xs_table_sqrts(
+          table.rho_incoming, m_rho, static_cast<double>(j) / xs_table_n_sqrts);
+      const std::array<double, 2> t_range =
+          xs_table_t_range(table.rho_incoming, m_rho, sqrts);
+      for (size_t l = 0; l <= table.n_t; l++) {
+        const double u =
+            table.n_t > 0 ? static_cast<double>(l) / table.n_t : 0.;
+        *value++ = cross_section(job, sqrts, xs_table_t(t_range, u), m_rho);
+      }
+    }
+  });
+  /* Compare the interpolation to the cross sections in the middle of the cells.
+   * The error of a differential cross section is measured relative to its
+   * average over t, since the weights of the photons are proportional to it. */
+  std::atomic<size_t> n_accurate{0};
+  for_each_index_in_parallel(jobs.size() * xs_table_n_m_rho, [&](size_t index) {
+    const Job &job = jobs[index / xs_table_n_m_rho];
+    CrossSectionTable &table = *job.table;
+    const size_t i = index % xs_table_n_m_rho;
+    const double m_rho = xs_table_m_rho_min + (i + 0.5) * dm;
+    for (size_t j = 0; j < xs_table_n_sqrts; j++) {
+      const double sqrts =
+          xs_table_sqrts(table.rho_incoming, xs_table_m_rho_min + i * dm,
+                         (j + 0.5) / xs_table_n_sqrts);
+      const std::array<double, 2> t_range =
+          xs_table_t_range(table.rho_incoming, m_rho, sqrts);
+      const size_t n_checks = std::max<size_t>(table.n_t, 1);
+      std::vector<double> t(n_checks), exact(n_checks);
+      double scale = really_small;
+      for (size_t l = 0; l < n_checks; l++) {
+        const double u = (l + 0.5) / n_checks;
+        t[l] = xs_table_t(t_range, u);
+        exact[l] = cross_section(job, sqrts, t[l], m_rho);
+        // average over t, weighted by the interval of t at the check
+        scale += std::abs(exact[l]) * 0.5 * M_PI * std::sin(M_PI * u) /
+                 n_checks;
+      }
+      for (size_t l = 0; l < n_checks; l++) {
+        double interpolated;
+        const bool accurate =
+            interpolate_cross_section(table, sqrts, m_rho, t[l],
+                                      &interpolated) &&
+            std::isfinite(exact[l]) && std::isfinite(interpolated) &&
+            std::abs(interpolated - exact[l]) <=
+                accuracy * std::max(std::abs(exact[l]), scale);
+        table.accurate[(i * xs_table_n_sqrts + j) * n_checks + l] = accurate;
+        n_accurate += accurate;
+      }
+    }
+  });
+
+  size_t n_cells = 0;
+  for (const Job &job : jobs) {
+    (job.differential ? diff_xs_tables_ : total_xs_tables_)[job.key] =
+        job.table;
+    n_cells += job.table->accurate.size();
+  }
+  logg[LScatterAction].info("Photon cross sections tabulated, ",
+                            100. * n_accurate / n_cells,
+                            "% of the cells are interpolated");
+}
+
 }  // namespace smash
@@ -10,6 +10,7 @@
 #include "smash/scatteractionsfinder.h"
 
 #include <algorithm>
+#include <array>
 #include <map>
 #include <vector>
 
@@ -191,6 +192,21 @@ static constexpr int LFindScatter = LogArea::FindScatter::id;
  * It is possible to produce a popcorn meson from the diquark end of a string
  * with certain probability (i.e., diquark to meson + diquark).
  *
+ * \key Pythia_Warm_Up_Beams (list of pairs of PDG codes, optional,
+ * default = []) \n
+ * Pairs of particles, for which PYTHIA is initialized at startup for the hard
+ * string routine, instead of when their first hard string process occurs,
+ * which takes a few seconds per pair. The particles are mapped onto the
+ * beam particles used in PYTHIA (nucleons, pions and leptons of the same
+ * baryon number and charge), e.g. [[2212, 2212], [2212, 2112], [211, 2212]]
+ * covers all nucleon-nucleon and nucleon-meson collisions.
+ *
+ * \key Pythia_Warm_Up_Sqrts (double, optional, default = 200 GeV) \n
+ * Center of mass energy at which the PYTHIA objects of Pythia_Warm_Up_Beams
+ * are initialized. It should not be smaller than the energy of the hard
+ * string processes, since the energy is only changed event by event
+ * afterwards.
+ *
  * **Examples: Configuring the String Paramters**\n
  *
  * String fragmentation is activated and if desired, the string parameters can
@@ -387,6 +403,25 @@ ScatterActionsFinder::ScatterActionsFinder(
         subconfig.take({"Prob_proton_to_d_uu"}, 1. / 3.),
         subconfig.take({"Separate_Fragment_Baryon"}, true),
         subconfig.take({"Popcorn_Rate"}, 0.15));
+
+    const std::vector<std::vector<int>> warm_up_beams = subconfig.take(
+        {"Pythia_Warm_Up_Beams"}, std::vector<std::vector<int>>{});
+    const double warm_up_sqrts =
+        subconfig.take({"Pythia_Warm_Up_Sqrts"}, 200.);
+    std::vector<std::array<PdgCode, 2>> beams;
+    for (const std::vector<int> &beam : warm_up_beams) {
+      if (beam.size() != 2) {
+        throw std::invalid_argument(
+            "Pythia_Warm_Up_Beams has to consist of pairs of PDG codes.");
+      }
+      beams.push_back(
+          {PdgCode::from_decimal(beam[0]), PdgCode::from_decimal(beam[1])});
+    }
+    if (!beams.empty()) {
+      logg[LFindScatter].info("Initializing PYTHIA for hard string processes "
+                              "of ", beams.size(), " beam pairs.");
+      string_process_interface_->warm_up_hard_pythia(beams, warm_up_sqrts);
+    }
   }
 }
 
@@ -23,6 +23,7 @@
 #include "smash/setup_particles_decaymodes.h"
 #include "smash/sha256.h"
 #include "smash/stringfunctions.h"
+#include "smash/threadpool.h"
 /* build dependent variables */
 #include "smash/config.h"
 
@@ -168,7 +169,9 @@ void usage(const int rc, const std::string &progname) {
       "                          This format is used in MUSIC and CLVisc\n"
       "                          relativistic hydro codes\n"
       "  -q, --quiet             Supress disclaimer print-out\n"
-      "  -n, --no-cache          Don't cache integrals on disk\n"
+      "  -n, --no-cache          Don't cache integrals and particle "
+      "properties\n"
+      "                          on disk\n"
       "  -v, --version\n\n");
   std::exit(rc);
 }
@@ -373,15 +376,19 @@ void initialize_particles_and_decays(Configuration &configuration) {
   ParticleType::create_type_list(configuration.take({"particles"}));
   DecayModes::load_decaymodes(configuration.take({"decaymodes"}));
   ParticleType::check_consistency();
+  ParticleType::width_tabulation_accuracy_ =
+      configuration.take({"Collision_Term", "Width_Tabulation_Accuracy"}, 0.);
 }
 
 /** Initialize the particles and decays from the configuration,
- *  the hash and the path to the cashed resonance integrals.
+ *  the hash and the path to the cashed resonance integrals. The caches of
+ *  the particle types are restored from or stored to the same path.
  */
 void initialize_particles_and_decays(Configuration &configuration,
                                      sha256::Hash hash,
                                      bf::path tabulations_path) {
   initialize_particles_and_decays(configuration);
+  ParticleType::fill_all_caches(hash, tabulations_path);
   logg[LMain].info("Tabulating cross section integrals...");
   IsoParticleType::tabulate_integrals(hash, tabulations_path);
 }
@@ -571,17 +578,32 @@ int main(int argc, char *argv[]) {
       configuration["decaymodes"] = particles_and_decays.second;
     }
 
-    // Calculate a hash of the SMASH version, the particles and decaymodes.
+    /* Calculate a hash of the SMASH version, the particles and decaymodes,
+     * and the accuracy of the width tabulation, which changes the cached
+     * resonance integrals. */
     const std::string version(VERSION_MAJOR);
     const std::string particle_string = configuration["particles"].to_string();
     const std::string decay_string = configuration["decaymodes"].to_string();
+    const double width_tabulation_accuracy = configuration.read(
+        {"Collision_Term", "Width_Tabulation_Accuracy"}, 0.);
     sha256::Context hash_context;
     hash_context.update(version);
     hash_context.update(particle_string);
     hash_context.update(decay_string);
+    hash_context.update(
+        reinterpret_cast<const uint8_t *>(&width_tabulation_accuracy),
+        sizeof(width_tabulation_accuracy));
     const auto hash = hash_context.finalize();
     logg[LMain].info() << "Config hash: " << sha256::hash_to_string(hash);
 
+    /* The threads shared by all parallel parts of SMASH are started once,
+     * before the tabulations at startup. */
+    const int n_threads = configuration.take({"General", "Threads"}, 1);
+    if (n_threads < 0) {
+      throw std::invalid_argument("General: Threads must not be negative.");
+    }
+    ThreadPool::set_global_size(n_threads);
+
     bf::path tabulations_path;
     if (cache_integrals) {
       tabulations_path = output_path.parent_path() / "tabulations";
@@ -147,6 +147,72 @@ void StringProcess::common_setup_pythia(Pythia8::Pythia *pythia_in,
   pythia_in->readString("Check:epTolWarn = 1e-8");
 }
 
+double StringProcess::sqrts_threshold_diffractive(int pdg_a, int pdg_b) const {
+  // This threshold magic is following Pythia. Todo(ryu): take care of this.
+  double sqrts_threshold = 2. * (1. + 1.0e-6);
+  /* In the case of mesons, the corresponding vector meson masses
+   * are used to evaluate the energy threshold. */
+  const int pdg_a_mod =
+      (std::abs(pdg_a) > 1000) ? pdg_a : 10 * (std::abs(pdg_a) / 10) + 3;
+  const int pdg_b_mod =
+      (std::abs(pdg_b) > 1000) ? pdg_b : 10 * (std::abs(pdg_b) / 10) + 3;
+  sqrts_threshold += pythia_hadron_->particleData.m0(pdg_a_mod) +
+                     pythia_hadron_->particleData.m0(pdg_b_mod);
+  return sqrts_threshold;
+}
+
+std::array<double, 3> StringProcess::compute_cross_sections_diffractive(
+    int pdg_a, int pdg_b, double sqrt_s) {
+  /* Constant cross-section for sub-processes below threshold equal to
+   * cross-section at the threshold. */
+  sqrt_s = std::max(sqrt_s, sqrts_threshold_diffractive(pdg_a, pdg_b));
+  pythia_sigmatot_.calc(pdg_a, pdg_b, sqrt_s);
+  return {pythia_sigmatot_.sigmaAX(), pythia_sigmatot_.sigmaXB(),
+          pythia_sigmatot_.sigmaXX()};
+}
+
+std::array<double, 3> StringProcess::cross_sections_diffractive(int pdg_a,
+                                                                int pdg_b,
+                                                                double sqrt_s) {
+  const double sqrts_max = diffractive_xs_sqrts_max_;
+  if (sqrt_s > sqrts_max) {
+    return compute_cross_sections_diffractive(pdg_a, pdg_b, sqrt_s);
+  }
+  const std::pair<int, int> pdg_ab{pdg_a, pdg_b};
+  auto found = diffractive_xs_tabulations_.find(pdg_ab);
+  if (found == diffractive_xs_tabulations_.end()) {
+    // The tabulation starts at the threshold, below which it is clamped.
+    DiffractiveXsTabulation tabulation;
+    tabulation.sqrts_threshold = sqrts_threshold_diffractive(pdg_a, pdg_b);
+    const double log_sqrts_min = std::log(tabulation.sqrts_threshold);
+    const double range = std::log(sqrts_max) - log_sqrts_min;
+    const size_t n = std::ceil(range / diffractive_xs_dlog_sqrts_);
+    // PYTHIA gives all three cross sections at once, so call it once per node
+    std::vector<std::array<double, 3>> xs_nodes(n + 1);
+    for (size_t node = 0; node <= n; node++) {
+      xs_nodes[node] = compute_cross_sections_diffractive(
+          pdg_a, pdg_b, std::exp(log_sqrts_min + node * range / n));
+    }
+    for (size_t i = 0; i < tabulation.xs.size(); i++) {
+      tabulation.xs[i] =
+          Tabulation(log_sqrts_min, range, n, [&](double log_sqrts) {
+            const size_t node =
+                std::lround((log_sqrts - log_sqrts_min) * n / range);
+            return xs_nodes[node][i];
+          });
+    }
+    found =
+        diffractive_xs_tabulations_.emplace(pdg_ab, std::move(tabulation))
+            .first;
+  }
+  const DiffractiveXsTabulation &tabulation = found->second;
+  const double log_sqrts =
+      std::log(std::max(sqrt_s, tabulation.sqrts_threshold));
+  return {tabulation.xs[0].get_value_linear(log_sqrts),
+          tabulation.xs[1].get_value_linear(log_sqrts),
+          tabulation.xs[2].get_value_linear(log_sqrts)};
+}
+
 // compute the formation time and fill the arrays with final-state particles
 int StringProcess::append_final_state(ParticleList &intermediate_particles,
                                       const FourVector &uString,
@@ -517,6 +583,51 @@ bool StringProcess::next_NDiffSoft() {
 }
 
 // hard non-diffractive
+Pythia8::Pythia *StringProcess::hard_pythia(std::pair<int, int> idAB,
+                                            double sqrts) {
+  std::unique_ptr<Pythia8::Pythia> &pythia = hard_map_[idAB];
+  if (pythia) {
+    return pythia.get();
+  }
+  // Only store the object once it is initialized successfully
+  std::unique_ptr<Pythia8::Pythia> new_pythia =
+      make_unique<Pythia8::Pythia>(PYTHIA_XML_DIR, false);
+  new_pythia->readString("SoftQCD:nonDiffractive = on");
+  new_pythia->readString("MultipartonInteractions:pTmin = 1.5");
+  new_pythia->readString("HadronLevel:all = off");
+
+  common_setup_pythia(new_pythia.get(), strange_supp_, diquark_supp_,
+                      popcorn_rate_, stringz_a_produce_, stringz_b_produce_,
+                      string_sigma_T_);
+
+  new_pythia->settings.flag("Beams:allowVariableEnergy", true);
+
+  new_pythia->settings.mode("Beams:idA", idAB.first);
+  new_pythia->settings.mode("Beams:idB", idAB.second);
+  new_pythia->settings.parm("Beams:eCM", sqrts);
+
+  logg[LPythia].debug("Pythia object initialized with ", idAB.first, " + ",
+                      idAB.second, " at CM energy [GeV] ", sqrts);
+
+  if (!new_pythia->init()) {
+    hard_map_.erase(idAB);
+    throw std::runtime_error("Pythia failed to initialize.");
+  }
+  pythia = std::move(new_pythia);
+  return pythia.get();
+}
+
+void StringProcess::warm_up_hard_pythia(
+    const std::vector<std::array<PdgCode, 2>> &beams, double sqrts) {
+  for (std::array<PdgCode, 2> beam : beams) {
+    const int id_a = pdg_map_for_pythia(beam[0]);
+    const int id_b = pdg_map_for_pythia(beam[1]);
+    // The order of the incoming particles is arbitrary
+    hard_pythia({id_a, id_b}, sqrts);
+    hard_pythia({id_b, id_a}, sqrts);
+  }
+}
+
 bool StringProcess::next_NDiffHard() {
   NpartFinal_ = 0;
   final_state_.clear();
@@ -555,37 +666,11 @@ bool StringProcess::next_NDiffHard() {
 
   std::pair<int, int> idAB{pdg_for_pythia[0], pdg_for_pythia[1]};
 
-  // If an entry for the calculated particle IDs does not exist, create one and
-  // initialize it accordingly
-  if (hard_map_.count(idAB) == 0) {
-    hard_map_[idAB] = make_unique<Pythia8::Pythia>(PYTHIA_XML_DIR, false);
-    hard_map_[idAB]->readString("SoftQCD:nonDiffractive = on");
-    hard_map_[idAB]->readString("MultipartonInteractions:pTmin = 1.5");
-    hard_map_[idAB]->readString("HadronLevel:all = off");
-
-    common_setup_pythia(hard_map_[idAB].get(), strange_supp_, diquark_supp_,
-                        popcorn_rate_, stringz_a_produce_, stringz_b_produce_,
-                        string_sigma_T_);
-
-    hard_map_[idAB]->settings.flag("Beams:allowVariableEnergy", true);
-
-    hard_map_[idAB]->settings.mode("Beams:idA", idAB.first);
-    hard_map_[idAB]->settings.mode("Beams:idB", idAB.second);
-    hard_map_[idAB]->settings.parm("Beams:eCM", sqrtsAB_);
-
-    logg[LPythia].debug("Pythia object initialized with ", pdg_for_pythia[0],
-                        " + ", pdg_for_pythia[1], " at CM energy [GeV] ",
-                        sqrtsAB_);
-
-    if (!hard_map_[idAB]->init()) {
-      throw std::runtime_error("Pythia failed to initialize.");
-    }
-  }
+  Pythia8::Pythia *pythia_hard = hard_pythia(idAB, sqrtsAB_);
 
-  // Else just pick the existing and initialized entry and go on
   // Initialize Pythias random number generator using SMASHs seed
   const int seed_new = random::uniform_int(1, maximum_rndm_seed_in_pythia);
-  hard_map_[idAB]->rndm.init(seed_new);
+  pythia_hard->rndm.init(seed_new);
   logg[LPythia].debug("hard_map_[", idAB.first, "][", idAB.second,
                       "] : rndm is initialized with seed ", seed_new);
 
@@ -594,7 +679,7 @@ bool StringProcess::next_NDiffHard() {
   // Short notation for Pythia event
   Pythia8::Event &event_hadron = pythia_hadron_->event;
   logg[LPythia].debug("Pythia hard event created");
-  bool final_state_success = hard_map_[idAB]->next(sqrtsAB_);
+  bool final_state_success = pythia_hard->next(sqrtsAB_);
   logg[LPythia].debug("Pythia final state computed, success = ",
                       final_state_success);
   if (!final_state_success) {
@@ -609,15 +694,15 @@ bool StringProcess::next_NDiffHard() {
   /* Update the partonic intermediate state from PYTHIA output.
    * Note that hadronization will be performed separately,
    * after identification of strings and replacement of constituents. */
-  for (int i = 0; i < hard_map_[idAB]->event.size(); i++) {
-    if (hard_map_[idAB]->event[i].isFinal()) {
-      const int pdgid = hard_map_[idAB]->event[i].id();
-      Pythia8::Vec4 pquark = hard_map_[idAB]->event[i].p();
-      const double mass = hard_map_[idAB]->particleData.m0(pdgid);
+  for (int i = 0; i < pythia_hard->event.size(); i++) {
+    if (pythia_hard->event[i].isFinal()) {
+      const int pdgid = pythia_hard->event[i].id();
+      Pythia8::Vec4 pquark = pythia_hard->event[i].p();
+      const double mass = pythia_hard->particleData.m0(pdgid);
 
-      const int status = hard_map_[idAB]->event[i].status();
-      const int color = hard_map_[idAB]->event[i].col();
-      const int anticolor = hard_map_[idAB]->event[i].acol();
+      const int status = pythia_hard->event[i].status();
+      const int color = pythia_hard->event[i].col();
+      const int anticolor = pythia_hard->event[i].acol();
 
       pSum += pquark;
       event_intermediate_.append(pdgid, status, color, anticolor, pquark, mass);
@@ -625,11 +710,11 @@ bool StringProcess::next_NDiffHard() {
   }
   // add junctions to the intermediate state if there is any.
   event_intermediate_.clearJunctions();
-  for (int i = 0; i < hard_map_[idAB]->event.sizeJunction(); i++) {
-    const int kind = hard_map_[idAB]->event.kindJunction(i);
+  for (int i = 0; i < pythia_hard->event.sizeJunction(); i++) {
+    const int kind = pythia_hard->event.kindJunction(i);
     std::array<int, 3> col;
     for (int j = 0; j < 3; j++) {
-      col[j] = hard_map_[idAB]->event.colJunction(i, j);
+      col[j] = pythia_hard->event.colJunction(i, j);
     }
     event_intermediate_.appendJunction(kind, col[0], col[1], col[2]);
   }
@@ -654,7 +739,7 @@ bool StringProcess::next_NDiffHard() {
     const int pdgid = event_intermediate_[ipart].id();
     if (event_intermediate_[ipart].isFinal() &&
         !event_intermediate_[ipart].isParton() &&
-        !hard_map_[idAB]->particleData.isOctetHadron(pdgid)) {
+        !pythia_hard->particleData.isOctetHadron(pdgid)) {
       logg[LPythia].debug("PDG ID from Pythia: ", pdgid);
       FourVector momentum = reorient(event_intermediate_[ipart], evecBasisAB_);
       logg[LPythia].debug("4-momentum from Pythia: ", momentum);
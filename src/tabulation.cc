@@ -22,6 +22,25 @@ Tabulation::Tabulation(double x_min, double range, size_t num,
   }
 }
 
+HermiteTabulation::HermiteTabulation(
+    double x_min, double range, size_t num,
+    std::function<std::pair<double, double>(double)> f)
+    : x_min_(x_min),
+      x_max_(x_min + range),
+      dx_(range / num),
+      inv_dx_(num / range) {
+  if (num < 2) {
+    throw std::runtime_error("Tabulation needs at least two values");
+  }
+  values_.resize(num + 1);
+  derivatives_.resize(num + 1);
+  for (size_t i = 0; i <= num; i++) {
+    const std::pair<double, double> f_and_df = f(x_min_ + i * dx_);
+    values_[i] = f_and_df.first;
+    derivatives_[i] = f_and_df.second;
+  }
+}
+
 double Tabulation::get_value_step(double x) const {
   if (x < x_min_) {
     return 0.;
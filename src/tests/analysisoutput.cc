@@ -0,0 +1,137 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include <vir/test.h>  // This include has to be first
+
+#include "setup.h"
+
+#include <fstream>
+#include <string>
+
+#include "../include/smash/analysisoutput.h"
+#include "../include/smash/particles.h"
+
+using namespace smash;
+
+static const bf::path testoutputpath = bf::absolute(SMASH_TEST_OUTPUT_PATH);
+
+TEST(directory_is_created) {
+  bf::create_directories(testoutputpath);
+  VERIFY(bf::exists(testoutputpath));
+}
+
+TEST(init_particletypes) { Test::create_smashon_particletypes(); }
+
+TEST(uniform_histogram) {
+  UniformHistogram h(-1., 1., 4);
+  COMPARE(h.n_bins(), 4);
+  COMPARE(h.bin_width(), 0.5);
+  COMPARE(h.bin_center(0), -0.75);
+  COMPARE(h.find_bin(-1.), 0);
+  COMPARE(h.find_bin(0.), 2);
+  COMPARE(h.find_bin(1.), -1);
+  COMPARE(h.find_bin(-1.5), -1);
+  h.fill(0.1);
+  h.fill(0.2, 2.);
+  h.fill(5.);
+  COMPARE(h.content(2), 3.);
+}
+
+TEST_CATCH(unknown_observable, std::invalid_argument) {
+  AnalysisOutput::create_observable("Unknown", AnalysisParameters());
+}
+
+/* Particles at midrapidity with pT = 1 GeV in direction of the impact
+ * parameter, i.e. maximal directed flow. */
+static void insert_flowing_particles(Particles *particles, int n) {
+  const double m = ParticleType::find(0x661).mass();
+  const double E = std::sqrt(m * m + 1.);
+  for (int i = 0; i < n; i++) {
+    particles->insert(Test::smashon(Test::Momentum{E, 1., 0., 0.}));
+  }
+}
+
+/* Find the first data line after the comment lines following a given
+ * comment. */
+static std::string first_line_after(const bf::path &path,
+                                    const std::string &comment, int skip = 0) {
+  std::ifstream file(path.native());
+  std::string line;
+  bool found = false;
+  while (std::getline(file, line)) {
+    if (line.find(comment) != std::string::npos) {
+      found = true;
+    } else if (found && !line.empty() && line[0] != '#' && skip-- == 0) {
+      return line;
+    }
+  }
+  return "";
+}
+
+TEST(analysis_output) {
+  OutputParameters out_par;
+  out_par.analysis.species = {661};
+  out_par.analysis.pt_range = {{0., 2.}};
+  out_par.analysis.pt_bins = 2;
+  out_par.analysis.rapidity_range = {{-1., 1.}};
+  out_par.analysis.rapidity_bins = 2;
+  out_par.analysis.max_harmonic = 2;
+  Particles particles;
+  insert_flowing_particles(&particles, 10);
+  {
+    AnalysisOutput output(testoutputpath, "Analysis", out_par);
+    VERIFY(bf::exists(testoutputpath / "analysis_flow.dat.unfinished"));
+    const EventInfo info = Test::default_event_info();
+    // two events
+    output.at_eventend(particles, 0, info);
+    output.at_eventend(particles, 1, info);
+    output.at_runend();
+  }
+  for (const char *name : {"spectra", "flow", "multiplicity",
+                           "collision_rate"}) {
+    VERIFY(bf::exists(testoutputpath /
+                      (std::string("analysis_") + name + ".dat")));
+  }
+  /* All particles are at y = 0, the upper rapidity bin [0, 1) has
+   * dN/dy = 10 particles per event / bin width 1. */
+  COMPARE(first_line_after(testoutputpath / "analysis_spectra.dat", "dN/dy",
+                           1),
+          "0.5 10");
+  // pT = 1 lies in the upper bin [1, 2)
+  COMPARE(first_line_after(testoutputpath / "analysis_spectra.dat", "dN/dpT",
+                           1),
+          "1.5 10");
+  // v1 = 1, v2 = cos(0) = 1 without fluctuations
+  COMPARE(first_line_after(testoutputpath / "analysis_flow.dat", "# 661", 1),
+          "1.5 20 1 0 1 0");
+  // smashons are not charged
+  COMPARE(first_line_after(testoutputpath / "analysis_multiplicity.dat",
+                           "N_ch"),
+          "0 1");
+}
+
+TEST(aborted_run_keeps_unfinished_names) {
+  OutputParameters out_par;
+  out_par.analysis.species = {661};
+  out_par.analysis.observables = {"Multiplicity"};
+  const bf::path path = testoutputpath / "analysis_multiplicity.dat";
+  bf::path unfinished = path;
+  unfinished += ".unfinished";
+  bf::remove(path);
+  try {
+    AnalysisOutput output(testoutputpath, "Analysis", out_par);
+    Particles particles;
+    output.at_eventend(particles, 0, Test::default_event_info());
+    throw std::runtime_error("abort");
+  } catch (std::runtime_error &) {
+  }
+  VERIFY(bf::exists(unfinished));
+  VERIFY(!bf::exists(path));
+  VERIFY(bf::remove(unfinished));
+}
@@ -346,6 +346,42 @@ TEST(particles_format) {
   VERIFY(bf::remove(particleoutputpath));
 }
 
+TEST(blocks_written_at_event_end) {
+  // enough particles to exceed the block buffer with a single block, and few
+  // enough to keep the other blocks in the buffer until the event ends
+  const size_t n_large = 1000, n_small = 3;
+  const auto particles =
+      Test::create_particles(n_large, [] { return Test::smashon_random(); });
+  const auto few_particles =
+      Test::create_particles(n_small, [] { return Test::smashon_random(); });
+  EventInfo event = Test::default_event_info();
+
+  const bf::path particleoutputpath = testoutputpath / "particles_binary.bin";
+  bf::path particleoutputpath_unfinished = particleoutputpath;
+  particleoutputpath_unfinished += ".unfinished";
+  const size_t header_size = 4 + 2 + 2 + 4 + std::strlen(VERSION_MAJOR);
+  const size_t particle_size = 9 * sizeof(double) + 3 * sizeof(int32_t);
+  const size_t end_block_size = 1 + sizeof(int32_t) + sizeof(double) + 1;
+  {
+    OutputParameters output_par = OutputParameters();
+    output_par.part_extended = false;
+    output_par.part_only_final = OutputOnlyFinal::No;
+    auto bin_output = make_unique<BinaryOutputParticles>(
+        testoutputpath, "Particles", output_par);
+    bin_output->at_eventstart(*particles, 0, event);
+    DensityParameters dens_par(Test::default_parameters());
+    bin_output->at_intermediate_time(*few_particles, nullptr, dens_par, event);
+    bin_output->at_eventend(*few_particles, 0, event);
+    // all blocks are on disk after the end of the event
+    const size_t large_block_size = 5 + n_large * particle_size;
+    const size_t small_block_size = 5 + n_small * particle_size;
+    COMPARE(bf::file_size(particleoutputpath_unfinished),
+            header_size + large_block_size + 2 * small_block_size +
+                end_block_size);
+  }
+  VERIFY(bf::remove(particleoutputpath));
+}
+
 TEST(extended) {
   /* create two smashon particles */
   Particles particles;
@@ -0,0 +1,159 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include <vir/test.h>  // This include has to be first
+
+#include "setup.h"
+
+#include <string>
+#include <vector>
+
+#include "../include/smash/columnaroutput.h"
+#include "../include/smash/particles.h"
+
+using namespace smash;
+
+static const bf::path testoutputpath = bf::absolute(SMASH_TEST_OUTPUT_PATH);
+
+TEST(directory_is_created) {
+  bf::create_directories(testoutputpath);
+  VERIFY(bf::exists(testoutputpath));
+}
+
+TEST(init_particletypes) { Test::create_smashon_particletypes(); }
+
+/* Compare the columns of a chunk with the particles */
+static void compare_chunk(ColumnarReader &reader, size_t chunk,
+                          const Particles &particles) {
+  const auto x = reader.read_doubles(chunk, "x");
+  const auto px = reader.read_doubles(chunk, "px");
+  const auto mass = reader.read_doubles(chunk, "mass");
+  const auto pdg = reader.read_ints(chunk, "pdg");
+  const auto id = reader.read_ints(chunk, "ID");
+  COMPARE(px.size(), particles.size());
+  size_t i = 0;
+  for (const ParticleData &p : particles) {
+    COMPARE(x[i], p.position().x1());
+    COMPARE(px[i], p.momentum().x1());
+    COMPARE(mass[i], p.effective_mass());
+    COMPARE(pdg[i], p.pdgcode().get_decimal());
+    COMPARE(id[i], p.id());
+    i++;
+  }
+}
+
+TEST(write_and_read) {
+  Particles particles;
+  for (int i = 0; i < 10; i++) {
+    particles.insert(Test::smashon_random());
+  }
+  const bf::path outputfilepath = testoutputpath / "particles_columnar.bin";
+  bf::path outputfilepath_unfinished = outputfilepath;
+  outputfilepath_unfinished += ".unfinished";
+  OutputParameters output_par = OutputParameters();
+  output_par.part_extended = true;
+  output_par.part_only_final = OutputOnlyFinal::No;
+  DensityParameters dens_par(Test::default_parameters());
+  {
+    ColumnarOutput output(testoutputpath, "Particles", output_par);
+    VERIFY(bf::exists(outputfilepath_unfinished));
+    for (int event = 0; event < 2; event++) {
+      EventInfo info = Test::default_event_info(0.5 * event, false);
+      output.at_eventstart(particles, event, info);
+      output.at_intermediate_time(particles, nullptr, dens_par, info);
+      output.at_eventend(particles, event, info);
+    }
+    output.at_runend();
+  }
+  VERIFY(!bf::exists(outputfilepath_unfinished));
+  VERIFY(bf::exists(outputfilepath));
+
+  ColumnarReader reader(outputfilepath);
+  VERIFY(reader.extended());
+  COMPARE(reader.columns().size(), ColumnarOutput::columns(true).size());
+  COMPARE(reader.chunks().size(), 6u);
+  const auto chunks = reader.chunks_of_event(1);
+  COMPARE(chunks.size(), 3u);
+  for (size_t chunk : chunks) {
+    COMPARE(reader.chunks()[chunk].event_number, 1);
+    COMPARE(reader.chunks()[chunk].n_particles, 10u);
+    COMPARE(reader.chunks()[chunk].impact_parameter, 0.5);
+  }
+  // read the chunks in reverse order to test seeking
+  for (size_t chunk = reader.chunks().size(); chunk-- > 0;) {
+    compare_chunk(reader, chunk, particles);
+  }
+  const auto pdg_mother1 = reader.read_ints(chunks.back(), "pdg_mother1");
+  COMPARE(pdg_mother1.size(), 10u);
+}
+
+TEST(only_final) {
+  Particles particles;
+  particles.insert(Test::smashon_random());
+  const bf::path outputfilepath = testoutputpath / "particles_columnar.bin";
+  OutputParameters output_par = OutputParameters();
+  output_par.part_only_final = OutputOnlyFinal::IfNotEmpty;
+  {
+    ColumnarOutput output(testoutputpath, "Particles", output_par);
+    for (int event = 0; event < 3; event++) {
+      // the second event is empty and not written
+      EventInfo info = Test::default_event_info(0., event == 1);
+      output.at_eventstart(particles, event, info);
+      output.at_eventend(particles, event, info);
+    }
+    output.at_runend();
+  }
+  ColumnarReader reader(outputfilepath);
+  VERIFY(!reader.extended());
+  COMPARE(reader.chunks().size(), 2u);
+  COMPARE(reader.chunks()[0].event_number, 0);
+  COMPARE(reader.chunks()[1].event_number, 2);
+  VERIFY(reader.chunks_of_event(1).empty());
+  compare_chunk(reader, 1, particles);
+}
+
+TEST_CATCH(unknown_column, std::invalid_argument) {
+  ColumnarReader reader(testoutputpath / "particles_columnar.bin");
+  reader.read_doubles(0, "unknown");
+}
+
+TEST_CATCH(wrong_column_type, std::invalid_argument) {
+  ColumnarReader reader(testoutputpath / "particles_columnar.bin");
+  reader.read_doubles(0, "pdg");
+}
+
+TEST_CATCH(not_columnar_file, std::runtime_error) {
+  const bf::path path = testoutputpath / "not_columnar.bin";
+  {
+    RenamingFilePtr file(path, "w");
+    std::fprintf(file.get(), "some text which is no columnar output\n");
+  }
+  ColumnarReader reader(path);
+}
+
+TEST(aborted_run_keeps_unfinished_name) {
+  Particles particles;
+  particles.insert(Test::smashon_random());
+  const bf::path outputfilepath = testoutputpath / "particles_columnar.bin";
+  bf::path outputfilepath_unfinished = outputfilepath;
+  outputfilepath_unfinished += ".unfinished";
+  OutputParameters output_par = OutputParameters();
+  const EventInfo info = Test::default_event_info();
+  bf::remove(outputfilepath);
+  try {
+    ColumnarOutput output(testoutputpath, "Particles", output_par);
+    output.at_eventstart(particles, 0, info);
+    output.at_eventend(particles, 0, info);
+    throw std::runtime_error("abort");
+  } catch (std::runtime_error &) {
+  }
+  VERIFY(bf::exists(outputfilepath_unfinished));
+  VERIFY(!bf::exists(outputfilepath));
+  VERIFY(bf::remove(outputfilepath_unfinished));
+}
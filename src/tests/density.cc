@@ -326,6 +326,114 @@ TEST(current_curl_in_rotating_box) {
   COMPARE_ABSOLUTE_ERROR(rot_j_T_over_z, 0., 0.01);
 }
 
+TEST(density_cell_list) {
+  ExperimentParameters exp_par = smash::Test::default_parameters();
+  exp_par.testparticles = 20;
+  const DensityParameters par(exp_par);
+  /* Protons, antiprotons and pions moving in random directions in a region
+   * which is much larger than the cutoff radius. */
+  std::vector<Particles> ensembles(2);
+  ParticleList P;
+  for (Particles &particles : ensembles) {
+    for (int i = 0; i < 2000; i++) {
+      const int kind = random::uniform_int(0, 2);
+      ParticleData part{ParticleType::find(
+          kind == 0 ? 0x2212 : (kind == 1 ? -0x2212 : 0x211))};
+      part.set_4momentum(part.pole_mass(),
+                         random::uniform(-1., 1.), random::uniform(-1., 1.),
+                         random::uniform(-1., 1.));
+      part.set_4position(FourVector(0., random::uniform(-10., 10.),
+                                    random::uniform(-10., 10.),
+                                    random::uniform(-20., 20.)));
+      P.push_back(particles.insert(part));
+    }
+  }
+  const DensityCellList cells(ensembles, par, DensityType::Baryon);
+  // pions do not contribute to the baryon density and are not stored
+  VERIFY(cells.size() < P.size());
+
+  for (int i = 0; i < 50; i++) {
+    // include points outside of the particle region
+    const ThreeVector r(random::uniform(-15., 15.), random::uniform(-15., 15.),
+                        random::uniform(-25., 25.));
+    for (DensityType dtype :
+         {DensityType::Baryon, DensityType::BaryonicIsospin}) {
+      const auto full = current_eckart(r, P, par, dtype, true, true);
+      const auto local =
+          current_eckart(r, cells.neighbors(r), par, dtype, true, true);
+      COMPARE_ABSOLUTE_ERROR(std::get<0>(local), std::get<0>(full), 1.e-12);
+      for (int k = 0; k < 4; k++) {
+        COMPARE_ABSOLUTE_ERROR(std::get<1>(local)[k], std::get<1>(full)[k],
+                               1.e-12);
+        COMPARE_ABSOLUTE_ERROR(std::get<4>(local)[k], std::get<4>(full)[k],
+                               1.e-12);
+      }
+      for (int k = 0; k < 3; k++) {
+        COMPARE_ABSOLUTE_ERROR(std::get<2>(local)[k], std::get<2>(full)[k],
+                               1.e-12);
+        COMPARE_ABSOLUTE_ERROR(std::get<3>(local)[k], std::get<3>(full)[k],
+                               1.e-12);
+      }
+    }
+  }
+}
+
+/* With finite difference derivatives, the lattice update only writes the
+ * derivatives of nodes where they change. The tiles far from the particle
+ * stay empty, and all nodes with derivatives lie in occupied tiles. */
+TEST(finite_difference_derivatives_keep_empty_tiles) {
+  ExperimentParameters exp_par = smash::Test::default_parameters();
+  exp_par.derivatives_mode = DerivativesMode::FiniteDifference;
+  const DensityParameters par(exp_par);
+  const std::array<double, 3> l = {40., 40., 40.};
+  const std::array<int, 3> n = {40, 40, 40};
+  const std::array<double, 3> origin = {-20., -20., -20.};
+  DensityLattice lat(l, n, origin, false, LatticeUpdate::EveryTimestep);
+  RectangularLattice<FourVector> old_jmu(l, n, origin, false,
+                                         LatticeUpdate::EveryTimestep),
+      new_jmu(l, n, origin, false, LatticeUpdate::EveryTimestep);
+  RectangularLattice<std::array<FourVector, 4>> four_grad(
+      l, n, origin, false, LatticeUpdate::EveryTimestep);
+
+  std::vector<Particles> ensembles(1);
+  ParticleData proton = create_proton();
+  proton.set_4momentum(0.938, 0.3, 0., 0.);
+  proton.set_4position(FourVector(0., 0.5, 0.5, 0.5));
+  ensembles[0].insert(proton);
+  for (int step = 0; step < 2; step++) {
+    update_lattice(&lat, &old_jmu, &new_jmu, &four_grad,
+                   LatticeUpdate::EveryTimestep, DensityType::Baryon, par,
+                   ensembles, 0.1, true);
+    for (ParticleData &p : ensembles[0]) {
+      p.set_4position(p.position() + FourVector(0.1, 0.03, 0., 0.));
+    }
+  }
+
+  const DensityLattice &const_lat = lat;
+  auto derivatives = [](const DensityOnLattice &node) {
+    double sum = 0.;
+    for (const FourVector &d : node.djmu_dxnu()) {
+      for (int k = 0; k < 4; k++) {
+        sum += std::abs(d[k]);
+      }
+    }
+    return sum;
+  };
+  double sum_all = 0.;
+  for (const DensityOnLattice &node : const_lat) {
+    sum_all += derivatives(node);
+  }
+  size_t n_occupied = 0;
+  double sum_occupied = 0.;
+  const_lat.iterate_occupied([&](const DensityOnLattice &node, int) {
+    n_occupied++;
+    sum_occupied += derivatives(node);
+  });
+  VERIFY(sum_all > 0.);
+  COMPARE_RELATIVE_ERROR(sum_occupied, sum_all, 1e-12);
+  VERIFY(n_occupied < const_lat.size() / 4) << n_occupied;
+}
+
 /*
    This test does not compare anything. It only prints density map versus
    time to vtk files, so that one can open it with paraview and make sure
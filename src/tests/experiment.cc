@@ -87,3 +87,47 @@ TEST(access_particles) {
   ParticleList part_list = part->copy_to_vector();
   VERIFY(part_list.size() == 1);
 }
+
+static ParticleData particle_at(PdgCode pdg, double x, int ncoll = 1) {
+  ParticleData p{ParticleType::find(pdg)};
+  p.set_4position(FourVector(0., x, 0., 0.));
+  p.set_history(ncoll, 0, ProcessType::Elastic, 0., {});
+  return p;
+}
+
+TEST(fit_adaptive_lattice) {
+  ExperimentParameters exp_par = Test::default_parameters();
+  exp_par.only_participants = true;
+  const DensityParameters par(exp_par);
+  const std::array<double, 3> cell = {1., 1., 1.};
+  const std::array<int, 3> max_n = {40, 40, 40};
+  std::array<double, 3> origin = {-10., -10., -10.};
+  std::array<int, 3> n = {20, 20, 20};
+
+  // Spectators and, without Coulomb potential, mesons do not contribute
+  std::vector<Particles> ensembles(1);
+  ensembles[0].insert(particle_at(0x2212, 0.));
+  ensembles[0].insert(particle_at(0x2112, 3.));
+  ensembles[0].insert(particle_at(0x211, 30.));
+  ensembles[0].insert(particle_at(0x2212, -30., 0));
+  VERIFY(!fit_adaptive_lattice(ensembles, par, false, cell, max_n, origin, n));
+  for (int i = 0; i < 3; i++) {
+    COMPARE(n[i], 20);
+    COMPARE(origin[i], -10.);
+  }
+
+  // Charged mesons do with Coulomb potential, without margin at the limit
+  VERIFY(fit_adaptive_lattice(ensembles, par, true, cell, max_n, origin, n));
+  COMPARE(n[0], 40);
+  COMPARE(n[1], 14);
+  COMPARE_ABSOLUTE_ERROR(origin[0], -5., 1e-12);
+  COMPARE_ABSOLUTE_ERROR(origin[1], -7., 1e-12);
+
+  // Too widely spread particles are limited to the maximal number of cells
+  ensembles[0].insert(particle_at(0x2212, 100.));
+  VERIFY(fit_adaptive_lattice(ensembles, par, false, cell, max_n, origin, n));
+  COMPARE(n[0], 40);
+  COMPARE(n[1], 14);
+  COMPARE_ABSOLUTE_ERROR(origin[0], 14., 1e-12);
+  VERIFY(!fit_adaptive_lattice(ensembles, par, false, cell, max_n, origin, n));
+}
@@ -0,0 +1,162 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include <vir/test.h>  // This include has to be first
+
+#include "setup.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "../include/smash/file.h"
+
+using namespace smash;
+
+static const bf::path testoutputpath = bf::absolute(SMASH_TEST_OUTPUT_PATH);
+
+static std::string read_file(const bf::path &path) {
+  std::ifstream in(path.native(), std::ios::binary);
+  std::stringstream content;
+  content << in.rdbuf();
+  return content.str();
+}
+
+/* Write some formatted lines and binary data into the file, flushing after
+ * every block like the outputs do at the end of an event. */
+static std::string write_test_content(RenamingFilePtr &file) {
+  std::string expected;
+  char line[64];
+  for (int block = 0; block < 20; block++) {
+    for (int i = 0; i < 50; i++) {
+      const int n = std::snprintf(line, sizeof(line), "%i %i %12.7f\n", block,
+                                  i, 0.1 * i * block);
+      std::fprintf(file.get(), "%i %i %12.7f\n", block, i, 0.1 * i * block);
+      expected.append(line, n);
+    }
+    const double x = block;
+    std::fwrite(&x, sizeof(x), 1, file.get());
+    expected.append(reinterpret_cast<const char *>(&x), sizeof(x));
+    file.flush();
+  }
+  return expected;
+}
+
+TEST(directory_is_created) {
+  bf::create_directories(testoutputpath);
+  VERIFY(bf::exists(testoutputpath));
+}
+
+TEST(renaming_file) {
+  const bf::path path = testoutputpath / "sync.dat";
+  bf::remove(path);
+  std::string expected;
+  {
+    RenamingFilePtr file(path, "wb");
+    expected = write_test_content(file);
+    VERIFY(bf::exists(testoutputpath / "sync.dat.unfinished"));
+    VERIFY(!bf::exists(path));
+  }
+  VERIFY(!bf::exists(testoutputpath / "sync.dat.unfinished"));
+  COMPARE(read_file(path), expected);
+}
+
+TEST(asynchronous_renaming_file) {
+  // tiny buffers and a short queue, such that the writer falls behind
+  AsyncWriteParameters async;
+  async.enabled = true;
+  async.buffer_size = 100;
+  async.max_pending_buffers = 1;
+  const bf::path path = testoutputpath / "async.dat";
+  bf::remove(path);
+  std::string expected;
+  {
+    RenamingFilePtr file(path, "wb", async);
+    expected = write_test_content(file);
+    VERIFY(bf::exists(testoutputpath / "async.dat.unfinished"));
+    VERIFY(!bf::exists(path));
+  }
+  VERIFY(!bf::exists(testoutputpath / "async.dat.unfinished"));
+  COMPARE(read_file(path), expected);
+}
+
+TEST(asynchronous_file_on_exception) {
+  AsyncWriteParameters async;
+  async.enabled = true;
+  const bf::path path = testoutputpath / "exception.dat";
+  try {
+    RenamingFilePtr file(path, "w", async);
+    std::fprintf(file.get(), "before the exception\n");
+    throw std::runtime_error("abort");
+  } catch (std::runtime_error &) {
+  }
+  COMPARE(read_file(path), "before the exception\n");
+}
+
+TEST(posted_tasks_keep_the_order) {
+  for (const bool enabled : {false, true}) {
+    AsyncWriteParameters async;
+    async.enabled = enabled;
+    async.buffer_size = 16;
+    async.max_pending_buffers = 2;
+    const bf::path path = testoutputpath / "posted.dat";
+    bf::remove(path);
+    std::string expected;
+    {
+      RenamingFilePtr file(path, "w", async);
+      COMPARE(file.asynchronous(), enabled);
+      for (int i = 0; i < 100; i++) {
+        std::fprintf(file.get(), "stream %i\n", i);
+        file.post([i](std::FILE *f) { std::fprintf(f, "task %i\n", i); });
+        expected += "stream " + std::to_string(i) + "\ntask " +
+                    std::to_string(i) + "\n";
+      }
+    }
+    COMPARE(read_file(path), expected) << enabled;
+  }
+}
+
+TEST(failed_write_keeps_unfinished_name) {
+  // the file is opened for reading only, such that writing it fails
+  const bf::path path = testoutputpath / "failed.dat";
+  bf::path unfinished = path;
+  unfinished += ".unfinished";
+  bf::remove(path);
+  { std::ofstream(unfinished.native()); }
+  AsyncWriteParameters async;
+  async.enabled = true;
+  {
+    RenamingFilePtr file(path, "r", async);
+    file.post([](std::FILE *f) { std::fprintf(f, "not written\n"); });
+  }
+  VERIFY(bf::exists(unfinished));
+  VERIFY(!bf::exists(path));
+  bf::remove(unfinished);
+}
+
+TEST(writer_reports_errors) {
+  std::FILE *full = std::fopen("/dev/full", "w");
+  if (full == nullptr) {
+    return;
+  }
+  AsyncWriteParameters async;
+  async.buffer_size = 16;
+  AsyncFileWriter writer(full, async);
+  const std::string data(100, 'x');
+  writer.append(data.data(), data.size());
+  COMPARE(writer.finish(), ENOSPC);
+  std::fclose(full);
+}
+
+TEST_CATCH(invalid_async_parameters, std::invalid_argument) {
+  AsyncWriteParameters async;
+  async.enabled = true;
+  async.max_pending_buffers = 0;
+  RenamingFilePtr file(testoutputpath / "invalid.dat", "w", async);
+}
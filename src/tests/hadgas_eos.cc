@@ -11,6 +11,11 @@
 
 #include "setup.h"
 
+#include <fstream>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
 #include "../include/smash/constants.h"
 #include "../include/smash/hadgas_eos.h"
 
@@ -70,7 +75,7 @@ TEST(EoS_table) {
   // make a small table of EoS
   HadronGasEos eos = HadronGasEos(false, false);
   EosTable table = EosTable(0.1, 0.05, 0.05, 5, 5, 5);
-  table.compile_table(eos, "small_test_table_eos.dat");
+  table.compile_table(eos, "small_test_table_eos.bin");
   EosTable::table_element x;
   const double my_e = 0.39, my_nb = 0.09, my_nq = 0.06;
   table.get(x, my_e, my_nb, my_nq);
@@ -81,7 +86,44 @@ TEST(EoS_table) {
       HadronGasEos::net_baryon_density(x.T, x.mub, x.mus, x.muq), my_nb, 1.e-2);
   COMPARE_ABSOLUTE_ERROR(
       HadronGasEos::net_charge_density(x.T, x.mub, x.mus, x.muq), my_nq, 1.e-2);
-  remove("small_test_table_eos.dat");
+}
+
+TEST(stored_EoS_table_is_mapped) {
+  const std::string filename = "small_test_table_eos.bin";
+  // Overwrite the stored elements, which has to show up in the mapped table
+  const size_t n_bytes = 5 * 5 * 5 * sizeof(EosTable::table_element);
+  const size_t file_size = boost::filesystem::file_size(filename);
+  {
+    std::fstream file(filename,
+                      std::ios::in | std::ios::out | std::ios::binary);
+    const std::vector<char> zeros(n_bytes, 0);
+    file.seekp(file_size - n_bytes);
+    file.write(zeros.data(), n_bytes);
+  }
+  HadronGasEos eos = HadronGasEos(false, false);
+  EosTable table = EosTable(0.1, 0.05, 0.05, 5, 5, 5);
+  table.compile_table(eos, filename);
+  EosTable::table_element x;
+  table.get(x, 0.39, 0.09, 0.06);
+  COMPARE(x.p, 0.0);
+  COMPARE(x.T, 0.0);
+  COMPARE(x.mub, 0.0);
+  COMPARE(boost::filesystem::file_size(filename), file_size);
+}
+
+TEST(EoS_table_with_other_grid_is_recompiled) {
+  const std::string filename = "small_test_table_eos.bin";
+  const size_t old_file_size = boost::filesystem::file_size(filename);
+  HadronGasEos eos = HadronGasEos(false, false);
+  EosTable table = EosTable(0.1, 0.05, 0.05, 5, 5, 4);
+  table.compile_table(eos, filename);
+  COMPARE(boost::filesystem::file_size(filename),
+          old_file_size - 5 * 5 * sizeof(EosTable::table_element));
+  EosTable::table_element x;
+  table.get(x, 0.39, 0.09, 0.06);
+  COMPARE_ABSOLUTE_ERROR(HadronGasEos::energy_density(x.T, x.mub, x.mus, x.muq),
+                         0.39, 1.e-2);
+  remove(filename.c_str());
 }
 
 /*
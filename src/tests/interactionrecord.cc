@@ -0,0 +1,146 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include <vir/test.h>  // This include has to be first
+
+#include "setup.h"
+
+#include <vector>
+
+#include "../include/smash/interactionrecord.h"
+#include "../include/smash/outputinterface.h"
+#include "../include/smash/scatteraction.h"
+
+using namespace smash;
+
+TEST(init_particletypes) { Test::create_smashon_particletypes(); }
+
+TEST(span_of_vector) {
+  const std::vector<int> v = {1, 2, 3};
+  const ConstSpan<int> span = v;
+  COMPARE(span.size(), 3u);
+  VERIFY(!span.empty());
+  COMPARE(span[1], 2);
+  int sum = 0;
+  for (int x : span) {
+    sum += x;
+  }
+  COMPARE(sum, 6);
+  VERIFY(ConstSpan<int>().empty());
+}
+
+TEST(record_of_action) {
+  const ParticleData a = Test::smashon(Test::Position{1., 0., 0., 0.},
+                                       Test::Momentum{1., 0.3, 0., 0.}, 0);
+  const ParticleData b = Test::smashon(Test::Position{1., 2., 0., 0.},
+                                       Test::Momentum{1., -0.3, 0., 0.}, 1);
+  ScatterAction action(a, b, 0.5);
+  action.add_all_scatterings(10., true, Test::all_reactions_included(),
+                             Test::no_multiparticle_reactions(), 0., true,
+                             false, false, NNbarTreatment::NoAnnihilation, 1.0,
+                             0.0);
+  action.generate_final_state();
+  const InteractionRecord record = make_interaction_record(action, 0.2);
+  COMPARE(record.type, ProcessType::Elastic);
+  COMPARE(record.time, 1.5);
+  COMPARE(record.total_weight, action.get_total_weight());
+  COMPARE(record.partial_weight, action.get_partial_weight());
+  COMPARE(record.density, 0.2);
+  COMPARE(record.interaction_point, action.get_interaction_point());
+  COMPARE(record.incoming.size(), 2u);
+  COMPARE(record.incoming.begin(), action.incoming_particles().data());
+  COMPARE(record.outgoing.size(), action.outgoing_particles().size());
+}
+
+/* Adds more records than fit into the initial storage, such that the views
+ * have to survive reallocations. */
+TEST(batch) {
+  InteractionBatch batch;
+  VERIFY(batch.empty());
+  std::vector<ParticleData> in, out;
+  for (int i = 0; i < 100; i++) {
+    in.push_back(Test::smashon(Test::Position{0.1 * i, 10., 0., 0.},
+                               Test::Momentum{1., 0.1, 0., 0.}, i));
+    out.push_back(in.back());
+    out.back().set_4position(FourVector(0.1 * i, 0., 0., 0.));
+    batch.add_wall_crossing(in.back(), out.back());
+  }
+  VERIFY(!batch.empty());
+  const ConstSpan<InteractionRecord> records = batch.records();
+  COMPARE(records.size(), 100u);
+  for (size_t i = 0; i < records.size(); i++) {
+    const InteractionRecord &record = records[i];
+    COMPARE(record.type, ProcessType::Wall);
+    COMPARE(record.time, 0.1 * i);
+    COMPARE(record.interaction_point, in[i].position());
+    COMPARE(record.incoming.size(), 1u);
+    COMPARE(record.outgoing.size(), 1u);
+    COMPARE(record.incoming[0].id(), in[i].id());
+    COMPARE(record.incoming[0].position(), in[i].position());
+    COMPARE(record.outgoing[0].position(), out[i].position());
+  }
+  batch.clear();
+  VERIFY(batch.empty());
+  COMPARE(batch.records().size(), 0u);
+}
+
+/* Records with different numbers of particles keep their own particles. */
+TEST(batch_of_copied_records) {
+  std::vector<ParticleData> particles;
+  for (int i = 0; i < 5; i++) {
+    particles.push_back(Test::smashon(Test::Position{0., 0.1 * i, 0., 0.},
+                                      Test::Momentum{1., 0., 0., 0.}, i));
+  }
+  InteractionRecord record;
+  record.type = ProcessType::TwoToThree;
+  record.incoming = ParticleSpan(particles.data(), 2);
+  record.outgoing = ParticleSpan(particles.data() + 2, 3);
+  InteractionBatch batch;
+  batch.add(record);
+  batch.add_wall_crossing(particles[4], particles[0]);
+  particles.clear();
+  const ConstSpan<InteractionRecord> records = batch.records();
+  COMPARE(records.size(), 2u);
+  COMPARE(records[0].type, ProcessType::TwoToThree);
+  COMPARE(records[0].incoming.size(), 2u);
+  COMPARE(records[0].outgoing.size(), 3u);
+  COMPARE(records[0].incoming[1].id(), 1);
+  COMPARE(records[0].outgoing[2].id(), 4);
+  COMPARE(records[1].incoming.size(), 1u);
+  COMPARE(records[1].outgoing.size(), 1u);
+  COMPARE(records[1].incoming[0].id(), 4);
+  COMPARE(records[1].outgoing[0].id(), 0);
+}
+
+/* Counts the records it receives. */
+class CountingOutput : public OutputInterface {
+ public:
+  CountingOutput() : OutputInterface("Collisions") {}
+  void at_interactions(ConstSpan<InteractionRecord> records) override {
+    calls++;
+    n_records += records.size();
+  }
+  int calls = 0;
+  size_t n_records = 0;
+};
+
+TEST(single_action_is_passed_as_batch) {
+  const ParticleData p = Test::smashon_random();
+  CountingOutput output;
+  InteractionBatch batch;
+  batch.add_wall_crossing(p, p);
+  batch.add_wall_crossing(p, p);
+  output.at_interactions(batch.records());
+  COMPARE(output.calls, 1);
+  COMPARE(output.n_records, 2u);
+  ScatterAction action(p, p, 0.);
+  output.at_interaction(action, 0.);
+  COMPARE(output.calls, 2);
+  COMPARE(output.n_records, 3u);
+}
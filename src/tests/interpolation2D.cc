@@ -9,6 +9,7 @@
 
 #include <vir/test.h>  // This include has to be first
 
+#include <cmath>
 #include <vector>
 #include "setup.h"
 
@@ -85,3 +86,45 @@ TEST(extrapolate_constant) {
   FUZZY_COMPARE((*interp)(2, 0.8), (*interp)(2, 1));
   FUZZY_COMPARE((*interp)(5, 16), (*interp)(5, 12));
 }
+
+TEST(uniform_fail_N_points) {
+  vir::test::expect_failure();
+  InterpolateData2DUniform([](double x, double y) { return x * y; }, 0., 1.,
+                           1, 0., 1., 4);
+}
+
+TEST(uniform_interpolate_bicubic) {
+  // bilinear and quadratic functions are reproduced away from the edges
+  auto f = [](double x, double y) {
+    return 1. + 2. * x - 3. * y + x * y + 0.5 * x * x;
+  };
+  const InterpolateData2DUniform uniform(f, 1., 5., 9, -2., 2., 11);
+  FUZZY_COMPARE(uniform(1., -2.), f(1., -2.));
+  FUZZY_COMPARE(uniform(3.5, 0.4), f(3.5, 0.4));
+  COMPARE_RELATIVE_ERROR(uniform(2.3, 0.13), f(2.3, 0.13), accuracy);
+  COMPARE_RELATIVE_ERROR(uniform(3.77, -1.01), f(3.77, -1.01), accuracy);
+  COMPARE_RELATIVE_ERROR(uniform(4.4, 1.55), f(4.4, 1.55), accuracy);
+
+  // bilinear functions are reproduced also in the edge cells
+  auto g = [](double x, double y) { return 1. + 2. * x - 3. * y + x * y; };
+  const InterpolateData2DUniform bilinear(g, 1., 5., 9, -2., 2., 11);
+  COMPARE_RELATIVE_ERROR(bilinear(1.2, -1.9), g(1.2, -1.9), accuracy);
+  COMPARE_RELATIVE_ERROR(bilinear(4.9, 1.7), g(4.9, 1.7), accuracy);
+  COMPARE_RELATIVE_ERROR(bilinear(1.1, 1.8), g(1.1, 1.8), accuracy);
+
+  // constant extrapolation
+  FUZZY_COMPARE(uniform(0.5, 1.), uniform(1., 1.));
+  FUZZY_COMPARE(uniform(8., 1.), uniform(5., 1.));
+  FUZZY_COMPARE(uniform(2., -3.), uniform(2., -2.));
+  FUZZY_COMPARE(uniform(2., 16.), uniform(2., 2.));
+}
+
+TEST(uniform_interpolate_logarithmic) {
+  auto f = [](double x, double y) { return std::log(x) * y; };
+  const InterpolateData2DUniform uniform(f, 1e-3, 1., 31, 0., 1., 5, true);
+  FUZZY_COMPARE(uniform(1e-3, 1.), f(1e-3, 1.));
+  FUZZY_COMPARE(uniform(1., 0.5), f(1., 0.5));
+  COMPARE_RELATIVE_ERROR(uniform(0.0123, 0.3), f(0.0123, 0.3), accuracy);
+  COMPARE_RELATIVE_ERROR(uniform(0.456, 0.71), f(0.456, 0.71), accuracy);
+  FUZZY_COMPARE(uniform(1e-4, 0.5), uniform(1e-3, 0.5));
+}
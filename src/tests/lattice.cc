@@ -50,6 +50,73 @@ TEST(reset) {
   }
 }
 
+TEST(occupied_tiles) {
+  // 20 cells in each direction are split into tiles of 8, 8 and 4 cells
+  const std::array<double, 3> l = {20., 20., 20.};
+  const std::array<int, 3> n = {20, 20, 20};
+  const std::array<double, 3> origin = {0., 0., 0.};
+  const FourVector one(1., 0., 0., 0.);
+  for (bool periodic : {false, true}) {
+    RectangularLattice<FourVector> lattice(l, n, origin, periodic,
+                                           LatticeUpdate::EveryTimestep);
+    const RectangularLattice<FourVector> &const_lattice = lattice;
+    auto count_occupied = [&]() {
+      int count = 0;
+      const_lattice.iterate_occupied(
+          [&](const FourVector &, int) { count++; });
+      return count;
+    };
+    auto sum_all = [&]() {
+      double sum = 0.;
+      for (const FourVector &node : const_lattice) {
+        sum += node.x0();
+      }
+      return sum;
+    };
+    COMPARE(count_occupied(), 0);
+
+    // Cells -1, 0 and 1 in each direction: wrap around if periodic
+    int n_visited = 0;
+    lattice.iterate_in_cube(ThreeVector(0.5, 0.5, 0.5), 1.2,
+                            [&](FourVector &node, int, int, int) {
+                              node += one;
+                              n_visited++;
+                            });
+    COMPARE(n_visited, periodic ? 27 : 8);
+    COMPARE(count_occupied(), periodic ? 12 * 12 * 12 : 8 * 8 * 8);
+    double sum_occupied = 0.;
+    lattice.iterate_occupied(
+        [&](FourVector &node, int) { sum_occupied += node.x0(); });
+    COMPARE(sum_occupied, sum_all());
+
+    lattice.assign_value(lattice.index1d(10, 10, 10), one);
+    lattice.node(19, 19, 19) += one;
+    COMPARE(count_occupied(), periodic ? 12 * 12 * 12 + 8 * 8 * 8
+                                       : 8 * 8 * 8 + 8 * 8 * 8 + 4 * 4 * 4);
+    COMPARE(sum_all(), n_visited + 2.);
+
+    lattice.reset();
+    COMPARE(count_occupied(), 0);
+    COMPARE(sum_all(), 0.);
+
+    // Writes through operator[] mark the tile of the cell
+    lattice[lattice.index1d(10, 10, 10)] = one;
+    COMPARE(count_occupied(), 8 * 8 * 8);
+    COMPARE(sum_all(), 1.);
+    lattice.reset();
+    COMPARE(sum_all(), 0.);
+
+    // Writes through the iterators are not tracked per tile
+    for (FourVector &node : lattice) {
+      node = one;
+    }
+    COMPARE(count_occupied(), 20 * 20 * 20);
+    lattice.reset();
+    COMPARE(count_occupied(), 0);
+    COMPARE(sum_all(), 0.);
+  }
+}
+
 TEST(out_of_bounds) {
   auto lattice1 = create_lattice(true);
   // For periodic lattice nothing is out of bounds
@@ -1022,6 +1089,111 @@ TEST(copy_constructor) {
                              });
 }
 
+TEST(refit_constructor) {
+  auto lattice = create_lattice(false);
+  int i = 0;
+  for (auto &node : *lattice) {
+    node = FourVector(i++, 0., 0., 0.);
+  }
+  // Cell sizes are 2.5, 0.75 and 2/3 fm, shift by (-1, 2, 0) cells
+  const std::array<int, 3> n = {6, 7, 2};
+  const std::array<double, 3> origin = {-2.5, 1.5, 0.};
+  RectangularLattice<FourVector> refitted(*lattice, n, origin);
+  COMPARE(refitted.n_cells(), n);
+  COMPARE(refitted.origin(), origin);
+  for (int d = 0; d < 3; d++) {
+    FUZZY_COMPARE(refitted.cell_sizes()[d], lattice->cell_sizes()[d]);
+    FUZZY_COMPARE(refitted.lattice_sizes()[d],
+                  n[d] * lattice->cell_sizes()[d]);
+  }
+  for (int iz = 0; iz < n[2]; iz++) {
+    for (int iy = 0; iy < n[1]; iy++) {
+      for (int ix = 0; ix < n[0]; ix++) {
+        const int jx = ix - 1, jy = iy + 2, jz = iz;
+        const bool shared = jx >= 0 && jx < 4 && jy >= 0 && jy < 8;
+        const FourVector expected =
+            shared ? lattice->node(jx, jy, jz) : FourVector();
+        COMPARE(refitted.node(ix, iy, iz), expected) << ix << iy << iz;
+        // cells share their centers
+        if (shared) {
+          const ThreeVector r = lattice->cell_center(jx, jy, jz);
+          const ThreeVector r_refitted = refitted.cell_center(ix, iy, iz);
+          for (int d = 0; d < 3; d++) {
+            FUZZY_COMPARE(r_refitted[d], r[d]);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CATCH(refit_constructor_misaligned, std::invalid_argument) {
+  auto lattice = create_lattice(false);
+  RectangularLattice<FourVector> refitted(*lattice, {4, 8, 3}, {0.1, 0., 0.});
+}
+
+TEST(values_at) {
+  for (bool periodic : {false, true}) {
+    auto lattice = create_lattice(periodic);
+    int i = 0;
+    for (auto &node : *lattice) {
+      node = FourVector(i++, 0., 0., 0.);
+    }
+    const std::vector<ThreeVector> positions = {
+        {0.1, 0.1, 0.1}, {9.9, 5.9, 1.9}, {3.3, 2.2, 1.1},
+        {-0.1, 1., 1.},  {5., 6.1, 1.},   {12.7, -1.3, 5.2}};
+    std::vector<FourVector> values;
+    std::vector<char> on_lattice;
+    const std::size_t n_on_lattice =
+        lattice->values_at(positions, values, on_lattice);
+    COMPARE(values.size(), positions.size());
+    COMPARE(on_lattice.size(), positions.size());
+    std::size_t n_expected = 0;
+    for (std::size_t k = 0; k < positions.size(); k++) {
+      FourVector expected;
+      const bool expected_on_lattice =
+          lattice->value_at(positions[k], expected);
+      COMPARE(static_cast<bool>(on_lattice[k]), expected_on_lattice);
+      COMPARE(values[k], expected);
+      n_expected += expected_on_lattice;
+    }
+    COMPARE(n_on_lattice, n_expected);
+    COMPARE(n_on_lattice, periodic ? positions.size() : 3u);
+  }
+
+  // many positions are split into batches, which several threads share
+  ThreadPool::set_global_size(3);
+  for (bool periodic : {false, true}) {
+    auto lattice = create_lattice(periodic);
+    int i = 0;
+    for (auto &node : *lattice) {
+      node = FourVector(i++, 0., 0., 0.);
+    }
+    std::vector<ThreeVector> positions;
+    for (int k = 0; k < 2000; k++) {
+      positions.emplace_back(-2. + 0.007 * k, -1. + 0.0041 * ((k * 37) % 2000),
+                             -1. + 0.002 * ((k * 91) % 2000));
+    }
+    std::vector<FourVector> values;
+    std::vector<char> on_lattice;
+    const std::size_t n_on_lattice =
+        lattice->values_at(positions, values, on_lattice);
+    std::size_t n_expected = 0;
+    for (std::size_t k = 0; k < positions.size(); k++) {
+      FourVector expected;
+      const bool expected_on_lattice =
+          lattice->value_at(positions[k], expected);
+      COMPARE(static_cast<bool>(on_lattice[k]), expected_on_lattice) << k;
+      COMPARE(values[k], expected) << k;
+      n_expected += expected_on_lattice;
+    }
+    COMPARE(n_on_lattice, n_expected);
+    VERIFY(n_on_lattice > 0u);
+    VERIFY(n_on_lattice < positions.size() || periodic);
+  }
+  ThreadPool::set_global_size(1);
+}
+
 double integrand(ThreeVector pos, double &value, ThreeVector point) {
   return value / ((pos - point).abs());
 }
@@ -0,0 +1,75 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include <vir/test.h>  // This include has to be first
+
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string>
+
+#include "../include/smash/linebuffer.h"
+
+using namespace smash;
+
+/* Compare the output of the line buffer with printf for all precisions used in
+ * the outputs and a few more. */
+static void compare_with_printf(double x) {
+  for (int precision : {0, 1, 2, 6, 9, 14, 15, 17}) {
+    char expected[512];
+    LineBuffer line;
+    line.append_general(x, precision);
+    std::snprintf(expected, sizeof(expected), "%.*g", precision, x);
+    COMPARE(line.str(), std::string(expected)) << x << " " << precision;
+    line.clear();
+    line.append_scientific(x, precision);
+    std::snprintf(expected, sizeof(expected), "%.*e", precision, x);
+    COMPARE(line.str(), std::string(expected)) << x << " " << precision;
+  }
+}
+
+TEST(special_values) {
+  const double inf = std::numeric_limits<double>::infinity();
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const double denorm = std::numeric_limits<double>::denorm_min();
+  for (double x : {0., 1., 0.5, 2.5, 0.15, 0.25, 1e-4, 1e-5, 9.9999995,
+                   99999.95, 999999.5, 1e15, 1e22, 1e23, 1.5e-300, DBL_MAX,
+                   DBL_MIN, denorm, inf, nan}) {
+    compare_with_printf(x);
+    compare_with_printf(-x);
+  }
+}
+
+TEST(random_values) {
+  std::mt19937_64 engine(1);
+  std::uniform_real_distribution<double> exponent(-30., 30.);
+  std::uniform_real_distribution<double> mantissa(-1., 1.);
+  for (int i = 0; i < 20000; i++) {
+    compare_with_printf(mantissa(engine) * std::pow(10., exponent(engine)));
+    // values with few decimal digits, where ties occur
+    compare_with_printf(std::round(mantissa(engine) * 1e6) /
+                        std::pow(10., i % 8));
+  }
+}
+
+TEST(integers_and_text) {
+  LineBuffer line;
+  line.append(-2147483647 - 1);
+  line.append(' ');
+  line.append(0);
+  line.append(' ');
+  line.append(static_cast<size_t>(18446744073709551615ull));
+  line.append(" ");
+  line.append(std::string("pdg"));
+  COMPARE(line.str(), "-2147483648 0 18446744073709551615 pdg");
+  line.clear();
+  COMPARE(line.str(), "");
+}
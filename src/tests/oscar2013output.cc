@@ -15,7 +15,9 @@
 #include <array>
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <fstream>
 #include <map>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -500,3 +502,59 @@ TEST(initial_conditions_2013_format) {
   }
   VERIFY(bf::remove(outputfilepath));
 }
+
+/* Write the same events synchronously and asynchronously, the latter with
+ * tiny buffers such that the writer thread falls behind, and compare the
+ * files. */
+TEST(asynchronous_output_is_identical) {
+  const std::array<std::string, 2> contents = {"Collisions", "Particles"};
+  const std::array<std::string, 2> filenames = {"full_event_history.oscar",
+                                                "particle_lists.oscar"};
+  std::array<std::string, 2> written[2];
+  for (const bool async : {false, true}) {
+    OutputParameters out_par = OutputParameters();
+    out_par.coll_printstartend = true;
+    out_par.coll_extended = true;
+    out_par.part_only_final = OutputOnlyFinal::No;
+    out_par.async_write.enabled = async;
+    out_par.async_write.buffer_size = 64;
+    out_par.async_write.max_pending_buffers = 1;
+    for (size_t i = 0; i < contents.size(); i++) {
+      random::set_seed(7);
+      {
+        std::unique_ptr<OutputInterface> output = create_oscar_output(
+            "Oscar2013", contents[i], testoutputpath, out_par);
+        Particles particles;
+        for (int j = 0; j < 10; j++) {
+          particles.insert(Test::smashon_random());
+        }
+        const EventInfo event = Test::default_event_info(1.783, false);
+        DensityParameters dens_par(Test::default_parameters());
+        output->at_eventstart(particles, 0, event);
+        for (int j = 0; j < 5; j++) {
+          ScatterActionPtr action = make_unique<ScatterAction>(
+              particles.copy_to_vector()[0], particles.copy_to_vector()[1],
+              0.);
+          action->add_all_scatterings(
+              10., true, Test::all_reactions_included(),
+              Test::no_multiparticle_reactions(), 0., true, false, false,
+              NNbarTreatment::NoAnnihilation, 1.0, 0.0);
+          action->generate_final_state();
+          action->perform(&particles, j + 1);
+          output->at_interaction(*action, 0.1 * j);
+          output->at_intermediate_time(particles, nullptr, dens_par, event);
+        }
+        output->at_eventend(particles, 0, event);
+      }
+      std::ifstream file((testoutputpath / filenames[i]).native());
+      std::stringstream content;
+      content << file.rdbuf();
+      written[async][i] = content.str();
+      VERIFY(bf::remove(testoutputpath / filenames[i]));
+    }
+  }
+  for (size_t i = 0; i < contents.size(); i++) {
+    VERIFY(written[0][i].size() > 1000) << contents[i];
+    COMPARE(written[1][i], written[0][i]) << contents[i];
+  }
+}
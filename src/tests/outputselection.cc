@@ -0,0 +1,239 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include <vir/test.h>  // This include has to be first
+
+#include "setup.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../include/smash/binaryoutput.h"
+#include "../include/smash/outputparameters.h"
+#include "../include/smash/outputselection.h"
+#include "../include/smash/oscaroutput.h"
+#include "../include/smash/particles.h"
+#include "../include/smash/wallcrossingaction.h"
+
+using namespace smash;
+
+static const bf::path testoutputpath = bf::absolute(SMASH_TEST_OUTPUT_PATH);
+
+TEST(directory_is_created) {
+  bf::create_directories(testoutputpath);
+  VERIFY(bf::exists(testoutputpath));
+}
+
+TEST(init_particletypes) { Test::create_smashon_particletypes(); }
+
+TEST(field_names) {
+  for (ParticleField field : default_fields(true)) {
+    COMPARE(field_from_name(field_name(field)), field);
+  }
+  COMPARE(default_fields(false).size(), 12u);
+  COMPARE(default_fields(true).size(), 20u);
+  COMPARE(std::string(field_name(ParticleField::Px)), "px");
+  COMPARE(std::string(field_unit(ParticleField::FormTime)), "fm");
+  VERIFY(field_is_integer(ParticleField::Pdg));
+  VERIFY(!field_is_integer(ParticleField::Mass));
+}
+
+TEST_CATCH(unknown_field, std::invalid_argument) { field_from_name("spin"); }
+
+TEST(field_values) {
+  const ParticleData p = Test::smashon(Test::Position{1., 2., 3., 4.},
+                                       Test::Momentum{5., 0.1, 0.2, 0.3}, 7);
+  COMPARE(field_value(p, ParticleField::T), 1.);
+  COMPARE(field_value(p, ParticleField::Z), 4.);
+  COMPARE(field_value(p, ParticleField::P0), 5.);
+  COMPARE(field_value(p, ParticleField::Pz), 0.3);
+  COMPARE(integer_field_value(p, ParticleField::ID), 7);
+  COMPARE(integer_field_value(p, ParticleField::Pdg), 661);
+}
+
+TEST(default_accepts_everything) {
+  const OutputSelection selection;
+  VERIFY(!selection.selects_particles());
+  VERIFY(selection.accepts(Test::smashon_random()));
+  const ParticleData p = Test::smashon_random();
+  VERIFY(selection.accepts(WallcrossingAction(p, p)));
+}
+
+TEST(particle_criteria) {
+  OutputSelection selection;
+  selection.pt_range = {{0.5, 1.5}};
+  selection.rapidity_range = {{-1., 1.}};
+  VERIFY(selection.selects_particles());
+  const double m = Test::smashon_mass;
+  // pT = 1, y = 0
+  const ParticleData central =
+      Test::smashon(Test::Momentum{std::sqrt(m * m + 1.), 1., 0., 0.});
+  // pT = 2
+  const ParticleData hard =
+      Test::smashon(Test::Momentum{std::sqrt(m * m + 4.), 0., 2., 0.});
+  // pT = 1, y > 1
+  const ParticleData forward =
+      Test::smashon(Test::Momentum{std::sqrt(m * m + 10.), 1., 0., 3.});
+  VERIFY(selection.accepts(central));
+  VERIFY(!selection.accepts(hard));
+  VERIFY(!selection.accepts(forward));
+
+  selection.only_participants = true;
+  VERIFY(!selection.accepts(central));
+
+  selection = OutputSelection();
+  selection.pdg_codes = {PdgCode(0x211)};
+  VERIFY(!selection.accepts(central));
+  selection.pdg_codes.push_back(PdgCode(0x661));
+  VERIFY(selection.accepts(central));
+
+  selection.time_range = {{1., 2.}};
+  VERIFY(!selection.accepts(central));
+  VERIFY(selection.accepts(Test::smashon(Test::Position{1.5, 0., 0., 0.},
+                                         Test::Momentum{1., 0., 0., 0.})));
+}
+
+TEST(interaction_criteria) {
+  const ParticleData p = Test::smashon(Test::Position{1., 0., 0., 0.},
+                                       Test::Momentum{1., 0., 0., 0.});
+  const WallcrossingAction action(p, p);
+  OutputSelection selection;
+  selection.process_types = {static_cast<int>(ProcessType::Decay)};
+  VERIFY(!selection.accepts(action));
+  selection.process_types.push_back(static_cast<int>(ProcessType::Wall));
+  VERIFY(selection.accepts(action));
+  selection.time_range = {{2., 3.}};
+  VERIFY(!selection.accepts(action));
+  selection.time_range = {{0., 3.}};
+  selection.pdg_codes = {PdgCode(0x211)};
+  VERIFY(!selection.accepts(action));
+  selection.pdg_codes = {PdgCode(0x661)};
+  VERIFY(selection.accepts(action));
+}
+
+TEST(read_selection) {
+  Configuration conf(
+      "Particles:\n"
+      "  Filter:\n"
+      "    PDG: [211, -211]\n"
+      "    Pt_Range: [0.1, 2.0]\n"
+      "    Only_Participants: True\n"
+      "  Columns: [pdg, px, py, pz]\n"
+      "Collisions:\n"
+      "  Filter:\n"
+      "    Process_Types: [2, 5]\n"
+      "    Time_Range: [0.0, 10.0]\n");
+  const OutputParameters out_par(std::move(conf));
+  const OutputSelection &part = out_par.get_selection("Particles");
+  COMPARE(part.pdg_codes.size(), 2u);
+  COMPARE(part.pdg_codes[1], PdgCode(-0x211));
+  COMPARE(part.pt_range[1], 2.);
+  VERIFY(part.only_participants);
+  COMPARE(part.fields.size(), 4u);
+  COMPARE(part.fields[0], ParticleField::Pdg);
+  const OutputSelection &coll = out_par.get_selection("Collisions");
+  COMPARE(coll.process_types, (std::vector<int>{2, 5}));
+  COMPARE(coll.time_range[1], 10.);
+  VERIFY(coll.fields.empty());
+  VERIFY(!out_par.get_selection("Photons").selects_particles());
+}
+
+TEST_CATCH(read_empty_range, std::invalid_argument) {
+  OutputParameters out_par(
+      Configuration("Particles:\n  Filter:\n    Pt_Range: [2.0, 1.0]\n"));
+}
+
+TEST_CATCH(oscar1999_columns, std::invalid_argument) {
+  OutputParameters out_par;
+  out_par.part_selection.fields = {ParticleField::Pdg};
+  create_oscar_output("Oscar1999", "Particles", testoutputpath, out_par);
+}
+
+/* Two particles of which only the second one is accepted. */
+static void insert_particles(Particles *particles) {
+  particles->insert(Test::smashon(Test::Position{0., 1., 2., 3.},
+                                  Test::Momentum{5., 3., 0., 0.}));
+  particles->insert(Test::smashon(Test::Position{0., 4., 5., 6.},
+                                  Test::Momentum{1., 0.5, 0., 0.}));
+}
+
+TEST(oscar2013_selection) {
+  OutputParameters out_par;
+  out_par.part_selection.pt_range = {{0., 1.}};
+  out_par.part_selection.fields = {ParticleField::ID, ParticleField::Px,
+                                   ParticleField::Pdg};
+  Particles particles;
+  insert_particles(&particles);
+  {
+    auto output =
+        create_oscar_output("Oscar2013", "Particles", testoutputpath, out_par);
+    output->at_eventend(particles, 0, Test::default_event_info());
+  }
+  std::ifstream file((testoutputpath / "particle_lists.oscar").native());
+  std::string line;
+  std::getline(file, line);
+  COMPARE(line, "#!OSCAR2013 particle_lists ID px pdg");
+  std::getline(file, line);
+  COMPARE(line, "# Units: none GeV none");
+  std::getline(file, line);  // version
+  std::getline(file, line);
+  COMPARE(line, "# event 0 out 1");
+  std::getline(file, line);
+  COMPARE(line, "1 0.5 661");
+  std::getline(file, line);
+  VERIFY(line.compare(0, 11, "# event 0 e") == 0) << line;
+}
+
+TEST(binary_selection) {
+  OutputParameters out_par;
+  out_par.part_selection.pt_range = {{0., 1.}};
+  out_par.part_selection.fields = {ParticleField::Pdg, ParticleField::Px};
+  Particles particles;
+  insert_particles(&particles);
+  {
+    BinaryOutputParticles output(testoutputpath, "Particles", out_par);
+    output.at_eventend(particles, 0, Test::default_event_info());
+  }
+  FilePtr file = fopen(testoutputpath / "particles_binary.bin", "rb");
+  char magic[4];
+  std::uint16_t version, variant;
+  COMPARE(std::fread(magic, 1, 4, file.get()), 4u);
+  COMPARE(std::fread(&version, sizeof(version), 1, file.get()), 1u);
+  COMPARE(std::fread(&variant, sizeof(variant), 1, file.get()), 1u);
+  COMPARE(variant, 2);
+  std::uint32_t size;
+  COMPARE(std::fread(&size, sizeof(size), 1, file.get()), 1u);
+  std::fseek(file.get(), size, SEEK_CUR);  // SMASH version
+  std::uint32_t n_fields;
+  COMPARE(std::fread(&n_fields, sizeof(n_fields), 1, file.get()), 1u);
+  COMPARE(n_fields, 2u);
+  for (const char *expected : {"pdgi", "pxd"}) {
+    COMPARE(std::fread(&size, sizeof(size), 1, file.get()), 1u);
+    std::string name(size + 1, ' ');
+    COMPARE(std::fread(&name[0], 1, size + 1, file.get()), size + 1);
+    COMPARE(name, expected);
+  }
+  char block;
+  std::uint32_t n_particles;
+  std::int32_t pdg;
+  double px;
+  COMPARE(std::fread(&block, 1, 1, file.get()), 1u);
+  COMPARE(block, 'p');
+  COMPARE(std::fread(&n_particles, sizeof(n_particles), 1, file.get()), 1u);
+  COMPARE(n_particles, 1u);
+  COMPARE(std::fread(&pdg, sizeof(pdg), 1, file.get()), 1u);
+  COMPARE(std::fread(&px, sizeof(px), 1, file.get()), 1u);
+  COMPARE(pdg, 661);
+  COMPARE(px, 0.5);
+  COMPARE(std::fread(&block, 1, 1, file.get()), 1u);
+  COMPARE(block, 'f');
+}
@@ -0,0 +1,155 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include <vir/test.h>  // This include has to be first
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "../include/smash/decaymodes.h"
+#include "../include/smash/particletype.h"
+#include "../include/smash/sha256.h"
+
+using namespace smash;
+
+static const bf::path testoutputpath = bf::absolute(SMASH_TEST_OUTPUT_PATH);
+
+TEST(directory_is_created) {
+  bf::create_directories(testoutputpath);
+  VERIFY(bf::exists(testoutputpath));
+}
+
+TEST(init_particles_and_decays) {
+  ParticleType::create_type_list(
+      "π 0.138 0      - 111 211\n"
+      "ρ 0.776 0.149  - 113 213\n"
+      "ω 0.783 8.49e-3 - 223\n"
+      "N 0.938 0      + 2112 2212\n"
+      "Δ 1.232 0.117  + 1114 2114 2214 2224\n");
+  DecayModes::load_decaymodes(
+      "ρ\n"
+      "1. 1 π π\n"
+      "\n"
+      "ω\n"
+      "1. 1 π ρ\n"
+      "\n"
+      "Δ\n"
+      "1. 1 N π\n");
+}
+
+static sha256::Hash make_hash(const std::string &input) {
+  sha256::Context context;
+  context.update(input);
+  return context.finalize();
+}
+
+static std::vector<unsigned char> read_file(const bf::path &path) {
+  std::ifstream file(path.string(), std::ios::binary);
+  return std::vector<unsigned char>(std::istreambuf_iterator<char>(file),
+                                    std::istreambuf_iterator<char>());
+}
+
+static const bf::path snapshot_path = testoutputpath / "particle_caches.bin";
+
+TEST(snapshot_is_stored) {
+  const sha256::Hash hash = make_hash("first");
+  ParticleType::fill_all_caches(hash, testoutputpath);
+  VERIFY(bf::exists(snapshot_path));
+  VERIFY(!bf::exists(testoutputpath / "particle_caches.bin.tmp"));
+  VERIFY(!bf::exists(testoutputpath / "tabulations.lock"));
+  const std::vector<unsigned char> content = read_file(snapshot_path);
+  COMPARE(std::string(content.begin(), content.begin() + 8), "SMASHPTC");
+  // magic, version and hash
+  VERIFY(std::equal(hash.begin(), hash.end(), content.begin() + 12));
+}
+
+TEST(snapshot_with_other_hash_is_replaced) {
+  const sha256::Hash hash = make_hash("second");
+  ParticleType::fill_all_caches(hash, testoutputpath);
+  const std::vector<unsigned char> content = read_file(snapshot_path);
+  VERIFY(std::equal(hash.begin(), hash.end(), content.begin() + 12));
+}
+
+/* The normalization of the Δ in the snapshot is doubled, which has to show up
+ * in its spectral function after restoring the caches. */
+TEST(snapshot_is_restored) {
+  const sha256::Hash hash = make_hash("second");
+  const ParticleType &delta = ParticleType::find(0x2214);
+  const double spectral = delta.spectral_function(1.3);
+  size_t index = 0;
+  while (ParticleType::list_all()[index] != delta) {
+    index++;
+  }
+  // magic, version, hash, number of types, then 3 doubles per type
+  const std::streamoff norm_position = 8 + 4 + 32 + 8 + 24 * index + 16;
+  {
+    std::fstream file(snapshot_path.string(),
+                      std::ios::in | std::ios::out | std::ios::binary);
+    double norm;
+    file.seekg(norm_position);
+    file.read(reinterpret_cast<char *>(&norm), sizeof(norm));
+    VERIFY(norm > 0.);
+    norm *= 2.;
+    file.seekp(norm_position);
+    file.write(reinterpret_cast<const char *>(&norm), sizeof(norm));
+  }
+  ParticleType::fill_all_caches(hash, testoutputpath);
+  FUZZY_COMPARE(delta.spectral_function(1.3), 2. * spectral);
+}
+
+TEST(tabulated_total_width) {
+  ParticleType::width_tabulation_accuracy_ = 1e-4;
+  for (PdgCode pdg : {0x113, 0x223, 0x2214}) {
+    const ParticleType &type = ParticleType::find(pdg);
+    std::vector<double> widths;
+    for (double m = 0.2; m < 4.; m += 0.0013) {
+      widths.push_back(type.total_width(m));
+    }
+    ParticleType::width_tabulation_accuracy_ = 0.;
+    size_t i = 0;
+    for (double m = 0.2; m < 4.; m += 0.0013) {
+      COMPARE_ABSOLUTE_ERROR(widths[i++], type.total_width(m),
+                             2e-4 * type.width_at_pole())
+          << type.name() << " at m = " << m;
+    }
+    ParticleType::width_tabulation_accuracy_ = 1e-4;
+  }
+  // beyond the grid the width is computed directly
+  const ParticleType &rho = ParticleType::find(0x113);
+  const double w = rho.total_width(10.);
+  ParticleType::width_tabulation_accuracy_ = 0.;
+  COMPARE(w, rho.total_width(10.));
+}
+
+/* The tabulated total widths are added to the snapshot, which is replaced
+ * when the accuracy changes. */
+TEST(snapshot_stores_width_tabulation) {
+  const sha256::Hash hash = make_hash("second");
+  ParticleType::fill_all_caches(hash, testoutputpath);
+  const size_t size_without_widths = read_file(snapshot_path).size();
+  ParticleType::width_tabulation_accuracy_ = 1e-4;
+  ParticleType::fill_all_caches(hash, testoutputpath);
+  VERIFY(read_file(snapshot_path).size() > size_without_widths);
+  const ParticleType &delta = ParticleType::find(0x2214);
+  const double width = delta.total_width(1.3);
+  ParticleType::fill_all_caches(hash, testoutputpath);
+  COMPARE(delta.total_width(1.3), width);
+  ParticleType::width_tabulation_accuracy_ = 0.;
+}
+
+TEST(nothing_is_done_without_path) {
+  bf::remove(snapshot_path);
+  ParticleType::fill_all_caches(make_hash("first"), "");
+  VERIFY(!bf::exists(snapshot_path));
+}
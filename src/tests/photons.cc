@@ -9,8 +9,15 @@
 
 #include "setup.h"
 
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
 #include "../include/smash/bremsstrahlungaction.h"
+#include "../include/smash/crosssectionsbrems.h"
 #include "../include/smash/crosssectionsphoton.h"
+#include "../include/smash/random.h"
 #include "../include/smash/scatteractionphoton.h"
 
 using namespace smash;
@@ -253,6 +260,60 @@ TEST(binary_scatterings_diff_cross_sections) {
   COMPARE_ABSOLUTE_ERROR(diff_cross4, 0.6907271, 1e-5);
 }
 
+/* The weights of the photons have to be the same with tabulated cross
+ * sections, since the random numbers do not depend on them. The accuracy of
+ * the differential cross sections refers to their average over t. */
+TEST(binary_scatterings_tabulated_cross_sections) {
+  const std::vector<std::pair<PdgCode, PdgCode>> pairs = {
+      {0x211, 0x113}, {0x211, -0x211}, {0x111, 0x213}, {-0x211, 0x213},
+      {0x111, -0x211}, {0x111, 0x113}};
+  // weights of the photons of every pair, momentum and number of photons
+  auto weights = [&]() {
+    random::set_seed(42);
+    std::vector<std::vector<double>> w;
+    for (const auto &pair : pairs) {
+      for (double p : {0.3, 0.8, 2.}) {
+        for (int n_frac : {1, 10}) {
+          ParticleData a{ParticleType::find(pair.first)};
+          ParticleData b{ParticleType::find(pair.second)};
+          a.set_4momentum(a.pole_mass(), ThreeVector(0., 0., p));
+          b.set_4momentum(b.pole_mass(), ThreeVector(0., 0., -p));
+          ParticleList in{a, b};
+          ScatterActionPhoton act(in, 0.05, n_frac, 5.0);
+          act.add_single_process();
+          w.emplace_back();
+          for (int i = 0; i < n_frac; i++) {
+            act.generate_final_state();
+            w.back().push_back(act.get_total_weight());
+          }
+        }
+      }
+    }
+    return w;
+  };
+  const std::vector<std::vector<double>> analytic = weights();
+  ScatterActionPhoton::tabulate_cross_sections(1e-3);
+  const std::vector<std::vector<double>> tabulated = weights();
+  ScatterActionPhoton::tabulate_cross_sections(0.);
+  COMPARE(tabulated.size(), analytic.size());
+  // the tables are used
+  VERIFY(tabulated != analytic);
+  for (size_t i = 0; i < analytic.size(); i++) {
+    double sum = 0., sum_tabulated = 0.;
+    for (size_t k = 0; k < analytic[i].size(); k++) {
+      VERIFY(analytic[i][k] > 0.);
+      sum += analytic[i][k];
+      sum_tabulated += tabulated[i][k];
+    }
+    for (size_t k = 0; k < analytic[i].size(); k++) {
+      COMPARE_ABSOLUTE_ERROR(tabulated[i][k], analytic[i][k], 5e-3 * sum)
+          << i << " " << k;
+    }
+    COMPARE_RELATIVE_ERROR(sum_tabulated, sum, 5e-3) << i;
+  }
+  COMPARE(weights(), analytic);
+}
+
 ////
 // Test photon production in Bremsstrahlung processes
 ////
@@ -275,7 +336,9 @@ TEST(bremsstrahlung_gen_final_state) {
   act->add_single_process();
 
   // Sample photons, implicitly test sample_3body_phasespace() and
-  // cross section functions
+  // cross section functions. The seed makes the photons independent of the
+  // random numbers drawn by the tests above.
+  random::set_seed(42);
   double tot_weight = 0.0;
   for (int i = 0; i < number_of_photons; i++) {
     act->generate_final_state();
@@ -285,7 +348,10 @@ TEST(bremsstrahlung_gen_final_state) {
     VERIFY(act->outgoing_particles()[1].type() == type_pim);
     VERIFY(act->outgoing_particles()[2].type() == type_photon);
   }
-  COMPARE_RELATIVE_ERROR(tot_weight, 1.84592, 1e-5);
+  // The reference comes from the bicubic splines of the tables. The uniform
+  // grids deviate from them by 2e-6 here, which the tolerance covers with
+  // room for rounding differences between platforms.
+  COMPARE_RELATIVE_ERROR(tot_weight, 2.75819, 1e-4);
 }
 
 TEST(bremsstrahlung_reaction_type_function) {
@@ -315,3 +381,55 @@ TEST(bremsstrahlung_reaction_type_function) {
   VERIFY(BremsstrahlungAction::bremsstrahlung_reaction_type(l8) ==
          BremsstrahlungAction::ReactionType::no_reaction);
 }
+
+/* The uniform grids of the differential cross sections have to reproduce the
+ * bicubic splines of the tables. The deviation is compared with the largest
+ * value at the same energy, since the cross sections cross zero near the
+ * kinematic limits, where the relative deviation is meaningless. The accuracy
+ * is only checked in the middle of the grid cells, so a larger deviation is
+ * allowed elsewhere. Without an accuracy the splines are used. */
+TEST(bremsstrahlung_uniform_interpolation) {
+  const std::vector<double> sqrts = BREMS_SQRTS;
+  const std::vector<double> k = BREMS_K;
+  const std::vector<double> theta = BREMS_THETA;
+  const std::vector<std::vector<double>> dsigma_dk = {
+      BREMS_PIPI_PIPI_OPP_DIFF_SIG_K, BREMS_PIPI_PIPI_SAME_DIFF_SIG_K,
+      BREMS_PIPI0_PIPI0_DIFF_SIG_K, BREMS_PIPI_PI0PI0_DIFF_SIG_K,
+      BREMS_PI0PI0_PIPI_DIFF_SIG_K};
+  const std::vector<std::vector<double>> dsigma_dtheta = {
+      BREMS_PIPI_PIPI_OPP_DIFF_SIG_THETA, BREMS_PIPI_PIPI_SAME_DIFF_SIG_THETA,
+      BREMS_PIPI0_PIPI0_DIFF_SIG_THETA, BREMS_PIPI_PI0PI0_DIFF_SIG_THETA,
+      BREMS_PI0PI0_PIPI_DIFF_SIG_THETA};
+  const double accuracy = 2e-3;
+  const double tolerance = 2 * accuracy;
+  for (const bool logarithmic_x : {true, false}) {
+    const std::vector<double> &x = logarithmic_x ? k : theta;
+    for (const auto &dsigma : logarithmic_x ? dsigma_dk : dsigma_dtheta) {
+      const InterpolateData2DSpline spline(x, sqrts, dsigma);
+      const auto uniform = make_brems_interpolation(x, sqrts, dsigma,
+                                                    logarithmic_x, accuracy);
+      const auto splined =
+          make_brems_interpolation(x, sqrts, dsigma, logarithmic_x, 0.);
+      for (size_t j = 0; j + 1 < sqrts.size(); j++) {
+        for (double fs : {0., 0.3, 0.5, 0.8}) {
+          const double s = sqrts[j] + fs * (sqrts[j + 1] - sqrts[j]);
+          double scale = 0.;
+          for (double xi : x) {
+            scale = std::max(scale, std::abs(spline(xi, s)));
+          }
+          for (size_t i = 0; i + 1 < x.size(); i++) {
+            for (double fx : {0., 0.3, 0.5, 0.8}) {
+              const double xi = logarithmic_x
+                                    ? x[i] * std::pow(x[i + 1] / x[i], fx)
+                                    : x[i] + fx * (x[i + 1] - x[i]);
+              COMPARE_ABSOLUTE_ERROR((*uniform)(xi, s), spline(xi, s),
+                                     tolerance * scale)
+                  << xi << " " << s;
+              COMPARE((*splined)(xi, s), spline(xi, s));
+            }
+          }
+        }
+      }
+    }
+  }
+}
@@ -26,6 +26,7 @@
 #include "../include/smash/propagation.h"
 #include "../include/smash/quantumsampling.h"
 #include "../include/smash/spheremodus.h"
+#include "../include/smash/threadpool.h"
 
 #include <boost/filesystem.hpp>
 
@@ -98,7 +99,6 @@ TEST(nucleus_potential_profile) {
   ColliderModus c(conf["Modi"], param);
   std::vector<Particles> P(1);
   c.initial_conditions(&(P[0]), param);
-  ParticleList plist;
 
   // Create potentials
   conf["Potentials"]["Skyrme"]["Skyrme_A"] = -209.2;
@@ -119,7 +119,8 @@ TEST(nucleus_potential_profile) {
     {
       a_file.open(("Nucleus_U_xy.vtk." + std::to_string(it)).c_str(),
                   std::ios::out);
-      plist = P[0].copy_to_vector();
+      const DensityCellList cells(P, pot.density_parameters(),
+                                  DensityType::Baryon);
       a_file << "# vtk DataFile Version 2.0\n"
              << "potential\n"
              << "ASCII\n"
@@ -136,7 +137,7 @@ TEST(nucleus_potential_profile) {
       for (auto iy = -ny; iy <= ny; iy++) {
         for (auto ix = -nx; ix <= nx; ix++) {
           r = ThreeVector(ix * dx, iy * dy, 8.0);
-          pot_value = pot.potential(r, plist, proton);
+          pot_value = pot.potential(r, cells, proton);
           a_file << pot_value << " ";
         }
         a_file << "\n";
@@ -170,7 +171,7 @@ TEST(propagation_in_test_potential) {
         : Potentials(conf, param), U0_(U0), d_(d), B0_(B0) {}
 
     std::tuple<ThreeVector, ThreeVector, ThreeVector, ThreeVector> all_forces(
-        const ThreeVector& r, const ParticleList&) const override {
+        const ThreeVector& r, const DensityCellList&) const override {
       const double tmp = std::exp(r.x1() / d_);
       return std::make_tuple(
           ThreeVector(U0_ / d_ * tmp / ((1.0 + tmp) * (1.0 + tmp)), 0.0, 0.0),
@@ -269,6 +270,64 @@ TEST(propagation_in_test_potential) {
       << P2[0].front().momentum().velocity().x3();
 }
 
+/* Without lattices the forces on many particles are summed over their
+ * neighbors by several threads. The updated momenta have to agree with the
+ * forces computed from all particles. */
+TEST(update_momenta_without_lattice) {
+  auto random_value = random::make_uniform_distribution(-4.0, +4.0);
+  std::vector<Particles> ensembles(1);
+  ParticleList plist;
+  for (int id = 0; id < 2000; id++) {
+    ParticleData p{ParticleType::find(id % 3 == 0 ? 0x2112 : 0x2212)};
+    p.set_4position({0., random_value(), random_value(), 2. * random_value()});
+    p.set_4momentum(smash::nucleon_mass, 0.1 * random_value(),
+                    0.1 * random_value(), 0.1 * random_value());
+    plist.push_back(ensembles[0].insert(p));
+  }
+
+  Configuration conf = Test::configuration(
+      "Potentials:\n"
+      "    Skyrme:\n"
+      "        Skyrme_A: -209.2\n"
+      "        Skyrme_B: 156.4\n"
+      "        Skyrme_Tau: 1.35\n"
+      "    Symmetry:\n"
+      "        S_Pot: 18.0\n");
+  ExperimentParameters param = smash::Test::default_parameters();
+  const Potentials pot(conf["Potentials"], param);
+  const double dt = 0.02;
+  // the particles are updated by several threads
+  ThreadPool::set_global_size(4);
+  update_momenta(ensembles, dt, pot, nullptr, nullptr, nullptr);
+  ThreadPool::set_global_size(1);
+
+  for (const ParticleData &p : plist) {
+    const auto forces = pot.all_forces(p.position().threevec(), plist);
+    const auto scale = pot.force_scale(p.type());
+    const ThreeVector v = p.momentum().velocity();
+    const ThreeVector force =
+        scale.first *
+            (std::get<0>(forces) + v.cross_product(std::get<1>(forces))) +
+        scale.second * p.type().isospin3_rel() *
+            (std::get<2>(forces) + v.cross_product(std::get<3>(forces)));
+    const ThreeVector expected = p.momentum().threevec() + force * dt;
+    const ThreeVector updated = ensembles[0].lookup(p).momentum().threevec();
+    for (int i = 0; i < 3; i++) {
+      COMPARE_ABSOLUTE_ERROR(updated[i], expected[i], 1e-12);
+    }
+  }
+
+  // the potential summed over the neighbors agrees with the full sum
+  const DensityCellList cells(ensembles, pot.density_parameters(),
+                              DensityType::Baryon);
+  const ParticleList updated = ensembles[0].copy_to_vector();
+  for (const ParticleData &p : updated) {
+    const ThreeVector r = p.position().threevec();
+    COMPARE_ABSOLUTE_ERROR(pot.potential(r, cells, p.type()),
+                           pot.potential(r, updated, p.type()), 1e-12);
+  }
+}
+
 /*
  * The idea is to compute potentials from the same set of particles,
  * but in one case they are testparticles in one ensemble, while in the
@@ -709,6 +768,95 @@ TEST(skyrme_vs_vdf_wo_lattice) {
          "the Skyrme and VDF forces to be comparable for this initialization.";
 }
 
+/*
+ * Comparing the tabulated density dependences of the Skyrme, symmetry and VDF
+ * potentials and forces with their direct evaluation, for densities below,
+ * within and above the tabulated range.
+ */
+TEST(tabulated_vs_direct_potentials) {
+  std::string conf_pot =
+      "Potentials:\n"
+      "    Skyrme:\n"
+      "        Skyrme_A: -209.2\n"
+      "        Skyrme_B: 156.4\n"
+      "        Skyrme_Tau: 1.35\n"
+      "    Symmetry:\n"
+      "        S_Pot: 18.0\n"
+      "        gamma: 0.8\n"
+      "    VDF:\n"
+      "      Sat_rhoB: 0.160\n"
+      "      Powers: [1.7681391, 3.5293515, 5.4352788, 6.3809822]\n"
+      "      Coeffs: [-8.450948e+01, 3.843139e+01, -7.958557e+00, "
+      "1.552594e+00]\n";
+  Configuration conf = Test::configuration(conf_pot);
+  ExperimentParameters param = default_parameters_vdf();
+  Potentials pot(conf["Potentials"], param);
+  const double gamma = 0.8;
+  const double rho_s = pot.saturation_density();
+  const FourVector jmu(1., 0., 0., 0.);
+  const ThreeVector e_x(1., 0., 0.), e_y(0., 1., 0.), zero(0., 0., 0.);
+  /* The interpolated derivatives entering the forces are less precise than
+   * the values, most of all close to the lower end of the tables. */
+  const double force_tolerance = 1e-5;
+  for (double rho : {0.001, 0.01, 0.02, 0.1, 0.16, 0.37, 0.8, 1.5, 3.0}) {
+    for (int sgn : {1, -1}) {
+      const double rhoB = sgn * rho;
+      const double x = rho / nuclear_density;
+      const double skyrme = sgn * mev_to_gev *
+                            (pot.skyrme_a() * x +
+                             pot.skyrme_b() * std::pow(x, pot.skyrme_tau()));
+      COMPARE_ABSOLUTE_ERROR(pot.skyrme_pot(rhoB), skyrme, 1e-8) << rhoB;
+      const double dskyrme_drho =
+          sgn * mev_to_gev / nuclear_density *
+          (pot.skyrme_a() + pot.skyrme_b() * pot.skyrme_tau() *
+                                std::pow(x, pot.skyrme_tau() - 1.));
+      const auto skyrme_force = pot.skyrme_force(rhoB, e_x, zero, e_y);
+      COMPARE_RELATIVE_ERROR(skyrme_force.first.x1(), -dskyrme_drho,
+                             force_tolerance)
+          << rhoB;
+      COMPARE_RELATIVE_ERROR(skyrme_force.second.x2(), dskyrme_drho,
+                             force_tolerance)
+          << rhoB;
+
+      double F_1 = 0.0, F_2 = 0.0;
+      for (int i = 0; i < pot.number_of_terms(); i++) {
+        F_1 += pot.coeffs()[i] * (pot.powers()[i] - 2.0) *
+               std::pow(rho, pot.powers()[i] - 3.0) /
+               std::pow(rho_s, pot.powers()[i] - 1.0);
+        F_2 += pot.coeffs()[i] * std::pow(rho, pot.powers()[i] - 2.0) /
+               std::pow(rho_s, pot.powers()[i] - 1.0);
+      }
+      COMPARE_ABSOLUTE_ERROR(pot.vdf_pot(rhoB, jmu).x0(), sgn * F_2, 1e-8)
+          << rhoB;
+      // grad rhoB along x and grad j0B along y separate the two factors
+      const auto vdf_force =
+          pot.vdf_force(rhoB, 0., e_x, zero, 1., e_y, zero, zero, zero);
+      COMPARE_RELATIVE_ERROR(vdf_force.first.x1(), -sgn * F_1,
+                             force_tolerance)
+          << rhoB;
+      COMPARE_RELATIVE_ERROR(vdf_force.first.x2(), -sgn * F_2,
+                             force_tolerance)
+          << rhoB;
+    }
+    // the density dependent symmetry term is only tabulated for rhoB > 0
+    const double x = rho / nuclear_density;
+    const double S = 12.3 * std::pow(x, 2. / 3.) + 20.0 * std::pow(x, gamma);
+    const double dS_dx =
+        8.2 * std::pow(x, -1. / 3.) + 20.0 * gamma * std::pow(x, gamma - 1.);
+    COMPARE_RELATIVE_ERROR(pot.symmetry_S(rho), S, 1e-8) << rho;
+    const double rhoI3 = -0.2 * rho;
+    const double dVsym_drhoB = mev_to_gev *
+                               (dS_dx / nuclear_density - 2. * S / rho) *
+                               rhoI3 * rhoI3 / (rho * rho);
+    // only grad j0B along x contributes to the symmetry force along x
+    const auto sym_force =
+        pot.symmetry_force(rhoI3, zero, zero, zero, rho, e_x, zero, zero);
+    COMPARE_RELATIVE_ERROR(sym_force.first.x1(), -dVsym_drhoB,
+                           force_tolerance)
+        << rho;
+  }
+}
+
 /*
  * Creates a histogram of densities in cells of a (cubic) box, and checks
  * whether the expected relation between histogram densities was found:
@@ -10,6 +10,9 @@
 #include <vir/test.h>  // This include has to be first
 
 #include <cinttypes>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
 
 #include "histogram.h"
 
@@ -119,3 +122,30 @@ TEST(beta_a0) {
   test_distribution(N_TEST, 0.001, [&]() { return random::beta_a0(xmin, b); },
                     [&](double x) { return std::pow(1.0 - x, b) / x; });
 }
+
+TEST(alias_sampler) {
+  const std::vector<double> weights = {0.5, 0.0, 3.0, 1.5, 0.0, 5.0};
+  const random::AliasSampler sampler(weights);
+  COMPARE(sampler.size(), weights.size());
+  std::vector<int> counts(weights.size(), 0);
+  for (int i = 0; i < N_TEST; i++) {
+    const size_t index = sampler.sample();
+    VERIFY(index < weights.size());
+    counts[index]++;
+  }
+  for (size_t i = 0; i < weights.size(); i++) {
+    const double expected = N_TEST * weights[i] / 10.0;
+    // 5 standard deviations of the binomial distribution
+    COMPARE_ABSOLUTE_ERROR(static_cast<double>(counts[i]), expected,
+                           5.0 * std::sqrt(expected) + 1e-9)
+        << "index " << i;
+  }
+}
+
+TEST_CATCH(alias_sampler_without_weights, std::invalid_argument) {
+  random::AliasSampler sampler({});
+}
+
+TEST_CATCH(alias_sampler_with_zero_weights, std::invalid_argument) {
+  random::AliasSampler sampler({0.0, 0.0});
+}
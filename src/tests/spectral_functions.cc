@@ -9,6 +9,9 @@
 
 #include <vir/test.h>  // This include has to be first
 
+#include <algorithm>
+#include <vector>
+
 #include "histogram.h"
 #include "setup.h"
 
@@ -90,3 +93,99 @@ TEST(mass_sampling) {
     return res.spectral_function(m) * pcm * bw;
   });
 }
+
+TEST(tabulated_mass_sampling) {
+  const ParticleType &res = ParticleType::find(0x12212);
+  ParticleType::tabulated_resonance_masses_ = true;
+  // Dummy reaction NN -> NN(1440) at sqrt(s) = 2.5 GeV, within the table
+  const double sqrts = 2.5;
+  const double mass_stable = 0.938;
+  const int L = 1;
+  const double dm_hist = 0.01;
+  Histogram1d hist(dm_hist);
+  const int N_sample = 1000000;
+  hist.populate(N_sample, [&]() {
+    const double m = res.sample_resonance_mass(mass_stable, sqrts, L);
+    VERIFY(m >= res.min_mass_spectral());
+    VERIFY(m < sqrts - mass_stable);
+    return m;
+  });
+  ParticleType::tabulated_resonance_masses_ = false;
+  hist.test([&](double m) {
+    const double pcm = pCM(sqrts, mass_stable, m);
+    const double bw = blatt_weisskopf_sqr(pcm, L);
+    return res.spectral_function(m) * pcm * bw;
+  });
+}
+
+TEST(tabulated_mass_sampling_near_threshold) {
+  const ParticleType &res = ParticleType::find(0x12212);
+  ParticleType::tabulated_resonance_masses_ = true;
+  // NN -> NN(1440) 10 MeV above threshold, where the distribution is narrow
+  const double mass_stable = 0.938;
+  const double sqrts = mass_stable + res.min_mass_spectral() + 0.01;
+  const int L = 1;
+  const double dm_hist = 0.0002;
+  Histogram1d hist(dm_hist);
+  const int N_sample = 1000000;
+  hist.populate(N_sample, [&]() {
+    const double m = res.sample_resonance_mass(mass_stable, sqrts, L);
+    VERIFY(m >= res.min_mass_spectral());
+    VERIFY(m < sqrts - mass_stable);
+    return m;
+  });
+  ParticleType::tabulated_resonance_masses_ = false;
+  hist.test([&](double m) {
+    const double pcm = pCM(sqrts, mass_stable, m);
+    const double bw = blatt_weisskopf_sqr(pcm, L);
+    return res.spectral_function(m) * pcm * bw;
+  });
+}
+
+TEST(tabulated_mass_cdf) {
+  /* Between the rows of the table, the sampled distribution mixes the
+   * neighboring rows. Bound the resulting error by the largest deviation of
+   * the sampled from the exact CDF, from close to the threshold up to far
+   * above it. The statistical deviation is about 0.0014 at 95% confidence. */
+  const ParticleType &res = ParticleType::find(0x12212);
+  const double mass_stable = 0.938;
+  const int L = 1;
+  const double min_mass = res.min_mass_spectral();
+  const int N_sample = 1000000;
+  const int n_grid = 4000;
+  for (double sqrts_above_threshold : {0.0005, 0.002, 0.01, 0.05, 0.3, 2.}) {
+    const double sqrts = mass_stable + min_mass + sqrts_above_threshold;
+    const double max_mass = sqrts - mass_stable;
+    auto density = [&](double m) {
+      const double pcm = pCM(sqrts, mass_stable, m);
+      return res.spectral_function(m) * pcm * blatt_weisskopf_sqr(pcm, L);
+    };
+    // exact CDF from the trapezoidal rule on a fine grid
+    const double dm = (max_mass - min_mass) / n_grid;
+    std::vector<double> cdf(n_grid + 1, 0.);
+    for (int k = 1; k <= n_grid; k++) {
+      cdf[k] = cdf[k - 1] + 0.5 * dm *
+                                (density(min_mass + (k - 1) * dm) +
+                                 density(min_mass + k * dm));
+    }
+    ParticleType::tabulated_resonance_masses_ = true;
+    std::vector<double> masses(N_sample);
+    for (double &m : masses) {
+      m = res.sample_resonance_mass(mass_stable, sqrts, L);
+    }
+    ParticleType::tabulated_resonance_masses_ = false;
+    std::sort(masses.begin(), masses.end());
+    double max_deviation = 0.;
+    for (int k = 0; k <= n_grid; k += 40) {
+      const double sampled_cdf =
+          static_cast<double>(std::upper_bound(masses.begin(), masses.end(),
+                                               min_mass + k * dm) -
+                              masses.begin()) /
+          N_sample;
+      max_deviation =
+          std::max(max_deviation, std::abs(sampled_cdf - cdf[k] / cdf[n_grid]));
+    }
+    VERIFY(max_deviation < 0.004)
+        << sqrts_above_threshold << " GeV above threshold: " << max_deviation;
+  }
+}
@@ -150,6 +150,44 @@ TEST(initialization) {
   }
 }
 
+TEST(warm_up_hard_pythia) {
+  std::unique_ptr<StringProcess> sp =
+      make_unique<StringProcess>(1.0, 1.0, .0, 0.001, .0, .0, 1., 1., .0, .0,
+                                 .5, .0, .0, .0, .0, true, 1. / 3., true, 0.);
+  COMPARE(sp->number_of_hard_pythia(), 0u);
+  // Both orders of p + n and of pi+ + p (K+ is mapped onto pi+)
+  sp->warm_up_hard_pythia({{PdgCode(0x2212), PdgCode(0x2112)},
+                           {PdgCode(0x321), PdgCode(0x2212)}},
+                          20.);
+  COMPARE(sp->number_of_hard_pythia(), 4u);
+  // Already initialized pairs are reused, p + p is added once
+  sp->warm_up_hard_pythia({{PdgCode(0x2112), PdgCode(0x2212)},
+                           {PdgCode(0x2212), PdgCode(0x2212)}},
+                          20.);
+  COMPARE(sp->number_of_hard_pythia(), 5u);
+}
+
+TEST(tabulated_diffractive_cross_sections) {
+  std::unique_ptr<StringProcess> sp =
+      make_unique<StringProcess>(1.0, 1.0, .0, 0.001, .0, .0, 1., 1., .0, .0,
+                                 .5, .0, .0, .0, .0, true, 1. / 3., true, 0.);
+  for (const std::array<int, 2> &pdg :
+       {std::array<int, 2>{2212, 2212}, std::array<int, 2>{211, 2112},
+        std::array<int, 2>{-2212, 2212}}) {
+    // below the threshold, close to it, at high energies and above the table
+    for (double sqrt_s : {1., 3.1, 3.456, 17.3, 200., 2.76e3, 1.3e4}) {
+      const std::array<double, 3> tabulated =
+          sp->cross_sections_diffractive(pdg[0], pdg[1], sqrt_s);
+      const std::array<double, 3> computed =
+          sp->compute_cross_sections_diffractive(pdg[0], pdg[1], sqrt_s);
+      for (size_t i = 0; i < 3; i++) {
+        COMPARE_ABSOLUTE_ERROR(tabulated[i], computed[i], 1.e-2)
+            << pdg[0] << " + " << pdg[1] << " at " << sqrt_s << " GeV";
+      }
+    }
+  }
+}
+
 TEST(rearrange_ex) {
   // StringProcess to use member functions
   std::unique_ptr<StringProcess> sp =
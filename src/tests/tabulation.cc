@@ -89,3 +89,40 @@ TEST(quadratic) {
   // check extrapolated values
   COMPARE_ABSOLUTE_ERROR(tab.get_value_linear(3.), 7.8, error);
 }
+
+TEST(hermite_empty) {
+  const HermiteTabulation tab;
+  VERIFY(tab.is_empty());
+  VERIFY(!tab.covers(0.));
+}
+
+TEST(hermite_cubic) {
+  // a cubic polynomial is reproduced exactly by the Hermite interpolation
+  const HermiteTabulation tab(-1., 3., 6, [](double x) {
+    return std::make_pair(x * x * x - 2. * x + 1., 3. * x * x - 2.);
+  });
+  VERIFY(!tab.is_empty());
+  VERIFY(tab.covers(-1.));
+  VERIFY(tab.covers(2.));
+  VERIFY(!tab.covers(-1.1));
+  VERIFY(!tab.covers(2.1));
+  const double error = 1E-12;
+  for (double x : {-1., -0.7, 0., 0.25, 1.3, 1.99, 2.}) {
+    const auto f_and_df = tab.get_value_and_derivative(x);
+    COMPARE_ABSOLUTE_ERROR(f_and_df.first, x * x * x - 2. * x + 1., error);
+    COMPARE_ABSOLUTE_ERROR(f_and_df.second, 3. * x * x - 2., error);
+  }
+}
+
+TEST(hermite_power) {
+  // tabulate a non-integer power, as used for the potentials
+  const double tau = 1.35;
+  const HermiteTabulation tab(0.1, 4., 400, [tau](double x) {
+    return std::make_pair(std::pow(x, tau), tau * std::pow(x, tau - 1.));
+  });
+  for (double x : {0.1, 0.123, 0.5, 1.0, 2.71, 4.1}) {
+    const auto f_and_df = tab.get_value_and_derivative(x);
+    COMPARE_RELATIVE_ERROR(f_and_df.first, std::pow(x, tau), 1E-6);
+    COMPARE_RELATIVE_ERROR(f_and_df.second, tau * std::pow(x, tau - 1.), 1E-4);
+  }
+}
@@ -0,0 +1,170 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include <vir/test.h>  // This include has to be first
+
+#include "setup.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../include/smash/density.h"
+#include "../include/smash/energymomentumtensor.h"
+#include "../include/smash/lattice.h"
+#include "../include/smash/particles.h"
+#include "../include/smash/thermodynamiclatticeoutput.h"
+
+using namespace smash;
+
+static const bf::path testoutputpath = bf::absolute(SMASH_TEST_OUTPUT_PATH);
+
+TEST(directory_is_created) {
+  bf::create_directories(testoutputpath / "double");
+  bf::create_directories(testoutputpath / "single");
+  bf::create_directories(testoutputpath / "jqbs");
+  VERIFY(bf::exists(testoutputpath));
+}
+
+/* Writes two time slices of T^{mu nu} on a 2x2x2 lattice, where the value of
+ * every component at every node is unique. */
+static void write_tmn(const bf::path &path, bool single_precision) {
+  OutputParameters out_par;
+  out_par.td_tmn = true;
+  out_par.td_single_precision = single_precision;
+  RectangularLattice<EnergyMomentumTensor> lattice(
+      {2., 2., 2.}, {2, 2, 2}, {0., 0., 0.}, false,
+      LatticeUpdate::EveryTimestep);
+  for (size_t node = 0; node < lattice.size(); node++) {
+    EnergyMomentumTensor::tmn_type tmn;
+    for (size_t i = 0; i < tmn.size(); i++) {
+      tmn[i] = 0.5 + node + 10. * i;
+    }
+    lattice[node] = EnergyMomentumTensor(tmn);
+  }
+  ThermodynamicLatticeOutput output(path, "Thermodynamics", out_par, false,
+                                    true);
+  output.at_eventstart(0, ThermodynamicQuantity::Tmn, DensityType::Hadron,
+                       lattice);
+  output.thermodynamics_lattice_output(ThermodynamicQuantity::Tmn, lattice,
+                                       1.);
+  output.thermodynamics_lattice_output(ThermodynamicQuantity::Tmn, lattice,
+                                       2.);
+  output.at_eventend(ThermodynamicQuantity::Tmn);
+}
+
+/* Reads a value of type T from the given position of the file. */
+template <typename T>
+static T read_at(std::ifstream &file, std::streamoff position) {
+  T x;
+  file.seekg(position);
+  file.read(reinterpret_cast<char *>(&x), sizeof(x));
+  return x;
+}
+
+// version, quantity, cell numbers, cell sizes and origin
+static constexpr std::streamoff header_size = 8 + 4 + 3 * 4 + 3 * 8 + 3 * 8;
+// 10 independent components at 8 nodes
+static constexpr int n_values = 80;
+
+TEST(double_precision) {
+  write_tmn(testoutputpath / "double", false);
+  std::ifstream file(
+      (testoutputpath / "double" / "hadron_tmn_0000000.bin").native(),
+      std::ios::binary);
+  VERIFY(file.good());
+  COMPARE(read_at<double>(file, 0), 1.0);
+  const std::streamoff slice_size = 8 + n_values * 8;
+  file.seekg(0, std::ios::end);
+  const std::streamoff file_size = file.tellg();
+  COMPARE(file_size, header_size + 2 * slice_size);
+  // second slice: time, then T^00 at node 0 and T^01 at node 1
+  COMPARE(read_at<double>(file, header_size + slice_size), 2.);
+  COMPARE(read_at<double>(file, header_size + slice_size + 8), 0.5);
+  COMPARE(read_at<double>(file, header_size + slice_size + 8 + 9 * 8), 11.5);
+}
+
+TEST(single_precision) {
+  write_tmn(testoutputpath / "single", true);
+  std::ifstream file(
+      (testoutputpath / "single" / "hadron_tmn_0000000.bin").native(),
+      std::ios::binary);
+  VERIFY(file.good());
+  COMPARE(read_at<double>(file, 0), 1.1);
+  COMPARE(read_at<int>(file, header_size), 4);
+  const std::streamoff header = header_size + 4;
+  const std::streamoff slice_size = 8 + 4 + n_values * 4;
+  file.seekg(0, std::ios::end);
+  const std::streamoff file_size = file.tellg();
+  COMPARE(file_size, header + 2 * slice_size);
+  COMPARE(read_at<double>(file, header + slice_size), 2.);
+  COMPARE(read_at<std::uint32_t>(file, header + slice_size + 8),
+          static_cast<std::uint32_t>(n_values));
+  COMPARE(read_at<float>(file, header + slice_size + 12), 0.5f);
+  COMPARE(read_at<float>(file, header + slice_size + 12 + 9 * 4), 11.5f);
+}
+
+TEST(init_particletypes) { Test::create_actual_particletypes(); }
+
+/* The deposited 4-currents have to agree with current_eckart evaluated at
+ * every node. */
+TEST(jqbs_deposit) {
+  OutputParameters out_par;
+  out_par.td_jQBS = true;
+  const DensityParameters dens_par(Test::default_parameters());
+  RectangularLattice<DensityOnLattice> lattice(
+      {8., 8., 8.}, {4, 4, 4}, {-4., -4., -4.}, false, LatticeUpdate::AtOutput);
+  std::vector<Particles> ensembles(1);
+  const std::vector<int> pdgs = {0x2212, 0x211, 0x321, -0x3122};
+  for (size_t i = 0; i < pdgs.size(); i++) {
+    ParticleData p{ParticleType::find(PdgCode(pdgs[i]))};
+    p.set_4position(FourVector(0., -2. + 1.3 * i, 0.5 * i, 1. - 0.7 * i));
+    p.set_4momentum(p.pole_mass(), ThreeVector(0.3 * i, -0.2, 0.1 * i));
+    ensembles[0].insert(p);
+  }
+  {
+    ThermodynamicLatticeOutput output(testoutputpath / "jqbs",
+                                      "Thermodynamics", out_par, false, true);
+    output.at_eventstart(0, ThermodynamicQuantity::j_QBS, DensityType::None,
+                         lattice);
+    output.thermodynamics_lattice_output(lattice, 1., ensembles, dens_par);
+    output.at_eventend(ThermodynamicQuantity::j_QBS);
+  }
+  bf::path filename;
+  for (const auto &entry : bf::directory_iterator(testoutputpath / "jqbs")) {
+    filename = entry.path();
+  }
+  std::ifstream file(filename.native(), std::ios::binary);
+  VERIFY(file.good());
+  COMPARE(read_at<double>(file, header_size), 1.);
+  const std::array<DensityType, 3> types = {
+      DensityType::Charge, DensityType::Baryon, DensityType::Strangeness};
+  std::streamoff position = header_size + 8;
+  double sum_jQ0 = 0.;
+  lattice.iterate_sublattice(
+      {0, 0, 0}, lattice.n_cells(),
+      [&](DensityOnLattice &, int ix, int iy, int iz) {
+        const ThreeVector r = lattice.cell_center(ix, iy, iz);
+        for (DensityType type : types) {
+          const FourVector j = std::get<1>(
+              current_eckart(r, ensembles[0], dens_par, type, false, true));
+          for (int l = 0; l < 4; l++) {
+            COMPARE_ABSOLUTE_ERROR(read_at<double>(file, position), j[l],
+                                   1e-12);
+            position += 8;
+          }
+        }
+        sum_jQ0 += read_at<double>(file, position - 12 * 8);
+      });
+  file.seekg(0, std::ios::end);
+  const std::streamoff file_size = file.tellg();
+  COMPARE(file_size, position);
+  VERIFY(sum_jQ0 > 0.);
+}
@@ -0,0 +1,110 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include <vir/test.h>  // This include has to be first
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "../include/smash/threadpool.h"
+
+using namespace smash;
+
+TEST(every_index_once) {
+  ThreadPool pool(4);
+  COMPARE(pool.size(), 4u);
+  for (std::size_t chunk : {1, 7, 1000}) {
+    std::vector<std::atomic<int>> calls(1001);
+    for (auto &c : calls) {
+      c = 0;
+    }
+    std::atomic<bool> valid_thread{true};
+    pool.for_each_index(calls.size(), chunk,
+                        [&](std::size_t i, std::size_t thread) {
+                          calls[i]++;
+                          if (thread >= pool.size()) {
+                            valid_thread = false;
+                          }
+                        });
+    for (const auto &c : calls) {
+      COMPARE(c.load(), 1);
+    }
+    VERIFY(valid_thread);
+  }
+  // the pool is reused for empty loops and loops of a single index
+  int n_calls = 0;
+  pool.for_each_index(0, 1, [&](std::size_t, std::size_t) { n_calls++; });
+  pool.for_each_index(1, 1, [&](std::size_t, std::size_t) { n_calls++; });
+  COMPARE(n_calls, 1);
+}
+
+TEST(reduction_per_thread) {
+  ThreadPool pool(3);
+  std::vector<double> sums(pool.size(), 0.);
+  pool.for_each_index(10000, 16, [&](std::size_t i, std::size_t thread) {
+    sums[thread] += i;
+  });
+  double sum = 0.;
+  for (double s : sums) {
+    sum += s;
+  }
+  COMPARE(sum, 10000. * 9999. / 2.);
+}
+
+TEST(nested_loops_run_serially) {
+  ThreadPool pool(4);
+  std::vector<std::atomic<int>> calls(100);
+  for (auto &c : calls) {
+    c = 0;
+  }
+  pool.for_each_index(10, 1, [&](std::size_t i, std::size_t) {
+    pool.for_each_index(10, 1, [&](std::size_t j, std::size_t thread) {
+      calls[10 * i + j]++;
+      if (thread != 0) {
+        calls[10 * i + j] = -100;
+      }
+    });
+  });
+  for (const auto &c : calls) {
+    COMPARE(c.load(), 1);
+  }
+}
+
+TEST(exceptions_are_rethrown) {
+  ThreadPool pool(4);
+  std::atomic<int> n_calls{0};
+  bool thrown = false;
+  try {
+    pool.for_each_index(1000, 1, [&](std::size_t i, std::size_t) {
+      n_calls++;
+      if (i == 10) {
+        throw std::runtime_error("index 10");
+      }
+    });
+  } catch (const std::runtime_error &) {
+    thrown = true;
+  }
+  VERIFY(thrown);
+  // the remaining indices are skipped
+  VERIFY(n_calls < 1000);
+  // and the pool can be used again
+  n_calls = 0;
+  pool.for_each_index(1000, 1, [&](std::size_t, std::size_t) { n_calls++; });
+  COMPARE(n_calls.load(), 1000);
+}
+
+TEST(global_pool) {
+  COMPARE(ThreadPool::global().size(), 1u);
+  ThreadPool::set_global_size(2);
+  COMPARE(ThreadPool::global().size(), 2u);
+  ThreadPool::set_global_size(0);
+  VERIFY(ThreadPool::global().size() >= 1u);
+  ThreadPool::set_global_size(1);
+}
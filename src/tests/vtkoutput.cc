@@ -1,6 +1,6 @@
 /*
  *
- *    Copyright (c) 2014-2020
+ *    Copyright (c) 2014-2021
  *      SMASH Team
  *
  *    GNU General Public License (GPLv3 or later)
@@ -12,14 +12,19 @@
 #include "setup.h"
 
 #include <smash/config.h>
+#include <algorithm>
 #include <array>
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <cstring>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include "../include/smash/clock.h"
 #include "../include/smash/configuration.h"
+#include "../include/smash/energymomentumtensor.h"
+#include "../include/smash/lattice.h"
 #include "../include/smash/outputinterface.h"
 #include "../include/smash/particles.h"
 #include "../include/smash/random.h"
@@ -33,6 +38,7 @@ static auto random_value = random::make_uniform_distribution(-15.0, +15.0);
 
 TEST(directory_is_created) {
   bf::create_directories(testoutputpath);
+  bf::create_directories(testoutputpath / "binary");
   VERIFY(bf::exists(testoutputpath));
 }
 
@@ -295,3 +301,153 @@ TEST(vtkoutputfile) {
   VERIFY(bf::remove(outputfilepath));
   VERIFY(bf::remove(outputfile2path));
 }
+
+/* Reads a big-endian value of type T, as written by the binary VTK format. */
+template <typename T>
+static T read_big_endian(std::istream &file) {
+  char bytes[sizeof(T)];
+  file.read(bytes, sizeof(T));
+#if defined(LITTLE_ENDIAN_ARCHITECTURE)
+  std::reverse(bytes, bytes + sizeof(T));
+#endif
+  T x;
+  std::memcpy(&x, bytes, sizeof(T));
+  return x;
+}
+
+/* Skips lines of the file up to the given one. */
+static void skip_to_line(std::istream &file, const std::string &expected) {
+  std::string line;
+  while (std::getline(file, line) && line != expected) {
+  }
+  COMPARE(line, expected);
+}
+
+// the smashon particle type was created in the vtkoutputfile test
+TEST(vtk_binary_particles) {
+  Particles particles;
+  const int number_of_particles = 5;
+  for (int i = 0; i < number_of_particles; i++) {
+    particles.insert(Test::smashon_random());
+  }
+  const bf::path path = testoutputpath / "binary";
+  {
+    VtkOutput output(path, "Particles", OutputParameters(), true);
+    output.at_eventstart(particles, 0, Test::default_event_info());
+  }
+  bf::ifstream file(path / "pos_ev00000_tstep00000.vtk", std::ios::binary);
+  VERIFY(file.good());
+  std::string line;
+  std::getline(file, line);
+  COMPARE(line, "# vtk DataFile Version 2.0");
+  std::getline(file, line);
+  std::getline(file, line);
+  COMPARE(line, "BINARY");
+  skip_to_line(file, "POINTS 5 double");
+  for (const auto &p : particles) {
+    for (int j = 1; j < 4; j++) {
+      COMPARE(read_big_endian<double>(file), p.position()[j]);
+    }
+  }
+  std::getline(file, line);
+  COMPARE(line, "");
+  std::getline(file, line);
+  COMPARE(line, "CELLS 5 10");
+  for (int i = 0; i < number_of_particles; i++) {
+    COMPARE(read_big_endian<std::int32_t>(file), 1);
+    COMPARE(read_big_endian<std::int32_t>(file), i);
+  }
+  skip_to_line(file, "SCALARS pdg_codes int 1");
+  std::getline(file, line);
+  COMPARE(line, "LOOKUP_TABLE default");
+  for (int i = 0; i < number_of_particles; i++) {
+    COMPARE(read_big_endian<std::int32_t>(file), 661);
+  }
+  skip_to_line(file, "VECTORS momentum double");
+  for (const auto &p : particles) {
+    for (int j = 1; j < 4; j++) {
+      COMPARE(read_big_endian<double>(file), p.momentum()[j]);
+    }
+  }
+  std::getline(file, line);
+  COMPARE(line, "");
+  VERIFY(file.peek() == EOF);
+}
+
+TEST(vtk_binary_lattice_single_precision) {
+  OutputParameters out_par;
+  out_par.td_single_precision = true;
+  RectangularLattice<EnergyMomentumTensor> lattice(
+      {2., 2., 2.}, {2, 2, 2}, {0., 0., 0.}, false,
+      LatticeUpdate::EveryTimestep);
+  for (size_t node = 0; node < lattice.size(); node++) {
+    EnergyMomentumTensor::tmn_type tmn;
+    for (size_t i = 0; i < tmn.size(); i++) {
+      tmn[i] = 0.5 + node + 10. * i;
+    }
+    lattice[node] = EnergyMomentumTensor(tmn);
+  }
+  const bf::path path = testoutputpath / "binary";
+  {
+    VtkOutput output(path, "Thermodynamics", out_par, true);
+    output.thermodynamics_output(ThermodynamicQuantity::Tmn,
+                                 DensityType::Hadron, lattice);
+  }
+  bf::ifstream file(path / "hadron_tmn_00000_tstep00000.vtk",
+                    std::ios::binary);
+  VERIFY(file.good());
+  skip_to_line(file, "BINARY");
+  skip_to_line(file, "POINT_DATA 8");
+  for (int i = 0; i < 4; i++) {
+    for (int j = i; j < 4; j++) {
+      skip_to_line(file, "SCALARS hadron_tmn" + std::to_string(i) +
+                             std::to_string(j) + " float 1");
+      std::string line;
+      std::getline(file, line);
+      COMPARE(line, "LOOKUP_TABLE default");
+      const int index = EnergyMomentumTensor::tmn_index(i, j);
+      for (int node = 0; node < 8; node++) {
+        COMPARE(read_big_endian<float>(file),
+                static_cast<float>(0.5 + node + 10. * index));
+      }
+    }
+  }
+  std::string line;
+  std::getline(file, line);
+  COMPARE(line, "");
+  VERIFY(file.peek() == EOF);
+}
+
+TEST(vtk_binary_fields_double_precision) {
+  // the single precision options of other contents do not apply to fields
+  OutputParameters out_par;
+  out_par.td_single_precision = true;
+  out_par.part_single_precision = true;
+  RectangularLattice<std::pair<ThreeVector, ThreeVector>> lattice(
+      {2., 2., 2.}, {2, 2, 2}, {0., 0., 0.}, false,
+      LatticeUpdate::EveryTimestep);
+  for (size_t node = 0; node < lattice.size(); node++) {
+    lattice[node] = std::make_pair(ThreeVector(0.1 + node, 0.2, 0.3),
+                                   ThreeVector(0.4, 0.5 + node, 0.6));
+  }
+  const bf::path path = testoutputpath / "binary";
+  {
+    VtkOutput output(path, "Fields", out_par, true);
+    output.fields_output("Efield", "Bfield", lattice);
+  }
+  bf::ifstream file(path / "Efield_00000_tstep00000.vtk", std::ios::binary);
+  VERIFY(file.good());
+  skip_to_line(file, "BINARY");
+  skip_to_line(file, "POINT_DATA 8");
+  std::string line;
+  std::getline(file, line);
+  COMPARE(line, "VECTORS Efield double");
+  for (int node = 0; node < 8; node++) {
+    COMPARE(read_big_endian<double>(file), 0.1 + node);
+    COMPARE(read_big_endian<double>(file), 0.2);
+    COMPARE(read_big_endian<double>(file), 0.3);
+  }
+  std::getline(file, line);
+  COMPARE(line, "");
+  VERIFY(file.peek() == EOF);
+}
@@ -9,6 +9,8 @@
 
 #include "smash/thermodynamiclatticeoutput.h"
 
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <memory>
 
@@ -16,6 +18,7 @@
 
 #include "smash/clock.h"
 #include "smash/config.h"
+#include "smash/cxx14compat.h"
 #include "smash/density.h"
 #include "smash/energymomentumtensor.h"
 #include "smash/experimentparameters.h"
@@ -24,6 +27,11 @@
 
 namespace smash {
 
+namespace {
+/// Number of digits after the decimal point in the ASCII lattice output
+constexpr int ascii_precision = 14;
+}  // unnamed namespace
+
 /*!\Userguide
  * \page thermodyn_lattice_output_ Thermodynamics Lattice Output
  *
@@ -76,6 +84,7 @@ namespace smash {
  *   (ASCII: 3 fixed 6 digits precision floats, Binary: 3 doubles)
  * - dx, dy, dz: size of the lattice (set in Lattice->Sizes)
  *   (ASCII: 3 fixed 6 digits precision floats, Binary: 3 doubles)
+ * - Binary files of version 1.1 only: number of bytes per value (int)
  *
  * In "Lattice_ASCII" the data entries are separated by 1 space and each line of
  * the header starts with "#", followed by the description of the entry.
@@ -93,7 +102,13 @@ namespace smash {
  *
  * All the data in the payload are represented as:
  * - ASCII files: scientific format, 14 precision digits
- * - Binary files: double type
+ * - Binary files: double type, or float type if the \key Single_Precision
+ *   option of the \b Thermodynamics output is true. The latter files have
+ *   version 1.1 and every output time is followed by the number of values
+ *   of the time slice (uint32_t).
+ *
+ * All time slices of a binary file have the same size, such that a slice
+ * can be read by seeking directly to its position.
  *
  * In the case of the energy-momentum tensor, the data payload consists
  * in the values of the quantity in the following order:
@@ -180,6 +195,9 @@ namespace smash {
 /* initialization of the static member version */
 const double_t ThermodynamicLatticeOutput::version = 1.0;
 
+/* initialization of the static member single_precision_version */
+const double_t ThermodynamicLatticeOutput::single_precision_version = 1.1;
+
 ThermodynamicLatticeOutput::ThermodynamicLatticeOutput(
     const bf::path &path, const std::string &name,
     const OutputParameters &out_par, const bool enable_ascii,
@@ -188,7 +206,8 @@ ThermodynamicLatticeOutput::ThermodynamicLatticeOutput(
       out_par_(out_par),
       base_path_(std::move(path)),
       enable_ascii_(enable_ascii),
-      enable_binary_(enable_binary) {
+      enable_binary_(enable_binary),
+      single_precision_(out_par.td_single_precision) {
   if (enable_ascii_ || enable_binary_) {
     enable_output_ = true;
   } else {
@@ -507,33 +526,36 @@ void ThermodynamicLatticeOutput::at_eventend(const ThermodynamicQuantity tq) {
 
 void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
     RectangularLattice<DensityOnLattice> &lattice, double ctime) {
-  double result;
   const auto dim = lattice.n_cells();
   std::shared_ptr<std::ofstream> fp(nullptr);
+  std::shared_ptr<std::ofstream> fp_ascii(nullptr);
   if (enable_ascii_) {
-    fp = output_ascii_files_[ThermodynamicQuantity::EckartDensity];
-    *fp << std::setprecision(14);
-    *fp << std::scientific;
-    *fp << ctime << std::endl;
+    fp_ascii = output_ascii_files_[ThermodynamicQuantity::EckartDensity];
+    *fp_ascii << std::setprecision(ascii_precision);
+    *fp_ascii << std::scientific;
+    *fp_ascii << ctime << std::endl;
   }
   if (enable_binary_) {
     fp = output_binary_files_[ThermodynamicQuantity::EckartDensity];
-    assert(sizeof(ctime) == sizeof(double));
-    fp->write(reinterpret_cast<char *>(&ctime), sizeof(ctime));
+    begin_binary_slice(ctime);
   }
   lattice.iterate_sublattice(
       {0, 0, 0}, dim, [&](DensityOnLattice &node, int ix, int, int) {
         if (enable_ascii_) {
-          *fp << node.rho() << " ";
+          line_.append_scientific(node.rho(), ascii_precision);
+          line_.append(' ');
           if (ix == dim[0] - 1) {
-            *fp << "\n";
+            line_.append('\n');
+            line_.write_to(*fp_ascii);
           }
         }
         if (enable_binary_) {
-          result = node.rho();
-          fp->write(reinterpret_cast<char *>(&result), sizeof(double));
+          append_binary_value(node.rho());
         }
       });
+  if (enable_binary_) {
+    write_binary_slice(fp.get());
+  }
 }
 
 void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
@@ -543,67 +565,112 @@ void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
   if (!enable_output_) {
     return;
   }
-  double result;
   const auto dim = lattice.n_cells();
   std::shared_ptr<std::ofstream> fp(nullptr);
-  FourVector jQ = FourVector(), jB = FourVector(), jS = FourVector();
-  constexpr bool compute_gradient = false;
+  std::shared_ptr<std::ofstream> fp_ascii(nullptr);
   if (enable_ascii_) {
-    fp = output_ascii_files_[ThermodynamicQuantity::j_QBS];
-    *fp << std::setprecision(14);
-    *fp << std::scientific;
-    *fp << ctime << std::endl;
+    fp_ascii = output_ascii_files_[ThermodynamicQuantity::j_QBS];
+    *fp_ascii << std::setprecision(ascii_precision);
+    *fp_ascii << std::scientific;
+    *fp_ascii << ctime << std::endl;
   }
   if (enable_binary_) {
     fp = output_binary_files_[ThermodynamicQuantity::j_QBS];
-    assert(sizeof(ctime) == sizeof(double));
-    fp->write(reinterpret_cast<char *>(&ctime), sizeof(ctime));
+    begin_binary_slice(ctime);
   }
-  lattice.iterate_sublattice(
-      {0, 0, 0}, dim, [&](DensityOnLattice &, int ix, int iy, int iz) {
-        const ThreeVector position = lattice.cell_center(ix, iy, iz);
-        jQ.reset();
-        jB.reset();
-        jS.reset();
-        for (const Particles &particles : ensembles) {
-          jQ += std::get<1>(current_eckart(
-              position, particles, dens_param, DensityType::Charge,
-              compute_gradient, out_par_.td_smearing));
-          jB += std::get<1>(current_eckart(
-              position, particles, dens_param, DensityType::Baryon,
-              compute_gradient, out_par_.td_smearing));
-          jS += std::get<1>(current_eckart(
-              position, particles, dens_param, DensityType::Strangeness,
-              compute_gradient, out_par_.td_smearing));
+  /* Deposit the contribution of every particle to j_Q, j_B and j_S onto the
+   * nodes within the cutoff radius, as in update_lattice. Without smearing
+   * the currents do not depend on the position and are summed only once. */
+  if (!jQBS_lattice_ || !jQBS_lattice_->identical_to_lattice(&lattice)) {
+    jQBS_lattice_ = make_unique<RectangularLattice<std::array<FourVector, 3>>>(
+        lattice.lattice_sizes(), dim, lattice.origin(), lattice.periodic(),
+        LatticeUpdate::AtOutput);
+  }
+  jQBS_lattice_->reset();
+  std::array<FourVector, 3> j_total;
+  for (const Particles &particles : ensembles) {
+    for (const ParticleData &part : particles) {
+      if (dens_param.only_participants() &&
+          part.get_history().collisions_per_particle == 0) {
+        continue;
+      }
+      const std::array<double, 3> dens_factors = {
+          density_factor(part.type(), DensityType::Charge),
+          density_factor(part.type(), DensityType::Baryon),
+          density_factor(part.type(), DensityType::Strangeness)};
+      if (std::fabs(dens_factors[0]) < really_small &&
+          std::fabs(dens_factors[1]) < really_small &&
+          std::fabs(dens_factors[2]) < really_small) {
+        continue;
+      }
+      const FourVector p_mu = part.momentum();
+      const double m = p_mu.abs();
+      if (m < really_small) {
+        continue;
+      }
+      const double m_inv = 1.0 / m;
+      const FourVector u_lab = p_mu * (dens_param.norm_factor_sf() / p_mu.x0());
+      if (!out_par_.td_smearing) {
+        for (int k = 0; k < 3; k++) {
+          j_total[k] += u_lab * dens_factors[k];
         }
+        continue;
+      }
+      const ThreeVector pos = part.position().threevec();
+      jQBS_lattice_->iterate_in_cube(
+          pos, dens_param.r_cut(),
+          [&](std::array<FourVector, 3> &node, int ix, int iy, int iz) {
+            const ThreeVector r = jQBS_lattice_->cell_center(ix, iy, iz);
+            const double sf =
+                unnormalized_smearing_factor(pos - r, p_mu, m_inv, dens_param)
+                    .first;
+            if (sf > 0.) {
+              for (int k = 0; k < 3; k++) {
+                node[k] += u_lab * (dens_factors[k] * sf);
+              }
+            }
+          });
+    }
+  }
+  const RectangularLattice<std::array<FourVector, 3>> &jQBS = *jQBS_lattice_;
+  jQBS.iterate_sublattice(
+      {0, 0, 0}, dim,
+      [&](const std::array<FourVector, 3> &node, int, int, int) {
+        const std::array<FourVector, 3> &j =
+            out_par_.td_smearing ? node : j_total;
+        const FourVector &jQ = j[0], &jB = j[1], &jS = j[2];
         if (enable_ascii_) {
-          *fp << jQ[0];
+          line_.append_scientific(jQ[0], ascii_precision);
           for (int l = 1; l < 4; l++) {
-            *fp << " " << jQ[l];
+            line_.append(' ');
+            line_.append_scientific(jQ[l], ascii_precision);
           }
           for (int l = 0; l < 4; l++) {
-            *fp << " " << jB[l];
+            line_.append(' ');
+            line_.append_scientific(jB[l], ascii_precision);
           }
           for (int l = 0; l < 4; l++) {
-            *fp << " " << jS[l];
+            line_.append(' ');
+            line_.append_scientific(jS[l], ascii_precision);
           }
-          *fp << "\n";
+          line_.append('\n');
+          line_.write_to(*fp_ascii);
         }
         if (enable_binary_) {
           for (int l = 0; l < 4; l++) {
-            result = jQ[l];
-            fp->write(reinterpret_cast<char *>(&result), sizeof(double));
+            append_binary_value(jQ[l]);
           }
           for (int l = 0; l < 4; l++) {
-            result = jB[l];
-            fp->write(reinterpret_cast<char *>(&result), sizeof(double));
+            append_binary_value(jB[l]);
           }
           for (int l = 0; l < 4; l++) {
-            result = jS[l];
-            fp->write(reinterpret_cast<char *>(&result), sizeof(double));
+            append_binary_value(jS[l]);
           }
         }
       });
+  if (enable_binary_) {
+    write_binary_slice(fp.get());
+  }
 }
 
 void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
@@ -612,26 +679,26 @@ void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
   if (!enable_output_) {
     return;
   }
-  double result;
   const auto dim = lattice.n_cells();
   std::shared_ptr<std::ofstream> fp(nullptr);
+  std::shared_ptr<std::ofstream> fp_ascii(nullptr);
   if (enable_ascii_) {
     switch (tq) {
       case ThermodynamicQuantity::Tmn:
-        fp = output_ascii_files_[ThermodynamicQuantity::Tmn];
+        fp_ascii = output_ascii_files_[ThermodynamicQuantity::Tmn];
         break;
       case ThermodynamicQuantity::TmnLandau:
-        fp = output_ascii_files_[ThermodynamicQuantity::TmnLandau];
+        fp_ascii = output_ascii_files_[ThermodynamicQuantity::TmnLandau];
         break;
       case ThermodynamicQuantity::LandauVelocity:
-        fp = output_ascii_files_[ThermodynamicQuantity::LandauVelocity];
+        fp_ascii = output_ascii_files_[ThermodynamicQuantity::LandauVelocity];
         break;
       default:
         return;
     }
-    *fp << std::setprecision(14);
-    *fp << std::scientific;
-    *fp << ctime << std::endl;
+    *fp_ascii << std::setprecision(ascii_precision);
+    *fp_ascii << std::scientific;
+    *fp_ascii << ctime << std::endl;
   }
   if (enable_binary_) {
     switch (tq) {
@@ -647,8 +714,7 @@ void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
       default:
         return;
     }
-    assert(sizeof(ctime) == sizeof(double));
-    fp->write(reinterpret_cast<char *>(&ctime), sizeof(double));
+    begin_binary_slice(ctime);
   }
   switch (tq) {
     case ThermodynamicQuantity::Tmn:
@@ -658,14 +724,18 @@ void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
               {0, 0, 0}, dim,
               [&](EnergyMomentumTensor &node, int ix, int, int) {
                 if (enable_ascii_) {
-                  *fp << node[EnergyMomentumTensor::tmn_index(i, j)] << " ";
+                  line_.append_scientific(
+                      node[EnergyMomentumTensor::tmn_index(i, j)],
+                      ascii_precision);
+                  line_.append(' ');
                   if (ix == dim[0] - 1) {
-                    *fp << "\n";
+                    line_.append('\n');
+                    line_.write_to(*fp_ascii);
                   }
                 }
                 if (enable_binary_) {
-                  result = node[EnergyMomentumTensor::tmn_index(i, j)];
-                  fp->write(reinterpret_cast<char *>(&result), sizeof(double));
+                  append_binary_value(
+                      node[EnergyMomentumTensor::tmn_index(i, j)]);
                 }
               });
         }
@@ -680,16 +750,20 @@ void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
                 if (enable_ascii_) {
                   const FourVector u = node.landau_frame_4velocity();
                   const EnergyMomentumTensor Tmn_L = node.boosted(u);
-                  *fp << Tmn_L[EnergyMomentumTensor::tmn_index(i, j)] << " ";
+                  line_.append_scientific(
+                      Tmn_L[EnergyMomentumTensor::tmn_index(i, j)],
+                      ascii_precision);
+                  line_.append(' ');
                   if (ix == dim[0] - 1) {
-                    *fp << "\n";
+                    line_.append('\n');
+                    line_.write_to(*fp_ascii);
                   }
                 }
                 if (enable_binary_) {
                   const FourVector u = node.landau_frame_4velocity();
                   const EnergyMomentumTensor Tmn_L = node.boosted(u);
-                  result = Tmn_L[EnergyMomentumTensor::tmn_index(i, j)];
-                  fp->write(reinterpret_cast<char *>(&result), sizeof(double));
+                  append_binary_value(
+                      Tmn_L[EnergyMomentumTensor::tmn_index(i, j)]);
                 }
               });
         }
@@ -701,18 +775,29 @@ void ThermodynamicLatticeOutput::thermodynamics_lattice_output(
             if (enable_ascii_) {
               const FourVector u = node.landau_frame_4velocity();
               const ThreeVector v = -u.velocity();
-              *fp << v.x1() << " " << v.x2() << " " << v.x3() << "\n";
+              line_.append_scientific(v.x1(), ascii_precision);
+              line_.append(' ');
+              line_.append_scientific(v.x2(), ascii_precision);
+              line_.append(' ');
+              line_.append_scientific(v.x3(), ascii_precision);
+              line_.append('\n');
+              line_.write_to(*fp_ascii);
             }
             if (enable_binary_) {
               const FourVector u = node.landau_frame_4velocity();
-              ThreeVector v = -u.velocity();
-              fp->write(reinterpret_cast<char *>(&v), 3 * sizeof(double));
+              const ThreeVector v = -u.velocity();
+              append_binary_value(v.x1());
+              append_binary_value(v.x2());
+              append_binary_value(v.x3());
             }
           });
       break;
     default:
       return;
   }
+  if (enable_binary_) {
+    write_binary_slice(fp.get());
+  }
 }
 
 int ThermodynamicLatticeOutput::to_int(const ThermodynamicQuantity &tq) {
@@ -773,12 +858,36 @@ void ThermodynamicLatticeOutput::write_therm_lattice_ascii_header(
 void ThermodynamicLatticeOutput::write_therm_lattice_binary_header(
     std::shared_ptr<std::ofstream> fp, const ThermodynamicQuantity &tq) {
   auto variable_id = to_int(tq);
-  fp->write(
-      reinterpret_cast<const char *>(&ThermodynamicLatticeOutput::version),
-      sizeof(double));
+  fp->write(reinterpret_cast<const char *>(
+                single_precision_ ? &single_precision_version : &version),
+            sizeof(double));
   fp->write(reinterpret_cast<char *>(&variable_id), sizeof(int));
   fp->write(reinterpret_cast<char *>(&nodes_), sizeof(nodes_));
   fp->write(reinterpret_cast<char *>(&sizes_), sizeof(sizes_));
   fp->write(reinterpret_cast<char *>(&origin_), sizeof(origin_));
+  if (single_precision_) {
+    const int value_size = sizeof(float);
+    fp->write(reinterpret_cast<const char *>(&value_size), sizeof(int));
+  }
+}
+
+void ThermodynamicLatticeOutput::begin_binary_slice(double ctime) {
+  slab_.clear();
+  append_binary_raw(&ctime, sizeof(ctime));
+  if (single_precision_) {
+    // number of values, filled in by write_binary_slice
+    const std::uint32_t n_values = 0;
+    append_binary_raw(&n_values, sizeof(n_values));
+  }
+}
+
+void ThermodynamicLatticeOutput::write_binary_slice(std::ofstream *fp) {
+  if (single_precision_) {
+    const std::uint32_t n_values =
+        (slab_.size() - sizeof(double) - sizeof(std::uint32_t)) /
+        sizeof(float);
+    std::memcpy(slab_.data() + sizeof(double), &n_values, sizeof(n_values));
+  }
+  fp->write(slab_.data(), slab_.size());
 }
 }  // namespace smash
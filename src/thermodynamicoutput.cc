@@ -117,7 +117,7 @@ ThermodynamicOutput::ThermodynamicOutput(const bf::path &path,
                                          const std::string &name,
                                          const OutputParameters &out_par)
     : OutputInterface(name),
-      file_{path / "thermodynamics.dat", "w"},
+      file_{path / "thermodynamics.dat", "w", out_par.async_write},
       out_par_(out_par) {
   std::fprintf(file_.get(), "# %s thermodynamics output\n", VERSION_MAJOR);
   const ThreeVector r = out_par.td_position;
@@ -177,7 +177,7 @@ void ThermodynamicOutput::at_eventstart(
 
 void ThermodynamicOutput::at_eventend(
     const std::vector<Particles> & /*particles*/, const int /*event_number*/) {
-  std::fflush(file_.get());
+  file_.flush();
 }
 
 void ThermodynamicOutput::at_intermediate_time(
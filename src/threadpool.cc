@@ -0,0 +1,111 @@
+/*
+ *
+ *    Copyright (c) 2021
+ *      SMASH Team
+ *
+ *    GNU General Public License (GPLv3 or later)
+ *
+ */
+
+#include "smash/threadpool.h"
+
+#include <memory>
+
+#include "smash/cxx14compat.h"
+
+namespace smash {
+
+ThreadPool::ThreadPool(std::size_t n_threads) {
+  if (n_threads == 0) {
+    n_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (std::size_t i = 1; i < n_threads; i++) {
+    workers_.emplace_back(&ThreadPool::work, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_.notify_all();
+  for (std::thread &worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::run(std::size_t n_threads,
+                     const std::function<void(std::size_t)> &task) {
+  if (n_threads <= 1 || busy_.exchange(true)) {
+    task(0);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    n_task_threads_ = std::min(n_threads, size()) - 1;
+    n_running_ = n_task_threads_;
+    generation_++;
+  }
+  start_.notify_all();
+  // The calling thread only returns after the other threads are done, even
+  // if the task throws, since they refer to it.
+  std::exception_ptr error;
+  try {
+    task(0);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return n_running_ == 0; });
+    task_ = nullptr;
+  }
+  busy_ = false;
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void ThreadPool::work(std::size_t thread) {
+  std::size_t generation = 0;
+  while (true) {
+    const std::function<void(std::size_t)> *task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_.wait(lock, [&]() { return stop_ || generation_ != generation; });
+      if (stop_) {
+        return;
+      }
+      generation = generation_;
+      if (thread > n_task_threads_) {
+        continue;
+      }
+      task = task_;
+    }
+    // Exceptions are handled by the tasks, see for_each_index().
+    (*task)(thread);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      n_running_--;
+    }
+    done_.notify_one();
+  }
+}
+
+/// Pool returned by ThreadPool::global().
+static std::unique_ptr<ThreadPool> global_thread_pool;
+
+ThreadPool &ThreadPool::global() {
+  if (!global_thread_pool) {
+    global_thread_pool = make_unique<ThreadPool>(std::size_t(1));
+  }
+  return *global_thread_pool;
+}
+
+void ThreadPool::set_global_size(std::size_t n_threads) {
+  global_thread_pool = make_unique<ThreadPool>(n_threads);
+}
+
+}  // namespace smash
@@ -7,8 +7,12 @@
  *
  */
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <memory>
+#include <sstream>
 #include <utility>
 
 #include "smash/clock.h"
@@ -21,11 +25,18 @@
 namespace smash {
 
 VtkOutput::VtkOutput(const bf::path &path, const std::string &name,
-                     const OutputParameters &out_par)
+                     const OutputParameters &out_par, bool binary)
     : OutputInterface(name),
       base_path_(std::move(path)),
       is_thermodynamics_output_(name == "Thermodynamics"),
-      is_fields_output_(name == "Fields") {
+      is_fields_output_(name == "Fields"),
+      binary_(binary),
+      /* The Fields content has no Single_Precision option of its own and is
+       * always written with double precision. */
+      single_precision_(binary && !is_fields_output_ &&
+                        (is_thermodynamics_output_
+                             ? out_par.td_single_precision
+                             : out_par.part_single_precision)) {
   if (out_par.part_extended) {
     logg[LOutput].warn()
         << "Creating VTK output: There is no extended VTK format.";
@@ -54,6 +65,13 @@ VtkOutput::~VtkOutput() {}
  * black box and opened with paraview, but at the same time they are
  * human-readable text files.
  *
+ * With the format "VTK_Binary" the same data is written in the binary
+ * legacy VTK format instead: the header and the keywords are text, while the
+ * values follow each keyword as raw big-endian 4 byte integers and 8 byte
+ * doubles, or 4 byte floats if \key Single_Precision is set for the
+ * \key Particles content. Such files are several times smaller and much
+ * faster to write and to load in paraview, but not human-readable.
+ *
  * There is also a possibility to print a lattice with thermodynamical
  * quantities to vtk files, see \ref output_vtk_lattice_.
  **/
@@ -91,7 +109,12 @@ void VtkOutput::write(const Particles &particles) {
   char filename[32];
   snprintf(filename, sizeof(filename), "pos_ev%05i_tstep%05i.vtk",
            current_event_, vtk_output_counter_);
-  FilePtr file_{std::fopen((base_path_ / filename).native().c_str(), "w")};
+  FilePtr file_{std::fopen((base_path_ / filename).native().c_str(),
+                           binary_ ? "wb" : "w")};
+  if (binary_) {
+    write_binary(file_.get(), particles);
+    return;
+  }
 
   /* Legacy VTK file format */
   std::fprintf(file_.get(), "# vtk DataFile Version 2.0\n");
@@ -165,6 +188,95 @@ void VtkOutput::write(const Particles &particles) {
   }
 }
 
+template <typename T>
+void VtkOutput::append_big_endian(T value) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+#if defined(LITTLE_ENDIAN_ARCHITECTURE)
+  std::reverse(bytes, bytes + sizeof(T));
+#endif
+  buffer_.append(bytes, sizeof(T));
+}
+
+void VtkOutput::write_binary(std::FILE *file, const Particles &particles) {
+  const std::string n = std::to_string(particles.size());
+  buffer_.clear();
+  buffer_ += "# vtk DataFile Version 2.0\n";
+  buffer_ += "Generated from molecular-offset data " VERSION_MAJOR "\n";
+  buffer_ += "BINARY\n";
+  buffer_ += "DATASET UNSTRUCTURED_GRID\n";
+  buffer_ += "POINTS " + n + " " + real_type() + "\n";
+  for (const auto &p : particles) {
+    append_real(p.position().x1());
+    append_real(p.position().x2());
+    append_real(p.position().x3());
+  }
+  buffer_ += "\nCELLS " + n + " " + std::to_string(2 * particles.size()) +
+             "\n";
+  for (size_t point_index = 0; point_index < particles.size(); point_index++) {
+    append_big_endian<std::int32_t>(1);
+    append_big_endian<std::int32_t>(point_index);
+  }
+  buffer_ += "\nCELL_TYPES " + n + "\n";
+  for (size_t point_index = 0; point_index < particles.size(); point_index++) {
+    append_big_endian<std::int32_t>(1);
+  }
+  buffer_ += "\nPOINT_DATA " + n + "\n";
+  buffer_ += "SCALARS pdg_codes int 1\nLOOKUP_TABLE default\n";
+  for (const auto &p : particles) {
+    append_big_endian<std::int32_t>(p.pdgcode().get_decimal());
+  }
+  buffer_ += "\nSCALARS is_formed int 1\nLOOKUP_TABLE default\n";
+  const double current_time = particles.time();
+  for (const auto &p : particles) {
+    append_big_endian<std::int32_t>(p.formation_time() > current_time ? 0 : 1);
+  }
+  buffer_ += "\nSCALARS cross_section_scaling_factor ";
+  buffer_ += real_type();
+  buffer_ += " 1\nLOOKUP_TABLE default\n";
+  for (const auto &p : particles) {
+    append_real(p.xsec_scaling_factor());
+  }
+  buffer_ += "\nSCALARS mass ";
+  buffer_ += real_type();
+  buffer_ += " 1\nLOOKUP_TABLE default\n";
+  for (const auto &p : particles) {
+    append_real(p.effective_mass());
+  }
+  buffer_ += "\nSCALARS N_coll int 1\nLOOKUP_TABLE default\n";
+  for (const auto &p : particles) {
+    append_big_endian<std::int32_t>(p.get_history().collisions_per_particle);
+  }
+  buffer_ += "\nSCALARS particle_ID int 1\nLOOKUP_TABLE default\n";
+  for (const auto &p : particles) {
+    append_big_endian<std::int32_t>(p.id());
+  }
+  buffer_ += "\nSCALARS baryon_number int 1\nLOOKUP_TABLE default\n";
+  for (const auto &p : particles) {
+    append_big_endian<std::int32_t>(p.pdgcode().baryon_number());
+  }
+  buffer_ += "\nSCALARS strangeness int 1\nLOOKUP_TABLE default\n";
+  for (const auto &p : particles) {
+    append_big_endian<std::int32_t>(p.pdgcode().strangeness());
+  }
+  buffer_ += "\nVECTORS momentum ";
+  buffer_ += real_type();
+  buffer_ += "\n";
+  for (const auto &p : particles) {
+    append_real(p.momentum().x1());
+    append_real(p.momentum().x2());
+    append_real(p.momentum().x3());
+  }
+  buffer_ += '\n';
+  std::fwrite(buffer_.data(), 1, buffer_.size(), file);
+}
+
+void VtkOutput::write_buffer(std::ofstream &file) {
+  if (binary_) {
+    file.write(buffer_.data(), buffer_.size());
+  }
+}
+
 /*!\Userguide
  * \page output_vtk_lattice_ Thermodynamics VTK Output
  * Density on the lattice can be printed out in the VTK format of
@@ -172,6 +284,12 @@ void VtkOutput::write(const Particles &particles) {
  * The name format is
  * \<density_name\>_\<event_number\>_tstep\<number_of_output_moment\>.vtk,
  * Files can be opened directly with ParaView (http://paraview.org).
+ *
+ * With the format "VTK_Binary" the values are written as raw big-endian
+ * 8 byte doubles in the binary legacy VTK format, or as 4 byte floats if
+ * \key Single_Precision is set for the \key Thermodynamics content. The
+ * electric and magnetic fields of the \key Fields content are always written
+ * as doubles. Every file is encoded in memory and written with a single call.
  */
 
 template <typename T>
@@ -181,25 +299,40 @@ void VtkOutput::write_vtk_header(std::ofstream &file,
   const auto dim = lattice.n_cells();
   const auto cs = lattice.cell_sizes();
   const auto orig = lattice.origin();
-  file << "# vtk DataFile Version 2.0\n"
-       << description << "\n"
-       << "ASCII\n"
-       << "DATASET STRUCTURED_POINTS\n"
-       << "DIMENSIONS " << dim[0] << " " << dim[1] << " " << dim[2] << "\n"
-       << "SPACING " << cs[0] << " " << cs[1] << " " << cs[2] << "\n"
-       << "ORIGIN " << orig[0] << " " << orig[1] << " " << orig[2] << "\n"
-       << "POINT_DATA " << lattice.size() << "\n";
+  std::ostringstream header;
+  header << "# vtk DataFile Version 2.0\n"
+         << description << "\n"
+         << (binary_ ? "BINARY\n" : "ASCII\n")
+         << "DATASET STRUCTURED_POINTS\n"
+         << "DIMENSIONS " << dim[0] << " " << dim[1] << " " << dim[2] << "\n"
+         << "SPACING " << cs[0] << " " << cs[1] << " " << cs[2] << "\n"
+         << "ORIGIN " << orig[0] << " " << orig[1] << " " << orig[2] << "\n"
+         << "POINT_DATA " << lattice.size() << "\n";
+  if (binary_) {
+    buffer_ = header.str();
+  } else {
+    file << header.str();
+  }
 }
 
 template <typename T, typename F>
 void VtkOutput::write_vtk_scalar(std::ofstream &file,
                                  RectangularLattice<T> &lattice,
                                  const std::string &varname, F &&get_quantity) {
+  const auto dim = lattice.n_cells();
+  if (binary_) {
+    buffer_ += "SCALARS " + varname + " " + real_type() + " 1\n";
+    buffer_ += "LOOKUP_TABLE default\n";
+    lattice.iterate_sublattice({0, 0, 0}, dim, [&](T &node, int, int, int) {
+      append_real(get_quantity(node));
+    });
+    buffer_ += '\n';
+    return;
+  }
   file << "SCALARS " << varname << " double 1\n"
        << "LOOKUP_TABLE default\n";
   file << std::setprecision(3);
   file << std::fixed;
-  const auto dim = lattice.n_cells();
   lattice.iterate_sublattice({0, 0, 0}, dim, [&](T &node, int ix, int, int) {
     const double f_from_node = get_quantity(node);
     file << f_from_node << " ";
@@ -213,10 +346,21 @@ template <typename T, typename F>
 void VtkOutput::write_vtk_vector(std::ofstream &file,
                                  RectangularLattice<T> &lattice,
                                  const std::string &varname, F &&get_quantity) {
+  const auto dim = lattice.n_cells();
+  if (binary_) {
+    buffer_ += "VECTORS " + varname + " " + real_type() + "\n";
+    lattice.iterate_sublattice({0, 0, 0}, dim, [&](T &node, int, int, int) {
+      const ThreeVector v = get_quantity(node);
+      append_real(v.x1());
+      append_real(v.x2());
+      append_real(v.x3());
+    });
+    buffer_ += '\n';
+    return;
+  }
   file << "VECTORS " << varname << " double\n";
   file << std::setprecision(3);
   file << std::fixed;
-  const auto dim = lattice.n_cells();
   lattice.iterate_sublattice({0, 0, 0}, dim, [&](T &node, int, int, int) {
     const ThreeVector v = get_quantity(node);
     file << v.x1() << " " << v.x2() << " " << v.x3() << "\n";
@@ -244,10 +388,12 @@ void VtkOutput::thermodynamics_output(
   }
   std::ofstream file;
   const std::string varname = make_varname(tq, dens_type);
-  file.open(make_filename(varname, vtk_density_output_counter_), std::ios::out);
+  file.open(make_filename(varname, vtk_density_output_counter_),
+            std::ios::out | std::ios::binary);
   write_vtk_header(file, lattice, varname);
   write_vtk_scalar(file, lattice, varname,
                    [&](DensityOnLattice &node) { return node.rho(); });
+  write_buffer(file);
   vtk_density_output_counter_++;
 }
 
@@ -277,7 +423,8 @@ void VtkOutput::thermodynamics_output(
   const std::string varname = make_varname(tq, dens_type);
 
   if (tq == ThermodynamicQuantity::Tmn) {
-    file.open(make_filename(varname, vtk_tmn_output_counter_++), std::ios::out);
+    file.open(make_filename(varname, vtk_tmn_output_counter_++),
+              std::ios::out | std::ios::binary);
     write_vtk_header(file, Tmn_lattice, varname);
     for (int i = 0; i < 4; i++) {
       for (int j = i; j < 4; j++) {
@@ -290,7 +437,7 @@ void VtkOutput::thermodynamics_output(
     }
   } else if (tq == ThermodynamicQuantity::TmnLandau) {
     file.open(make_filename(varname, vtk_tmn_landau_output_counter_++),
-              std::ios::out);
+              std::ios::out | std::ios::binary);
     write_vtk_header(file, Tmn_lattice, varname);
     for (int i = 0; i < 4; i++) {
       for (int j = i; j < 4; j++) {
@@ -305,7 +452,7 @@ void VtkOutput::thermodynamics_output(
     }
   } else {
     file.open(make_filename(varname, vtk_v_landau_output_counter_++),
-              std::ios::out);
+              std::ios::out | std::ios::binary);
     write_vtk_header(file, Tmn_lattice, varname);
     write_vtk_vector(file, Tmn_lattice, varname,
                      [&](EnergyMomentumTensor &node) {
@@ -313,6 +460,7 @@ void VtkOutput::thermodynamics_output(
                        return -u.velocity();
                      });
   }
+  write_buffer(file);
 }
 
 void VtkOutput::fields_output(
@@ -322,17 +470,21 @@ void VtkOutput::fields_output(
     return;
   }
   std::ofstream file1;
-  file1.open(make_filename(name1, vtk_fields_output_counter_), std::ios::out);
+  file1.open(make_filename(name1, vtk_fields_output_counter_),
+             std::ios::out | std::ios::binary);
   write_vtk_header(file1, lat, name1);
   write_vtk_vector(
       file1, lat, name1,
       [&](std::pair<ThreeVector, ThreeVector> &node) { return node.first; });
+  write_buffer(file1);
   std::ofstream file2;
-  file2.open(make_filename(name2, vtk_fields_output_counter_), std::ios::out);
+  file2.open(make_filename(name2, vtk_fields_output_counter_),
+             std::ios::out | std::ios::binary);
   write_vtk_header(file2, lat, name2);
   write_vtk_vector(
       file2, lat, name2,
       [&](std::pair<ThreeVector, ThreeVector> &node) { return node.second; });
+  write_buffer(file2);
   vtk_fields_output_counter_++;
 }
 
@@ -342,7 +494,7 @@ void VtkOutput::thermodynamics_output(const GrandCanThermalizer &gct) {
   }
   std::ofstream file;
   file.open(make_filename("fluidization_td", vtk_fluidization_counter_++),
-            std::ios::out);
+            std::ios::out | std::ios::binary);
   write_vtk_header(file, gct.lattice(), "fluidization_td");
   write_vtk_scalar(file, gct.lattice(), "e",
                    [&](ThermLatticeNode &node) { return node.e(); });
@@ -356,6 +508,7 @@ void VtkOutput::thermodynamics_output(const GrandCanThermalizer &gct) {
                    [&](ThermLatticeNode &node) { return node.mub(); });
   write_vtk_scalar(file, gct.lattice(), "mus",
                    [&](ThermLatticeNode &node) { return node.mus(); });
+  write_buffer(file);
 }
 
 }  // namespace smash